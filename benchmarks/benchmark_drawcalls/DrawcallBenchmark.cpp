@@ -0,0 +1,202 @@
+#include "DrawcallBenchmark.h"
+
+#include <ituGL/shader/Shader.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/geometry/Model.h>
+#include <ituGL/geometry/VertexFormat.h>
+#include <ituGL/renderer/ForwardRenderPass.h>
+#include <ituGL/utils/Json.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+// Same uniforms as the default shaders of the exercises, with batched lights
+static const char* s_vertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec3 VertexPosition;
+uniform mat4 WorldMatrix;
+uniform mat4 ViewProjMatrix;
+void main()
+{
+    gl_Position = ViewProjMatrix * WorldMatrix * vec4(VertexPosition, 1.0);
+}
+)";
+
+static const char* s_fragmentShaderSource = R"(
+#version 330 core
+uniform vec3 Color;
+uniform vec3 AmbientColor;
+uniform bool LightIndirect;
+uniform int LightCount;
+uniform vec3 LightColors[8];
+uniform vec3 LightPositions[8];
+uniform vec3 LightDirections[8];
+uniform vec4 LightAttenuations[8];
+out vec4 FragColor;
+void main()
+{
+    vec3 color = LightIndirect ? AmbientColor : vec3(0.0);
+    for (int i = 0; i < LightCount; ++i)
+    {
+        color += LightColors[i] * max(dot(LightDirections[i], vec3(0.0, 1.0, 0.0)), 0.0);
+    }
+    FragColor = vec4(color * Color, 1.0);
+}
+)";
+
+DrawcallBenchmark::DrawcallBenchmark(const BenchmarkApplication::Settings& settings)
+    : m_settings(settings)
+    , m_device(DeviceGL::Backend::Null)
+    , m_renderer(m_device)
+{
+    BenchmarkApplication::ResolvePaths(m_settings);
+
+    m_device.SetViewport(0, 0, 1024, 1024);
+}
+
+int DrawcallBenchmark::Run()
+{
+    Initialize();
+
+    unsigned int frameCount = m_settings.warmupFrames + m_settings.measuredFrames;
+    m_cpuTimes.reserve(m_settings.measuredFrames);
+    for (unsigned int frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        RenderFrame();
+        auto endTime = std::chrono::steady_clock::now();
+
+        if (frameIndex >= m_settings.warmupFrames)
+        {
+            m_cpuTimes.push_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+        }
+    }
+
+    std::ofstream file(m_settings.outputPath);
+    WriteJson(file);
+
+    // Nanoseconds per drawcall, from the median frame
+    BenchmarkApplication::Statistics cpuStatistics = BenchmarkApplication::ComputeStatistics(m_cpuTimes);
+    double drawcallTime = cpuStatistics.p50 * 1e6 / std::max(m_settings.sceneScale, 1u);
+    std::cout << m_settings.name << ": " << m_settings.sceneScale << " drawcalls, " << m_cpuTimes.size() << " frames" << std::endl;
+    BenchmarkApplication::PrintStatistics("CPU", cpuStatistics);
+    std::cout << "  ns per drawcall: " << drawcallTime << std::endl;
+    std::cout << "  Results written to " << m_settings.outputPath << std::endl;
+
+    return 0;
+}
+
+void DrawcallBenchmark::Initialize()
+{
+    // Single triangle. It has no bounds, so it is never culled
+    std::vector<glm::vec3> vertices = { glm::vec3(-0.5f, 0.0f, 0.0f), glm::vec3(0.5f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) };
+    VertexFormat vertexFormat;
+    vertexFormat.AddVertexAttribute<float>(3, VertexAttribute::Semantic::Position);
+    m_mesh = std::make_shared<Mesh>();
+    m_mesh->AddSubmesh<glm::vec3, VertexFormat::LayoutIterator>(Drawcall::Primitive::Triangles, vertices, vertexFormat.LayoutBegin(3, false), vertexFormat.LayoutEnd());
+
+    ShaderUniformCollection::NameSet filteredUniforms;
+    filteredUniforms.insert("WorldMatrix");
+    filteredUniforms.insert("ViewProjMatrix");
+    filteredUniforms.insert("LightIndirect");
+    filteredUniforms.insert("LightCount");
+    filteredUniforms.insert("LightColors[0]");
+    filteredUniforms.insert("LightPositions[0]");
+    filteredUniforms.insert("LightDirections[0]");
+    filteredUniforms.insert("LightAttenuations[0]");
+
+    for (unsigned int programIndex = 0; programIndex < ShaderProgramCount; ++programIndex)
+    {
+        Shader vertexShader(Shader::VertexShader);
+        vertexShader.SetSource(s_vertexShaderSource);
+        vertexShader.Compile();
+
+        Shader fragmentShader(Shader::FragmentShader);
+        fragmentShader.SetSource(s_fragmentShaderSource);
+        fragmentShader.Compile();
+
+        std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
+        shaderProgramPtr->Build(vertexShader, fragmentShader);
+
+        ShaderProgram::Location worldMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldMatrix");
+        ShaderProgram::Location viewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("ViewProjMatrix");
+        m_renderer.RegisterShaderProgram(shaderProgramPtr,
+            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+            {
+                if (cameraChanged)
+                {
+                    shaderProgram.SetUniform(viewProjMatrixLocation, camera.GetViewProjectionMatrix());
+                }
+                shaderProgram.SetUniform(worldMatrixLocation, worldMatrix);
+            },
+            m_renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
+        );
+
+        for (unsigned int materialIndex = 0; materialIndex < MaterialsPerShaderProgram; ++materialIndex)
+        {
+            std::shared_ptr<Material> material = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+            material->SetUniformValue("Color", glm::vec3(1.0f, materialIndex / 8.0f, programIndex / 4.0f));
+            material->SetUniformValue("AmbientColor", glm::vec3(0.25f));
+
+            std::shared_ptr<Model> model = std::make_shared<Model>(m_mesh);
+            model->AddMaterial(material);
+            m_models.push_back(model);
+        }
+    }
+
+    // Drawcalls in a grid in front of the camera
+    m_worldMatrices.reserve(m_settings.sceneScale);
+    for (unsigned int i = 0; i < m_settings.sceneScale; ++i)
+    {
+        glm::vec3 position(static_cast<float>(i % 100) - 50.0f, static_cast<float>(i / 100 % 100) - 50.0f, -static_cast<float>(i / 10000));
+        m_worldMatrices.push_back(glm::translate(glm::mat4(1.0f), position));
+    }
+
+    m_camera.SetPerspectiveProjectionMatrix(1.0f, 1.0f, 0.1f, 1000.0f);
+    m_camera.SetViewMatrix(glm::vec3(0.0f, 0.0f, 100.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Every drawcall takes its own path
+    m_renderer.SetCullingEnabled(false);
+    m_renderer.SetInstancingEnabled(false);
+    m_renderer.SetGpuProfilingEnabled(false);
+    m_renderer.AddRenderPass(std::make_unique<ForwardRenderPass>());
+}
+
+void DrawcallBenchmark::RenderFrame()
+{
+    m_renderer.SetCurrentCamera(m_camera);
+    m_renderer.AddLight(m_light);
+
+    // Interleave the materials, so the sort has something to do
+    for (unsigned int i = 0; i < m_worldMatrices.size(); ++i)
+    {
+        m_renderer.AddModel(*m_models[i % m_models.size()], m_worldMatrices[i]);
+    }
+
+    m_device.Clear(true, Color(0.0f, 0.0f, 0.0f, 1.0f), true, 1.0f);
+    m_renderer.Render();
+}
+
+void DrawcallBenchmark::WriteJson(std::ostream& stream) const
+{
+    BenchmarkApplication::Statistics cpuStatistics = BenchmarkApplication::ComputeStatistics(m_cpuTimes);
+
+    stream.setf(std::ios::fixed);
+    stream.precision(4);
+
+    stream << "{\n";
+    stream << "  \"name\": ";
+    Json::WriteString(stream, m_settings.name);
+    stream << ",\n";
+    stream << "  \"backend\": \"null\",\n";
+    stream << "  \"drawcalls\": " << m_settings.sceneScale << ",\n";
+    stream << "  \"warmupFrames\": " << m_settings.warmupFrames << ",\n";
+    stream << "  \"measuredFrames\": " << m_cpuTimes.size() << ",\n";
+    BenchmarkApplication::WriteStatistics(stream, "cpu", cpuStatistics);
+    stream << "  \"nsPerDrawcall\": " << cpuStatistics.p50 * 1e6 / std::max(m_settings.sceneScale, 1u) << "\n";
+    stream << "}\n";
+}
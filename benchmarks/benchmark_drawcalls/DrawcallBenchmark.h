@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ituGL/application/BenchmarkApplication.h>
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/camera/Camera.h>
+#include <ituGL/lighting/DirectionalLight.h>
+#include <ituGL/geometry/Mesh.h>
+#include <ituGL/renderer/Renderer.h>
+
+#include <ostream>
+#include <vector>
+
+class Model;
+class Material;
+
+// Microbenchmark of the cost of each drawcall on the CPU: submitting it, preparing its states and drawing it
+// It runs on the null GL backend, with a single triangle and a single light, so the driver and the scene don't add anything
+// The drawcalls use several materials and shader programs, with instancing and culling disabled, so each one takes the full path
+class DrawcallBenchmark
+{
+public:
+    DrawcallBenchmark(const BenchmarkApplication::Settings& settings);
+
+    // Render the warmup and the measured frames, and save the results. Returns the exit code
+    int Run();
+
+private:
+    void Initialize();
+    void RenderFrame();
+
+    void WriteJson(std::ostream& stream) const;
+
+private:
+    BenchmarkApplication::Settings m_settings;
+
+    // Device using the null backend. Created first, the objects below need it
+    DeviceGL m_device;
+
+    Renderer m_renderer;
+
+    Camera m_camera;
+    DirectionalLight m_light;
+
+    // One model per material, all of them using the same mesh
+    std::shared_ptr<Mesh> m_mesh;
+    std::vector<std::shared_ptr<Model>> m_models;
+
+    // World matrix of each drawcall
+    std::vector<glm::mat4> m_worldMatrices;
+
+    // CPU time of each measured frame, in milliseconds
+    std::vector<double> m_cpuTimes;
+
+    // The drawcalls are spread over these programs and materials
+    static const unsigned int ShaderProgramCount = 4;
+    static const unsigned int MaterialsPerShaderProgram = 8;
+};
@@ -0,0 +1,15 @@
+#include "DrawcallBenchmark.h"
+
+int main(int argc, char* argv[])
+{
+    BenchmarkApplication::Settings settings;
+    settings.name = "benchmark_drawcalls";
+    settings.sceneScale = 10000;
+    if (!BenchmarkApplication::ParseArguments(argc, argv, settings))
+    {
+        return -1;
+    }
+
+    DrawcallBenchmark benchmark(settings);
+    return benchmark.Run();
+}
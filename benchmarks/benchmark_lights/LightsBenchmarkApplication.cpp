@@ -0,0 +1,334 @@
+#include "LightsBenchmarkApplication.h"
+
+#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/asset/ModelLoader.h>
+
+#include <ituGL/camera/Camera.h>
+#include <ituGL/scene/SceneCamera.h>
+
+#include <ituGL/lighting/DirectionalLight.h>
+#include <ituGL/lighting/PointLight.h>
+#include <ituGL/scene/SceneLight.h>
+
+#include <ituGL/shader/ShaderUniformCollection.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/geometry/Model.h>
+#include <ituGL/scene/SceneModel.h>
+#include <ituGL/scene/Transform.h>
+
+#include <ituGL/renderer/GBufferRenderPass.h>
+#include <ituGL/renderer/DeferredRenderPass.h>
+#include <ituGL/renderer/TiledDeferredRenderPass.h>
+#include <ituGL/renderer/PostFXRenderPass.h>
+#include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/scene/RendererSceneVisitor.h>
+
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+LightsBenchmarkApplication::LightsBenchmarkApplication(const Settings& settings)
+    : BenchmarkApplication(1024, 1024, settings)
+    , m_renderer(GetDevice())
+    , m_gbufferLayout(GBufferRenderPass::Layout::GetDefault())
+    , m_tiledLighting(false)
+    , m_extent(8.0f)
+{
+    if (settings.variant == "packed")
+    {
+        m_gbufferLayout = GBufferRenderPass::Layout::GetPacked(TextureObject::InternalFormatRGB10A2);
+    }
+    else if (settings.variant == "packed-rgba8")
+    {
+        m_gbufferLayout = GBufferRenderPass::Layout::GetPacked(TextureObject::InternalFormatRGBA8);
+    }
+    else if (settings.variant == "tiled")
+    {
+        m_tiledLighting = true;
+    }
+}
+
+void LightsBenchmarkApplication::Initialize()
+{
+    BenchmarkApplication::Initialize();
+
+    // The tiled variant needs compute shaders. Without them, the results would measure nothing
+    if (m_tiledLighting && !TiledDeferredRenderPass::IsSupported())
+    {
+        Terminate(-3, "The tiled variant needs OpenGL 4.3");
+        return;
+    }
+
+    InitializeCamera();
+    InitializeLights();
+    InitializeMaterials();
+    InitializeModels();
+    InitializeRenderer();
+}
+
+void LightsBenchmarkApplication::Update()
+{
+    BenchmarkApplication::Update();
+
+    float time = GetCurrentTime();
+
+    // Slow orbit around the scene. It only depends on the time, so every run renders the same frames
+    float angle = 0.1f * time;
+    glm::vec3 position(1.5f * m_extent * std::cos(angle), 0.6f * m_extent, 1.5f * m_extent * std::sin(angle));
+    m_camera->SetViewMatrix(position, glm::vec3(0.0f), glm::vec3(0, 1, 0));
+
+    // Each light moves in its own circle, with a speed and phase that depend on its index
+    for (std::size_t i = 0; i < m_pointLights.size(); ++i)
+    {
+        float lightAngle = (0.5f + 0.01f * (i % 50)) * time + 2.39996f * i;
+        float radius = m_extent * std::sqrt((i + 0.5f) / m_pointLights.size());
+        m_pointLights[i]->SetPosition(glm::vec3(radius * std::cos(lightAngle), 0.5f, radius * std::sin(lightAngle)));
+    }
+
+    // Add the scene nodes to the renderer
+    RendererSceneVisitor rendererSceneVisitor(m_renderer);
+    m_scene.AcceptVisitor(rendererSceneVisitor);
+}
+
+void LightsBenchmarkApplication::Render()
+{
+    BenchmarkApplication::Render();
+
+    GetDevice().Clear(true, Color(0.0f, 0.0f, 0.0f, 1.0f), true, 1.0f);
+
+    // Render the scene
+    m_renderer.Render();
+}
+
+void LightsBenchmarkApplication::InitializeCamera()
+{
+    // Create the main camera. The view matrix is set every frame
+    m_camera = std::make_shared<Camera>();
+    m_camera->SetPerspectiveProjectionMatrix(1.0f, GetMainWindow().GetAspectRatio(), 0.1f, 100.0f);
+
+    // Create a scene node for the camera, and add it to the scene
+    m_scene.AddSceneNode(std::make_shared<SceneCamera>("camera", m_camera));
+}
+
+void LightsBenchmarkApplication::InitializeLights()
+{
+    // Dim directional light, so the point lights dominate
+    std::shared_ptr<DirectionalLight> directionalLight = std::make_shared<DirectionalLight>();
+    directionalLight->SetDirection(glm::vec3(0.0f, -1.0f, -0.3f)); // It will be normalized inside the function
+    directionalLight->SetIntensity(0.2f);
+    m_scene.AddSceneNode(std::make_shared<SceneLight>("directional light", directionalLight));
+
+    // Point lights with random colors. The seed is fixed, so every run gets the same colors
+    std::minstd_rand random(1);
+    std::uniform_real_distribution<float> distribution(0.2f, 1.0f);
+    unsigned int pointLightCount = GetSettings().sceneScale;
+    for (unsigned int i = 0; i < pointLightCount; ++i)
+    {
+        std::shared_ptr<PointLight> pointLight = std::make_shared<PointLight>();
+        pointLight->SetColor(glm::vec3(distribution(random), distribution(random), distribution(random)));
+        pointLight->SetIntensity(2.0f);
+        pointLight->SetDistanceAttenuation(glm::vec2(1.0f, 2.0f));
+        m_scene.AddSceneNode(std::make_shared<SceneLight>("point light " + std::to_string(i), pointLight));
+        m_pointLights.push_back(pointLight);
+    }
+}
+
+void LightsBenchmarkApplication::InitializeMaterials()
+{
+    // G-buffer material
+    {
+        // Load and build shader
+        std::vector<const char*> vertexShaderPaths;
+        vertexShaderPaths.push_back("shaders/version330.glsl");
+        vertexShaderPaths.push_back("shaders/default.vert");
+        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
+
+        std::vector<const char*> fragmentShaderPaths;
+        fragmentShaderPaths.push_back("shaders/version330.glsl");
+        if (m_gbufferLayout.encoding == GBufferRenderPass::Layout::Encoding::Packed)
+        {
+            fragmentShaderPaths.push_back("shaders/gbuffer-packed.glsl");
+        }
+        fragmentShaderPaths.push_back("shaders/utils.glsl");
+        fragmentShaderPaths.push_back("shaders/default.frag");
+        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
+
+        std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
+        shaderProgramPtr->Build(vertexShader, fragmentShader);
+
+        // Get transform related uniform locations
+        ShaderProgram::Location worldViewMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewMatrix");
+        ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
+
+        // Register shader with renderer
+        m_renderer.RegisterShaderProgram(shaderProgramPtr,
+            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+            {
+                shaderProgram.SetUniform(worldViewMatrixLocation, camera.GetViewMatrix() * worldMatrix);
+                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+            },
+            nullptr
+        );
+
+        // Filter out uniforms that are not material properties
+        ShaderUniformCollection::NameSet filteredUniforms;
+        filteredUniforms.insert("WorldViewMatrix");
+        filteredUniforms.insert("WorldViewProjMatrix");
+
+        // Create material
+        m_defaultMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+        m_defaultMaterial->SetUniformValue("Color", glm::vec3(1.0f));
+    }
+
+    // Tiled deferred material
+    if (m_tiledLighting)
+    {
+        m_deferredMaterial = TiledDeferredRenderPass::CreateMaterial(m_renderer, m_gbufferLayout);
+
+        // Copy of the lit scene to the default framebuffer
+        std::vector<const char*> vertexShaderPaths;
+        vertexShaderPaths.push_back("shaders/version330.glsl");
+        vertexShaderPaths.push_back("shaders/renderer/fullscreen.vert");
+        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
+
+        std::vector<const char*> fragmentShaderPaths;
+        fragmentShaderPaths.push_back("shaders/version330.glsl");
+        fragmentShaderPaths.push_back("shaders/postfx/copy.frag");
+        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
+
+        std::shared_ptr<ShaderProgram> copyShaderProgramPtr = std::make_shared<ShaderProgram>();
+        copyShaderProgramPtr->Build(vertexShader, fragmentShader);
+        m_copyMaterial = std::make_shared<Material>(copyShaderProgramPtr);
+    }
+    // Deferred material
+    else
+    {
+        std::vector<const char*> vertexShaderPaths;
+        vertexShaderPaths.push_back("shaders/version330.glsl");
+        vertexShaderPaths.push_back("shaders/renderer/deferred.vert");
+        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
+
+        std::vector<const char*> fragmentShaderPaths;
+        fragmentShaderPaths.push_back("shaders/version330.glsl");
+        if (m_gbufferLayout.encoding == GBufferRenderPass::Layout::Encoding::Packed)
+        {
+            fragmentShaderPaths.push_back("shaders/gbuffer-packed.glsl");
+        }
+        fragmentShaderPaths.push_back("shaders/utils.glsl");
+        fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
+        fragmentShaderPaths.push_back("shaders/lighting.glsl");
+        fragmentShaderPaths.push_back("shaders/renderer/deferred.frag");
+        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
+
+        std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
+        shaderProgramPtr->Build(vertexShader, fragmentShader);
+
+        // Filter out uniforms that are not material properties
+        ShaderUniformCollection::NameSet filteredUniforms;
+        filteredUniforms.insert("InvViewMatrix");
+        filteredUniforms.insert("InvProjMatrix");
+        filteredUniforms.insert("WorldViewProjMatrix");
+        filteredUniforms.insert("LightIndirect");
+        filteredUniforms.insert("LightColor");
+        filteredUniforms.insert("LightPosition");
+        filteredUniforms.insert("LightDirection");
+        filteredUniforms.insert("LightAttenuation");
+
+        // Get transform related uniform locations
+        ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
+        ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
+        ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
+
+        // Register shader with renderer
+        m_renderer.RegisterShaderProgram(shaderProgramPtr,
+            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+            {
+                if (cameraChanged)
+                {
+                    shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
+                    shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
+                }
+                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+            },
+            m_renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
+        );
+
+        // Create material
+        m_deferredMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+    }
+}
+
+void LightsBenchmarkApplication::InitializeModels()
+{
+    // Configure loader
+    ModelLoader loader(m_defaultMaterial);
+    loader.SetCreateMaterials(true);
+    loader.GetTexture2DLoader().SetFlipVertical(true);
+
+    // Link vertex properties to attributes
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Position, "VertexPosition");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Normal, "VertexNormal");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Tangent, "VertexTangent");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Bitangent, "VertexBitangent");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::TexCoord0, "VertexTexCoord");
+
+    // Link material properties to uniforms
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::DiffuseColor, "Color");
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::DiffuseTexture, "ColorTexture");
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::NormalTexture, "NormalTexture");
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::SpecularTexture, "SpecularTexture");
+
+    // A fixed grid of cannons for the lights to move over. The benchmark scales the lights, not the models
+    std::shared_ptr<Model> cannonModel = loader.LoadShared("models/cannon/cannon.obj");
+    const int gridSize = 6;
+    float spacing = 2.0f * m_extent / gridSize;
+    for (int i = 0; i < gridSize * gridSize; ++i)
+    {
+        std::shared_ptr<Transform> transform = std::make_shared<Transform>();
+        transform->SetTranslation(glm::vec3((i % gridSize + 0.5f) * spacing - m_extent, 0.0f, (i / gridSize + 0.5f) * spacing - m_extent));
+        transform->SetRotation(glm::vec3(0.0f, glm::half_pi<float>() * i, 0.0f));
+        m_scene.AddSceneNode(std::make_shared<SceneModel>("cannon " + std::to_string(i), cannonModel, transform));
+    }
+}
+
+void LightsBenchmarkApplication::InitializeRenderer()
+{
+    int width, height;
+    GetMainWindow().GetDimensions(width, height);
+
+    // The g-buffer can only store opaque drawcalls
+    unsigned int opaqueCollectionIndex = m_renderer.AddDrawcallCollection(Renderer::IsOpaqueDrawcall);
+    std::unique_ptr<GBufferRenderPass> gbufferRenderPass(std::make_unique<GBufferRenderPass>(width, height, opaqueCollectionIndex, m_gbufferLayout));
+    std::cout << GetSettings().name << ": g-buffer of " << gbufferRenderPass->GetBytesPerPixel() << " bytes per pixel, without depth" << std::endl;
+
+    // Set the g-buffer textures as properties of the deferred material. The packed layout has no others texture
+    m_deferredMaterial->SetUniformValue("DepthTexture", gbufferRenderPass->GetDepthTexture());
+    m_deferredMaterial->SetUniformValue("AlbedoTexture", gbufferRenderPass->GetAlbedoTexture());
+    m_deferredMaterial->SetUniformValue("NormalTexture", gbufferRenderPass->GetNormalTexture());
+    m_deferredMaterial->SetUniformValue("OthersTexture", gbufferRenderPass->GetOthersTexture());
+
+    m_renderer.AddRenderPass(std::move(gbufferRenderPass));
+
+    if (m_tiledLighting)
+    {
+        // The compute pass lights the scene into a texture, copied to the default framebuffer like the other variants draw to it
+        std::shared_ptr<Texture2DObject> sceneTexture = std::make_shared<Texture2DObject>();
+        sceneTexture->Bind();
+        sceneTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatRGBA16F);
+        sceneTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
+        sceneTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+        Texture2DObject::Unbind();
+
+        m_copyMaterial->SetUniformValue("SourceTexture", sceneTexture);
+
+        m_renderer.AddRenderPass(std::make_unique<TiledDeferredRenderPass>(m_deferredMaterial, sceneTexture));
+        m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(m_copyMaterial));
+    }
+    else
+    {
+        // The lights are drawn as volumes to the default framebuffer, without the g-buffer depth to test them against
+        m_renderer.AddRenderPass(std::make_unique<DeferredRenderPass>(m_deferredMaterial));
+    }
+}
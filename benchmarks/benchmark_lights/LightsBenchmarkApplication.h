@@ -0,0 +1,60 @@
+#pragma once
+
+#include <ituGL/application/BenchmarkApplication.h>
+
+#include <ituGL/scene/Scene.h>
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/renderer/GBufferRenderPass.h>
+#include <vector>
+
+class Camera;
+class Material;
+class PointLight;
+
+// Scene of exercise09 scaled up: a grid of cannons, lit with deferred rendering by many point lights that move over them
+// The variant selects the g-buffer layout: "default", "packed" (RGB10A2 normal) or "packed-rgba8"
+// Or "tiled", the default layout lit by the tiled compute pass instead of one draw per light
+class LightsBenchmarkApplication : public BenchmarkApplication
+{
+public:
+    LightsBenchmarkApplication(const Settings& settings);
+
+protected:
+    void Initialize() override;
+    void Update() override;
+    void Render() override;
+
+private:
+    void InitializeCamera();
+    void InitializeLights();
+    void InitializeMaterials();
+    void InitializeModels();
+    void InitializeRenderer();
+
+private:
+    // Global scene
+    Scene m_scene;
+
+    // Renderer
+    Renderer m_renderer;
+
+    // Camera, moved along a fixed path
+    std::shared_ptr<Camera> m_camera;
+
+    // Point lights, moved every frame
+    std::vector<std::shared_ptr<PointLight>> m_pointLights;
+
+    // Materials
+    std::shared_ptr<Material> m_defaultMaterial;
+    std::shared_ptr<Material> m_deferredMaterial;
+    std::shared_ptr<Material> m_copyMaterial;
+
+    // Formats and encoding of the g-buffer, from the variant
+    GBufferRenderPass::Layout m_gbufferLayout;
+
+    // Light with the tiled compute pass, from the variant
+    bool m_tiledLighting;
+
+    // Half of the size of the area covered by the models and the lights
+    float m_extent;
+};
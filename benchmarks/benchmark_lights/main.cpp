@@ -0,0 +1,17 @@
+#include "LightsBenchmarkApplication.h"
+
+int main(int argc, char* argv[])
+{
+    BenchmarkApplication::Settings settings;
+    settings.name = "benchmark_lights";
+    settings.sceneScale = 256;
+    settings.assetDirectory = BENCHMARK_ASSET_DIRECTORY;
+    settings.variants = { "default", "packed", "packed-rgba8", "tiled" };
+    if (!BenchmarkApplication::ParseArguments(argc, argv, settings))
+    {
+        return -1;
+    }
+
+    LightsBenchmarkApplication benchmarkApplication(settings);
+    return benchmarkApplication.Run();
+}
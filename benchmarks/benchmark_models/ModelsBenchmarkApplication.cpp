@@ -0,0 +1,34 @@
+#include "ModelsBenchmarkApplication.h"
+
+#include <ituGL/renderer/ForwardRenderPass.h>
+
+ModelsBenchmarkApplication::ModelsBenchmarkApplication(const Settings& settings)
+    : BenchmarkApplication(1024, 1024, settings)
+    , m_renderer(GetDevice())
+{
+}
+
+void ModelsBenchmarkApplication::Initialize()
+{
+    BenchmarkApplication::Initialize();
+
+    m_scene.Initialize(m_renderer, GetSettings().sceneScale, GetMainWindow().GetAspectRatio(), true);
+    m_renderer.AddRenderPass(std::make_unique<ForwardRenderPass>());
+}
+
+void ModelsBenchmarkApplication::Update()
+{
+    BenchmarkApplication::Update();
+
+    m_scene.Update(m_renderer, GetCurrentTime());
+}
+
+void ModelsBenchmarkApplication::Render()
+{
+    BenchmarkApplication::Render();
+
+    GetDevice().Clear(true, Color(0.0f, 0.0f, 0.0f, 1.0f), true, 1.0f);
+
+    // Render the scene
+    m_renderer.Render();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ituGL/application/BenchmarkApplication.h>
+#include <ituGL/application/BenchmarkScene.h>
+
+#include <ituGL/renderer/Renderer.h>
+
+// Scene of exercise08 scaled up: a grid of treasure chests, lit by forward rendering, with a camera orbiting around them
+// Each chest has a box occluder, so the chests hidden by the closer ones are culled on the CPU
+class ModelsBenchmarkApplication : public BenchmarkApplication
+{
+public:
+    ModelsBenchmarkApplication(const Settings& settings);
+
+protected:
+    void Initialize() override;
+    void Update() override;
+    void Render() override;
+
+private:
+    // Global scene, shared with benchmark_submission
+    BenchmarkScene m_scene;
+
+    // Renderer
+    Renderer m_renderer;
+};
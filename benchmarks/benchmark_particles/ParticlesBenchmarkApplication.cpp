@@ -0,0 +1,185 @@
+#include "ParticlesBenchmarkApplication.h"
+
+#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/geometry/VertexAttribute.h>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+// Structure defining that Particle data
+struct Particle
+{
+    glm::vec2 position;
+    float size;
+    float birth;
+    float duration;
+    Color color;
+    glm::vec2 velocity;
+};
+
+// List of attributes of the particle. Must match the structure above
+const std::array<VertexAttribute, 6> s_vertexAttributes =
+{
+    VertexAttribute(Data::Type::Float, 2), // position
+    VertexAttribute(Data::Type::Float, 1), // size
+    VertexAttribute(Data::Type::Float, 1), // birth
+    VertexAttribute(Data::Type::Float, 1), // duration
+    VertexAttribute(Data::Type::Float, 4), // color
+    VertexAttribute(Data::Type::Float, 2), // velocity
+};
+
+// Particles live between these durations, in seconds
+const float s_minDuration = 1.0f;
+const float s_maxDuration = 2.0f;
+
+// The buffer is split in regions that are protected separately
+const unsigned int s_regionCount = 4;
+
+ParticlesBenchmarkApplication::ParticlesBenchmarkApplication(const Settings& settings)
+    : BenchmarkApplication(1024, 1024, settings)
+    , m_currentTimeUniform(0)
+    , m_gravityUniform(0)
+    , m_random(1)
+    , m_particleCount(0)
+    , m_particleCapacity(0)
+    , m_particlesPerFrame(0)
+{
+}
+
+void ParticlesBenchmarkApplication::Initialize()
+{
+    BenchmarkApplication::Initialize();
+
+    // Round the capacity up to the number of regions
+    m_particleCapacity = std::max(GetSettings().sceneScale, 1u);
+    m_particleCapacity = (m_particleCapacity + s_regionCount - 1) / s_regionCount * s_regionCount;
+
+    // With a fixed delta time, this many particles per frame fill the capacity in the max duration
+    m_particlesPerFrame = std::max(static_cast<unsigned int>(m_particleCapacity * GetFixedDeltaTime() / s_maxDuration), 1u);
+
+    InitializeGeometry();
+
+    InitializeShaders();
+
+    // Enable GL_PROGRAM_POINT_SIZE to have variable point size per-particle
+    GetDevice().EnableFeature(GL_PROGRAM_POINT_SIZE);
+
+    // Enable GL_BLEND to have blending on the particles, and configure it as additive blending
+    GetDevice().EnableFeature(GL_BLEND);
+    GetDevice().SetBlendFunction(GL_SRC_ALPHA, GL_ONE);
+
+    // Get "CurrentTime" uniform location in the shader program
+    m_currentTimeUniform = m_shaderProgram.GetUniformLocation("CurrentTime");
+
+    // Get "Gravity" uniform location in the shader program
+    m_gravityUniform = m_shaderProgram.GetUniformLocation("Gravity");
+}
+
+void ParticlesBenchmarkApplication::Update()
+{
+    BenchmarkApplication::Update();
+
+    // The emitter moves in a circle, and the particles come out in all directions
+    float angle = GetCurrentTime();
+    glm::vec2 emitterPosition = 0.5f * glm::vec2(std::cos(angle), std::sin(angle));
+    for (unsigned int i = 0; i < m_particlesPerFrame; ++i)
+    {
+        float size = RandomRange(2.0f, 8.0f);
+        float duration = RandomRange(s_minDuration, s_maxDuration);
+        Color color(RandomRange(0.0f, 1.0f), RandomRange(0.0f, 1.0f), RandomRange(0.0f, 1.0f));
+        float direction = RandomRange(0.0f, glm::two_pi<float>());
+        glm::vec2 velocity = RandomRange(0.1f, 0.5f) * glm::vec2(std::cos(direction), std::sin(direction));
+
+        EmitParticle(emitterPosition, size, duration, color, velocity);
+    }
+}
+
+void ParticlesBenchmarkApplication::Render()
+{
+    // Clear background
+    GetDevice().Clear(Color(0.0f, 0.0f, 0.0f));
+
+    // Set our particles shader program
+    m_shaderProgram.Use();
+
+    // Set CurrentTime uniform
+    m_shaderProgram.SetUniform(m_currentTimeUniform, GetCurrentTime());
+
+    // Set Gravity uniform
+    m_shaderProgram.SetUniform(m_gravityUniform, -0.5f);
+
+    // Upload the particles emitted this frame, if the buffer is not mapped
+    m_streamingBuffer.Flush();
+
+    // Bind the particle system VAO
+    m_vao.Bind();
+
+    // Draw points. The amount of points can't exceed the capacity
+    unsigned int drawCount = std::min(m_particleCount, m_particleCapacity);
+    glDrawArrays(GL_POINTS, 0, drawCount);
+
+    // The draw reads all the live particles, not only the new ones, like in exercise02
+    // Don't overwrite the new particles until the GPU is done with this frame, and the old ones with some frames of slack
+    m_streamingBuffer.MarkRead(0, drawCount * sizeof(Particle));
+    m_streamingBuffer.EndFrame();
+
+    BenchmarkApplication::Render();
+}
+
+void ParticlesBenchmarkApplication::InitializeGeometry()
+{
+    m_vbo.Bind();
+
+    // Allocate enough data for all the particles, split in regions that are protected separately
+    m_streamingBuffer.Initialize(m_vbo, m_particleCapacity / s_regionCount * sizeof(Particle), s_regionCount);
+
+    m_vao.Bind();
+
+    // Interleaved attributes, so the offset is local to the particle, and the stride is the size of the particle
+    GLsizei stride = sizeof(Particle);
+    GLint offset = 0;
+    GLuint location = 0;
+    for (const VertexAttribute& attribute : s_vertexAttributes)
+    {
+        m_vao.SetAttribute(location++, attribute, offset, stride);
+        offset += attribute.GetSize();
+    }
+
+    // Unbind VAO and VBO
+    VertexArrayObject::Unbind();
+    VertexBufferObject::Unbind();
+}
+
+void ParticlesBenchmarkApplication::InitializeShaders()
+{
+    Shader vertexShader = ShaderLoader::Load(Shader::VertexShader, "shaders/particles.vert");
+    Shader fragmentShader = ShaderLoader::Load(Shader::FragmentShader, "shaders/particles.frag");
+    m_shaderProgram.Build(vertexShader, fragmentShader);
+}
+
+void ParticlesBenchmarkApplication::EmitParticle(const glm::vec2& position, float size, float duration, const Color& color, const glm::vec2& velocity)
+{
+    // Get the next particle in the circular buffer. It wraps around when it reaches the end
+    size_t offset;
+    std::span<Particle> particles = m_streamingBuffer.Allocate<Particle>(1, offset);
+    assert(offset / sizeof(Particle) == m_particleCount % m_particleCapacity);
+
+    // Initialize the particle, directly in the buffer memory
+    Particle& particle = particles[0];
+    particle.position = position;
+    particle.size = size;
+    particle.birth = GetCurrentTime();
+    particle.duration = duration;
+    particle.color = color;
+    particle.velocity = velocity;
+
+    // Increment the particle count
+    m_particleCount++;
+}
+
+float ParticlesBenchmarkApplication::RandomRange(float from, float to)
+{
+    return std::uniform_real_distribution<float>(from, to)(m_random);
+}
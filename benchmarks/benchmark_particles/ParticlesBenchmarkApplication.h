@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ituGL/application/BenchmarkApplication.h>
+#include <ituGL/geometry/VertexBufferObject.h>
+#include <ituGL/core/StreamingBuffer.h>
+#include <ituGL/geometry/VertexArrayObject.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <random>
+
+// Particles of exercise02 scaled up: an emitter that moves in a circle, emitting enough particles every frame
+// to keep the whole capacity alive, instead of one particle per frame while the mouse is pressed
+class ParticlesBenchmarkApplication : public BenchmarkApplication
+{
+public:
+    ParticlesBenchmarkApplication(const Settings& settings);
+
+protected:
+    void Initialize() override;
+    void Update() override;
+    void Render() override;
+
+private:
+    // Initialize the VBO and VAO
+    void InitializeGeometry();
+
+    // Load, compile and link shaders
+    void InitializeShaders();
+
+    // Emit a new particle
+    void EmitParticle(const glm::vec2& position, float size, float duration, const Color& color, const glm::vec2& velocity);
+
+    // Random value in a range, from a generator with a fixed seed
+    float RandomRange(float from, float to);
+
+private:
+    // All particles stored in a single VBO with interleaved attributes
+    VertexBufferObject m_vbo;
+
+    // Ring buffer on top of the VBO, so new particles are written without a buffer update each
+    StreamingBuffer m_streamingBuffer;
+
+    // VAO that represents the particle system
+    VertexArrayObject m_vao;
+
+    // Particles shader program
+    ShaderProgram m_shaderProgram;
+
+    // Location of the "CurrentTime" uniform
+    ShaderProgram::Location m_currentTimeUniform;
+
+    // Location of the "Gravity" uniform
+    ShaderProgram::Location m_gravityUniform;
+
+    // Random generator, with the same seed in every run
+    std::minstd_rand m_random;
+
+    // Total number of particles created
+    unsigned int m_particleCount;
+
+    // Max number of particles that can exist at the same time
+    unsigned int m_particleCapacity;
+
+    // Particles that are emitted every frame, so the oldest one is dead before it is replaced
+    unsigned int m_particlesPerFrame;
+};
@@ -0,0 +1,16 @@
+#include "ParticlesBenchmarkApplication.h"
+
+int main(int argc, char* argv[])
+{
+    BenchmarkApplication::Settings settings;
+    settings.name = "benchmark_particles";
+    settings.sceneScale = 65536;
+    settings.assetDirectory = BENCHMARK_ASSET_DIRECTORY;
+    if (!BenchmarkApplication::ParseArguments(argc, argv, settings))
+    {
+        return -1;
+    }
+
+    ParticlesBenchmarkApplication benchmarkApplication(settings);
+    return benchmarkApplication.Run();
+}
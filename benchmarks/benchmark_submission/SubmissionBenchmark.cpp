@@ -0,0 +1,100 @@
+#include "SubmissionBenchmark.h"
+
+#include <ituGL/renderer/ForwardRenderPass.h>
+#include <ituGL/utils/Json.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+SubmissionBenchmark::SubmissionBenchmark(const BenchmarkApplication::Settings& settings)
+    : m_settings(settings)
+    , m_device(DeviceGL::Backend::Null)
+    , m_renderer(m_device)
+{
+    BenchmarkApplication::ResolvePaths(m_settings);
+
+    // Same size as the windows of the other benchmarks
+    m_device.SetViewport(0, 0, 1024, 1024);
+}
+
+int SubmissionBenchmark::Run()
+{
+    // Textures are still decoded, but the upload goes nowhere
+    m_scene.Initialize(m_renderer, m_settings.sceneScale, 1.0f, false);
+    m_renderer.AddRenderPass(std::make_unique<ForwardRenderPass>());
+
+    unsigned int frameCount = m_settings.warmupFrames + m_settings.measuredFrames;
+    m_cpuTimes.reserve(m_settings.measuredFrames);
+    for (unsigned int frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+    {
+        bool measured = frameIndex >= m_settings.warmupFrames;
+        if (measured && !GLCallRecorder::IsRecording())
+        {
+            GLCallRecorder::BeginRecording();
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        RenderFrame(frameIndex * m_settings.fixedDeltaTime);
+        auto endTime = std::chrono::steady_clock::now();
+
+        if (measured)
+        {
+            m_cpuTimes.push_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+        }
+    }
+    GLCallRecorder::EndRecording();
+    m_callStatistics = GLCallRecorder::GetStatistics();
+
+    std::ofstream file(m_settings.outputPath);
+    WriteJson(file);
+
+    unsigned int measuredFrames = std::max(m_settings.measuredFrames, 1u);
+    std::cout << m_settings.name << ": " << m_cpuTimes.size() << " frames" << std::endl;
+    BenchmarkApplication::PrintStatistics("CPU", BenchmarkApplication::ComputeStatistics(m_cpuTimes));
+    std::cout << "  GL calls per frame: " << m_callStatistics.callCount / measuredFrames;
+    std::cout << ", draw calls per frame: " << m_callStatistics.drawCallCount / measuredFrames << std::endl;
+    std::cout << "  Results written to " << m_settings.outputPath << std::endl;
+
+    return 0;
+}
+
+void SubmissionBenchmark::RenderFrame(float time)
+{
+    m_scene.Update(m_renderer, time);
+
+    m_device.Clear(true, Color(0.0f, 0.0f, 0.0f, 1.0f), true, 1.0f);
+
+    // Render the scene
+    m_renderer.Render();
+}
+
+void SubmissionBenchmark::WriteJson(std::ostream& stream) const
+{
+    stream.setf(std::ios::fixed);
+    stream.precision(4);
+
+    stream << "{\n";
+    stream << "  \"name\": ";
+    Json::WriteString(stream, m_settings.name);
+    stream << ",\n";
+    stream << "  \"backend\": \"null\",\n";
+    stream << "  \"sceneScale\": " << m_settings.sceneScale << ",\n";
+    stream << "  \"warmupFrames\": " << m_settings.warmupFrames << ",\n";
+    stream << "  \"measuredFrames\": " << m_cpuTimes.size() << ",\n";
+    BenchmarkApplication::WriteStatistics(stream, "cpu", BenchmarkApplication::ComputeStatistics(m_cpuTimes));
+
+    // Calls of all the measured frames together
+    stream << "  \"gl\": ";
+    GLCallRecorder::WriteJson(stream, m_callStatistics);
+    stream << ",\n";
+
+    // Times of each frame in milliseconds
+    stream << "  \"frames\": [";
+    for (std::size_t i = 0; i < m_cpuTimes.size(); ++i)
+    {
+        stream << (i ? ", " : "\n    ") << m_cpuTimes[i];
+    }
+    stream << "\n  ]\n}\n";
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ituGL/application/BenchmarkApplication.h>
+#include <ituGL/application/BenchmarkScene.h>
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/core/GLCallRecorder.h>
+
+#include <ituGL/renderer/Renderer.h>
+
+#include <ostream>
+#include <vector>
+
+// Scene of benchmark_models, rendered with the null GL backend: no window, no driver and no GPU
+// What is left is the CPU cost of ituGL itself: visiting the scene, sorting and submitting the drawcalls and setting the state
+// It also records the GL calls of the measured frames, so changes in the number of calls show up in the results
+class SubmissionBenchmark
+{
+public:
+    SubmissionBenchmark(const BenchmarkApplication::Settings& settings);
+
+    // Render the warmup and the measured frames, and save the results. Returns the exit code
+    int Run();
+
+private:
+    void RenderFrame(float time);
+
+    void WriteJson(std::ostream& stream) const;
+
+private:
+    BenchmarkApplication::Settings m_settings;
+
+    // Device using the null backend. Created first, the objects below need it
+    DeviceGL m_device;
+
+    // Global scene, without the occluders of benchmark_models
+    BenchmarkScene m_scene;
+
+    // Renderer
+    Renderer m_renderer;
+
+    // CPU time of each measured frame, in milliseconds, and the GL calls made in all of them
+    std::vector<double> m_cpuTimes;
+    GLCallRecorder::Statistics m_callStatistics;
+};
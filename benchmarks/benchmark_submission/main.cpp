@@ -0,0 +1,16 @@
+#include "SubmissionBenchmark.h"
+
+int main(int argc, char* argv[])
+{
+    BenchmarkApplication::Settings settings;
+    settings.name = "benchmark_submission";
+    settings.sceneScale = 256;
+    settings.assetDirectory = BENCHMARK_ASSET_DIRECTORY;
+    if (!BenchmarkApplication::ParseArguments(argc, argv, settings))
+    {
+        return -1;
+    }
+
+    SubmissionBenchmark benchmark(settings);
+    return benchmark.Run();
+}
@@ -175,7 +175,7 @@ void TerrainApplication::Initialize()
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
     // Enable depth buffer
-    glEnable(GL_DEPTH_TEST);
+    GetDevice().EnableFeature(GL_DEPTH_TEST);
 }
 
 void TerrainApplication::Update()
@@ -55,7 +55,7 @@ void ParticlesApplication::Initialize()
 
     // Enable GL_BLEND to have blending on the particles, and configure it as additive blending
     GetDevice().EnableFeature(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    GetDevice().SetBlendFunction(GL_SRC_ALPHA, GL_ONE);
 
     // We need to enable V-sync, otherwise the framerate would be too high and spawn multiple particles in one click
     GetDevice().SetVSyncEnabled(true);
@@ -105,11 +105,20 @@ void ParticlesApplication::Render()
     // Set Gravity uniform
     m_shaderProgram.SetUniform(m_gravityUniform, -9.8f);
 
+    // Upload the particles emitted this frame, if the buffer is not mapped
+    m_streamingBuffer.Flush();
+
     // Bind the particle system VAO
     m_vao.Bind();
 
     // Draw points. The amount of points can't exceed the capacity
-    glDrawArrays(GL_POINTS, 0, std::min(m_particleCount, m_particleCapacity));
+    unsigned int drawCount = std::min(m_particleCount, m_particleCapacity);
+    glDrawArrays(GL_POINTS, 0, drawCount);
+
+    // The draw reads all the live particles, not only the new ones
+    // The oldest ones are overwritten once the GPU is done with the frame from 3 frames back (one less than the regions)
+    m_streamingBuffer.MarkRead(0, drawCount * sizeof(Particle));
+    m_streamingBuffer.EndFrame();
 
     Application::Render();
 }
@@ -120,9 +129,11 @@ void ParticlesApplication::InitializeGeometry()
 {
     m_vbo.Bind();
 
-    // Allocate enough data for all the particles
-    // Notice the DynamicDraw usage, because we will update the buffer every time we emit a particle
-    m_vbo.AllocateData(m_particleCapacity * sizeof(Particle), BufferObject::Usage::DynamicDraw);
+    // Allocate enough data for all the particles, split in 4 regions that are protected separately
+    // The streaming buffer maps it if possible, so we can write the particles directly in the buffer
+    const unsigned int regionCount = 4;
+    assert(m_particleCapacity % regionCount == 0);
+    m_streamingBuffer.Initialize(m_vbo, m_particleCapacity / regionCount * sizeof(Particle), regionCount);
 
     m_vao.Bind();
 
@@ -162,8 +173,13 @@ void ParticlesApplication::InitializeShaders()
 
 void ParticlesApplication::EmitParticle(const glm::vec2& position, float size, float duration, const Color& color, const glm::vec2& velocity)
 {
-    // Initialize the particle
-    Particle particle;
+    // Get the next particle in the circular buffer. It wraps around when it reaches the end
+    size_t offset;
+    std::span<Particle> particles = m_streamingBuffer.Allocate<Particle>(1, offset);
+    assert(offset / sizeof(Particle) == m_particleCount % m_particleCapacity);
+
+    // Initialize the particle, directly in the buffer memory
+    Particle& particle = particles[0];
     particle.position = position;
     particle.size = size;
     particle.birth = GetCurrentTime();
@@ -171,19 +187,6 @@ void ParticlesApplication::EmitParticle(const glm::vec2& position, float size, f
     particle.color = color;
     particle.velocity = velocity;
 
-    // Get the index in the circular buffer
-    unsigned int particleIndex = m_particleCount % m_particleCapacity;
-
-    // Bind the VBO before updating data
-    m_vbo.Bind();
-
-    // Update the particle data in the VBO
-    int offset = particleIndex * sizeof(Particle);
-    m_vbo.UpdateData(std::span(&particle, 1), offset);
-
-    // Unbind the VBO
-    VertexBufferObject::Unbind();
-
     // Increment the particle count
     m_particleCount++;
 }
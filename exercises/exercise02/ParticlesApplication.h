@@ -2,6 +2,7 @@
 
 #include <ituGL/application/Application.h>
 #include <ituGL/geometry/VertexBufferObject.h>
+#include <ituGL/core/StreamingBuffer.h>
 #include <ituGL/geometry/VertexArrayObject.h>
 #include <ituGL/shader/ShaderProgram.h>
 
@@ -38,6 +39,9 @@ private:
     // All particles stored in a single VBO with interleaved attributes
     VertexBufferObject m_vbo;
 
+    // Ring buffer on top of the VBO, so new particles are written without a buffer update each
+    StreamingBuffer m_streamingBuffer;
+
     // VAO that represents the particle system
     VertexArrayObject m_vao;
 
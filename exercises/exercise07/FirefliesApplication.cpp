@@ -3,8 +3,10 @@
 #include <ituGL/asset/ShaderLoader.h>
 #include <ituGL/asset/ModelLoader.h>
 #include <ituGL/asset/Texture2DLoader.h>
+#include <ituGL/geometry/GeometryArena.h>
 #include <ituGL/shader/Material.h>
 #include <ituGL/renderer/ForwardRenderPass.h>
+#include <ituGL/renderer/ClusteredForwardRenderPass.h>
 #include <ituGL/renderer/GBufferRenderPass.h>
 #include <ituGL/renderer/DeferredRenderPass.h>
 #include <glm/gtx/transform.hpp>
@@ -30,6 +32,7 @@ void FirefliesApplication::Initialize()
     m_imGui.Initialize(GetMainWindow());
 
     InitializeForwardMaterials();
+    InitializeClusteredForwardMaterials();
     InitializeDeferredMaterials();
     InitializeModels();
     InitializeCamera();
@@ -122,11 +125,13 @@ void FirefliesApplication::InitializeForwardMaterials()
     // Load and build shader
     std::vector<const char*> vertexShaderPaths;
     vertexShaderPaths.push_back("shaders/version330.glsl");
+    vertexShaderPaths.push_back("shaders/camera.glsl");
     vertexShaderPaths.push_back("shaders/lit.vert");
     Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
     std::vector<const char*> fragmentShaderPaths;
     fragmentShaderPaths.push_back("shaders/version330.glsl");
+    fragmentShaderPaths.push_back("shaders/camera.glsl");
     fragmentShaderPaths.push_back("shaders/utils.glsl");
     fragmentShaderPaths.push_back("shaders/blinn-phong.glsl");
     fragmentShaderPaths.push_back("shaders/lighting.glsl");
@@ -136,29 +141,15 @@ void FirefliesApplication::InitializeForwardMaterials()
     std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
     shaderProgramPtr->Build(vertexShader, fragmentShader);
 
-    // Get transform related uniform locations
-    ShaderProgram::Location cameraPositionLocation = shaderProgramPtr->GetUniformLocation("CameraPosition");
-    ShaderProgram::Location worldMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldMatrix");
-    ShaderProgram::Location viewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("ViewProjMatrix");
-
     // Register shader with renderer
+    // Camera comes from the CameraBlock and world matrix comes from the InstanceWorldMatrix attribute
     m_renderer.RegisterShaderProgram(shaderProgramPtr,
-        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
-        {
-            if (cameraChanged)
-            {
-                shaderProgram.SetUniform(cameraPositionLocation, camera.ExtractTranslation());
-                shaderProgram.SetUniform(viewProjMatrixLocation, camera.GetViewProjectionMatrix());
-            }
-            shaderProgram.SetUniform(worldMatrixLocation, worldMatrix);
-        },
+        nullptr,
         GetUpdateLightsFunction(shaderProgramPtr)
         );
 
     // Filter out uniforms that are not material properties
     ShaderUniformCollection::NameSet filteredUniforms;
-    filteredUniforms.insert("WorldMatrix");
-    filteredUniforms.insert("ViewProjMatrix");
     filteredUniforms.insert("AmbientColor");
     filteredUniforms.insert("LightColor");
     filteredUniforms.insert("LightPosition");
@@ -169,6 +160,48 @@ void FirefliesApplication::InitializeForwardMaterials()
     m_forwardMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
 }
 
+void FirefliesApplication::InitializeClusteredForwardMaterials()
+{
+    // Same shader as forward, but the lighting loops over the lights of the cluster
+    std::vector<const char*> vertexShaderPaths;
+    vertexShaderPaths.push_back("shaders/version330.glsl");
+    vertexShaderPaths.push_back("shaders/camera.glsl");
+    vertexShaderPaths.push_back("shaders/lit.vert");
+    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
+
+    std::vector<const char*> fragmentShaderPaths;
+    fragmentShaderPaths.push_back("shaders/version330.glsl");
+    fragmentShaderPaths.push_back("shaders/camera.glsl");
+    fragmentShaderPaths.push_back("shaders/utils.glsl");
+    fragmentShaderPaths.push_back("shaders/blinn-phong.glsl");
+    fragmentShaderPaths.push_back("shaders/clustered-lighting.glsl");
+    fragmentShaderPaths.push_back("shaders/lit.frag");
+    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
+
+    std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
+    shaderProgramPtr->Build(vertexShader, fragmentShader);
+
+    // Register shader with renderer
+    // The update lights function only sets the ambient color, the lights come from the light grid
+    m_renderer.RegisterShaderProgram(shaderProgramPtr,
+        nullptr,
+        GetUpdateLightsFunction(shaderProgramPtr)
+        );
+
+    // Filter out uniforms that are not material properties
+    ShaderUniformCollection::NameSet filteredUniforms;
+    filteredUniforms.insert("AmbientColor");
+    filteredUniforms.insert("ClusterLightData");
+    filteredUniforms.insert("ClusterRanges");
+    filteredUniforms.insert("ClusterLightIndices");
+    filteredUniforms.insert("ClusterGridSize");
+    filteredUniforms.insert("ClusterDepthParams");
+    filteredUniforms.insert("GlobalLightCount");
+
+    // Create reference material
+    m_clusteredForwardMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+}
+
 void FirefliesApplication::InitializeDeferredMaterials()
 {
     // G-buffer material
@@ -176,6 +209,7 @@ void FirefliesApplication::InitializeDeferredMaterials()
         // Load and build shader
         std::vector<const char*> vertexShaderPaths;
         vertexShaderPaths.push_back("shaders/version330.glsl");
+        vertexShaderPaths.push_back("shaders/camera.glsl");
         vertexShaderPaths.push_back("shaders/gbuffer.vert");
         Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
@@ -187,24 +221,12 @@ void FirefliesApplication::InitializeDeferredMaterials()
         std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
         shaderProgramPtr->Build(vertexShader, fragmentShader);
 
-        // Get transform related uniform locations
-        ShaderProgram::Location worldViewMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewMatrix");
-        ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
-
         // Register shader with renderer
-        m_renderer.RegisterShaderProgram(shaderProgramPtr,
-            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
-            {
-                shaderProgram.SetUniform(worldViewMatrixLocation, camera.GetViewMatrix() * worldMatrix);
-                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
-            },
-            nullptr
-        );
+        // Camera comes from the CameraBlock and world matrix comes from the InstanceWorldMatrix attribute
+        m_renderer.RegisterShaderProgram(shaderProgramPtr, nullptr, nullptr);
 
         // Filter out uniforms that are not material properties
         ShaderUniformCollection::NameSet filteredUniforms;
-        filteredUniforms.insert("WorldViewMatrix");
-        filteredUniforms.insert("WorldViewProjMatrix");
 
         // Create material
         m_gbufferMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
@@ -219,6 +241,7 @@ void FirefliesApplication::InitializeDeferredMaterials()
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
+        fragmentShaderPaths.push_back("shaders/camera.glsl");
         fragmentShaderPaths.push_back("shaders/utils.glsl");
         fragmentShaderPaths.push_back("shaders/blinn-phong.glsl");
         fragmentShaderPaths.push_back("shaders/lighting.glsl");
@@ -230,23 +253,15 @@ void FirefliesApplication::InitializeDeferredMaterials()
 
         // Filter out uniforms that are not material properties
         ShaderUniformCollection::NameSet filteredUniforms;
-        filteredUniforms.insert("InvProjMatrix");
         filteredUniforms.insert("WorldViewProjMatrix");
 
-        // Get transform related uniform locations
-        ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
-        ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
+        // Get transform related uniform locations. Inverse camera matrices come from the CameraBlock
         ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
 
         // Register shader with renderer
         m_renderer.RegisterShaderProgram(shaderProgramPtr,
             [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
             {
-                if (cameraChanged)
-                {
-                    shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
-                    shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
-                }
                 shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
             },
             GetUpdateLightsFunction(shaderProgramPtr)
@@ -259,7 +274,19 @@ void FirefliesApplication::InitializeDeferredMaterials()
 
 void FirefliesApplication::InitializeModels()
 {
-    std::shared_ptr<Material> material = m_renderMode == RenderMode::Forward ? m_forwardMaterial : m_gbufferMaterial;
+    std::shared_ptr<Material> material;
+    switch (m_renderMode)
+    {
+    case RenderMode::Forward:
+        material = m_forwardMaterial;
+        break;
+    case RenderMode::ClusteredForward:
+        material = m_clusteredForwardMaterial;
+        break;
+    case RenderMode::Deferred:
+        material = m_gbufferMaterial;
+        break;
+    }
 
     material->SetUniformValue("Color", glm::vec3(1.0f));
     material->SetUniformValue("AmbientReflectance", 1.0f);
@@ -277,6 +304,9 @@ void FirefliesApplication::InitializeModels()
     loader.SetMaterialProperty(ModelLoader::MaterialProperty::DiffuseTexture, "ColorTexture");
     loader.SetMaterialProperty(ModelLoader::MaterialProperty::SpecularExponent, "SpecularExponent");
 
+    // Store the geometry of both models in the same buffers, so their drawcalls share a VAO
+    loader.SetGeometryArena(std::make_shared<GeometryArena>(16384, 65536));
+
     // Load models
     m_fireflyModel = loader.Load("models/firefly/firefly.obj");
     m_floorModel = loader.Load("models/floor/floor.obj");
@@ -307,6 +337,9 @@ void FirefliesApplication::InitializeRenderer()
     case RenderMode::Forward:
         m_renderer.AddRenderPass(std::make_unique<ForwardRenderPass>());
         break;
+    case RenderMode::ClusteredForward:
+        m_renderer.AddRenderPass(std::make_unique<ClusteredForwardRenderPass>());
+        break;
     case RenderMode::Deferred:
         {
             // Set up deferred passes
@@ -25,6 +25,7 @@ protected:
 
 private:
     void InitializeForwardMaterials();
+    void InitializeClusteredForwardMaterials();
     void InitializeDeferredMaterials();
     void InitializeModels();
     void InitializeCamera();
@@ -47,6 +48,7 @@ private:
     enum class RenderMode
     {
         Forward,
+        ClusteredForward,
         Deferred
     };
     RenderMode m_renderMode;
@@ -59,6 +61,7 @@ private:
 
     // Default materials
     std::shared_ptr<Material> m_forwardMaterial;
+    std::shared_ptr<Material> m_clusteredForwardMaterial;
     std::shared_ptr<Material> m_gbufferMaterial;
     std::shared_ptr<Material> m_deferredMaterial;
 
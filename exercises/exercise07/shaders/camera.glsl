@@ -0,0 +1,12 @@
+
+// Camera uniforms, shared by all the shaders and uploaded once per frame by the renderer
+layout (std140) uniform CameraBlock
+{
+	mat4 ViewMatrix;
+	mat4 ProjMatrix;
+	mat4 ViewProjMatrix;
+	mat4 InvViewMatrix;
+	mat4 InvProjMatrix;
+	mat4 InvViewProjMatrix;
+	vec3 CameraPosition;
+};
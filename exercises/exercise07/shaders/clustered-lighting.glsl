@@ -0,0 +1,113 @@
+
+// Light grid built on the CPU and uploaded once per frame by the ClusteredForwardRenderPass
+uniform samplerBuffer ClusterLightData;
+uniform usamplerBuffer ClusterRanges;
+uniform usamplerBuffer ClusterLightIndices;
+uniform uvec3 ClusterGridSize;
+uniform vec2 ClusterDepthParams;
+uniform uint GlobalLightCount;
+
+struct LightData
+{
+	vec3 position;
+	vec3 color;
+	vec3 direction;
+	vec4 attenuation;
+};
+
+// Each light takes 4 texels: position, color, direction and attenuation
+LightData FetchLight(uint lightIndex)
+{
+	int texel = int(lightIndex) * 4;
+
+	LightData light;
+	light.position = texelFetch(ClusterLightData, texel).xyz;
+	light.color = texelFetch(ClusterLightData, texel + 1).rgb;
+	light.direction = texelFetch(ClusterLightData, texel + 2).xyz;
+	light.attenuation = texelFetch(ClusterLightData, texel + 3);
+	return light;
+}
+
+// Find the cluster of a world position: tile from the screen position, and slice from the log of the view depth
+int GetClusterIndex(vec3 position)
+{
+	vec4 viewPosition = ViewMatrix * vec4(position, 1);
+	vec4 clipPosition = ProjMatrix * viewPosition;
+
+	vec2 gridSizeXY = vec2(ClusterGridSize.xy);
+	vec2 tile = clamp((clipPosition.xy / clipPosition.w * 0.5f + 0.5f) * gridSizeXY, vec2(0), gridSizeXY - 1);
+	float slice = clamp(log(-viewPosition.z) * ClusterDepthParams.x + ClusterDepthParams.y, 0, float(ClusterGridSize.z) - 1);
+
+	return int(tile.x) + (int(tile.y) + int(slice) * int(ClusterGridSize.y)) * int(ClusterGridSize.x);
+}
+
+float ComputeDistanceAttenuation(LightData light, vec3 position)
+{
+	// Compute distance attenuation, reading the range from attenuation.x (fade start) and attenuation.y (fade end)
+	return smoothstep(light.attenuation.y, light.attenuation.x, distance(position, light.position));
+}
+
+float ComputeAngularAttenuation(LightData light, vec3 lightDir)
+{
+	float angle = acos(dot(light.direction, lightDir));
+	vec2 attAngle = light.attenuation.zw;
+	return smoothstep(attAngle.y, attAngle.x, angle);
+}
+
+float ComputeAttenuation(LightData light, vec3 position, vec3 lightDir)
+{
+	float attenuation = 1.0f;
+	if (light.attenuation.y > 0)
+	{
+		attenuation *= ComputeDistanceAttenuation(light, position);
+	}
+	if (light.attenuation.w > 0)
+	{
+		attenuation *= ComputeAngularAttenuation(light, lightDir);
+	}
+	return attenuation;
+}
+
+vec3 ComputeLightDirection(LightData light, vec3 position)
+{
+	return light.attenuation.y >= 0 ? GetDirection(position, light.position) : light.direction;
+}
+
+vec3 ComputeLight(LightData lightData, SurfaceData data, vec3 viewDir, vec3 position)
+{
+	vec3 lightDir = ComputeLightDirection(lightData, position);
+
+	vec3 light = vec3(0);
+	light += ComputeDiffuseLighting(data, lightDir);
+	light += ComputeSpecularLighting(data, lightDir, viewDir);
+
+	float attenuation = ComputeAttenuation(lightData, position, lightDir);
+	return light * lightData.color * attenuation;
+}
+
+vec3 ComputeLighting(vec3 position, SurfaceData data, vec3 viewDir, bool indirect)
+{
+	vec3 light = vec3(0);
+
+	if (indirect)
+	{
+		light += ComputeDiffuseIndirectLighting(data);
+		light += ComputeSpecularIndirectLighting(data, viewDir);
+	}
+
+	// Global lights affect all the clusters
+	for (uint i = 0u; i < GlobalLightCount; ++i)
+	{
+		light += ComputeLight(FetchLight(i), data, viewDir, position);
+	}
+
+	// Lights of the cluster
+	uvec2 range = texelFetch(ClusterRanges, GetClusterIndex(position)).xy;
+	for (uint i = 0u; i < range.y; ++i)
+	{
+		uint lightIndex = texelFetch(ClusterLightIndices, int(range.x + i)).x;
+		light += ComputeLight(FetchLight(lightIndex), data, viewDir, position);
+	}
+
+	return light;
+}
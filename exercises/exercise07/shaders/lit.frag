@@ -15,7 +15,6 @@ uniform float DiffuseReflectance;
 uniform float SpecularReflectance;
 uniform float SpecularExponent;
 
-uniform vec3 CameraPosition;
 
 void main()
 {
@@ -18,6 +18,7 @@
 
 #include <ituGL/renderer/SkyboxRenderPass.h>
 #include <ituGL/renderer/ForwardRenderPass.h>
+#include <ituGL/renderer/DepthPrePassRenderPass.h>
 #include <ituGL/scene/RendererSceneVisitor.h>
 
 #include <ituGL/scene/ImGuiSceneVisitor.h>
@@ -41,6 +42,8 @@ void SceneViewerApplication::Initialize()
     InitializeMaterial();
     InitializeModels();
     InitializeRenderer();
+
+    GetDevice().SetVSyncEnabled(true);
 }
 
 void SceneViewerApplication::Update()
@@ -120,7 +123,8 @@ void SceneViewerApplication::InitializeMaterial()
     fragmentShaderPaths.push_back("shaders/version330.glsl");
     fragmentShaderPaths.push_back("shaders/utils.glsl");
     fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
-    fragmentShaderPaths.push_back("shaders/lighting.glsl");
+    // Batched lighting, so the default update function sets several lights in each pass
+    fragmentShaderPaths.push_back("shaders/lighting-batched.glsl");
     fragmentShaderPaths.push_back("shaders/default_pbr.frag");
     Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
@@ -152,10 +156,12 @@ void SceneViewerApplication::InitializeMaterial()
     filteredUniforms.insert("WorldMatrix");
     filteredUniforms.insert("ViewProjMatrix");
     filteredUniforms.insert("LightIndirect");
-    filteredUniforms.insert("LightColor");
-    filteredUniforms.insert("LightPosition");
-    filteredUniforms.insert("LightDirection");
-    filteredUniforms.insert("LightAttenuation");
+    filteredUniforms.insert("LightCount");
+    // Arrays are listed with the name of their first element
+    filteredUniforms.insert("LightColors[0]");
+    filteredUniforms.insert("LightPositions[0]");
+    filteredUniforms.insert("LightDirections[0]");
+    filteredUniforms.insert("LightAttenuations[0]");
 
     // Create reference material
     assert(shaderProgramPtr);
@@ -186,6 +192,9 @@ void SceneViewerApplication::InitializeModels()
     // Flip vertically textures loaded by the model loader
     loader.GetTexture2DLoader().SetFlipVertical(true);
 
+    // Add a position-only stream to each submesh, for the depth pre-pass
+    loader.SetCreatePositionStreams(true);
+
     // Link vertex properties to attributes
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Position, "VertexPosition");
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Normal, "VertexNormal");
@@ -215,7 +224,13 @@ void SceneViewerApplication::InitializeModels()
 
 void SceneViewerApplication::InitializeRenderer()
 {
-    m_renderer.AddRenderPass(std::make_unique<ForwardRenderPass>());
+    // Lay down the depth first, so the lights only shade the visible surfaces
+    m_renderer.AddRenderPass(std::make_unique<DepthPrePassRenderPass>());
+
+    std::unique_ptr<ForwardRenderPass> forwardRenderPass(std::make_unique<ForwardRenderPass>());
+    forwardRenderPass->SetDepthPrePass(true);
+    m_renderer.AddRenderPass(std::move(forwardRenderPass));
+
     m_renderer.AddRenderPass(std::make_unique<SkyboxRenderPass>(m_skyboxTexture));
 }
 
@@ -16,6 +16,9 @@ out vec2 TexCoord;
 uniform mat4 WorldMatrix;
 uniform mat4 ViewProjMatrix;
 
+// Must match the depth pre-pass exactly, see shaders/renderer/depth.vert
+invariant gl_Position;
+
 void main()
 {
 	// vertex position in world space (for lighting computation)
@@ -0,0 +1,79 @@
+
+// Same as lighting.glsl, but adding up to LIGHT_BATCH_SIZE lights in each pass
+#ifndef LIGHT_BATCH_SIZE
+#define LIGHT_BATCH_SIZE 16
+#endif
+
+uniform bool LightIndirect;
+uniform int LightCount;
+uniform vec3 LightColors[LIGHT_BATCH_SIZE];
+uniform vec3 LightPositions[LIGHT_BATCH_SIZE];
+uniform vec3 LightDirections[LIGHT_BATCH_SIZE];
+uniform vec4 LightAttenuations[LIGHT_BATCH_SIZE];
+
+float ComputeDistanceAttenuation(int i, vec3 position)
+{
+	// Compute distance attenuation, reading the range from LightAttenuations[i].x (fade start) and LightAttenuations[i].y (fade end)
+	return smoothstep(LightAttenuations[i].y, LightAttenuations[i].x, distance(position, LightPositions[i]));
+}
+
+float ComputeAngularAttenuation(int i, vec3 lightDir)
+{
+	float angle = acos(dot(LightDirections[i], lightDir));
+	vec2 attAngle = LightAttenuations[i].zw;
+	return smoothstep(attAngle.y, attAngle.x, angle);
+}
+
+float ComputeAttenuation(int i, vec3 position, vec3 lightDir)
+{
+	float attenuation = 1.0f;
+	if (LightAttenuations[i].y > 0)
+	{
+		attenuation *= ComputeDistanceAttenuation(i, position);
+	}
+	if (LightAttenuations[i].w > 0)
+	{
+		attenuation *= ComputeAngularAttenuation(i, lightDir);
+	}
+	return attenuation;
+}
+
+vec3 ComputeLightDirection(int i, vec3 position)
+{
+	return LightAttenuations[i].y >= 0 ? GetDirection(position, LightPositions[i]) : -LightDirections[i];
+}
+
+vec3 ComputeLight(int i, SurfaceData data, vec3 viewDir, vec3 position)
+{
+	vec3 lightDir = ComputeLightDirection(i, position);
+
+	vec3 diffuse = ComputeDiffuseLighting(data, lightDir);
+	vec3 specular = ComputeSpecularLighting(data, lightDir, viewDir);
+	vec3 light = CombineLighting(diffuse, specular, data, lightDir, viewDir);
+
+	float attenuation = ComputeAttenuation(i, position, lightDir);
+	return light * LightColors[i] * attenuation;
+}
+
+vec3 ComputeLighting(vec3 position, SurfaceData data, vec3 viewDir, bool indirect)
+{
+	vec3 light = vec3(0);
+	for (int i = 0; i < LightCount; ++i)
+	{
+		light += ComputeLight(i, data, viewDir, position);
+	}
+
+	if (indirect && LightIndirect)
+	{
+		vec3 diffuseIndirect = ComputeDiffuseIndirectLighting(data);
+		vec3 specularIndirect = ComputeSpecularIndirectLighting(data, viewDir);
+		light += CombineIndirectLighting(diffuseIndirect, specularIndirect, data, viewDir);
+	}
+
+	return light;
+}
+
+vec3 ComputeLighting(vec3 position, SurfaceData data, vec3 viewDir)
+{
+	return ComputeLighting(position, data, viewDir, true);
+}
@@ -0,0 +1,18 @@
+#version 330 core
+
+//Inputs
+layout (location = 0) in vec3 VertexPosition;
+
+//Uniforms
+uniform mat4 WorldMatrix;
+uniform mat4 ViewProjMatrix;
+
+// The shading passes test with GL_EQUAL against this depth, so the position must be the same in both programs
+invariant gl_Position;
+
+void main()
+{
+	// Same operations as default.vert, so the shading passes get exactly the same depth for GL_EQUAL
+	vec3 WorldPosition = (WorldMatrix * vec4(VertexPosition, 1.0)).xyz;
+	gl_Position = ViewProjMatrix * vec4(WorldPosition, 1.0);
+}
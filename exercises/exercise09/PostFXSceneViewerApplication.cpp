@@ -12,6 +12,7 @@
 #include <ituGL/scene/SceneLight.h>
 
 #include <ituGL/shader/ShaderUniformCollection.h>
+#include <ituGL/shader/ShaderStorageBufferObject.h>
 #include <ituGL/shader/Material.h>
 #include <ituGL/geometry/Model.h>
 #include <ituGL/scene/SceneModel.h>
@@ -19,16 +20,21 @@
 #include <ituGL/renderer/SkyboxRenderPass.h>
 #include <ituGL/renderer/GBufferRenderPass.h>
 #include <ituGL/renderer/DeferredRenderPass.h>
+#include <ituGL/renderer/TiledDeferredRenderPass.h>
 #include <ituGL/renderer/PostFXRenderPass.h>
+#include <ituGL/renderer/RenderGraph.h>
 #include <ituGL/scene/RendererSceneVisitor.h>
 
 #include <ituGL/scene/ImGuiSceneVisitor.h>
+#include <ituGL/utils/CpuProfiler.h>
 #include <imgui.h>
+#include <fstream>
 
 PostFXSceneViewerApplication::PostFXSceneViewerApplication()
     : Application(1024, 1024, "Post FX Scene Viewer demo")
     , m_renderer(GetDevice())
-    , m_sceneFramebuffer(std::make_shared<FramebufferObject>())
+    , m_gbufferLayout(GBufferRenderPass::Layout::GetPacked())
+    , m_tiledLighting(false)
     , m_exposure(1.0f)
     , m_contrast(1.0f)
     , m_hueShift(0.0f)
@@ -47,11 +53,16 @@ void PostFXSceneViewerApplication::Initialize()
     // Initialize DearImGUI
     m_imGui.Initialize(GetMainWindow());
 
+    // Compute shaders need OpenGL 4.3. Otherwise, the lights are drawn one by one
+    m_tiledLighting = TiledDeferredRenderPass::IsSupported();
+
     InitializeCamera();
     InitializeLights();
     InitializeMaterials();
     InitializeModels();
     InitializeRenderer();
+
+    GetDevice().SetVSyncEnabled(true);
 }
 
 void PostFXSceneViewerApplication::Update()
@@ -123,14 +134,29 @@ void PostFXSceneViewerApplication::InitializeMaterials()
 {
     // G-buffer material
     {
+        // With OpenGL 4.3, the vertex shader reads the world matrices from the storage buffer of the renderer
+        bool worldMatrixBlock = ShaderStorageBufferObject::IsSupported();
+
         // Load and build shader
         std::vector<const char*> vertexShaderPaths;
-        vertexShaderPaths.push_back("shaders/version330.glsl");
+        if (worldMatrixBlock)
+        {
+            vertexShaderPaths.push_back("shaders/version430.glsl");
+            vertexShaderPaths.push_back("shaders/world-matrix-block.glsl");
+        }
+        else
+        {
+            vertexShaderPaths.push_back("shaders/version330.glsl");
+        }
         vertexShaderPaths.push_back("shaders/default.vert");
         Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
+        if (m_gbufferLayout.encoding == GBufferRenderPass::Layout::Encoding::Packed)
+        {
+            fragmentShaderPaths.push_back("shaders/gbuffer-packed.glsl");
+        }
         fragmentShaderPaths.push_back("shaders/utils.glsl");
         fragmentShaderPaths.push_back("shaders/default.frag");
         Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
@@ -138,31 +164,29 @@ void PostFXSceneViewerApplication::InitializeMaterials()
         std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
         shaderProgramPtr->Build(vertexShader, fragmentShader);
 
-        // Get transform related uniform locations
-        ShaderProgram::Location worldViewMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewMatrix");
-        ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
-
-        // Register shader with renderer
-        m_renderer.RegisterShaderProgram(shaderProgramPtr,
-            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
-            {
-                shaderProgram.SetUniform(worldViewMatrixLocation, camera.GetViewMatrix() * worldMatrix);
-                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
-            },
-            nullptr
-        );
+        // Register shader with renderer, with the standard WorldViewMatrix and WorldViewProjMatrix uniforms
+        // The g-buffer pass records its drawcalls in parallel, and the renderer records the values of these uniforms too
+        // Reading the WorldMatrixBlock, the shader doesn't declare them, and the renderer only sets WorldMatrixIndex
+        m_renderer.RegisterShaderProgram(shaderProgramPtr, nullptr);
 
         // Filter out uniforms that are not material properties
         ShaderUniformCollection::NameSet filteredUniforms;
         filteredUniforms.insert("WorldViewMatrix");
         filteredUniforms.insert("WorldViewProjMatrix");
+        filteredUniforms.insert("WorldMatrixIndex");
 
         // Create material
         m_defaultMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
         m_defaultMaterial->SetUniformValue("Color", glm::vec3(1.0f));
     }
 
+    // Tiled deferred material. A single compute shader lights all the pixels, with the lights that affect their tile
+    if (m_tiledLighting)
+    {
+        m_deferredMaterial = TiledDeferredRenderPass::CreateMaterial(m_renderer, m_gbufferLayout);
+    }
     // Deferred material
+    else
     {
         std::vector<const char*> vertexShaderPaths;
         vertexShaderPaths.push_back("shaders/version330.glsl");
@@ -171,6 +195,10 @@ void PostFXSceneViewerApplication::InitializeMaterials()
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
+        if (m_gbufferLayout.encoding == GBufferRenderPass::Layout::Encoding::Packed)
+        {
+            fragmentShaderPaths.push_back("shaders/gbuffer-packed.glsl");
+        }
         fragmentShaderPaths.push_back("shaders/utils.glsl");
         fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
         fragmentShaderPaths.push_back("shaders/lighting.glsl");
@@ -255,56 +283,18 @@ void PostFXSceneViewerApplication::InitializeModels()
     m_scene.AddSceneNode(std::make_shared<SceneModel>("cannon", cannonModel));
 }
 
-void PostFXSceneViewerApplication::InitializeFramebuffers()
-{
-    int width, height;
-    GetMainWindow().GetDimensions(width, height);
-
-    // Scene Texture
-    m_sceneTexture = std::make_shared<Texture2DObject>();
-    m_sceneTexture->Bind();
-    m_sceneTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormat::InternalFormatRGBA16F);
-    m_sceneTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
-    m_sceneTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
-    Texture2DObject::Unbind();
-
-    // Scene framebuffer
-    m_sceneFramebuffer->Bind();
-    m_sceneFramebuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Depth, *m_depthTexture);
-    m_sceneFramebuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Color0, *m_sceneTexture);
-    m_sceneFramebuffer->SetDrawBuffers(std::array<FramebufferObject::Attachment, 1>({ FramebufferObject::Attachment::Color0 }));
-    FramebufferObject::Unbind();
-
-    // Add temp textures and frame buffers
-    for (int i = 0; i < m_tempFramebuffers.size(); ++i)
-    {
-        m_tempTextures[i] = std::make_shared<Texture2DObject>();
-        m_tempTextures[i]->Bind();
-        m_tempTextures[i]->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormat::InternalFormatRGBA16F);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::WrapS, GL_CLAMP_TO_EDGE);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::WrapT, GL_CLAMP_TO_EDGE);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
-
-        m_tempFramebuffers[i] = std::make_shared<FramebufferObject>();
-        m_tempFramebuffers[i]->Bind();
-        m_tempFramebuffers[i]->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Color0, *m_tempTextures[i]);
-        m_tempFramebuffers[i]->SetDrawBuffers(std::array<FramebufferObject::Attachment, 1>({ FramebufferObject::Attachment::Color0 }));
-    }
-    Texture2DObject::Unbind();
-    FramebufferObject::Unbind();
-}
-
 void PostFXSceneViewerApplication::InitializeRenderer()
 {
     int width, height;
     GetMainWindow().GetDimensions(width, height);
 
-    // Set up deferred passes
+    // Set up the g-buffer pass. It creates its own textures and framebuffer
     {
-        std::unique_ptr<GBufferRenderPass> gbufferRenderPass(std::make_unique<GBufferRenderPass>(width, height));
+        // The g-buffer can only store opaque drawcalls
+        unsigned int opaqueCollectionIndex = m_renderer.AddDrawcallCollection(Renderer::IsOpaqueDrawcall);
+        std::unique_ptr<GBufferRenderPass> gbufferRenderPass(std::make_unique<GBufferRenderPass>(width, height, opaqueCollectionIndex, m_gbufferLayout));
 
-        // Set the g-buffer textures as properties of the deferred material
+        // Set the g-buffer textures as properties of the deferred material. The packed layout has no others texture
         m_deferredMaterial->SetUniformValue("DepthTexture", gbufferRenderPass->GetDepthTexture());
         m_deferredMaterial->SetUniformValue("AlbedoTexture", gbufferRenderPass->GetAlbedoTexture());
         m_deferredMaterial->SetUniformValue("NormalTexture", gbufferRenderPass->GetNormalTexture());
@@ -313,54 +303,109 @@ void PostFXSceneViewerApplication::InitializeRenderer()
         // Get the depth texture from the gbuffer pass - This could be reworked
         m_depthTexture = gbufferRenderPass->GetDepthTexture();
 
-        // Add the render passes
         m_renderer.AddRenderPass(std::move(gbufferRenderPass));
-        m_renderer.AddRenderPass(std::make_unique<DeferredRenderPass>(m_deferredMaterial, m_sceneFramebuffer));
     }
 
-    // Initialize the framebuffers and the textures they use
-    InitializeFramebuffers();
+    // The rest of the passes are declared in a render graph, that creates the textures and framebuffers they need
+    RenderGraph renderGraph;
+    RenderGraph::TextureDesc hdrTextureDesc = { width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatRGBA16F };
+
+    RenderGraph::ResourceId depth = renderGraph.ImportTexture(m_depthTexture);
+    RenderGraph::ResourceId backbuffer = renderGraph.ImportBackbuffer();
+    RenderGraph::ResourceId scene;
+
+    // Tiled deferred pass. The shader writes the scene as an image, so the texture is created here instead of in the graph
+    if (m_tiledLighting)
+    {
+        std::shared_ptr<Texture2DObject> sceneTexture = std::make_shared<Texture2DObject>();
+        sceneTexture->Bind();
+        sceneTexture->SetImage(0, width, height, hdrTextureDesc.format, hdrTextureDesc.internalFormat);
+        sceneTexture->SetParameter(TextureObject::ParameterEnum::WrapS, GL_CLAMP_TO_EDGE);
+        sceneTexture->SetParameter(TextureObject::ParameterEnum::WrapT, GL_CLAMP_TO_EDGE);
+        sceneTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
+        sceneTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
+        Texture2DObject::Unbind();
+
+        scene = renderGraph.ImportTexture(sceneTexture);
+
+        RenderGraph::PassBuilder builder = renderGraph.AddPass(std::make_unique<TiledDeferredRenderPass>(m_deferredMaterial, sceneTexture));
+        scene = builder.Write(scene);
+    }
+    // Deferred pass. The scene shares the g-buffer depth, so the light volumes can be depth tested
+    else
+    {
+        scene = renderGraph.CreateTexture(hdrTextureDesc);
 
-    // Skybox pass
-    m_renderer.AddRenderPass(std::make_unique<SkyboxRenderPass>(m_skyboxTexture));
+        std::unique_ptr<DeferredRenderPass> deferredRenderPass(std::make_unique<DeferredRenderPass>(m_deferredMaterial));
+        deferredRenderPass->SetDepthBoundsEnabled(true);
 
-    // Create a copy pass from m_sceneTexture to the first temporary texture
-    std::shared_ptr<Material> copyMaterial = CreatePostFXMaterial("shaders/postfx/copy.frag", m_sceneTexture);
-    m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(copyMaterial, m_tempFramebuffers[0]));
+        RenderGraph::PassBuilder builder = renderGraph.AddPass(std::move(deferredRenderPass));
+        builder.SetDepth(depth);
+        scene = builder.Write(scene);
+    }
 
-    // Replace the copy pass with a new bloom pass
-    m_bloomMaterial = CreatePostFXMaterial("shaders/postfx/bloom.frag", m_sceneTexture);
-    m_bloomMaterial->SetUniformValue("Range", glm::vec2(2.0f, 3.0f));
-    m_bloomMaterial->SetUniformValue("Intensity", 1.0f);
-    m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(m_bloomMaterial, m_tempFramebuffers[0]));
+    // Skybox pass, on top of the lit scene
+    {
+        RenderGraph::PassBuilder builder = renderGraph.AddPass(std::make_unique<SkyboxRenderPass>(m_skyboxTexture));
+        builder.Read(scene);
+        builder.SetDepth(depth);
+        scene = builder.Write(scene);
+    }
 
-    // Add blur passes
-    std::shared_ptr<Material> blurHorizontalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag", m_tempTextures[0]);
+    // Bloom pass
+    RenderGraph::ResourceId bloom = renderGraph.CreateTexture(hdrTextureDesc);
+    {
+        m_bloomMaterial = CreatePostFXMaterial("shaders/postfx/bloom.frag");
+        m_bloomMaterial->SetUniformValue("Range", glm::vec2(2.0f, 3.0f));
+        m_bloomMaterial->SetUniformValue("Intensity", 1.0f);
+
+        RenderGraph::PassBuilder builder = renderGraph.AddPass(std::make_unique<PostFXRenderPass>(m_bloomMaterial));
+        builder.SetName("Bloom");
+        builder.Read(scene, m_bloomMaterial, "SourceTexture");
+        bloom = builder.Write(bloom);
+    }
+
+    // Add blur passes. Each one writes a new texture, and the graph reuses the ones that are not read anymore
+    std::shared_ptr<Material> blurHorizontalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag");
     blurHorizontalMaterial->SetUniformValue("Scale", glm::vec2(1.0f / width, 0.0f));
-    std::shared_ptr<Material> blurVerticalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag", m_tempTextures[1]);
+    std::shared_ptr<Material> blurVerticalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag");
     blurVerticalMaterial->SetUniformValue("Scale", glm::vec2(0.0f, 1.0f / height));
     for (int i = 0; i < m_blurIterations; ++i)
     {
-        m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(blurHorizontalMaterial, m_tempFramebuffers[1]));
-        m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(blurVerticalMaterial, m_tempFramebuffers[0]));
+        RenderGraph::PassBuilder horizontalBuilder = renderGraph.AddPass(std::make_unique<PostFXRenderPass>(blurHorizontalMaterial));
+        horizontalBuilder.SetName("Blur horizontal");
+        horizontalBuilder.Read(bloom, blurHorizontalMaterial, "SourceTexture");
+        RenderGraph::ResourceId blurred = horizontalBuilder.Write(renderGraph.CreateTexture(hdrTextureDesc));
+
+        RenderGraph::PassBuilder verticalBuilder = renderGraph.AddPass(std::make_unique<PostFXRenderPass>(blurVerticalMaterial));
+        verticalBuilder.SetName("Blur vertical");
+        verticalBuilder.Read(blurred, blurVerticalMaterial, "SourceTexture");
+        bloom = verticalBuilder.Write(renderGraph.CreateTexture(hdrTextureDesc));
     }
 
     // Final pass
-    m_composeMaterial = CreatePostFXMaterial("shaders/postfx/compose.frag", m_sceneTexture);
-
-    // Set exposure uniform default value
-    m_composeMaterial->SetUniformValue("Exposure", m_exposure);
-
-    // Set uniform default values
-    m_composeMaterial->SetUniformValue("Contrast", m_contrast);
-    m_composeMaterial->SetUniformValue("HueShift", m_hueShift);
-    m_composeMaterial->SetUniformValue("Saturation", m_saturation);
-    m_composeMaterial->SetUniformValue("ColorFilter", m_colorFilter);
-
-    // Set the bloom texture uniform
-    m_composeMaterial->SetUniformValue("BloomTexture", m_tempTextures[0]);
+    {
+        m_composeMaterial = CreatePostFXMaterial("shaders/postfx/compose.frag");
+
+        // Set exposure uniform default value
+        m_composeMaterial->SetUniformValue("Exposure", m_exposure);
+
+        // Set uniform default values
+        m_composeMaterial->SetUniformValue("Contrast", m_contrast);
+        m_composeMaterial->SetUniformValue("HueShift", m_hueShift);
+        m_composeMaterial->SetUniformValue("Saturation", m_saturation);
+        m_composeMaterial->SetUniformValue("ColorFilter", m_colorFilter);
+
+        // Read the scene and the bloom texture
+        RenderGraph::PassBuilder builder = renderGraph.AddPass(std::make_unique<PostFXRenderPass>(m_composeMaterial));
+        builder.SetName("Compose");
+        builder.Read(scene, m_composeMaterial, "SourceTexture");
+        builder.Read(bloom, m_composeMaterial, "BloomTexture");
+        builder.Write(backbuffer);
+    }
 
-    m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(m_composeMaterial, m_renderer.GetDefaultFramebuffer()));
+    // Add the passes to the renderer
+    renderGraph.Compile(m_renderer);
 }
 
 std::shared_ptr<Material> PostFXSceneViewerApplication::CreatePostFXMaterial(const char* fragmentShaderPath, std::shared_ptr<Texture2DObject> sourceTexture)
@@ -417,6 +462,21 @@ void PostFXSceneViewerApplication::RenderGUI()
     // Draw GUI for camera controller
     m_cameraController.DrawGUI(m_imGui);
 
+    // Draw GUI with the CPU zones of the last frame
+    CpuProfiler::DrawGUI(m_imGui);
+
+    // Draw GUI with the GPU time of each pass, and a button to save it
+    const GpuProfiler& gpuProfiler = m_renderer.GetGpuProfiler();
+    gpuProfiler.DrawGUI(m_imGui);
+    if (auto window = m_imGui.UseWindow("GPU Profiler"))
+    {
+        if (ImGui::Button("Save to gpu_timings.json"))
+        {
+            std::ofstream file("gpu_timings.json");
+            gpuProfiler.WriteJson(file);
+        }
+    }
+
     if (auto window = m_imGui.UseWindow("Post FX"))
     {
         if (m_composeMaterial)
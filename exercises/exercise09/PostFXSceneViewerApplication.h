@@ -5,6 +5,7 @@
 #include <ituGL/scene/Scene.h>
 #include <ituGL/texture/FramebufferObject.h>
 #include <ituGL/renderer/Renderer.h>
+#include <ituGL/renderer/GBufferRenderPass.h>
 #include <ituGL/camera/CameraController.h>
 #include <ituGL/utils/DearImGui.h>
 #include <array>
@@ -29,7 +30,6 @@ private:
     void InitializeLights();
     void InitializeMaterials();
     void InitializeModels();
-    void InitializeFramebuffers();
     void InitializeRenderer();
 
     std::shared_ptr<Material> CreatePostFXMaterial(const char* fragmentShaderPath, std::shared_ptr<Texture2DObject> sourceTexture = nullptr);
@@ -60,12 +60,14 @@ private:
     std::shared_ptr<Material> m_composeMaterial;
     std::shared_ptr<Material> m_bloomMaterial;
 
-    // Framebuffers
-    std::shared_ptr<FramebufferObject> m_sceneFramebuffer;
+    // Formats and encoding of the g-buffer. The g-buffer and deferred shaders are built to match it
+    GBufferRenderPass::Layout m_gbufferLayout;
+
+    // Light the scene with the tiled compute pass instead of one draw per light. Only if the context supports compute shaders
+    bool m_tiledLighting;
+
+    // Depth of the g-buffer. The textures and framebuffers of the other passes are created by the render graph
     std::shared_ptr<Texture2DObject> m_depthTexture;
-    std::shared_ptr<Texture2DObject> m_sceneTexture;
-    std::array<std::shared_ptr<FramebufferObject>, 2> m_tempFramebuffers;
-    std::array<std::shared_ptr<Texture2DObject>, 2> m_tempTextures;
 
     // Configuration values
     float m_exposure;
@@ -6,8 +6,12 @@ in vec2 TexCoord;
 
 //Outputs
 out vec4 FragAlbedo;
+#ifdef GBUFFER_PACKED
+out vec4 FragNormal;
+#else
 out vec2 FragNormal;
 out vec4 FragOthers;
+#endif
 
 //Uniforms
 uniform vec3 Color;
@@ -17,10 +21,17 @@ uniform sampler2D SpecularTexture;
 
 void main()
 {
-	FragAlbedo = vec4(Color.rgb * texture(ColorTexture, TexCoord).rgb, 1);
-
+	vec3 albedo = Color.rgb * texture(ColorTexture, TexCoord).rgb;
 	vec3 viewNormal = SampleNormalMap(NormalTexture, TexCoord, normalize(ViewNormal), normalize(ViewTangent), normalize(ViewBitangent));
-	FragNormal = viewNormal.xy;
+	vec4 others = texture(SpecularTexture, TexCoord);
 
-	FragOthers = texture(SpecularTexture, TexCoord);
+#ifdef GBUFFER_PACKED
+	// AO goes with the albedo, roughness and metalness with the normal, remapped to unorm
+	FragAlbedo = vec4(albedo, others.x);
+	FragNormal = vec4(EncodeOctahedral(viewNormal) * 0.5f + 0.5f, others.y, others.z);
+#else
+	FragAlbedo = vec4(albedo, 1);
+	FragNormal = viewNormal.xy;
+	FragOthers = others;
+#endif
 }
@@ -12,11 +12,38 @@ out vec3 ViewBitangent;
 out vec2 TexCoord;
 
 //Uniforms
+#ifdef WORLD_MATRIX_BLOCK
+// Camera matrices, uploaded once per frame by the renderer
+layout(std140) uniform CameraBlock
+{
+	mat4 ViewMatrix;
+	mat4 ProjMatrix;
+	mat4 ViewProjMatrix;
+	mat4 InvViewMatrix;
+	mat4 InvProjMatrix;
+	mat4 InvViewProjMatrix;
+	vec4 CameraPosition;
+};
+
+// World matrices of all the drawcalls in the frame, uploaded once by the renderer
+layout(std430) readonly buffer WorldMatrixBlock
+{
+	mat4 WorldMatrices[];
+};
+
+uniform uint WorldMatrixIndex;
+#else
 uniform mat4 WorldViewMatrix;
 uniform mat4 WorldViewProjMatrix;
+#endif
 
 void main()
 {
+#ifdef WORLD_MATRIX_BLOCK
+	mat4 WorldViewMatrix = ViewMatrix * WorldMatrices[WorldMatrixIndex];
+	mat4 WorldViewProjMatrix = ViewProjMatrix * WorldMatrices[WorldMatrixIndex];
+#endif
+
 	// normal in view space (for lighting computation)
 	ViewNormal = (WorldViewMatrix * vec4(VertexNormal, 0.0)).xyz;
 
@@ -0,0 +1,3 @@
+// Add after version330.glsl to the g-buffer and deferred shaders, when GBufferRenderPass uses Layout::GetPacked()
+// Albedo + AO in the albedo target, octahedral normal + roughness + metalness in the normal target
+#define GBUFFER_PACKED
@@ -0,0 +1,67 @@
+// Lights of the frame, uploaded once per frame by the TiledDeferredRenderPass
+// Same values as the uniforms of lighting.glsl, with the color already multiplied by the intensity
+struct LightData
+{
+	vec4 position;
+	vec4 color;
+	vec4 direction;
+	vec4 attenuation;
+};
+
+layout(std430) buffer LightBlock
+{
+	LightData Lights[];
+};
+
+uniform uint LightCount;
+
+float ComputeDistanceAttenuation(LightData light, vec3 position)
+{
+	// Compute distance attenuation, reading the range from attenuation.x (fade start) and attenuation.y (fade end)
+	return smoothstep(light.attenuation.y, light.attenuation.x, distance(position, light.position.xyz));
+}
+
+float ComputeAngularAttenuation(LightData light, vec3 lightDir)
+{
+	float angle = acos(dot(light.direction.xyz, lightDir));
+	vec2 attAngle = light.attenuation.zw;
+	return smoothstep(attAngle.y, attAngle.x, angle);
+}
+
+float ComputeAttenuation(LightData light, vec3 position, vec3 lightDir)
+{
+	float attenuation = 1.0f;
+	if (light.attenuation.y > 0)
+	{
+		attenuation *= ComputeDistanceAttenuation(light, position);
+	}
+	if (light.attenuation.w > 0)
+	{
+		attenuation *= ComputeAngularAttenuation(light, lightDir);
+	}
+	return attenuation;
+}
+
+vec3 ComputeLightDirection(LightData light, vec3 position)
+{
+	return light.attenuation.y >= 0 ? GetDirection(position, light.position.xyz) : -light.direction.xyz;
+}
+
+vec3 ComputeLight(LightData light, SurfaceData data, vec3 viewDir, vec3 position)
+{
+	vec3 lightDir = ComputeLightDirection(light, position);
+
+	vec3 diffuse = ComputeDiffuseLighting(data, lightDir);
+	vec3 specular = ComputeSpecularLighting(data, lightDir, viewDir);
+	vec3 lighting = CombineLighting(diffuse, specular, data, lightDir, viewDir);
+
+	float attenuation = ComputeAttenuation(light, position, lightDir);
+	return lighting * light.color.rgb * attenuation;
+}
+
+vec3 ComputeIndirectLighting(SurfaceData data, vec3 viewDir)
+{
+	vec3 diffuseIndirect = ComputeDiffuseIndirectLighting(data);
+	vec3 specularIndirect = ComputeSpecularIndirectLighting(data, viewDir);
+	return CombineIndirectLighting(diffuseIndirect, specularIndirect, data, viewDir);
+}
@@ -1,6 +1,3 @@
-//Inputs
-in vec2 TexCoord;
-
 //Outputs
 out vec4 FragColor;
 
@@ -8,17 +5,30 @@ out vec4 FragColor;
 uniform sampler2D DepthTexture;
 uniform sampler2D AlbedoTexture;
 uniform sampler2D NormalTexture;
+#ifndef GBUFFER_PACKED
 uniform sampler2D OthersTexture;
+#endif
 uniform mat4 InvViewMatrix;
 uniform mat4 InvProjMatrix;
 
 void main()
 {
+	// Texture coordinates from the pixel position, light volumes can't interpolate them from the vertices
+	vec2 TexCoord = gl_FragCoord.xy / vec2(textureSize(DepthTexture, 0));
+
 	// Extract information from g-buffers
 	vec3 position = ReconstructViewPosition(DepthTexture, TexCoord, InvProjMatrix);
+#ifdef GBUFFER_PACKED
+	vec4 albedoOcclusion = texture(AlbedoTexture, TexCoord);
+	vec4 normalMaterial = texture(NormalTexture, TexCoord);
+	vec3 albedo = albedoOcclusion.rgb;
+	vec3 normal = DecodeOctahedral(normalMaterial.xy * 2.0f - 1.0f);
+	vec4 others = vec4(albedoOcclusion.a, normalMaterial.zw, 0.0f);
+#else
 	vec3 albedo = texture(AlbedoTexture, TexCoord).rgb;
 	vec3 normal = GetImplicitNormal(texture(NormalTexture, TexCoord).xy);
 	vec4 others = texture(OthersTexture, TexCoord);
+#endif
 
 	// Compute view vector en view space
 	vec3 viewDir = GetDirection(position, vec3(0));
@@ -32,6 +32,30 @@ vec3 GetImplicitNormal(vec2 normal)
 	return vec3(normal, z);
 }
 
+// Octahedral encoding: project the unit vector on the octahedron and unfold it into the [-1, 1] square
+vec2 EncodeOctahedral(vec3 normal)
+{
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+	vec2 encoded = normal.xy;
+	if (normal.z < 0)
+	{
+		// Fold the lower half over the diagonals
+		vec2 signs = vec2(normal.x >= 0 ? 1.0f : -1.0f, normal.y >= 0 ? 1.0f : -1.0f);
+		encoded = (1.0f - abs(normal.yx)) * signs;
+	}
+	return encoded;
+}
+
+//
+vec3 DecodeOctahedral(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float fold = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0 ? -fold : fold;
+	normal.y += normal.y >= 0 ? -fold : fold;
+	return normalize(normal);
+}
+
 //
 vec3 SampleNormalMap(sampler2D normalTexture, vec2 texCoord, vec3 normal, vec3 tangent, vec3 bitangent)
 {
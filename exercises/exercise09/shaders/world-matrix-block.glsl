@@ -0,0 +1,3 @@
+// Add after version430.glsl to the vertex shaders, to read the world matrices from the WorldMatrixBlock of the renderer
+// The camera comes from the CameraBlock, so the renderer only sets WorldMatrixIndex for each drawcall
+#define WORLD_MATRIX_BLOCK
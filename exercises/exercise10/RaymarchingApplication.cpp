@@ -27,6 +27,8 @@ void RaymarchingApplication::Initialize()
     InitializeCamera();
     InitializeMaterial();
     InitializeRenderer();
+
+    GetDevice().SetVSyncEnabled(true);
 }
 
 void RaymarchingApplication::Update()
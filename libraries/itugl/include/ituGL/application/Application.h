@@ -8,7 +8,8 @@ class Application
 {
 public:
     // Construct the application specifying the dimensions of the window and its title
-    Application(int width, int height, const char* title);
+    // A headless application renders to a hidden window, see Window
+    Application(int width, int height, const char* title, bool headless = false);
 
     // Destroy de application
     virtual ~Application();
@@ -33,6 +34,11 @@ protected:
     // Get time in seconds of the current frame
     float GetDeltaTime() const { return m_deltaTime; }
 
+    // Advance the time by a fixed amount each frame, instead of using the real time. 0 to use the real time
+    // With a fixed delta time, every run computes the same frames, whatever the framerate
+    float GetFixedDeltaTime() const { return m_fixedDeltaTime; }
+    void SetFixedDeltaTime(float fixedDeltaTime) { m_fixedDeltaTime = fixedDeltaTime; }
+
     // Test if the application is currently running
     bool IsRunning() const;
 
@@ -48,6 +54,10 @@ protected:
     // Render the current frame
     virtual void Render();
 
+    // Called at the start of each frame, after the time is updated, and at the end, after the buffers are swapped
+    virtual void BeginFrame();
+    virtual void EndFrame();
+
     // Release all resources after the main loop
     virtual void Cleanup();
 
@@ -71,6 +81,8 @@ private:
     float m_currentTime;
     // Time in seconds of the current frame
     float m_deltaTime;
+    // Time in seconds added each frame, if not 0
+    float m_fixedDeltaTime;
 
     // Exit code
     int m_exitCode;
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <ituGL/application/Application.h>
+#include <ituGL/core/QueryObject.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Application that renders a fixed number of frames as fast as possible, and saves how long they took
+// Time advances by a fixed amount each frame and VSync is disabled, so all the runs render the same frames
+// The first frames are only warmup, to let the driver compile shaders and upload resources
+// The times of the rest, on the CPU and on the GPU, are written as JSON with their percentiles
+class BenchmarkApplication : public Application
+{
+public:
+    struct Settings
+    {
+        // Name of the benchmark, written in the results
+        std::string name;
+
+        // Frames rendered before measuring, and frames measured
+        unsigned int warmupFrames = 100;
+        unsigned int measuredFrames = 1000;
+
+        // Time in seconds added each frame
+        float fixedDeltaTime = 1.0f / 60.0f;
+
+        // Render to a hidden window
+        bool headless = true;
+
+        // Size of the scene, like the number of models or lights. The meaning depends on the benchmark
+        unsigned int sceneScale = 0;
+
+        // Configuration of the renderer to measure, like a different g-buffer layout. The meaning depends on the benchmark
+        std::string variant;
+
+        // Variants that the benchmark supports, the first one is the default. Empty if the benchmark has no variants
+        std::vector<std::string> variants;
+
+        // File where the results are written
+        std::string outputPath;
+
+        // Directory with the shaders and models. It becomes the working directory if not empty
+        std::string assetDirectory;
+    };
+
+    // Read the settings from the command line, on top of the default values:
+    // --warmup N, --frames N, --scale N, --variant NAME, --delta SECONDS, --output PATH, --windowed
+    // Variants that are not in the list of the settings are rejected, like unknown arguments
+    static bool ParseArguments(int argc, char* argv[], Settings& settings);
+
+    // Statistics of a list of times, in milliseconds
+    struct Statistics
+    {
+        double mean;
+        double min;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    static Statistics ComputeStatistics(std::vector<double> times);
+
+    // Write the statistics as a JSON member, followed by a comma, for the results of any benchmark
+    static void WriteStatistics(std::ostream& stream, const char* name, const Statistics& statistics);
+
+    // Print the percentiles in the summary, like "CPU ms: p50 ..."
+    static void PrintStatistics(const char* label, const Statistics& statistics);
+
+    // Make the output path absolute, with a default name, and move to the asset directory
+    static void ResolvePaths(Settings& settings);
+
+public:
+    BenchmarkApplication(int width, int height, const Settings& settings);
+
+    // Times of the measured frames, in milliseconds. GPU times are negative if they could not be measured
+    inline const std::vector<double>& GetCpuTimes() const { return m_cpuTimes; }
+    inline const std::vector<double>& GetGpuTimes() const { return m_gpuTimes; }
+
+    // Write the settings, the statistics and the times of each frame
+    void WriteJson(std::ostream& stream) const;
+
+protected:
+    void BeginFrame() override;
+    void EndFrame() override;
+
+    inline const Settings& GetSettings() const { return m_settings; }
+
+    // Index of the current frame, counting the warmup frames
+    inline unsigned int GetFrameIndex() const { return m_frameIndex; }
+
+private:
+    // Read the timestamps of the frame that used the slot before, waiting for them if needed
+    void ReadGpuTime(unsigned int slotIndex);
+
+    // Write the results and print a summary
+    void SaveResults() const;
+
+    // GPU times of the measured frames, leaving out the frames without GPU time
+    std::vector<double> GetValidGpuTimes() const;
+
+private:
+    Settings m_settings;
+
+    unsigned int m_frameIndex;
+
+    std::vector<double> m_cpuTimes;
+    std::vector<double> m_gpuTimes;
+
+    // Timestamps at the start and the end of the frames in flight. Read FrameLatency frames later
+    static const unsigned int FrameLatency = 3;
+    struct GpuFrame
+    {
+        QueryObject startQuery;
+        QueryObject endQuery;
+        unsigned int frameIndex = 0;
+        bool pending = false;
+    };
+    // Empty if the device can't measure time
+    std::vector<GpuFrame> m_gpuFrames;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ituGL/scene/Scene.h>
+#include <memory>
+
+class Camera;
+class Material;
+class Renderer;
+struct OccluderMesh;
+
+// Scene of exercise08 scaled up, shared by the benchmarks that measure it: a grid of treasure chests,
+// lit by a directional light and a ring of point lights, with a camera orbiting around them
+// The shaders and the model are loaded from the exercise08 assets, relative to the working directory
+class BenchmarkScene
+{
+public:
+    BenchmarkScene();
+
+    // Register the material in the renderer, and fill the scene with a square grid of modelCount models
+    // With occluders, each chest gets a box occluder, so the chests hidden by the closer ones are culled on the CPU
+    void Initialize(Renderer& renderer, unsigned int modelCount, float aspectRatio, bool occluders);
+
+    // Move the camera along its orbit, and add the scene nodes to the renderer
+    // It only depends on the time, so every run renders the same frames
+    void Update(Renderer& renderer, float time);
+
+    inline Scene& GetScene() { return m_scene; }
+
+private:
+    void InitializeCamera(float aspectRatio);
+    void InitializeLights();
+    void InitializeMaterial(Renderer& renderer);
+    void InitializeModels(unsigned int modelCount, bool occluders);
+
+private:
+    Scene m_scene;
+
+    // Camera, moved along a fixed path
+    std::shared_ptr<Camera> m_camera;
+
+    // Default material
+    std::shared_ptr<Material> m_defaultMaterial;
+
+    // Box inside the chest, shared by all of them. Null without occluders
+    std::shared_ptr<OccluderMesh> m_chestOccluder;
+
+    // Distance between the models in the grid, and number of models in each side
+    float m_spacing;
+    int m_gridSize;
+};
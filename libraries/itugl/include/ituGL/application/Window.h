@@ -6,7 +6,8 @@
 class Window
 {
 public:
-    Window(int width, int height, const char* title);
+    // A headless window is never shown, and it prefers an EGL context, so it can run on offscreen drivers like llvmpipe
+    Window(int width, int height, const char* title, bool headless = false);
     ~Window();
 
     // (C++) 1
@@ -10,6 +10,7 @@
 struct aiMesh;
 struct aiMaterial;
 class VertexFormat;
+class GeometryArena;
 
 // Asset loader for Models. Contains a pointer to a reference material for loaded submeshes
 class ModelLoader : public AssetLoader<Model>
@@ -27,9 +28,18 @@ public:
     bool GetCreateMaterials() const;
     void SetCreateMaterials(bool createMaterials);
 
+    // Also store the positions in their own tightly packed VBO, with a position-only VAO for each submesh
+    // Depth-only passes read 12 bytes per vertex instead of the whole vertex. Not done for submeshes in the geometry arena
+    bool GetCreatePositionStreams() const;
+    void SetCreatePositionStreams(bool createPositionStreams);
+
     Texture2DLoader& GetTexture2DLoader();
     const Texture2DLoader& GetTexture2DLoader() const;
 
+    // Optional arena to store the geometry of static meshes. If null, each submesh gets its own buffers and VAO
+    std::shared_ptr<GeometryArena> GetGeometryArena() const;
+    void SetGeometryArena(std::shared_ptr<GeometryArena> geometryArena);
+
     // Load the model from the path
     Model Load(const char* path) override;
 
@@ -43,6 +53,9 @@ private:
     // Generate a submesh from the loaded mesh data
     void GenerateSubmesh(Mesh& mesh, const aiMesh& meshData);
 
+    // Generate a submesh with the data stored in the geometry arena. Returns false if it didn't fit
+    bool GenerateArenaSubmesh(Mesh& mesh, const aiMesh& meshData, const VertexFormat& vertexFormat, std::span<const GLubyte> vertexData);
+
     // Generate a material from the loaded material data
     std::shared_ptr<Material> GenerateMaterial(const aiMaterial& materialData);
 
@@ -82,8 +95,14 @@ private:
     // Should create new materials for each submesh or use the reference material
     bool m_createMaterials;
 
+    // Should add a position-only VAO to each submesh
+    bool m_createPositionStreams;
+
     // Texture loader to cache already loaded shared textures
     mutable Texture2DLoader m_textureLoader;
+
+    // Arena where the geometry is stored, if any
+    std::shared_ptr<GeometryArena> m_geometryArena;
 };
 
 enum class ModelLoader::MaterialProperty
@@ -13,6 +13,14 @@ public:
         ArrayBuffer = GL_ARRAY_BUFFER,
         // Element Buffer Object
         ElementArrayBuffer = GL_ELEMENT_ARRAY_BUFFER,
+        // Draw Indirect Buffer, with the parameters of indirect drawcalls
+        DrawIndirectBuffer = GL_DRAW_INDIRECT_BUFFER,
+        // Uniform Buffer Object, source of uniform blocks
+        UniformBuffer = GL_UNIFORM_BUFFER,
+        // Shader Storage Buffer Object, source of shader storage blocks (OpenGL 4.3)
+        ShaderStorageBuffer = GL_SHADER_STORAGE_BUFFER,
+        // Texture Buffer, source of the texels of a buffer texture
+        TextureBuffer = GL_TEXTURE_BUFFER,
         // TODO: There are more types, add them when they are supported
     };
 
@@ -58,11 +66,24 @@ public:
     // Modify the contents of the buffer, starting at offset
     void UpdateData(std::span<const std::byte> data, size_t offset = 0);
 
+    // Allocate immutable storage, with glBufferStorage flags. The size can't change after this (OpenGL 4.4)
+    void AllocateStorage(size_t size, GLbitfield flags);
+    static bool IsStorageSupported();
+
+    // Map a range of the buffer to client memory, with glMapBufferRange access flags
+    std::span<std::byte> MapRange(size_t offset, size_t size, GLbitfield access);
+    // Unmap the buffer. Returns false if the contents got corrupted while mapped
+    bool Unmap();
+
 protected:
     // Bind the specific target. Used by the Bind() method in derived classes
     void Bind(Target target) const;
     // Unbind the specific target. It is static because we dont need any objects to do it
     static void Unbind(Target target);
+
+    // Bind the whole buffer, or a range of it, to an indexed binding point of the target. Only for indexed targets
+    void BindBase(Target target, GLuint index) const;
+    void BindRange(Target target, GLuint index, GLintptr offset, GLsizeiptr size) const;
 };
 
 // (C++) 5
@@ -2,6 +2,8 @@
 
 #include <ituGL/core/Color.h>
 #include <glad/glad.h>
+#include <array>
+#include <unordered_map>
 
 class Window;
 struct GLFWwindow;
@@ -11,7 +13,16 @@ struct GLFWwindow;
 class DeviceGL
 {
 public:
-    DeviceGL();
+    // Where the GL calls go: the driver of the current window, or the null backend that does nothing
+    // The null backend is ready without a window, and is used to measure the CPU cost of the renderer alone
+    enum class Backend
+    {
+        Device,
+        Null,
+    };
+
+public:
+    DeviceGL(Backend backend = Backend::Device);
     ~DeviceGL();
 
     // Singleton method to get a reference to the instance. Will crash if there is none
@@ -23,11 +34,16 @@ public:
     // Check if device is initialized
     inline bool IsReady() const { return m_contextLoaded; }
 
+    // Get the backend selected when the device was created
+    inline Backend GetBackend() const { return m_backend; }
+
     // Set the window that OpenGL will use for rendering
     void SetCurrentWindow(Window &window);
 
     // Set the dimensions of the viewport
     void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    // Get the dimensions of the current viewport
+    void GetViewport(GLint& x, GLint& y, GLsizei& width, GLsizei& height) const;
 
     // Poll the events in the window event queue
     void PollEvents();
@@ -39,6 +55,10 @@ public:
     // Clear the framebuffer with the specified color, depth and stencil
     void Clear(bool clearColor, const Color& color, bool clearDepth, GLdouble depth, bool clearStencil, GLint stencil);
 
+    // Make the image and buffer writes of the previous shaders visible to the commands that follow (OpenGL 4.2)
+    // The barriers are the GL_*_BARRIER_BIT flags of the ways the data is read later
+    void IssueMemoryBarrier(GLbitfield barriers);
+
     // Get if a feature is enabled
     bool IsFeatureEnabled(GLenum feature) const;
     // enable / disable a feature
@@ -52,10 +72,110 @@ public:
     // enable / disable v-sync
     void SetVSyncEnabled(bool enabled);
 
+    // Render states. The device keeps a shadow copy of the GL state and skips the calls that would not change it
+
+    // Set the depth test function and if depth is written
+    void SetDepthFunction(GLenum function);
+    void SetDepthWrite(bool enabled);
+
+    // Set if the color channels are written. Disabled for passes that only write depth
+    void SetColorWrite(bool enabled);
+
+    // Set which faces are culled when GL_CULL_FACE is enabled: GL_FRONT, GL_BACK or GL_FRONT_AND_BACK
+    void SetCullFace(GLenum face);
+
+    // Set the rectangle used by the scissor test, in pixels
+    void SetScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // Set the stencil test function and operations for GL_FRONT, GL_BACK or GL_FRONT_AND_BACK faces
+    void SetStencilFunction(GLenum face, GLenum function, GLint refValue, GLuint mask);
+    void SetStencilOperations(GLenum face, GLenum stencilFail, GLenum depthFail, GLenum depthPass);
+
+    // Set the blend equations, blend parameters and blend constant color
+    void SetBlendEquation(GLenum equationColor, GLenum equationAlpha);
+    inline void SetBlendEquation(GLenum equation) { SetBlendEquation(equation, equation); }
+    void SetBlendFunction(GLenum sourceColor, GLenum destColor, GLenum sourceAlpha, GLenum destAlpha);
+    inline void SetBlendFunction(GLenum source, GLenum dest) { SetBlendFunction(source, dest, source, dest); }
+    void SetBlendColor(const Color& color);
+
+    // Object bindings
+    void UseProgram(GLuint handle);
+    void BindVertexArray(GLuint handle);
+    void BindFramebuffer(GLenum target, GLuint handle);
+    void SetActiveTexture(GLint textureUnit);
+    void BindTexture(GLenum target, GLuint handle);
+
+    // Deleting an object clears its bindings in GL, so the shadow copy needs to forget them too
+    void OnProgramDeleted(GLuint handle);
+    void OnVertexArrayDeleted(GLuint handle);
+    void OnFramebufferDeleted(GLuint handle);
+    void OnTextureDeleted(GLuint handle);
+
+    // Forget the shadow copy, so the next calls are always issued. Needed after changing the state with direct GL calls
+    void InvalidateState();
+
+    // Counters of state calls sent to GL and skipped because they would not change anything
+    inline unsigned int GetIssuedStateCalls() const { return m_issuedStateCalls; }
+    inline unsigned int GetElidedStateCalls() const { return m_elidedStateCalls; }
+    void ResetStateCallCounters();
+
 private:
+    // Returns true if the call must be issued, and updates the counters
+    bool CheckStateChange(bool changed);
+
+    // Index of the texture target in the per-unit bindings, or -1 if it is not shadowed
+    static int GetTextureTargetIndex(GLenum target);
+
+private:
+    Backend m_backend;
+
     // Has a context been loaded? We use the context of the current window
     bool m_contextLoaded;
 
+    // Value used in the shadow copy when the real state is not known
+    static constexpr GLuint UnknownState = ~0u;
+
+    // Enabled features that have been set or queried. Missing ones are unknown
+    mutable std::unordered_map<GLenum, bool> m_features;
+
+    // Depth state
+    GLenum m_depthFunction;
+    GLuint m_depthWrite;
+
+    // Color state, the same mask for all the channels
+    GLuint m_colorWrite;
+
+    // Rasterizer state
+    GLenum m_cullFace;
+    std::array<GLint, 4> m_scissor;
+
+    // Stencil state, front and back
+    std::array<GLenum, 2> m_stencilFunctions;
+    std::array<GLint, 2> m_stencilRefValues;
+    std::array<GLuint, 2> m_stencilMasks;
+    std::array<std::array<GLenum, 3>, 2> m_stencilOperations;
+
+    // Blend state. Color is NaN when unknown, so it never compares equal
+    std::array<GLenum, 2> m_blendEquations;
+    std::array<GLenum, 4> m_blendFunctions;
+    std::array<float, 4> m_blendColor;
+
+    // Bound objects
+    GLuint m_program;
+    GLuint m_vertexArray;
+    GLuint m_drawFramebuffer;
+    GLuint m_readFramebuffer;
+
+    // Texture bindings for each unit and target
+    static const unsigned int MaxTextureUnits = 32;
+    static const unsigned int TextureTargetCount = 8;
+    GLint m_activeTexture;
+    std::array<std::array<GLuint, TextureTargetCount>, MaxTextureUnits> m_textures;
+
+    // State calls counters
+    unsigned int m_issuedStateCalls;
+    unsigned int m_elidedStateCalls;
+
 private:
     // Singleton instance
     static DeviceGL* m_instance;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+// Records the OpenGL calls made through glad, with the device or with the null backend
+// It uses the pre-call callback of glad, so it sees every call, including the ones made outside of ituGL
+// Use it to measure how many calls the renderer makes, and to catch regressions in the call counts
+class GLCallRecorder
+{
+public:
+    struct Statistics
+    {
+        // Number of calls of each entry point, by name
+        std::map<std::string, unsigned int> callCounts;
+
+        // Total number of calls, and number of draw calls
+        unsigned int callCount = 0;
+        unsigned int drawCallCount = 0;
+
+        // Bytes sent from client memory with glBufferData, glBufferSubData, glBufferStorage and glTexImage2D
+        std::uint64_t bufferBytesUploaded = 0;
+        std::uint64_t textureBytesUploaded = 0;
+    };
+
+public:
+    // Start recording, forgetting the calls recorded before
+    static void BeginRecording();
+
+    // Stop recording. The statistics are kept until the next BeginRecording
+    static void EndRecording();
+
+    static bool IsRecording();
+
+    // Statistics of the calls recorded since BeginRecording
+    static Statistics GetStatistics();
+
+    // Write the statistics as a JSON object
+    static void WriteJson(std::ostream& stream, const Statistics& statistics);
+};
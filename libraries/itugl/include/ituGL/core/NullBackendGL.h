@@ -0,0 +1,24 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// OpenGL backend that does nothing, so code using ituGL can run without a context or a GPU
+// glad keeps a table of function pointers for the GL entry points. Installing the backend replaces them with functions that:
+// - Hand out fake handles for buffers, textures, vertex arrays, framebuffers, queries, shaders and programs
+// - Report that shaders compile, programs link, queries are available, fences are signaled and framebuffers are complete
+// - Reflect shader programs from their source code: declared uniforms, uniform blocks and vertex inputs are reported as active
+// - Return memory in client memory when a buffer is mapped
+// Everything else is ignored. Entry points not used by ituGL are left as they were
+// The device reports OpenGL 4.1, the version requested by Window, so the same code paths are taken as with a real context
+class NullBackendGL
+{
+public:
+    // Replace the GL entry points with the null functions. There must be no context current
+    static void Install();
+
+    // Check if the null functions are installed
+    static bool IsInstalled();
+
+    // Number of handles created and not deleted yet, to detect leaks
+    static unsigned int GetLiveObjectCount();
+};
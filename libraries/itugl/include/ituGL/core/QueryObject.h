@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ituGL/core/Object.h>
+
+// Query object, used to ask the GPU for information about the commands between Begin and End, like how long they took
+// Results arrive some time after End. Reading them before they are available makes the CPU wait for the GPU
+class QueryObject : public Object
+{
+public:
+    enum class Target : GLenum
+    {
+        TimeElapsed = GL_TIME_ELAPSED,
+        SamplesPassed = GL_SAMPLES_PASSED,
+        AnySamplesPassed = GL_ANY_SAMPLES_PASSED,
+        PrimitivesGenerated = GL_PRIMITIVES_GENERATED,
+    };
+
+public:
+    QueryObject();
+    virtual ~QueryObject();
+
+    // (C++) 8
+    // Move semantics
+    QueryObject(QueryObject&& queryObject) noexcept;
+    QueryObject& operator = (QueryObject&& queryObject) noexcept;
+
+    // Implements the Bind required by Object. Queries use Begin and End instead
+    void Bind() const override;
+
+    // Start and finish the query. Only one query of each target can be active at the same time
+    void Begin(Target target) const;
+    static void End(Target target);
+
+    // Record the GPU time, in nanoseconds, when all the previous commands are done. It can be used while a query is active
+    void RecordTimestamp() const;
+
+    // Check if the result can be read without waiting
+    bool IsResultAvailable() const;
+
+    // Read the result, waiting for it if it is not available yet. For TimeElapsed, it is in nanoseconds
+    GLuint64 GetResult() const;
+
+    // Check if the device supports timer queries
+    static bool IsTimerSupported();
+};
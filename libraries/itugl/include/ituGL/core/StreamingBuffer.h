@@ -0,0 +1,111 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+#include <span>
+#include <vector>
+
+// Ring buffer for data that is written by the CPU every frame (particles, instance data, debug lines...)
+// The buffer is split in regions. Allocations move forward through the regions and wrap around at the end,
+// and a fence is placed on each region written in a frame, so it is not overwritten while the GPU could still be reading it.
+// Data written in earlier frames and read again (MarkRead) is protected with some slack instead: writing over it waits for the frame
+// regionCount - 1 frames back, not for the last one. The CPU stays at most that many frames ahead of the GPU, and the frames in flight
+// may see some of the new values. That is fine for data that is being replaced anyway, like the oldest particles.
+// If persistent mapping is supported (OpenGL 4.4), producers write directly in the buffer memory.
+// Otherwise, they write in a copy in client memory, and the modified ranges are uploaded when flushing.
+class StreamingBuffer
+{
+public:
+    StreamingBuffer();
+    ~StreamingBuffer();
+
+    // (C++) 4
+    // Make the object non-copyable, the fences would be deleted twice
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    void operator = (const StreamingBuffer&) = delete;
+
+    // Allocate the storage of the buffer, that must be bound, with regionCount regions of regionSize bytes
+    // The buffer must not have been allocated before, and must outlive the StreamingBuffer
+    void Initialize(BufferObject& buffer, size_t regionSize, unsigned int regionCount = 3);
+
+    // The BufferObject that holds the data
+    inline BufferObject& GetBuffer() const { return *m_buffer; }
+
+    inline size_t GetCapacity() const { return m_data.size(); }
+    inline size_t GetRegionSize() const { return m_regionSize; }
+
+    // Allocate size bytes, aligned to alignment from the start of the buffer. offset returns where they are in the buffer
+    // If they don't fit before the end of the buffer, it wraps around and continues from the beginning
+    std::span<std::byte> Allocate(size_t size, size_t alignment, size_t& offset);
+
+    // Allocate count elements of type T. The offset is a multiple of sizeof(T), so it can also be used as an index
+    template<typename T>
+    std::span<T> Allocate(size_t count, size_t& offset);
+
+    // Make the data written since the last flush visible to the GPU. Call it before the commands that read it
+    void Flush();
+
+    // Mark size bytes from offset as read by the commands of this frame, so they are protected with the frame slack
+    // Needed for data written in earlier frames that is still drawn, like live particles
+    void MarkRead(size_t offset, size_t size);
+
+    // Protect the regions written this frame, and the data read, with fences. Call it after the commands that read them
+    void EndFrame();
+
+    // Check if the buffer can be mapped persistently
+    static bool IsPersistentMappingSupported();
+
+private:
+    // Get the region ready to be written when entering it, waiting for the GPU if it is still reading it
+    void AcquireRegion(unsigned int regionIndex);
+
+    // Wait for the GPU to finish the frame from regionCount - 1 frames back, before writing over data read since then
+    void WaitForReads();
+
+    // Wait until the fence is signaled, and delete it
+    static void WaitAndDeleteFence(GLsync& fence);
+
+    // Mark a range of bytes as modified
+    void AddDirtyRange(size_t begin, size_t end);
+
+private:
+    struct Region
+    {
+        // Fence placed the last frame the region was written. Null if the GPU is done with it
+        GLsync fence;
+
+        // Written this frame
+        bool written;
+
+        // Holds data read since the region was acquired. Then any write in the region waits for the frame slack, not only the first one
+        bool read;
+
+        // Range modified since the last flush, only needed if not mapped
+        size_t dirtyBegin;
+        size_t dirtyEnd;
+    };
+
+    BufferObject* m_buffer;
+
+    // Memory where producers write: the mapped buffer, or m_clientData
+    std::span<std::byte> m_data;
+    std::vector<std::byte> m_clientData;
+    bool m_persistent;
+
+    size_t m_regionSize;
+    std::vector<Region> m_regions;
+
+    // Next byte to allocate, and the region it belongs to
+    size_t m_cursor;
+    unsigned int m_currentRegion;
+
+    // Fences placed at the end of the last frames, used as a ring. The next one to replace is the oldest
+    std::vector<GLsync> m_frameFences;
+    unsigned int m_frameIndex;
+};
+
+template<typename T>
+std::span<T> StreamingBuffer::Allocate(size_t count, size_t& offset)
+{
+    std::span<std::byte> bytes = Allocate(count * sizeof(T), sizeof(T), offset);
+    return std::span<T>(reinterpret_cast<T*>(bytes.data()), bytes.size() / sizeof(T));
+}
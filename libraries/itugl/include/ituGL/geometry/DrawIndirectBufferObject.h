@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+#include <ituGL/geometry/Drawcall.h>
+
+// Buffer containing the parameters of indirect drawcalls, read by the GPU when drawing
+class DrawIndirectBufferObject : public BufferObjectBase<BufferObject::DrawIndirectBuffer>
+{
+public:
+    DrawIndirectBufferObject();
+
+    // (C++) 3
+    // Use the same AllocateData and UpdateData methods from the base class
+    using BufferObject::AllocateData;
+    using BufferObject::UpdateData;
+
+    // Allocate the buffer with a list of indirect commands
+    void AllocateData(std::span<const Drawcall::IndirectCommand> commands, Usage usage = Usage::StreamDraw);
+};
@@ -23,17 +23,54 @@ public:
         Patches = GL_PATCHES
     };
 
+    // Layout of the commands read by glMultiDrawElementsIndirect
+    struct IndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
 public:
     Drawcall();
     Drawcall(Primitive primitive, GLsizei count, GLint first = 0);
     Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first = 0);
+    // baseVertex is added to every element, so several meshes can share the same buffers
+    Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first, GLint baseVertex);
 
     // Check if the drawcall is valid
     inline bool IsValid() const { return m_primitive != Primitive::Invalid && m_count > 0; }
 
+    inline Primitive GetPrimitive() const { return m_primitive; }
+    inline GLint GetFirst() const { return m_first; }
+    inline GLsizei GetCount() const { return m_count; }
+    inline Data::Type GetEBOType() const { return m_eboType; }
+    inline GLint GetBaseVertex() const { return m_baseVertex; }
+
+    // Check if two drawcalls can be submitted in the same multi-draw
+    inline bool IsMultiDrawCompatible(const Drawcall& other) const
+    {
+        return m_eboType != Data::Type::None && m_primitive == other.m_primitive && m_eboType == other.m_eboType;
+    }
+
+    // Get the indirect command equivalent to this drawcall. Only valid for drawcalls with EBO
+    IndirectCommand GetIndirectCommand(GLuint instanceCount, GLuint baseInstance) const;
+
     // Execute the drawcall
     void Draw() const;
 
+    // Execute the drawcall, rendering instanceCount instances
+    void DrawInstanced(GLsizei instanceCount) const;
+
+    // Execute drawCount indirect commands, starting at indirectOffset in the bound draw indirect buffer
+    // The commands use the primitive and EBO type of this drawcall
+    void DrawMultiIndirect(GLintptr indirectOffset, GLsizei drawCount) const;
+
+    // Check if the device supports glMultiDrawElementsIndirect
+    static bool IsMultiDrawIndirectSupported();
+
 private:
     // Type of primitive to be rendered
     Primitive m_primitive;
@@ -46,4 +83,7 @@ private:
 
     // Data type of the elements in the EBO (int, uint, short, byte, etc.). A value of None means no EBO
     Data::Type m_eboType;
+
+    // Value added to each element before fetching the vertex
+    GLint m_baseVertex;
 };
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ituGL/geometry/Mesh.h>
+#include <ituGL/geometry/VertexFormat.h>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Large shared buffers storing the vertex and element data of many static meshes
+// Meshes with the same VertexFormat and attribute locations are placed in the same pool and share a single VAO.
+// Their drawcalls use a base vertex to find their data, so they can be drawn without switching VAOs, or in a single multi-draw
+class GeometryArena
+{
+public:
+    // vertexCapacity and elementCapacity are the size of each pool, in vertices and elements
+    GeometryArena(unsigned int vertexCapacity, unsigned int elementCapacity);
+
+    // Copy interleaved vertex data and its elements in a pool compatible with vertexFormat and locations
+    // Returns the VAO and the drawcall to render it, or nullptr if the data doesn't fit in a pool
+    const VertexArrayObject* Allocate(const VertexFormat& vertexFormat, const Mesh::SemanticMap& locations,
+        std::span<const std::byte> vertexData, std::span<const GLuint> elements, Drawcall::Primitive primitive, Drawcall& drawcall);
+
+    // Number of pools created so far
+    inline unsigned int GetPoolCount() const { return static_cast<unsigned int>(m_pools.size()); }
+
+private:
+    // Set of buffers for one vertex format. Elements are always stored as GLuint, so all drawcalls can share a multi-draw
+    struct Pool
+    {
+        VertexFormat vertexFormat;
+        Mesh::SemanticMap locations;
+
+        VertexBufferObject vbo;
+        ElementBufferObject ebo;
+        VertexArrayObject vao;
+
+        // Used vertices and elements
+        unsigned int vertexCount;
+        unsigned int elementCount;
+    };
+
+private:
+    // Find a compatible pool with enough space, or create a new one
+    Pool* GetPool(const VertexFormat& vertexFormat, const Mesh::SemanticMap& locations, unsigned int vertexCount, unsigned int elementCount);
+
+    // Check if two vertex formats have the same attributes
+    static bool IsSameFormat(const VertexFormat& a, const VertexFormat& b);
+
+private:
+    unsigned int m_vertexCapacity;
+    unsigned int m_elementCapacity;
+
+    // Pools are referenced by the meshes, so they can't move
+    std::vector<std::unique_ptr<Pool>> m_pools;
+};
@@ -8,6 +8,10 @@
 #include <ituGL/shader/ShaderProgram.h>
 #include <vector>
 #include <unordered_map>
+#include <memory>
+
+class GeometryArena;
+class AabbBounds;
 
 // Class that groups several VBO, EBO and VAO that are part of the same object
 // Can contain several drawcalls using the data in those objects
@@ -34,6 +38,10 @@ public:
     // Adds a new VAO. It is your responsability to set the attribute pointers and the EBO, if needed
     unsigned int AddVertexArray();
 
+    // Adds a new VAO with only the positions, read as tightly packed vec3 from a VBO of the mesh, at location 0
+    // eboIndex is the index inside m_ebos of the EBO to be used, or -1 if none
+    unsigned int AddPositionVertexArray(unsigned int vboIndex, int eboIndex = -1);
+
     // (C++) 7
     // Adds a new VAO, with data stored in a single VBO inside the mesh, and an iterator for the attributes
     // vboIndex is the index inside m_vbos of the VBO to be used
@@ -52,6 +60,9 @@ public:
     // Adds a new submesh, with the index of the VAO to be bound, and the parameters to create a Drawcall
     unsigned int AddSubmesh(unsigned int vaoIndex, Drawcall::Primitive primitive, GLint first, GLsizei count, Data::Type eboType);
 
+    // Adds a new submesh with its data stored in a GeometryArena, using the VAO returned by the arena. The mesh keeps the arena alive
+    unsigned int AddSubmesh(std::shared_ptr<const GeometryArena> arena, const VertexArrayObject& arenaVao, const Drawcall& drawcall);
+
     // (C++) 7
     // Adds a new submesh, adding a new VAO that uses a single VBO, no EBO, and providing the parameters to create a Drawcall
     // vboIndex is the index inside m_vbos of the VBO to be used
@@ -110,9 +121,24 @@ public:
     inline const VertexArrayObject& GetVertexArray(unsigned int vaoIndex) const { return m_vaos[vaoIndex]; }
 
     inline unsigned int GetSubmeshCount() const { return static_cast<unsigned int>(m_submeshes.size()); }
-    inline const VertexArrayObject& GetSubmeshVertexArray(unsigned int submeshIndex) const { return m_vaos[m_submeshes[submeshIndex].vaoIndex]; }
+    const VertexArrayObject& GetSubmeshVertexArray(unsigned int submeshIndex) const;
     inline const Drawcall& GetSubmeshDrawcall(unsigned int submeshIndex) const { return m_submeshes[submeshIndex].drawcall; }
 
+    // Optional VAO of a submesh with only its positions, usually created with AddPositionVertexArray
+    // Depth-only passes use it with the same drawcall, so it must see the same vertices and elements as the main VAO
+    void SetSubmeshPositionVertexArray(unsigned int submeshIndex, unsigned int vaoIndex);
+    inline bool HasSubmeshPositionVertexArray(unsigned int submeshIndex) const { return m_submeshes[submeshIndex].positionVaoIndex >= 0; }
+    const VertexArrayObject* GetSubmeshPositionVertexArray(unsigned int submeshIndex) const;
+
+    // Local bounds of each submesh, used for culling. Submeshes without bounds are never culled
+    void SetSubmeshBounds(unsigned int submeshIndex, const AabbBounds& bounds);
+    inline bool HasSubmeshBounds(unsigned int submeshIndex) const { return m_submeshes[submeshIndex].hasBounds; }
+    AabbBounds GetSubmeshBounds(unsigned int submeshIndex) const;
+
+    // Local bounds containing all the submeshes. Only valid if all of them have bounds
+    bool HasBounds() const;
+    AabbBounds GetBounds() const;
+
     // Draws a submesh
     void DrawSubmesh(int submeshIndex) const;
 
@@ -123,6 +149,17 @@ private:
     {
         unsigned int vaoIndex;
         Drawcall drawcall;
+
+        // If not null, VAO inside a GeometryArena used instead of vaoIndex
+        const VertexArrayObject* arenaVao;
+
+        // VAO with only the positions, or -1 if none
+        int positionVaoIndex;
+
+        // Local AABB, stored as center and half size
+        bool hasBounds;
+        glm::vec3 boundsCenter;
+        glm::vec3 boundsSize;
     };
 
 private:
@@ -151,6 +188,9 @@ private:
 
     // Submeshes contained in this mesh
     std::vector<Submesh> m_submeshes;
+
+    // Arenas storing the data of some submeshes
+    std::vector<std::shared_ptr<const GeometryArena>> m_arenas;
 };
 
 template<typename T>
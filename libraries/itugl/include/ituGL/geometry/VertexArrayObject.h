@@ -27,6 +27,13 @@ public:
     // stride: how far each element is from the previous one. Default value 0 will use the attribute size
     void SetAttribute(GLuint location, const VertexAttribute& attribute, GLint offset, GLsizei stride = 0);
 
+    // Sets how often the attribute in location advances: 0 means every vertex, N means every N instances
+    void SetAttributeDivisor(GLuint location, GLuint divisor);
+
+    // Sets a mat4 attribute, that takes 4 locations, to read one matrix per instance from the bound VBO, starting at offset
+    // It can be called on a const VAO: the instance attributes change between batches, but not the vertex data of the mesh
+    void SetInstanceMatrixAttribute(GLuint location, GLint offset) const;
+
 #ifndef NDEBUG
     // Check if there is any VertexArrayObject currently bound
     inline static bool IsAnyBound() { return s_boundHandle != Object::NullHandle; }
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/LightGrid.h>
+#include <ituGL/texture/TextureBufferObject.h>
+#include <ituGL/texture/BufferTextureObject.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <unordered_map>
+
+// Forward pass that draws each drawcall once, with all its lights
+// The lights are assigned to the clusters of a LightGrid, that is uploaded in buffer textures once per frame.
+// Shaders find their cluster from the view position and loop only over its lights. They declare these uniforms:
+// ClusterLightData, ClusterRanges, ClusterLightIndices, ClusterGridSize, ClusterDepthParams and GlobalLightCount
+class ClusteredForwardRenderPass : public RenderPass
+{
+public:
+    ClusteredForwardRenderPass(int drawcallCollectionIndex = 0, const glm::uvec3& gridSize = glm::uvec3(16, 9, 24));
+
+    void Render() override;
+
+    const LightGrid& GetLightGrid() const { return m_lightGrid; }
+
+    // Texture units of the light grid textures. The last ones, to not collide with the material textures
+    static constexpr GLint LightDataTextureUnit = 13;
+    static constexpr GLint ClusterRangesTextureUnit = 14;
+    static constexpr GLint LightIndicesTextureUnit = 15;
+
+private:
+    void InitTextures();
+
+    // Upload the light grid to the buffers and bind the textures
+    void UploadLightGrid();
+
+    // Set the light grid uniforms of a shader program, that must be in use
+    void SetLightGridUniforms(const ShaderProgram& shaderProgram);
+
+private:
+    int m_drawcallCollectionIndex;
+
+    LightGrid m_lightGrid;
+
+    TextureBufferObject m_lightDataBuffer;
+    TextureBufferObject m_clusterRangesBuffer;
+    TextureBufferObject m_lightIndicesBuffer;
+
+    BufferTextureObject m_lightDataTexture;
+    BufferTextureObject m_clusterRangesTexture;
+    BufferTextureObject m_lightIndicesTexture;
+
+    // Locations of the light grid uniforms in each shader program
+    struct LightGridLocations
+    {
+        ShaderProgram::Location lightData;
+        ShaderProgram::Location clusterRanges;
+        ShaderProgram::Location lightIndices;
+        ShaderProgram::Location gridSize;
+        ShaderProgram::Location depthParams;
+        ShaderProgram::Location globalLightCount;
+    };
+    std::unordered_map<const ShaderProgram*, LightGridLocations> m_lightGridLocations;
+};
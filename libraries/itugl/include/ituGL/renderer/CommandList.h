@@ -0,0 +1,145 @@
+#pragma once
+
+#include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/core/Data.h>
+#include <variant>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+class Material;
+class VertexArrayObject;
+class VertexBufferObject;
+class UniformBufferObject;
+class DrawIndirectBufferObject;
+class TextureObject;
+class Drawcall;
+class Renderer;
+
+// List of rendering commands that can be recorded on any thread, and executed later on the thread that owns the context
+// Recording only stores the commands and their values, nothing is sent to the device until Execute
+// The objects referenced by the commands must stay alive until the list is executed
+class CommandList
+{
+public:
+    CommandList();
+
+    // Remove all the commands, keeping the memory to record the next ones
+    void Clear();
+
+    inline bool IsEmpty() const { return m_commands.empty(); }
+    inline unsigned int GetCommandCount() const { return static_cast<unsigned int>(m_commands.size()); }
+
+    // Use the shader program of the material, set a copy of its uniform values and bind its textures, and set its render states
+    // The uniforms are expanded in the list when recording, only the render states are read from the material when executing
+    void UseMaterial(const Material& material);
+
+    // Use a shader program without any material
+    void UseShaderProgram(const ShaderProgram& shaderProgram);
+
+    void BindVertexArray(const VertexArrayObject& vao);
+
+    // Bind a buffer to a uniform block binding point
+    void BindUniformBuffer(const UniformBufferObject& uniformBuffer, GLuint binding);
+
+    // Bind a texture to a unit, and set the unit in a sampler uniform. The shader program must be in use
+    void BindTexture(const ShaderProgram& shaderProgram, ShaderProgram::Location location, GLint textureUnit, const TextureObject& texture);
+
+    // Set uniform values, copied in the list. Same combinations as ShaderProgram. The shader program must be in use
+    template<typename T>
+    void SetUniform(const ShaderProgram& shaderProgram, ShaderProgram::Location location, const T& value);
+    template<typename T>
+    void SetUniforms(const ShaderProgram& shaderProgram, ShaderProgram::Location location, std::span<const T> values);
+    template<typename T, int N>
+    void SetUniforms(const ShaderProgram& shaderProgram, ShaderProgram::Location location, std::span<const glm::vec<N, T>> values);
+    template<typename T, int C, int R>
+    void SetUniforms(const ShaderProgram& shaderProgram, ShaderProgram::Location location, std::span<const glm::mat<C, R, T>> values);
+
+    // Call the transforms function registered in the renderer for the shader program. It runs when the list is executed
+    // Only needed for programs with their own function, the renderer records the standard transforms as uniform values
+    void UpdateTransforms(const Renderer& renderer, const ShaderProgram& shaderProgram, unsigned int worldMatrixIndex, bool cameraChanged);
+
+    // Point the 4 columns of a mat4 instance attribute to the first instance in the buffer
+    void SetInstanceAttributes(const VertexArrayObject& vao, const VertexBufferObject& instanceBuffer, GLuint location, unsigned int firstInstance);
+
+    void Draw(const Drawcall& drawcall);
+    void DrawInstanced(const Drawcall& drawcall, GLsizei instanceCount);
+    void DrawMultiIndirect(const Drawcall& drawcall, const DrawIndirectBufferObject& indirectBuffer, GLintptr indirectOffset, GLsizei drawCount);
+
+    // Send all the commands to the device, in the order they were recorded
+    void Execute() const;
+
+private:
+    struct UseMaterialStatesCommand { const Material* material; };
+    struct UseShaderProgramCommand { const ShaderProgram* shaderProgram; };
+    struct BindVertexArrayCommand { const VertexArrayObject* vao; };
+    struct BindUniformBufferCommand { const UniformBufferObject* uniformBuffer; GLuint binding; };
+    struct BindTextureCommand { const ShaderProgram* shaderProgram; ShaderProgram::Location location; GLint textureUnit; const TextureObject* texture; };
+
+    // The values are stored in m_uniformData. Scalars and vectors have 1 column, with 1 to 4 rows
+    struct SetUniformCommand { const ShaderProgram* shaderProgram; ShaderProgram::Location location; Data::Type type; std::uint8_t columns; std::uint8_t rows; GLsizei count; unsigned int dataOffset; };
+
+    struct UpdateTransformsCommand { const Renderer* renderer; const ShaderProgram* shaderProgram; unsigned int worldMatrixIndex; bool cameraChanged; };
+    struct SetInstanceAttributesCommand { const VertexArrayObject* vao; const VertexBufferObject* instanceBuffer; GLuint location; unsigned int firstInstance; };
+    struct DrawCommand { const Drawcall* drawcall; };
+    struct DrawInstancedCommand { const Drawcall* drawcall; GLsizei instanceCount; };
+    struct DrawMultiIndirectCommand { const Drawcall* drawcall; const DrawIndirectBufferObject* indirectBuffer; GLintptr indirectOffset; GLsizei drawCount; };
+
+    using Command = std::variant<UseMaterialStatesCommand, UseShaderProgramCommand, BindVertexArrayCommand, BindUniformBufferCommand,
+        BindTextureCommand, SetUniformCommand, UpdateTransformsCommand, SetInstanceAttributesCommand,
+        DrawCommand, DrawInstancedCommand, DrawMultiIndirectCommand>;
+
+    // Copy the values of a uniform at the end of m_uniformData
+    template<typename T>
+    void AddSetUniform(const ShaderProgram& shaderProgram, ShaderProgram::Location location, int columns, int rows, GLsizei count, const T* values);
+
+    void Execute(const SetUniformCommand& command) const;
+    template<typename T>
+    void ExecuteSetUniform(const SetUniformCommand& command) const;
+    void Execute(const UpdateTransformsCommand& command) const;
+    void Execute(const SetInstanceAttributesCommand& command) const;
+
+private:
+    std::vector<Command> m_commands;
+
+    // Values of the SetUniform commands. Floats are enough to store all the types bit by bit
+    // Doubles start at an even offset, the allocation is aligned enough for them
+    std::vector<float> m_uniformData;
+};
+
+template<typename T>
+void CommandList::SetUniform(const ShaderProgram& shaderProgram, ShaderProgram::Location location, const T& value)
+{
+    SetUniforms(shaderProgram, location, std::span(&value, 1));
+}
+
+template<typename T>
+void CommandList::SetUniforms(const ShaderProgram& shaderProgram, ShaderProgram::Location location, std::span<const T> values)
+{
+    AddSetUniform(shaderProgram, location, 1, 1, static_cast<GLsizei>(values.size()), values.data());
+}
+
+template<typename T, int N>
+void CommandList::SetUniforms(const ShaderProgram& shaderProgram, ShaderProgram::Location location, std::span<const glm::vec<N, T>> values)
+{
+    AddSetUniform(shaderProgram, location, 1, N, static_cast<GLsizei>(values.size()), &values[0][0]);
+}
+
+template<typename T, int C, int R>
+void CommandList::SetUniforms(const ShaderProgram& shaderProgram, ShaderProgram::Location location, std::span<const glm::mat<C, R, T>> values)
+{
+    AddSetUniform(shaderProgram, location, C, R, static_cast<GLsizei>(values.size()), &values[0][0][0]);
+}
+
+template<typename T>
+void CommandList::AddSetUniform(const ShaderProgram& shaderProgram, ShaderProgram::Location location, int columns, int rows, GLsizei count, const T* values)
+{
+    static_assert(sizeof(T) % sizeof(float) == 0);
+    const unsigned int alignment = sizeof(T) / sizeof(float);
+    unsigned int dataOffset = static_cast<unsigned int>(m_uniformData.size() + alignment - 1) / alignment * alignment;
+    const float* data = reinterpret_cast<const float*>(values);
+    m_uniformData.resize(dataOffset);
+    m_uniformData.insert(m_uniformData.end(), data, data + columns * rows * count * alignment);
+    SetUniformCommand command = { &shaderProgram, location, Data::GetType<T>(), static_cast<std::uint8_t>(columns), static_cast<std::uint8_t>(rows), count, dataOffset };
+    m_commands.push_back(command);
+}
@@ -4,10 +4,13 @@
 
 #include <ituGL/shader/ShaderProgram.h>
 #include <ituGL/geometry/Mesh.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
 #include <memory>
 
 class Texture2DObject;
 class Material;
+class Light;
 
 class DeferredRenderPass: public RenderPass
 {
@@ -16,9 +19,35 @@ public:
 
     void Render() override;
 
+    // Draw point and spot lights as meshes that cover only the pixels they can affect, instead of fullscreen
+    inline bool GetLightVolumesEnabled() const { return m_lightVolumesEnabled; }
+    inline void SetLightVolumesEnabled(bool enabled) { m_lightVolumesEnabled = enabled; }
+
+    // Depth test the light volumes against the scene, to skip the pixels that are behind them
+    // Enable it only if the target framebuffer has the depth of the G-buffer attached
+    inline bool GetDepthBoundsEnabled() const { return m_depthBoundsEnabled; }
+    inline void SetDepthBoundsEnabled(bool enabled) { m_depthBoundsEnabled = enabled; }
+
 private:
     void InitializeMeshes();
 
+    // Get the mesh and world matrix of the volume of a light. Returns false if it lights the whole screen
+    bool GetLightVolume(const Light& light, const Mesh*& mesh, glm::mat4& worldMatrix) const;
+
+    // Get the rectangle of the viewport covered by the light volume
+    // Returns false if the volume is outside of the view. fullscreen is true if the rectangle can't be computed
+    static bool GetScissorRectangle(const glm::mat4& worldViewProjMatrix, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+        const glm::ivec4& viewport, glm::ivec4& rectangle, bool& fullscreen);
+
 private:
     std::shared_ptr<Material> m_material;
+
+    // Unit sphere, for point lights
+    Mesh m_sphereMesh;
+
+    // Unit cone with the apex in the origin and the base in z = -1, for spot lights
+    Mesh m_coneMesh;
+
+    bool m_lightVolumesEnabled;
+    bool m_depthBoundsEnabled;
 };
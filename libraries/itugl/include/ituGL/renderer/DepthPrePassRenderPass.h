@@ -0,0 +1,30 @@
+#pragma once
+
+#include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/Renderer.h>
+
+#include <ituGL/shader/ShaderProgram.h>
+
+// Writes the depth of the opaque drawcalls before shading them, so the shading passes only run for the visible fragments
+// It draws the position-only VAOs of the submeshes (see ModelLoader::SetCreatePositionStreams) with a trivial shader
+// Drawcalls without that VAO, or whose material doesn't write depth with a less test, are skipped, and the shading passes lay down their depth as usual
+// The shading passes test with GL_EQUAL. GLSL only guarantees the same gl_Position in different programs if it is declared
+// invariant, so their vertex shaders must declare "invariant gl_Position;" and compute it like shaders/renderer/depth.vert
+class DepthPrePassRenderPass : public RenderPass
+{
+public:
+    DepthPrePassRenderPass(int drawcallCollectionIndex = 0);
+
+    void Render() override;
+
+    // Returns true if the pre-pass writes the depth of the drawcall: opaque, with position-only VAO, and a material that writes depth
+    // with a less or less-equal test. The pre-pass itself always draws with GL_LESS
+    static bool IsDepthPrepared(const Renderer::DrawcallInfo& drawcallInfo);
+
+private:
+    int m_drawcallCollectionIndex;
+
+    ShaderProgram m_shaderProgram;
+    ShaderProgram::Location m_worldMatrixLocation;
+    ShaderProgram::Location m_viewProjMatrixLocation;
+};
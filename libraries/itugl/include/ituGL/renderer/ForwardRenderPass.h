@@ -8,8 +8,15 @@ public:
     ForwardRenderPass();
     ForwardRenderPass(int drawcallCollectionIndex);
 
+    // Enable if a DepthPrePassRenderPass renders the same drawcalls before this pass
+    // The drawcalls with depth are then shaded with GL_EQUAL and without writing depth, even for the first light
+    bool GetDepthPrePass() const { return m_depthPrePass; }
+    void SetDepthPrePass(bool depthPrePass) { m_depthPrePass = depthPrePass; }
+
     void Render() override;
 
 private:
     int m_drawcallCollectionIndex;
+
+    bool m_depthPrePass;
 };
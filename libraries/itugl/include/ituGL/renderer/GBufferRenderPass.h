@@ -1,28 +1,66 @@
 #pragma once
 
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/texture/TextureObject.h>
 
 class Texture2DObject;
 
 class GBufferRenderPass : public RenderPass
 {
 public:
-    GBufferRenderPass(int width, int height, int drawcallCollectionIndex = 0);
+    // Formats of the g-buffer targets, and how the surface data is stored in them
+    // The shaders writing and reading the g-buffer must use the same encoding
+    struct Layout
+    {
+        enum class Encoding
+        {
+            // Albedo, view normal xy and others (AO, roughness, metalness) in separate targets
+            Default,
+            // Albedo + AO, and octahedral normal + roughness + metalness. There is no others target
+            Packed,
+        };
+
+        Encoding encoding;
+        TextureObject::InternalFormat albedoFormat;
+        TextureObject::InternalFormat normalFormat;
+        // InternalFormatInvalid if the encoding doesn't use the others target
+        TextureObject::InternalFormat othersFormat;
+
+        // SRGBA8 albedo, RG16F normal and SRGBA8 others. 12 bytes per pixel, without depth
+        static Layout GetDefault();
+
+        // SRGBA8 albedo and RGB10A2 or RGBA8 normal. 8 bytes per pixel, without depth
+        // RGB10A2 gives more precision to the normal, but only 2 bits to the metalness
+        static Layout GetPacked(TextureObject::InternalFormat normalFormat = TextureObject::InternalFormatRGB10A2);
+    };
+
+public:
+    GBufferRenderPass(int width, int height, int drawcallCollectionIndex = 0, const Layout& layout = Layout::GetDefault());
 
     void Render() override;
 
+    const Layout& GetLayout() const { return m_layout; }
+
+    // Bytes per pixel of the color targets, to compare layouts
+    int GetBytesPerPixel() const;
+
     const std::shared_ptr<Texture2DObject> GetDepthTexture() const { return m_depthTexture; }
     const std::shared_ptr<Texture2DObject> GetAlbedoTexture() const { return m_albedoTexture; }
     const std::shared_ptr<Texture2DObject> GetNormalTexture() const { return m_normalTexture; }
+    // Null if the layout doesn't use the others target
     const std::shared_ptr<Texture2DObject> GetOthersTexture() const { return m_othersTexture; }
 
 private:
     void InitTextures(int width, int height);
     void InitFramebuffer();
 
+    static std::shared_ptr<Texture2DObject> CreateTexture(int width, int height, TextureObject::InternalFormat internalFormat);
+
 private:
     int m_drawcallCollectionIndex;
 
+    Layout m_layout;
+
     std::shared_ptr<Texture2DObject> m_depthTexture;
     std::shared_ptr<Texture2DObject> m_albedoTexture;
     std::shared_ptr<Texture2DObject> m_normalTexture;
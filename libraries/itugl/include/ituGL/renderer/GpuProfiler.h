@@ -0,0 +1,91 @@
+#pragma once
+
+#include <ituGL/core/QueryObject.h>
+#include <array>
+#include <vector>
+#include <string>
+#include <span>
+#include <iosfwd>
+
+class DearImGui;
+
+// Measures the GPU time of a list of timers, like the passes of a Renderer, with GL_TIME_ELAPSED queries
+// Each timer has one query per frame in flight. The result of a query is read when it is going to be reused,
+// FrameLatency frames later, so the CPU never waits for the GPU. Results that are still not ready are dropped
+class GpuProfiler
+{
+public:
+    // Number of frames that the queries of a timer stay in flight
+    static const unsigned int FrameLatency = 3;
+
+    // Statistics of a timer over the last samples, in milliseconds
+    struct Timing
+    {
+        std::string name;
+        float lastTime = 0.0f;
+        float minTime = 0.0f;
+        float averageTime = 0.0f;
+        float maxTime = 0.0f;
+        unsigned int sampleCount = 0;
+    };
+
+public:
+    GpuProfiler(unsigned int historySize = 64);
+
+    // (C++) 4
+    // Make the object non-copyable, the queries can't be shared
+    GpuProfiler(const GpuProfiler&) = delete;
+    void operator = (const GpuProfiler&) = delete;
+
+    // Start a new frame, reading the results of the queries that are going to be reused
+    void BeginFrame();
+
+    // Measure the commands between BeginTimer and EndTimer. Timers can't be nested
+    void BeginTimer(unsigned int timerIndex, const std::string& name);
+    void EndTimer();
+
+    // Statistics of all the timers, indexed like in BeginTimer
+    std::span<const Timing> GetTimings() const { return m_timings; }
+
+    // Sum of the average times of all the timers, in milliseconds
+    float GetTotalTime() const;
+
+    // Number of samples used for min / avg / max
+    unsigned int GetHistorySize() const { return m_historySize; }
+
+    // Forget the samples collected so far
+    void ResetTimings();
+
+    // Show the timings in a window
+    void DrawGUI(DearImGui& imGui, const char* windowName = "GPU Profiler") const;
+
+    // Write the timings as a JSON object: { "frames": N, "totalTime": T, "timers": [ { "name": ..., "last": ..., "min": ..., "avg": ..., "max": ..., "samples": ... } ] }
+    void WriteJson(std::ostream& stream) const;
+
+private:
+    struct Timer
+    {
+        std::array<QueryObject, FrameLatency> queries;
+
+        // If the query in each slot was issued and not read yet
+        std::array<bool, FrameLatency> pending = {};
+
+        // Ring buffer with the last samples
+        std::vector<float> history;
+        unsigned int historyIndex = 0;
+    };
+
+    void AddSample(unsigned int timerIndex, float time);
+
+private:
+    std::vector<Timer> m_timers;
+    std::vector<Timing> m_timings;
+
+    unsigned int m_historySize;
+
+    // Frames started, used to select the query slot
+    unsigned long long m_frameCount;
+
+    // Timer being measured, or -1
+    int m_activeTimer;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
+#include <span>
+
+class Light;
+class ThreadPool;
+
+// Grid of clusters that slice the camera frustum, with the list of lights that can affect each cluster
+// Tiles split the screen in X and Y, and depth slices grow exponentially with the distance, so clusters are roughly cubic.
+// Lights with a range (point and spot) are added to the clusters their bounding sphere overlaps.
+// Lights without a range (directional) affect all the clusters, so they are kept apart as global lights.
+// It is built on the CPU, one depth slice per job, and the result is ready to be uploaded to buffers
+class LightGrid
+{
+public:
+    // Light data as 4 texels: position and type, color and intensity, direction, attenuation (like Light::GetAttenuation)
+    struct LightData
+    {
+        glm::vec4 position;
+        glm::vec4 color;
+        glm::vec4 direction;
+        glm::vec4 attenuation;
+    };
+
+public:
+    LightGrid(const glm::uvec3& gridSize = glm::uvec3(16, 9, 24));
+
+    inline const glm::uvec3& GetGridSize() const { return m_gridSize; }
+    inline unsigned int GetClusterCount() const { return m_gridSize.x * m_gridSize.y * m_gridSize.z; }
+
+    // Assign the lights to the clusters of the frustum of a perspective camera
+    void Build(const glm::mat4& viewMatrix, const glm::mat4& projMatrix, std::span<const Light* const> lights, ThreadPool* threadPool = nullptr);
+
+    // Data of all the lights: first the global ones, then the ones with range
+    inline std::span<const LightData> GetLightData() const { return m_lightData; }
+    inline unsigned int GetGlobalLightCount() const { return m_globalLightCount; }
+
+    // Offset and count in the light index list of each cluster. Index is x + (y + z * sizeY) * sizeX
+    inline std::span<const glm::uvec2> GetClusterRanges() const { return m_clusterRanges; }
+
+    // Indices in the light data, of the lights in each cluster
+    inline std::span<const unsigned int> GetLightIndices() const { return m_lightIndices; }
+
+    // Scale and bias to get the depth slice from the view depth: slice = log(depth) * scale + bias
+    inline const glm::vec2& GetDepthSliceParams() const { return m_depthSliceParams; }
+
+private:
+    // Assign the lights to the clusters of one depth slice
+    void BuildSlice(unsigned int slice);
+
+private:
+    glm::uvec3 m_gridSize;
+
+    // Near and far planes of the camera, and distance of the first slice
+    float m_nearDistance;
+    float m_farDistance;
+    glm::vec2 m_depthSliceParams;
+
+    // View direction of the corners of each tile, scaled to depth 1
+    std::vector<glm::vec3> m_tileCorners;
+
+    std::vector<LightData> m_lightData;
+    unsigned int m_globalLightCount;
+
+    // Bounding sphere (view space) and tile rectangle of the lights with range
+    struct LocalLight
+    {
+        glm::vec3 viewPosition;
+        float range;
+        glm::uvec2 minTile;
+        glm::uvec2 maxTile;
+    };
+    std::vector<LocalLight> m_localLights;
+
+    // Work data of each slice: lights overlapping its depth range, and light lists before merging
+    struct Slice
+    {
+        std::vector<unsigned int> candidateLights;
+        std::vector<unsigned int> lightIndices;
+    };
+    std::vector<Slice> m_slices;
+
+    std::vector<glm::uvec2> m_clusterRanges;
+    std::vector<unsigned int> m_lightIndices;
+};
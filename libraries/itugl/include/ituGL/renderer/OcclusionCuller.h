@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
+#include <array>
+#include <span>
+#include <cstdint>
+
+class ThreadPool;
+
+// Simplified geometry of an object that hides what is behind it (walls, floors, big props...)
+// It stays in client memory, because the occlusion culler rasterizes it on the CPU
+struct OccluderMesh
+{
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> indices;
+};
+
+// Occlusion culling done fully on the CPU, so it doesn't need to read anything back from the GPU
+// The occluders are rasterized in a small depth buffer, split in tiles that are rasterized in parallel.
+// Then, a pyramid with the min and max depth of each block of pixels is built, and the screen rectangle of each
+// box is tested against it: if the box is further than the max depth of all the pixels it covers, it is hidden
+class OcclusionCuller
+{
+public:
+    OcclusionCuller(unsigned int width = 256, unsigned int height = 128);
+
+    inline unsigned int GetWidth() const { return m_width; }
+    inline unsigned int GetHeight() const { return m_height; }
+
+    // Forget the occluders added
+    void Reset();
+
+    // Add a mesh to be rasterized. It is referenced, not copied, so it must be kept alive until the culling is done
+    void AddOccluder(const OccluderMesh& occluder, const glm::mat4& worldMatrix);
+    inline unsigned int GetOccluderCount() const { return static_cast<unsigned int>(m_occluders.size()); }
+
+    // Rasterize the occluders seen with the view projection matrix, and build the depth pyramid
+    // If a thread pool is provided, the tiles are rasterized in parallel
+    void Rasterize(const glm::mat4& viewProjMatrix, ThreadPool* threadPool = nullptr);
+
+    // Check if a world AABB can be visible. Boxes crossing the near plane are always visible
+    bool IsVisible(const glm::vec3& center, const glm::vec3& size) const;
+
+    // Test many AABBs stored as structure of arrays. Only the ones with visible != 0 are tested, the hidden ones are set to 0
+    void TestAabbs(const std::array<std::span<const float>, 3>& centers, const std::array<std::span<const float>, 3>& sizes,
+        std::span<std::uint8_t> visible, ThreadPool* threadPool = nullptr) const;
+
+    // Depth of each pixel after rasterizing, from 0 (near) to 1 (far, or empty). Rows start from the bottom
+    inline std::span<const float> GetDepthBuffer() const { return m_pyramid[0].maxDepth; }
+
+    inline unsigned int GetPyramidLevelCount() const { return static_cast<unsigned int>(m_pyramid.size()); }
+
+private:
+    // Triangle already projected to pixel coordinates and depth in [0, 1]
+    struct ScreenTriangle
+    {
+        glm::vec3 vertices[3];
+    };
+
+    // Transform the triangles of an occluder, clip them against the near plane and project them
+    void AddScreenTriangles(const OccluderMesh& occluder, const glm::mat4& worldViewProjMatrix);
+    void AddScreenTriangle(const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2);
+
+    // Rasterize the triangles that overlap a tile, writing only inside the tile
+    void RasterizeTile(unsigned int tileIndex);
+    void RasterizeTriangle(const ScreenTriangle& triangle, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY);
+
+    // Build the coarser levels of the pyramid from the depth buffer
+    void BuildPyramid();
+
+    // Check if any texel of the level inside the pixel rectangle is further than depth, refining in the finer levels
+    bool IsRegionVisible(unsigned int level, int minX, int minY, int maxX, int maxY, float depth) const;
+
+private:
+    unsigned int m_width;
+    unsigned int m_height;
+
+    struct Occluder
+    {
+        const OccluderMesh* mesh;
+        glm::mat4 worldMatrix;
+    };
+    std::vector<Occluder> m_occluders;
+
+    glm::mat4 m_viewProjMatrix;
+
+    std::vector<ScreenTriangle> m_triangles;
+
+    // Indices of the triangles overlapping each tile
+    unsigned int m_tileCountX;
+    unsigned int m_tileCountY;
+    std::vector<std::vector<unsigned int>> m_tileBins;
+
+    // Level 0 is the depth buffer, only in maxDepth. Each other level has half the size of the previous one
+    struct PyramidLevel
+    {
+        unsigned int width;
+        unsigned int height;
+        std::vector<float> minDepth;
+        std::vector<float> maxDepth;
+    };
+    std::vector<PyramidLevel> m_pyramid;
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <ituGL/texture/TextureObject.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/texture/RenderTargetPool.h>
+#include <memory>
+#include <vector>
+#include <string>
+
+class Renderer;
+class RenderPass;
+class Material;
+class Texture2DObject;
+class FramebufferObject;
+
+// Builds the render passes of a Renderer from passes that declare which textures they read and write
+// When compiled, the graph:
+// - Culls the passes whose outputs are not read by any other pass, and don't write imported textures or have side effects
+// - Computes the lifetime of the transient textures, and shares the same texture between the ones that don't overlap
+//   The textures are acquired from the RenderTargetPool of the renderer, so compiling a graph again reuses them
+// - Creates the framebuffers of each pass, sharing them between passes with the same attachments
+// Passes run in the order they were added, that must be an order where textures are written before they are read
+class RenderGraph
+{
+public:
+    // Identifies a version of a texture. Each write creates a new version
+    using ResourceId = int;
+    static const ResourceId InvalidResource = -1;
+
+    // Description of the transient textures. Only textures with the same description can share storage
+    struct TextureDesc
+    {
+        int width;
+        int height;
+        TextureObject::Format format;
+        TextureObject::InternalFormat internalFormat;
+
+        bool operator == (const TextureDesc& other) const = default;
+    };
+
+    // Declares the resources used by a pass, returned by AddPass
+    class PassBuilder
+    {
+    public:
+        // Read a texture. If a material is given, the texture is set in its uniform before the pass renders
+        void Read(ResourceId resource);
+        void Read(ResourceId resource, std::shared_ptr<Material> material, const char* uniformName);
+
+        // Write a texture as the next color attachment. Returns the new version, that later passes must read
+        // To draw on top of the previous contents, read the previous version too
+        ResourceId Write(ResourceId resource);
+
+        // Use a texture as depth attachment. It is not written, the depth of the texture is only tested
+        void SetDepth(ResourceId resource);
+
+        // Never cull the pass. For passes with effects that the graph doesn't see, like writing buffers or images
+        void SetSideEffects();
+
+        // Set the name of the pass, shown in the profiler
+        void SetName(const std::string& name);
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, int passIndex);
+
+        RenderGraph& m_graph;
+        int m_passIndex;
+    };
+
+public:
+    RenderGraph();
+    ~RenderGraph();
+
+    // (C++) 4
+    // Make the object non-copyable, it owns the passes until it is compiled
+    RenderGraph(const RenderGraph&) = delete;
+    void operator = (const RenderGraph&) = delete;
+
+    // Add a texture created outside of the graph. Passes that write it are never culled
+    ResourceId ImportTexture(std::shared_ptr<Texture2DObject> texture);
+
+    // Add the default framebuffer. Passes that write it are never culled
+    ResourceId ImportBackbuffer();
+
+    // Add a texture that only lives in the graph. Its storage is allocated when the graph is compiled
+    ResourceId CreateTexture(const TextureDesc& desc);
+
+    // Add a pass, that must not have a target framebuffer. Use the builder to declare its resources
+    PassBuilder AddPass(std::unique_ptr<RenderPass> renderPass);
+
+    // Acquire the textures and create the framebuffers, and add the passes that are not culled to the renderer
+    // The graph can't be modified after this
+    void Compile(Renderer& renderer);
+
+    // Statistics of the last compilation
+    inline unsigned int GetPassCount() const { return static_cast<unsigned int>(m_passes.size()); }
+    inline unsigned int GetCulledPassCount() const { return m_culledPassCount; }
+    inline unsigned int GetTransientTextureCount() const { return m_transientTextureCount; }
+    inline unsigned int GetAllocatedTextureCount() const { return m_allocatedTextureCount; }
+
+private:
+    class CompiledPass;
+
+    struct Texture
+    {
+        TextureDesc desc;
+
+        // Storage of the texture. Null for the backbuffer, and for transient textures until compiled
+        std::shared_ptr<Texture2DObject> texture;
+
+        // Render target that owns the storage of transient textures
+        std::shared_ptr<const RenderTargetPool::RenderTarget> renderTarget;
+
+        bool imported;
+        bool backbuffer;
+
+        // Last version, the only one that can be written
+        ResourceId lastVersion;
+
+        // First and last passes that use the texture, -1 if unused
+        int firstPass;
+        int lastPass;
+    };
+
+    struct Binding
+    {
+        ResourceId resource;
+        std::shared_ptr<Material> material;
+        ShaderProgram::Location location;
+    };
+
+    struct Pass
+    {
+        std::unique_ptr<RenderPass> renderPass;
+        std::vector<ResourceId> reads;
+        std::vector<ResourceId> writes;
+        std::vector<Binding> bindings;
+        ResourceId depth;
+        bool sideEffects;
+        bool culled;
+    };
+
+private:
+    ResourceId AddVersion(int textureIndex);
+
+    void CullPasses();
+    void ComputeLifetimes();
+    void AllocateTextures(RenderTargetPool& renderTargetPool);
+    std::shared_ptr<const FramebufferObject> GetFramebuffer(const Pass& pass, const Renderer& renderer);
+
+    inline Texture& GetTexture(ResourceId resource) { return m_textures[m_versions[resource]]; }
+
+private:
+    std::vector<Texture> m_textures;
+
+    // Index of the texture of each version
+    std::vector<int> m_versions;
+
+    std::vector<Pass> m_passes;
+
+    // Framebuffers created, and the color and depth textures attached to them
+    struct Framebuffer
+    {
+        std::vector<const Texture2DObject*> colors;
+        const Texture2DObject* depth;
+        std::shared_ptr<FramebufferObject> framebuffer;
+    };
+    std::vector<Framebuffer> m_framebuffers;
+
+    bool m_compiled;
+    unsigned int m_culledPassCount;
+    unsigned int m_transientTextureCount;
+    unsigned int m_allocatedTextureCount;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 class Renderer;
 class FramebufferObject;
@@ -13,6 +14,10 @@ public:
 
     std::shared_ptr<const FramebufferObject> GetTargetFramebuffer() const;
 
+    // Name used to identify the pass in the profiler
+    const std::string& GetName() const;
+    void SetName(const std::string& name);
+
     virtual void Render() = 0;
 
 protected:
@@ -22,8 +27,12 @@ protected:
 protected:
     std::shared_ptr<const FramebufferObject> m_targetFramebuffer;
 
+private:
+    std::string m_name;
+
 private:
     friend class Renderer;
+    friend class RenderGraph;
     void SetRenderer(Renderer* renderer);
 
 private:
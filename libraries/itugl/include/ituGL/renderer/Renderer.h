@@ -4,12 +4,23 @@
 #include <ituGL/renderer/RenderPass.h>
 #include <ituGL/geometry/Drawcall.h>
 #include <ituGL/geometry/Mesh.h>
+#include <ituGL/geometry/VertexBufferObject.h>
+#include <ituGL/geometry/DrawIndirectBufferObject.h>
+#include <ituGL/shader/UniformBufferObject.h>
+#include <ituGL/shader/ShaderStorageBufferObject.h>
+#include <ituGL/renderer/OcclusionCuller.h>
+#include <ituGL/utils/FrameArena.h>
+#include <ituGL/utils/ThreadPool.h>
+#include <ituGL/texture/RenderTargetPool.h>
+#include <ituGL/renderer/GpuProfiler.h>
+#include <ituGL/renderer/CommandList.h>
 #include <glm/mat4x4.hpp>
 #include <vector>
-#include <unordered_map>
 #include <memory>
+#include <array>
 #include <span>
 #include <functional>
+#include <cstdint>
 
 class Camera;
 class Light;
@@ -25,18 +36,55 @@ class Renderer
 public:
     struct DrawcallInfo
     {
-        DrawcallInfo(const Material& material, unsigned int worldMatrixIndex, const VertexArrayObject& vao, const Drawcall& drawcall)
-            : material(material), worldMatrixIndex(worldMatrixIndex), vao(vao), drawcall(drawcall)
+        DrawcallInfo(const Material& material, const ShaderProgram& shaderProgram, unsigned int worldMatrixIndex,
+            const VertexArrayObject& vao, const VertexArrayObject* positionVao, const Drawcall& drawcall)
+            : material(material), shaderProgram(shaderProgram), worldMatrixIndex(worldMatrixIndex), vao(vao), positionVao(positionVao), drawcall(drawcall), sortKey(0)
         {
         }
 
         const Material& material;
+        // Shader program of the material, borrowed without touching its reference count. The material keeps it alive
+        const ShaderProgram& shaderProgram;
         unsigned int worldMatrixIndex;
         const VertexArrayObject& vao;
+        // VAO with only the positions, for depth-only passes. Null if the submesh doesn't have one
+        const VertexArrayObject* positionVao;
         const Drawcall& drawcall;
+
+        // Packed key used to order the drawcalls before rendering. Computed in Renderer::SortDrawcalls
+        // Opaque:  [queue:2][shader program:16][material:16][VAO:16][depth:14] (front to back)
+        // Blended: [queue:2][inverted depth:14][shader program:16][material:16][VAO:16] (back to front)
+        uint64_t sortKey;
+    };
+
+    // A collection is a list of indices in the drawcall array, with the drawcalls that a pass wants to render
+    // Drawcalls only live during one frame, so they are allocated in the frame arena
+    using DrawcallCollection = std::pmr::vector<unsigned int>;
+
+    // Decides if a drawcall belongs to a collection
+    using DrawcallPredicate = std::function<bool(const DrawcallInfo&)>;
+
+    // Consecutive drawcalls sharing material and VAO, rendered with a single instanced draw or multi-draw
+    struct DrawcallBatch
+    {
+        // First drawcall of the batch, used to set up the states
+        const DrawcallInfo* drawcallInfo;
+
+        // Range of the world matrices in the instance buffer. If instanceCount is 0, the batch is not instanced
+        unsigned int firstInstance;
+        unsigned int instanceCount;
+
+        // Range of the commands in the indirect buffer. If commandCount is 0, the batch uses a single drawcall
+        unsigned int firstCommand;
+        unsigned int commandCount;
     };
 
-    using DrawcallCollection = std::vector<DrawcallInfo>;
+    // Binding points of the blocks shared by all the shader programs. Shaders opt in by declaring blocks with these names
+    // CameraBlock: uniform block with the camera matrices, uploaded once per frame
+    // WorldMatrixBlock: shader storage block with all the world matrices, indexed with the WorldMatrixIndex uniform (OpenGL 4.3)
+    //                   Only uploaded once a program declaring it has been found
+    static const GLuint CameraBlockBinding = 0;
+    static const GLuint WorldMatrixBlockBinding = 0;
 
     using UpdateTransformsFunction = std::function<void(const ShaderProgram&, const glm::mat4&, const Camera&, bool)>;
     using UpdateLightsFunction = std::function<bool(const ShaderProgram&, std::span<const Light* const>, unsigned int&)>;
@@ -60,30 +108,182 @@ public:
     std::span<const Light* const> GetLights() const;
     void AddLight(const Light& light);
 
-    std::span<const DrawcallInfo> GetDrawcalls(unsigned int collectionIndex) const;
+    // Add a collection with the drawcalls accepted by the predicate, or all of them if it is null. Returns its index
+    // Collection 0 always exists, and contains all the drawcalls
+    unsigned int AddDrawcallCollection(const DrawcallPredicate& predicate);
+    static bool IsOpaqueDrawcall(const DrawcallInfo& drawcallInfo);
+    static bool IsBlendedDrawcall(const DrawcallInfo& drawcallInfo);
+
+    std::span<const DrawcallInfo> GetDrawcalls() const;
+    inline const glm::mat4& GetWorldMatrix(unsigned int worldMatrixIndex) const { return m_worldMatrices[worldMatrixIndex]; }
+    std::span<const unsigned int> GetDrawcallIndices(unsigned int collectionIndex) const;
+    std::span<const DrawcallBatch> GetDrawcallBatches(unsigned int collectionIndex) const;
     void AddModel(const Model& model, const glm::mat4& worldMatrix);
 
+    // Add a mesh that hides the drawcalls behind it. It must be kept alive until Render()
+    void AddOccluder(const OccluderMesh& occluder, const glm::mat4& worldMatrix);
+
     const Mesh& GetFullscreenMesh() const;
 
     void RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
         const UpdateTransformsFunction& updateTransformFunction,
         const UpdateLightsFunction& updateLightsFunction);
 
-    void UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, const glm::mat4& worldMatrix, bool cameraChanged = true) const;
-    void UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, unsigned int worldMatrixIndex, bool cameraChanged = true) const;
+    // Register a program with the standard transforms instead of a function. Only the uniforms it declares are set:
+    // WorldMatrix, WorldViewMatrix, WorldViewProjMatrix, ViewProjMatrix and CameraPosition
+    // The renderer computes them itself, so the command lists record their values instead of calling a function
+    void RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
+        const UpdateLightsFunction& updateLightsFunction);
 
-    UpdateLightsFunction GetDefaultUpdateLightsFunction(const ShaderProgram& shaderProgram);
-    bool UpdateLights(std::shared_ptr<const ShaderProgram> shaderProgramPtr, std::span<const Light* const> lights, unsigned int& lightIndex) const;
+    // Call the functions registered for the shader program, or set its standard transforms. They are found with the id of the program, without hashing
+    void UpdateTransforms(const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, bool cameraChanged = true) const;
+    void UpdateTransforms(const ShaderProgram& shaderProgram, unsigned int worldMatrixIndex, bool cameraChanged = true) const;
 
+    // Update one light per pass in the LightColor, LightPosition, LightDirection and LightAttenuation uniforms
+    // If the shader declares the arrays of the batched version, the batched function is returned instead
+    UpdateLightsFunction GetDefaultUpdateLightsFunction(const ShaderProgram& shaderProgram);
+    // Update up to K lights per pass in the LightColors, LightPositions, LightDirections and LightAttenuations arrays,
+    // and the number of lights in LightCount. K is the size of the arrays declared in the shader
+    UpdateLightsFunction GetBatchedUpdateLightsFunction(const ShaderProgram& shaderProgram);
+    bool UpdateLights(const ShaderProgram& shaderProgram, std::span<const Light* const> lights, unsigned int& lightIndex) const;
+
+    // Enable / disable sorting the drawcall collections by state before the passes are rendered
+    bool GetSortDrawcalls() const { return m_sortDrawcalls; }
+    void SetSortDrawcalls(bool sortDrawcalls) { m_sortDrawcalls = sortDrawcalls; }
+
+    // Enable / disable merging drawcalls into instanced batches. Shaders opt in by declaring the InstanceWorldMatrix attribute
+    bool GetInstancingEnabled() const { return m_instancingEnabled; }
+    void SetInstancingEnabled(bool instancingEnabled) { m_instancingEnabled = instancingEnabled; }
+
+    // Enable / disable merging different drawcalls with the same material and VAO (like a GeometryArena) in a single multi-draw
+    // Only used for instanced shaders, and if glMultiDrawElementsIndirect is supported
+    bool GetMultiDrawEnabled() const { return m_multiDrawEnabled; }
+    void SetMultiDrawEnabled(bool multiDrawEnabled) { m_multiDrawEnabled = multiDrawEnabled; }
+
+    // Enable / disable removing the drawcalls outside of the camera frustum before rendering
+    bool GetCullingEnabled() const { return m_cullingEnabled; }
+    void SetCullingEnabled(bool cullingEnabled) { m_cullingEnabled = cullingEnabled; }
+    unsigned int GetCulledDrawcallCount() const { return m_culledDrawcallCount; }
+
+    // Enable / disable removing the drawcalls hidden behind the occluders. Only done if frustum culling is enabled
+    bool GetOcclusionCullingEnabled() const { return m_occlusionCullingEnabled; }
+    void SetOcclusionCullingEnabled(bool occlusionCullingEnabled) { m_occlusionCullingEnabled = occlusionCullingEnabled; }
+    unsigned int GetOccludedDrawcallCount() const { return m_occludedDrawcallCount; }
+    const OcclusionCuller& GetOcclusionCuller() const { return m_occlusionCuller; }
+
+    // Workers for the parallel tasks of the renderer and its passes
+    ThreadPool& GetThreadPool() { return m_threadPool; }
+
+    // Render targets shared by the passes. Free render targets are deleted after a few frames without use
+    RenderTargetPool& GetRenderTargetPool() { return m_renderTargetPool; }
+    const RenderTargetPool& GetRenderTargetPool() const { return m_renderTargetPool; }
+
+    // Enable / disable measuring the GPU time of each pass with timer queries
+    bool GetGpuProfilingEnabled() const { return m_gpuProfilingEnabled; }
+    void SetGpuProfilingEnabled(bool gpuProfilingEnabled) { m_gpuProfilingEnabled = gpuProfilingEnabled; }
+
+    // GPU time of each pass, indexed like the passes. The results are a few frames old
+    GpuProfiler& GetGpuProfiler() { return m_gpuProfiler; }
+    const GpuProfiler& GetGpuProfiler() const { return m_gpuProfiler; }
+
+    // Arena with all the per-frame data of the renderer. Useful to check its high-water mark
+    const FrameArena& GetFrameArena() const { return m_frameArena; }
+
+    // Set up the states for a drawcall, skipping the material, transforms and VAO if they didn't change since the last one
     void PrepareDrawcall(const DrawcallInfo& drawcallInfo);
 
-    void SetLightingRenderStates(bool firstPass);
+    // Set up the states for a batch, including the instance attributes if needed, and draw it
+    void PrepareDrawcall(const DrawcallBatch& drawcallBatch);
+    void Draw(const DrawcallBatch& drawcallBatch) const;
+
+    // Record the states and draws of a range of batches, like PrepareDrawcall and Draw. The list starts with no states set
+    // It only reads the renderer, so several ranges can be recorded at the same time on different threads
+    void RecordDrawcallBatches(unsigned int collectionIndex, unsigned int firstBatch, unsigned int batchCount, CommandList& commandList) const;
+
+    // Prepare and draw all the batches of a collection. With parallel recording, slices of the batches are recorded
+    // in command lists on the thread pool, and then executed in order on this thread
+    void DrawDrawcallBatches(unsigned int collectionIndex);
+
+    // Enable / disable recording the batches on the thread pool in DrawDrawcallBatches
+    bool GetParallelRecordingEnabled() const { return m_parallelRecordingEnabled; }
+    void SetParallelRecordingEnabled(bool parallelRecordingEnabled) { m_parallelRecordingEnabled = parallelRecordingEnabled; }
+
+    // Forget the states cached by PrepareDrawcall. Needed when something else changes them (other passes, direct GL calls...)
+    void InvalidateDrawcallStates();
+
+    // Set the render states for the first and additional lights. If the depth is already in the buffer, like after
+    // a depth pre-pass, all the passes only shade the visible surface and don't write depth
+    void SetLightingRenderStates(bool firstPass, bool depthPrepared = false);
 
     void Render();
 
 private:
     void Reset();
 
+    // Upload the data shared by all the drawcalls of the frame: camera block and world matrices
+    void UploadFrameData();
+    void UploadWorldMatrices();
+
+    // Remove the drawcalls with world bounds outside of the camera frustum, or hidden by the occluders
+    void CullDrawcalls();
+
+    // Compute the sort keys of all the drawcalls and sort them
+    void SortDrawcalls();
+    uint64_t ComputeSortKey(const DrawcallInfo& drawcallInfo) const;
+
+    // Fill the index list of each collection, keeping the order of the drawcalls
+    void FilterDrawcalls();
+
+    // Group the drawcalls of each collection in batches, and upload the world matrices of the instanced ones
+    void BuildDrawcallBatches();
+
+    // Locations used by the renderer in each shader program. The first time a program is found, its blocks are bound
+    struct ShaderProgramInfo
+    {
+        // Location of the InstanceWorldMatrix attribute, or -1 if it doesn't opt in to instancing
+        GLint instanceAttributeLocation;
+        // Location of the WorldMatrixIndex uniform, or -1 if it doesn't read the world matrices from the WorldMatrixBlock
+        GLint worldMatrixIndexLocation;
+    };
+    const ShaderProgramInfo& GetShaderProgramInfo(const ShaderProgram& shaderProgram);
+
+    // Get the info of a program that was already found. Safe to call from worker threads
+    const ShaderProgramInfo& FindShaderProgramInfo(const ShaderProgram& shaderProgram) const;
+
+    // Locations of the standard transform uniforms, or -1 if the program doesn't declare them
+    struct TransformLocations
+    {
+        GLint worldMatrix;
+        GLint worldViewMatrix;
+        GLint worldViewProjMatrix;
+        GLint viewProjMatrix;
+        GLint cameraPosition;
+    };
+
+    // Compute the standard transforms that the program declares, and pass each one to setUniform(location, value)
+    template<typename SetUniformFunction>
+    void SetStandardTransforms(const TransformLocations& locations, const glm::mat4& worldMatrix, bool cameraChanged, SetUniformFunction setUniform) const;
+
+    // Everything the renderer knows about a shader program, in a table indexed by the program id
+    struct ShaderProgramEntry
+    {
+        // Functions set by RegisterShaderProgram. The program is kept alive, like the functions usually do with their captures
+        std::shared_ptr<const ShaderProgram> shaderProgram;
+        UpdateTransformsFunction updateTransformsFunction;
+        UpdateLightsFunction updateLightsFunction;
+
+        // Set if it was registered with the standard transforms, used when there is no function
+        bool standardTransforms = false;
+        TransformLocations transformLocations;
+
+        // Locations, filled the first time the program is found
+        bool hasInfo = false;
+        ShaderProgramInfo info;
+    };
+
+    // Get the entry of a program, or null if it never reached the renderer
+    const ShaderProgramEntry* FindShaderProgramEntry(const ShaderProgram& shaderProgram) const;
+
     void InitializeFullscreenMesh();
 
 private:
@@ -96,14 +296,104 @@ private:
     std::shared_ptr<const FramebufferObject> m_defaultFramebuffer;
     std::shared_ptr<const FramebufferObject> m_currentFramebuffer;
 
-    std::vector<const Light*> m_lights;
+    // Memory for all the data that is submitted every frame. Reset at the end of Render()
+    FrameArena m_frameArena;
+
+    std::pmr::vector<const Light*> m_lights;
+
+    std::pmr::vector<glm::mat4> m_worldMatrices;
 
-    std::vector<glm::mat4> m_worldMatrices;
+    // All the drawcalls submitted this frame
+    std::pmr::vector<DrawcallInfo> m_drawcalls;
 
     std::vector<DrawcallCollection> m_drawcallCollections;
+    std::vector<DrawcallPredicate> m_drawcallPredicates;
+
+    // World AABB of each drawcall, as a structure of arrays to test them with SIMD: center x, y, z and size x, y, z
+    std::array<std::pmr::vector<float>, 6> m_drawcallBounds;
+    std::pmr::vector<std::uint8_t> m_drawcallVisibility;
+
+    // Frustum culling
+    bool m_cullingEnabled;
+    unsigned int m_culledDrawcallCount;
+
+    // Occlusion culling, with the occluders rasterized on the CPU
+    bool m_occlusionCullingEnabled;
+    unsigned int m_occludedDrawcallCount;
+    OcclusionCuller m_occlusionCuller;
+
+    // Workers for the parallel tasks of the renderer
+    ThreadPool m_threadPool;
+
+    // Record the drawcall batches on the workers, in one command list per slice
+    bool m_parallelRecordingEnabled;
+    std::vector<CommandList> m_commandLists;
+
+    // Smaller slices don't make up for the cost of waking up the workers
+    static const unsigned int MinBatchesPerCommandList = 64;
+
+    // Render targets used by the passes
+    RenderTargetPool m_renderTargetPool;
+
+    // Timer queries around each pass
+    bool m_gpuProfilingEnabled;
+    GpuProfiler m_gpuProfiler;
+
+    // Sort drawcalls before rendering
+    bool m_sortDrawcalls;
+
+    // Scratch buffers reused every frame to sort the drawcalls
+    struct SortEntry
+    {
+        uint64_t key;
+        unsigned int index;
+    };
+    std::pmr::vector<SortEntry> m_sortEntries;
+    std::pmr::vector<SortEntry> m_sortEntriesScratch;
+    std::pmr::vector<DrawcallInfo> m_sortedDrawcalls;
+
+    // Batches of each drawcall collection
+    std::vector<std::pmr::vector<DrawcallBatch>> m_drawcallBatches;
+
+    // Merge drawcalls into instanced batches
+    bool m_instancingEnabled;
+
+    // World matrices of the instanced batches, uploaded once per frame
+    std::pmr::vector<glm::mat4> m_instanceWorldMatrices;
+    VertexBufferObject m_instanceBuffer;
+
+    // Merge drawcalls into multi-draw batches
+    bool m_multiDrawEnabled;
+
+    // Commands of the multi-draw batches, uploaded once per frame
+    std::pmr::vector<Drawcall::IndirectCommand> m_indirectCommands;
+    DrawIndirectBufferObject m_indirectBuffer;
+
+    // Camera matrices, following the std140 layout of the CameraBlock
+    struct CameraBlock
+    {
+        glm::mat4 viewMatrix;
+        glm::mat4 projMatrix;
+        glm::mat4 viewProjMatrix;
+        glm::mat4 invViewMatrix;
+        glm::mat4 invProjMatrix;
+        glm::mat4 invViewProjMatrix;
+        glm::vec4 cameraPosition;
+    };
+    UniformBufferObject m_cameraBuffer;
+
+    // All the world matrices of the frame, if shader storage buffers are supported and some program reads them
+    ShaderStorageBufferObject m_worldMatrixBuffer;
+    bool m_worldMatrixBlockUsed;
+
+    // Entries of the shader programs, by id. Ids are small and never reused, so the table stays dense
+    std::vector<ShaderProgramEntry> m_shaderProgramEntries;
 
-    std::unordered_map<std::shared_ptr<const ShaderProgram>, UpdateTransformsFunction> m_updateTransformsFunctions;
-    std::unordered_map<std::shared_ptr<const ShaderProgram>, UpdateLightsFunction> m_updateLightsFunctions;
+    // States set by the last PrepareDrawcall, to skip redundant changes
+    const Material* m_lastMaterial;
+    const ShaderProgram* m_lastShaderProgram;
+    const VertexArrayObject* m_lastVao;
+    unsigned int m_lastWorldMatrixIndex;
 
     Mesh m_fullscreenMesh;
 
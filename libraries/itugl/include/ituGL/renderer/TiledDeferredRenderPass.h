@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/GBufferRenderPass.h>
+#include <ituGL/renderer/LightGrid.h>
+#include <ituGL/shader/ShaderStorageBufferObject.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <vector>
+
+class Texture2DObject;
+class Material;
+
+// Deferred lighting of all the lights in a single compute dispatch, instead of one draw per light like DeferredRenderPass
+// Each work group shades a tile of TileSize x TileSize pixels: it finds the depth range of the tile, culls the lights against
+// the tile frustum into a list in shared memory, and lights its pixels with that list. The G-buffer is read once per pixel.
+// The material has the compute shader and the G-buffer textures. The shader declares the uniforms LightCount and TargetImage,
+// the storage block LightBlock and the CameraBlock of the renderer, so it must be registered with the renderer too.
+// The lit pixels are stored in the target texture, that must be RGBA16F and cover the viewport (OpenGL 4.3)
+class TiledDeferredRenderPass : public RenderPass
+{
+public:
+    TiledDeferredRenderPass(std::shared_ptr<Material> material, std::shared_ptr<Texture2DObject> targetTexture);
+
+    void Render() override;
+
+    // Size in pixels of the tiles. It must match the local size of the compute shader
+    static constexpr unsigned int TileSize = 16;
+
+    // Binding point of the light storage block, after the world matrices of the renderer
+    static const GLuint LightBlockBinding = 1;
+
+    // Image unit of the target texture
+    static const GLuint TargetImageUnit = 0;
+
+    // Compute shaders and image load/store are core in OpenGL 4.3
+    static bool IsSupported();
+
+    // Build the material from the shaders in the application folder, decoding the G-buffer layout
+    // The shader program is registered with the renderer, to get the camera block
+    static std::shared_ptr<Material> CreateMaterial(Renderer& renderer, const GBufferRenderPass::Layout& gbufferLayout);
+
+private:
+    // Upload the data of all the lights, in the order of the renderer
+    void UploadLights();
+
+private:
+    std::shared_ptr<Material> m_material;
+
+    std::shared_ptr<Texture2DObject> m_targetTexture;
+
+    // Same layout as the light data of the light grid: position, color, direction and attenuation
+    std::vector<LightGrid::LightData> m_lightData;
+    ShaderStorageBufferObject m_lightBuffer;
+
+    ShaderProgram::Location m_lightCountLocation;
+    ShaderProgram::Location m_targetImageLocation;
+};
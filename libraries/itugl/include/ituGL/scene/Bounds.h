@@ -1,7 +1,13 @@
 #pragma once
 
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <array>
+#include <span>
+#include <cstdint>
+#include <cassert>
 
 class Bounds
 {
@@ -103,21 +109,32 @@ private:
     glm::vec3 m_size;
 };
 
-class FrustumBounds : public RotatedBounds
+class FrustumBounds : public Bounds
 {
 public:
-    FrustumBounds(const glm::vec3& center, const glm::vec3& size);
+    // Extract the 6 clipping planes from a view projection matrix. The center is the center of the 8 corners
+    FrustumBounds(const glm::mat4& viewProjMatrix);
 
     inline Type GetType() const override { return Type::Frustum; }
 
+    // Planes are stored as (normal, distance), with the normal pointing inside and normalized
+    // Order: left, right, bottom, top, near, far
+    inline const glm::vec4& GetPlane(int index) const { return m_planes[index]; }
+
+    // Test many AABBs at once, stored as a structure of arrays: centers and sizes of each axis
+    // visible[i] is set to 1 if the box i intersects the frustum, 0 otherwise. Uses SIMD if available
+    void IntersectsAabbs(const std::array<std::span<const float>, 3>& centers, const std::array<std::span<const float>, 3>& sizes,
+        std::span<std::uint8_t> visible) const;
+
 private:
+    std::array<glm::vec4, 6> m_planes;
 };
 
 
 template<typename T>
 bool Bounds::Intersects(const T& other) const
 {
-    Bounds::Intersects(this, other);
+    return Bounds::Intersects(*this, other);
 }
 
 template<typename TA, typename TB>
@@ -144,6 +161,8 @@ bool Bounds::Intersects(const Bounds& boundsA, const TB& boundsB)
         return Bounds::Intersects(static_cast<const AabbBounds&>(boundsA), boundsB);
     case Type::Box:
         return Bounds::Intersects(static_cast<const BoxBounds&>(boundsA), boundsB);
+    case Type::Frustum:
+        return Bounds::Intersects(static_cast<const FrustumBounds&>(boundsA), boundsB);
     default:
         assert(false);
         return false;
@@ -168,8 +187,8 @@ template<>
 bool Bounds::Intersects(const FrustumBounds& boundsA, const AabbBounds& boundsB);
 template<>
 bool Bounds::Intersects(const FrustumBounds& boundsA, const BoxBounds& boundsB);
-//template<>
-//bool Bounds::Intersects(const FrustumBounds& boundsA, const FrustumBounds& boundsB);
+template<>
+bool Bounds::Intersects(const FrustumBounds& boundsA, const FrustumBounds& boundsB);
 
 
 
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <ituGL/scene/Bounds.h>
+#include <glm/vec3.hpp>
+#include <vector>
+
+// Bounding volume hierarchy of AABBs that can be updated incrementally
+// Each leaf (proxy) stores an AABB enlarged by a margin, so small movements don't need to change the tree.
+// Queries only visit the branches that intersect the query bounds, so they are O(log n) instead of O(n)
+class DynamicAabbTree
+{
+public:
+    using ProxyId = int;
+    static const ProxyId NullProxy = -1;
+
+public:
+    DynamicAabbTree(float margin = 0.1f);
+
+    // Add a leaf with the bounds and a user pointer. Returns the id used to move or destroy it
+    ProxyId CreateProxy(const AabbBounds& bounds, void* userData);
+    void DestroyProxy(ProxyId proxyId);
+
+    // Update the bounds of a leaf. It is only reinserted if the new bounds don't fit in the enlarged ones
+    // Returns true if the tree changed
+    bool MoveProxy(ProxyId proxyId, const AabbBounds& bounds);
+
+    inline void* GetUserData(ProxyId proxyId) const { return m_nodes[proxyId].userData; }
+
+    // Enlarged bounds of a leaf
+    AabbBounds GetFatBounds(ProxyId proxyId) const;
+
+    // Height of the tree, 0 if empty or only one leaf
+    int GetHeight() const;
+
+    // Call callback(proxyId) for each leaf whose enlarged bounds intersect the bounds. Stop if the callback returns false
+    template<typename TBounds, typename TCallback>
+    void Query(const TBounds& bounds, TCallback callback) const;
+
+    // Call callback(proxyId, maxDistance) for each leaf whose enlarged bounds are hit by the ray before maxDistance
+    // The callback returns the new max distance, so closer hits can clip the ray. Direction must be normalized
+    template<typename TCallback>
+    void RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TCallback callback) const;
+
+    // Check if a ray hits a box before maxDistance, and get the distance to the hit
+    static bool RayIntersects(const glm::vec3& origin, const glm::vec3& invDirection, const glm::vec3& boxMin, const glm::vec3& boxMax,
+        float maxDistance, float& distance);
+
+private:
+    struct Node
+    {
+        // Enlarged bounds for leaves, union of the children for internal nodes
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+
+        void* userData;
+
+        // Parent, or next free node if the node is in the free list
+        int parent;
+        int child1;
+        int child2;
+
+        // Leaves are 0, free nodes are -1
+        int height;
+
+        inline bool IsLeaf() const { return child1 == NullProxy; }
+    };
+
+private:
+    int AllocateNode();
+    void FreeNode(int nodeId);
+
+    void InsertLeaf(int leafId);
+    void RemoveLeaf(int leafId);
+
+    // Perform a left or right rotation if the node is unbalanced. Returns the new root of the subtree
+    int Balance(int nodeId);
+
+    // Recompute the bounds and height of the nodes from nodeId to the root
+    void RefitAncestors(int nodeId);
+
+    static float GetSurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+private:
+    std::vector<Node> m_nodes;
+    int m_root;
+    int m_freeList;
+
+    // Distance added in each direction to the bounds of the leaves
+    float m_margin;
+};
+
+template<typename TBounds, typename TCallback>
+void DynamicAabbTree::Query(const TBounds& bounds, TCallback callback) const
+{
+    if (m_root == NullProxy)
+    {
+        return;
+    }
+
+    std::vector<int> stack;
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        int nodeId = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[nodeId];
+        AabbBounds nodeBounds(0.5f * (node.boundsMin + node.boundsMax), 0.5f * (node.boundsMax - node.boundsMin));
+        if (!Bounds::Intersects(bounds, nodeBounds))
+        {
+            continue;
+        }
+
+        if (node.IsLeaf())
+        {
+            if (!callback(nodeId))
+            {
+                return;
+            }
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+template<typename TCallback>
+void DynamicAabbTree::RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TCallback callback) const
+{
+    if (m_root == NullProxy)
+    {
+        return;
+    }
+
+    // Division by 0 gives infinity, that works with the slab test
+    glm::vec3 invDirection = 1.0f / direction;
+
+    std::vector<int> stack;
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        int nodeId = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[nodeId];
+        float distance;
+        if (!RayIntersects(origin, invDirection, node.boundsMin, node.boundsMax, maxDistance, distance))
+        {
+            continue;
+        }
+
+        if (node.IsLeaf())
+        {
+            maxDistance = callback(nodeId, maxDistance);
+            if (maxDistance <= 0.0f)
+            {
+                return;
+            }
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <ituGL/scene/DynamicAabbTree.h>
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <vector>
 
 class SceneNode;
 class SceneVisitor;
@@ -23,6 +25,45 @@ public:
     void AcceptVisitor(SceneVisitor& visitor);
     void AcceptVisitor(SceneVisitor& visitor) const;
 
+    // Visit only the nodes with AABB intersecting the bounds (frustum, sphere, box...), using the bounds tree
+    void AcceptVisitor(SceneVisitor& visitor, const Bounds& bounds);
+
+    // Get the nodes with AABB intersecting the bounds
+    void GetSceneNodes(const Bounds& bounds, std::vector<std::shared_ptr<SceneNode>>& nodes);
+
+    // Get the closest node with AABB hit by the ray, or null. Direction must be normalized
+    std::shared_ptr<SceneNode> RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& distance);
+
+    // Update the bounds tree with the nodes that moved since the last update. Queries call it automatically
+    void UpdateBounds();
+
+    // Update the bounds of one node, when they changed without moving its transform
+    void UpdateBounds(const SceneNode& node);
+
+private:
+    friend class SceneNode;
+
+    struct SceneNodeProxy
+    {
+        DynamicAabbTree::ProxyId proxyId;
+
+        // The node is in the list of moved nodes
+        bool moved;
+    };
+
+    void AddSceneNodeProxy(const SceneNode& node);
+    void RemoveSceneNodeProxy(const SceneNode& node);
+
+    // Called by the node when its transform is modified. The bounds are updated in the next query
+    void MarkMoved(const SceneNode& node);
+
 private:
     std::unordered_map<std::string, std::shared_ptr<SceneNode>> m_nodes;
+
+    // Bounds of the nodes, to avoid visiting all of them in spatial queries
+    DynamicAabbTree m_boundsTree;
+    std::unordered_map<const SceneNode*, SceneNodeProxy> m_nodeProxies;
+
+    // Nodes that moved since the last update. They can be removed from the scene in between, then they have no proxy
+    std::vector<const SceneNode*> m_movedNodes;
 };
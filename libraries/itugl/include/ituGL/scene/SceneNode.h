@@ -16,6 +16,11 @@ public:
 
     virtual ~SceneNode();
 
+    // (C++) 4
+    // Make the node non-copyable, its transform keeps a pointer to it
+    SceneNode(const SceneNode&) = delete;
+    void operator = (const SceneNode&) = delete;
+
     const std::string& GetName() const;
     void Rename(const std::string& name);
 
@@ -32,12 +37,20 @@ public:
 
 private:
     friend class Scene;
+    friend class Transform;
 
     Scene* GetOwnerScene() const;
     void SetOwnerScene(Scene* scene);
 
+    // Called by the transform when it, or one of its parents, is modified
+    void OnTransformModified();
+
     Scene* m_scene;
 
+protected:
+    // Let the owner scene know that the bounds changed without changing the transform
+    void NotifyBoundsChanged() const;
+
 protected:
     std::string m_name;
     std::shared_ptr<Transform> m_transform;
@@ -3,23 +3,32 @@
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
 #include <memory>
+#include <vector>
+
+class SceneNode;
 
 class Transform
 {
 public:
     Transform();
+    ~Transform();
+
+    // (C++) 4
+    // Make the transform non-copyable, the children and the scene nodes are linked to this object
+    Transform(const Transform&) = delete;
+    void operator = (const Transform&) = delete;
 
     inline glm::vec3 GetTranslation() const { return m_translation; }
-    inline void SetTranslation(const glm::vec3& translation) { m_translation = translation; m_dirty = true; }
+    inline void SetTranslation(const glm::vec3& translation) { m_translation = translation; SetDirty(); }
 
     inline glm::vec3 GetRotation() const { return m_rotation; }
-    inline void SetRotation(const glm::vec3& rotation) { m_rotation = rotation; m_dirty = true; }
+    inline void SetRotation(const glm::vec3& rotation) { m_rotation = rotation; SetDirty(); }
 
     inline glm::vec3 GetScale() const { return m_scale; }
-    inline void SetScale(const glm::vec3& scale) { m_scale = scale; m_dirty = true; }
+    inline void SetScale(const glm::vec3& scale) { m_scale = scale; SetDirty(); }
 
     inline std::shared_ptr<Transform> GetParent() const { return m_parent; }
-    inline void SetParent(std::shared_ptr<Transform> parent) { m_parent = parent; m_dirty = true; }
+    void SetParent(std::shared_ptr<Transform> parent);
 
     glm::mat4 GetTranslationMatrix() const;
     glm::mat4 GetRotationMatrix() const;
@@ -29,6 +38,18 @@ public:
 
     bool IsDirty() const;
 
+private:
+    friend class SceneNode;
+
+    // Scene nodes using this transform are notified when it, or one of its parents, is modified
+    void AddSceneNode(SceneNode* node);
+    void RemoveSceneNode(SceneNode* node);
+
+    inline void SetDirty() { m_dirty = true; NotifyModified(); }
+
+    // Notify the scene nodes of this transform, and of all the children below it
+    void NotifyModified() const;
+
 private:
     glm::vec3 m_translation;
     glm::vec3 m_rotation;
@@ -36,6 +57,10 @@ private:
 
     std::shared_ptr<Transform> m_parent;
 
+    // Not owned: the children keep their parent alive, and remove themselves when destroyed
+    std::vector<Transform*> m_children;
+    std::vector<SceneNode*> m_sceneNodes;
+
     // Cached matrix
     mutable glm::mat4 m_matrix;
     mutable bool m_dirty;
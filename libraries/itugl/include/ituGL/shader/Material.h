@@ -106,6 +106,10 @@ public:
     // You can skip depth, stencil or blending using the override flags
     void Use(OverrideFlags overrideFlags = OverrideFlags::NoOverride) const;
 
+    // Second half of Use: run the shader setup function, and set depth properties, stencil properties, and blending
+    // Used after the uniforms are set from a command list. Requires the shader program to be in use
+    void UseStates(OverrideFlags overrideFlags = OverrideFlags::NoOverride) const;
+
 private:
     // Set all the properties relative to depth
     void UseDepthTest() const;
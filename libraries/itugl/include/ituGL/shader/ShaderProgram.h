@@ -41,6 +41,9 @@ public:
     // Implements the Bind required by Object. Shaders and shader programs don't use Bind()
     void Bind() const override;
 
+    // Small number that identifies the program. Unlike the handle, it is never reused, so it can index tables
+    inline unsigned int GetId() const { return m_id; }
+
     // Build (Attach and link) a shader program with a compute shader
     bool Build(const Shader& computeShader);
 
@@ -90,6 +93,19 @@ public:
     // Get information about a specific uniform
     void GetUniformInfo(unsigned int index, int& size, GLenum& glType, std::span<char> uniformName) const;
 
+    // Get the number of elements of an active uniform array, 1 if it is not an array, or 0 if not found
+    int GetUniformArraySize(const char* name) const;
+
+    // Find a uniform block index by name. Returns GL_INVALID_INDEX if not found
+    GLuint GetUniformBlockIndex(const char* name) const;
+    // Set the binding point where the uniform block reads its buffer
+    void SetUniformBlockBinding(GLuint blockIndex, GLuint binding) const;
+
+    // Find a shader storage block index by name. Returns GL_INVALID_INDEX if not found (OpenGL 4.3)
+    GLuint GetShaderStorageBlockIndex(const char* name) const;
+    // Set the binding point where the shader storage block reads its buffer (OpenGL 4.3)
+    void SetShaderStorageBlockBinding(GLuint blockIndex, GLuint binding) const;
+
     // Template method combinations to simplify getting uniforms
     template<typename T>
     void GetUniform(Location location, T& value) const;
@@ -116,6 +132,9 @@ public:
     // Set the shader program as the active one to be used for rendering
     void Use() const;
 
+    // Run the compute shader with a number of work groups in each dimension. Requires the program to be in use (OpenGL 4.3)
+    void Dispatch(GLuint groupCountX, GLuint groupCountY, GLuint groupCountZ = 1) const;
+
 private:
     // Build (Attach and link) all shaders provided for the rasterization pipeline
     bool Build(const Shader& vertexShader, const Shader& fragmentShader,
@@ -139,6 +158,11 @@ private:
     void SetUniforms(Location location, const T* values, GLsizei count) const;
 
 private:
+    unsigned int m_id;
+
+    // Id of the next program created
+    static unsigned int s_nextId;
+
 #ifndef NDEBUG
     inline bool IsUsed() const { return s_usedHandle == GetHandle(); }
     static Handle s_usedHandle;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+#include <ituGL/core/Data.h>
+
+// Shader Storage Buffer Object (SSBO) is a BufferObject used as the source of a shader storage block (OpenGL 4.3)
+// Unlike UBOs, they can be very large, have a runtime sized array at the end, and be written by the shaders
+class ShaderStorageBufferObject : public BufferObjectBase<BufferObject::ShaderStorageBuffer>
+{
+public:
+    ShaderStorageBufferObject();
+
+    // (C++) 3
+    // Use the same AllocateData and UpdateData methods from the base class
+    using BufferObject::AllocateData;
+    using BufferObject::UpdateData;
+
+    // AllocateData and UpdateData template methods for any type of data span. It must follow the std430 layout
+    template<typename T>
+    inline void AllocateData(std::span<const T> data, Usage usage = Usage::DynamicDraw) { AllocateData(Data::GetBytes(data), usage); }
+    template<typename T>
+    inline void UpdateData(std::span<const T> data, size_t offsetBytes = 0) { UpdateData(Data::GetBytes(data), offsetBytes); }
+
+    // Bind the buffer to a shader storage block binding point
+    inline void BindBase(GLuint index) const { BufferObject::BindBase(GetTarget(), index); }
+    inline void BindRange(GLuint index, GLintptr offset, GLsizeiptr size) const { BufferObject::BindRange(GetTarget(), index, offset, size); }
+
+    // Check if the device supports shader storage buffers
+    static bool IsSupported();
+};
@@ -10,6 +10,8 @@
 #include <cstring>
 #include <memory>
 
+class CommandList;
+
 class ShaderUniformCollection
 {
 public:
@@ -25,6 +27,9 @@ public:
     std::shared_ptr<ShaderProgram> GetShaderProgram();
     std::shared_ptr<const ShaderProgram> GetShaderProgram() const;
 
+    // Get the shader program without sharing its ownership, to avoid touching the reference count in hot loops
+    inline const ShaderProgram* GetShaderProgramPointer() const { return m_shaderProgram.get(); }
+
     // Reset the material with a different shader
     void ChangeShader(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet& filteredUniforms = NameSet());
 
@@ -71,6 +76,9 @@ public:
     // Set all the properties to the shader. Requires the shader program to be in use
     void SetUniforms() const;
 
+    // Record the commands that set all the properties, with a copy of their values, like SetUniforms
+    void RecordUniforms(CommandList& commandList) const;
+
 private:
     // Different dimensions of the properties
     enum class UniformDimension
@@ -141,6 +149,12 @@ private:
     void UseUniform(const DataUniform& uniform) const;
     void UseUniform(const TextureUniform& uniform) const;
 
+    // Record uniform property
+    void RecordUniform(const DataUniform& uniform, CommandList& commandList) const;
+    template<typename T>
+    void RecordUniform(const DataUniform& uniform, CommandList& commandList) const;
+    void RecordUniform(const TextureUniform& uniform, CommandList& commandList) const;
+
     // Get the buffer where data values are stored for a certain type
     template<typename T>
     std::vector<T>& GetDataValues();
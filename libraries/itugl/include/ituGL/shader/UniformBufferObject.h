@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+#include <ituGL/core/Data.h>
+
+// Uniform Buffer Object (UBO) is a BufferObject used as the source of the uniforms inside a uniform block
+class UniformBufferObject : public BufferObjectBase<BufferObject::UniformBuffer>
+{
+public:
+    UniformBufferObject();
+
+    // (C++) 3
+    // Use the same AllocateData and UpdateData methods from the base class
+    using BufferObject::AllocateData;
+    using BufferObject::UpdateData;
+
+    // AllocateData and UpdateData template methods for a single struct. It must follow the std140 layout
+    template<typename T>
+    inline void AllocateData(const T& data, Usage usage = Usage::DynamicDraw) { AllocateData(Data::GetBytes(data), usage); }
+    template<typename T>
+    inline void UpdateData(const T& data, size_t offsetBytes = 0) { UpdateData(Data::GetBytes(data), offsetBytes); }
+
+    // Bind the buffer to a uniform block binding point
+    inline void BindBase(GLuint index) const { BufferObject::BindBase(GetTarget(), index); }
+    inline void BindRange(GLuint index, GLintptr offset, GLsizeiptr size) const { BufferObject::BindRange(GetTarget(), index, offset, size); }
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <ituGL/texture/TextureObject.h>
+
+class TextureBufferObject;
+
+// Texture that reads its texels from a TextureBufferObject, as a 1D array without filtering
+// Shaders access it with samplerBuffer / usamplerBuffer and texelFetch
+class BufferTextureObject : public TextureObjectBase<TextureObject::TextureBuffer>
+{
+public:
+    BufferTextureObject();
+
+    // Attach the buffer. The format of each texel must be sized, for example InternalFormatRGBA32F or InternalFormatR32UI
+    void SetBuffer(InternalFormat internalFormat, const TextureBufferObject& buffer);
+};
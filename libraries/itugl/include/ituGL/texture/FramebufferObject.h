@@ -5,6 +5,7 @@
 #include <memory>
 
 class Texture2DObject;
+class Texture2DMultisampleObject;
 
 // Abstract OpenGL object that encapsulates a Framebuffer
 class FramebufferObject : public Object
@@ -28,6 +29,7 @@ public:
     static void Unbind(Target target);
 
     void SetTexture(Target target, Attachment attachment, const Texture2DObject& texture, int level = 0);
+    void SetTexture(Target target, Attachment attachment, const Texture2DMultisampleObject& texture);
 
     void SetDrawBuffers(std::span<const Attachment> attachments);
 
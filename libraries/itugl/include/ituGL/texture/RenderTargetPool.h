@@ -0,0 +1,97 @@
+#pragma once
+
+#include <ituGL/texture/TextureObject.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+class FramebufferObject;
+
+// Hands out framebuffers with their attached textures, reusing the ones that are not used anymore
+// A render target is in use while someone keeps a pointer to it. When all the pointers are released it goes back to the pool,
+// and it is deleted if it is not acquired again in the next few frames
+class RenderTargetPool
+{
+public:
+    static const unsigned int MaxColorAttachments = 4;
+
+    // Attachments of a render target. Unused attachments have InternalFormatInvalid
+    struct Descriptor
+    {
+        int width = 0;
+        int height = 0;
+        std::array<TextureObject::InternalFormat, MaxColorAttachments> colorFormats = {};
+        TextureObject::InternalFormat depthFormat = TextureObject::InternalFormatInvalid;
+        // Samples per pixel. If more than 1, the textures are Texture2DMultisampleObject, otherwise Texture2DObject
+        int samples = 1;
+
+        // Descriptor with one color attachment, and optionally depth
+        static Descriptor Create(int width, int height, TextureObject::InternalFormat colorFormat,
+            TextureObject::InternalFormat depthFormat = TextureObject::InternalFormatInvalid, int samples = 1);
+
+        bool operator == (const Descriptor& other) const = default;
+    };
+
+    struct RenderTarget
+    {
+        Descriptor descriptor;
+        std::shared_ptr<FramebufferObject> framebuffer;
+        std::array<std::shared_ptr<TextureObject>, MaxColorAttachments> colorTextures;
+        std::shared_ptr<TextureObject> depthTexture;
+
+        // Get an attached texture as its actual type
+        template<typename T>
+        inline std::shared_ptr<T> GetColorTexture(unsigned int index) const { return std::dynamic_pointer_cast<T>(colorTextures[index]); }
+        template<typename T>
+        inline std::shared_ptr<T> GetDepthTexture() const { return std::dynamic_pointer_cast<T>(depthTexture); }
+    };
+
+public:
+    RenderTargetPool(unsigned int maxUnusedFrames = 3);
+
+    // (C++) 4
+    // Make the object non-copyable, the render targets must be owned by only one pool
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    void operator = (const RenderTargetPool&) = delete;
+
+    // Get a render target with the descriptor. It is reused from the pool if there is a free one, otherwise it is created
+    std::shared_ptr<const RenderTarget> Acquire(const Descriptor& descriptor);
+
+    // Call once per frame. Deletes the render targets that have been free for more than maxUnusedFrames frames
+    void EndFrame();
+
+    // Delete all the render targets that are free now
+    void ReleaseUnused();
+
+    // Number of frames that a free render target stays in the pool
+    inline unsigned int GetMaxUnusedFrames() const { return m_maxUnusedFrames; }
+    inline void SetMaxUnusedFrames(unsigned int maxUnusedFrames) { m_maxUnusedFrames = maxUnusedFrames; }
+
+    // Render targets in the pool, both used and free
+    inline unsigned int GetRenderTargetCount() const { return static_cast<unsigned int>(m_entries.size()); }
+
+    // Estimated video memory used by the textures of the render targets in the pool, in bytes
+    inline size_t GetMemorySize() const { return m_memorySize; }
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<RenderTarget> renderTarget;
+        size_t memorySize;
+
+        // Frames since the render target was last in use
+        unsigned int unusedFrames;
+    };
+
+    static std::shared_ptr<RenderTarget> CreateRenderTarget(const Descriptor& descriptor);
+    static std::shared_ptr<TextureObject> CreateTexture(const Descriptor& descriptor, TextureObject::InternalFormat internalFormat);
+    static size_t GetMemorySize(const Descriptor& descriptor);
+
+    // If only the pool has a pointer to it, the render target is free
+    inline static bool IsInUse(const Entry& entry) { return entry.renderTarget.use_count() > 1; }
+
+private:
+    std::vector<Entry> m_entries;
+    unsigned int m_maxUnusedFrames;
+    size_t m_memorySize;
+};
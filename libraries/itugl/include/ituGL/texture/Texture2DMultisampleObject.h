@@ -0,0 +1,14 @@
+#pragma once
+
+#include <ituGL/texture/TextureObject.h>
+
+// Texture object in 2 dimensions with several samples per pixel. It can only be rendered to, and read with texelFetch
+class Texture2DMultisampleObject : public TextureObjectBase<TextureObject::Texture2DMultisample>
+{
+public:
+    Texture2DMultisampleObject();
+
+    // Initialize the texture with a specific number of samples and format
+    // If fixedSampleLocations is true, all the pixels use the same sample pattern
+    void SetStorage(GLsizei samples, GLsizei width, GLsizei height, InternalFormat internalFormat, bool fixedSampleLocations = true);
+};
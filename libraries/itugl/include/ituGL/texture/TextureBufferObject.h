@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+#include <ituGL/core/Data.h>
+
+// Buffer with the texels of a BufferTextureObject. Useful to read big arrays in shaders that don't support storage buffers
+class TextureBufferObject : public BufferObjectBase<BufferObject::TextureBuffer>
+{
+public:
+    TextureBufferObject();
+
+    // (C++) 3
+    // Use the same AllocateData and UpdateData methods from the base class
+    using BufferObject::AllocateData;
+    using BufferObject::UpdateData;
+
+    // Allocate the buffer with an array of elements
+    template<typename T>
+    inline void AllocateData(std::span<const T> data, Usage usage = Usage::StreamDraw) { AllocateData(Data::GetBytes(data), usage); }
+};
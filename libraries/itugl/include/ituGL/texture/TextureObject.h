@@ -44,6 +44,10 @@ public:
     // Generate mipmaps automatically for this texture
     void GenerateMipmap();
 
+    // Bind a level of the texture to an image unit, so shaders can load and store its texels (OpenGL 4.2)
+    // Access is GL_READ_ONLY, GL_WRITE_ONLY or GL_READ_WRITE. The format must match the format declared in the shader
+    void BindImage(GLuint imageUnit, GLint level, GLenum access, InternalFormat format) const;
+
     // Get value of the texture parameter of type float
     void GetParameter(ParameterFloat pname, GLfloat& param) const;
     // Set value of the texture parameter of type float
@@ -75,6 +79,9 @@ public:
     // Get number of components of the data type of the texture (packed components count as 1)
     static int GetDataComponentCount(InternalFormat internalFormat);
 
+    // Get the size in bytes of one pixel of a sized internal format. Unsized formats assume 8 bits per component
+    static int GetPixelSize(InternalFormat internalFormat);
+
     // Set active texture unit
     static void SetActiveTexture(GLint textureUnit);
 
@@ -239,6 +246,10 @@ enum TextureObject::InternalFormat : GLint
     // Others
     InternalFormatR11G11B10 = GL_R11F_G11F_B10F,
     InternalFormatRGB10A2 = GL_RGB10_A2,
+
+    InternalFormatR32UI = GL_R32UI,
+    InternalFormatRG32UI = GL_RG32UI,
+    InternalFormatRGBA32UI = GL_RGBA32UI,
     // And many more....
 };
 
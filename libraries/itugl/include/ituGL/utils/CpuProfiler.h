@@ -0,0 +1,83 @@
+#pragma once
+
+#include <span>
+#include <iosfwd>
+#include <cstdint>
+
+class DearImGui;
+
+// Records how long the CPU spends in named zones, on any thread, grouped by frame
+// Zones are declared with ITUGL_PROFILE_SCOPE, and they last until the end of the scope
+// Each thread writes its zones in its own ring buffer, without locks. EndFrame collects them on the main thread
+// If ITUGL_PROFILER_ENABLED is not defined, the zones are compiled out and the profiler stays empty
+class CpuProfiler
+{
+public:
+    // A zone of the last frame. Times are in milliseconds, relative to the start of the frame
+    struct Zone
+    {
+        const char* name;
+        unsigned int threadIndex;
+
+        // Number of zones of the same thread that contain this one
+        unsigned int depth;
+
+        double startTime;
+        double duration;
+    };
+
+    // Records a zone from construction to destruction. Use it through ITUGL_PROFILE_SCOPE
+    class ScopedZone
+    {
+    public:
+        ScopedZone(const char* name);
+        ~ScopedZone();
+
+        // (C++) 4
+        // Make the object non-copyable, the zone must be recorded once
+        ScopedZone(const ScopedZone&) = delete;
+        void operator = (const ScopedZone&) = delete;
+
+    private:
+        const char* m_name;
+        std::uint64_t m_startTime;
+        unsigned int m_depth;
+    };
+
+public:
+    // Mark the start and the end of a frame. EndFrame collects the zones finished by all the threads
+    static void BeginFrame();
+    static void EndFrame();
+
+    // Zones of the last frame, sorted by thread and start time, so each zone is followed by the zones it contains
+    static std::span<const Zone> GetFrameZones();
+
+    // Duration of the last frame, in milliseconds
+    static double GetFrameTime();
+
+    // Name of the calling thread in the trace. Threads are called "Thread N" otherwise
+    static void SetThreadName(const char* name);
+
+    // Zones that didn't fit in the ring buffer of their thread, because EndFrame was not called often enough
+    static unsigned int GetDroppedZoneCount();
+
+    // While capturing, the zones of all the frames are kept, to write them as a trace
+    static void BeginCapture();
+    static void EndCapture();
+    static bool IsCapturing();
+
+    // Write the captured zones in the Chrome trace event format, that can be opened in chrome://tracing or Perfetto
+    static void WriteChromeTrace(std::ostream& stream);
+
+    // Show the zones of the last frame, and buttons to capture a trace to cpu_trace.json
+    static void DrawGUI(DearImGui& imGui, const char* windowName = "CPU Profiler");
+};
+
+#ifdef ITUGL_PROFILER_ENABLED
+#define ITUGL_PROFILE_CONCAT_INNER(a, b) a##b
+#define ITUGL_PROFILE_CONCAT(a, b) ITUGL_PROFILE_CONCAT_INNER(a, b)
+// Record the time until the end of the current scope. The name must stay valid until the end of the frame
+#define ITUGL_PROFILE_SCOPE(name) CpuProfiler::ScopedZone ITUGL_PROFILE_CONCAT(profilerZone, __LINE__)(name)
+#else
+#define ITUGL_PROFILE_SCOPE(name) ((void)0)
+#endif
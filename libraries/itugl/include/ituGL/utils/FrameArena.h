@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory_resource>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+// Linear allocator for data that only lives during one frame
+// Allocations move a cursor forward in a single block, deallocations do nothing, and Reset() frees everything at once.
+// It can be used with std::pmr containers. If a frame needs more memory than the block has, the extra allocations
+// come from the heap, and the block grows on Reset() to fit the high-water mark, so steady frames don't allocate at all
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    FrameArena(size_t capacity = 0);
+
+    // Forget all the allocations. Containers using the arena must have released their memory before
+    void Reset();
+
+    // Size of the block, in bytes
+    inline size_t GetCapacity() const { return m_capacity; }
+
+    // Bytes allocated since the last Reset(), including the ones that didn't fit in the block
+    inline size_t GetUsedSize() const { return m_usedSize + m_overflowSize; }
+
+    // Max bytes used in a single frame
+    inline size_t GetHighWaterMark() const { return m_highWaterMark; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    std::unique_ptr<std::byte[]> m_block;
+    size_t m_capacity;
+    size_t m_usedSize;
+
+    // Allocations that didn't fit in the block this frame
+    std::vector<std::unique_ptr<std::byte[]>> m_overflowBlocks;
+    size_t m_overflowSize;
+
+    size_t m_highWaterMark;
+};
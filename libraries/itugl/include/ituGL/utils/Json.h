@@ -0,0 +1,12 @@
+#pragma once
+
+#include <ostream>
+#include <string_view>
+
+// Helpers to write JSON by hand, shared by the profilers and the benchmarks
+class Json
+{
+public:
+    // Write a string between quotes, escaping the characters that need it. Control characters are written as spaces
+    static void WriteString(std::ostream& stream, std::string_view string);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// Set of worker threads that run the iterations of a loop in parallel
+// The threads are created once and sleep between jobs, so ParallelFor can be called every frame
+class ThreadPool
+{
+public:
+    using Job = std::function<void(unsigned int)>;
+
+public:
+    // With 0 threads, it uses one less than the hardware threads. The calling thread always helps with the jobs
+    ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    // (C++) 4
+    // Make the object non-copyable, the threads can't be shared
+    ThreadPool(const ThreadPool&) = delete;
+    void operator = (const ThreadPool&) = delete;
+
+    // Number of threads that can run jobs at the same time, including the calling thread
+    inline unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_threads.size()) + 1; }
+
+    // Call job(index) for each index in [0, count) and wait until all of them are done
+    // The order is not defined, so the job must not depend on other indices
+    void ParallelFor(unsigned int count, const Job& job);
+
+private:
+    void WorkerLoop();
+
+    // Take indices until there are no more left
+    void RunJobs();
+
+private:
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_doneCondition;
+
+    // Current job. m_generation changes every ParallelFor, to wake up the workers
+    const Job* m_job;
+    unsigned int m_count;
+    unsigned int m_generation;
+    bool m_stop;
+
+    // Next index to run, and workers that are still running the current job
+    std::atomic<unsigned int> m_nextIndex;
+    unsigned int m_activeWorkers;
+};
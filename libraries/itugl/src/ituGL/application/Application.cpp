@@ -1,5 +1,6 @@
 #include <ituGL/application/Application.h>
 
+#include <ituGL/utils/CpuProfiler.h>
 // For breaking execution in debug when an unexpected condition is found
 #include <cassert>
 // For accurate application time
@@ -8,8 +9,8 @@
 #include <iostream>
 
 // DeviceGL and main Window are constructed in the correct order because they were declared like that!
-Application::Application(int width, int height, const char* title)
-    : m_mainWindow(width, height, title), m_currentTime(0), m_deltaTime(0), m_exitCode(0)
+Application::Application(int width, int height, const char* title, bool headless)
+    : m_mainWindow(width, height, title, headless), m_currentTime(0), m_deltaTime(0), m_fixedDeltaTime(0), m_exitCode(0)
 {
     // If the main window is not valid, exit with error
     if (!m_mainWindow.IsValid())
@@ -42,7 +43,12 @@ int Application::Run()
     // If the application is not in error state, run
     if (!m_exitCode)
     {
-        Initialize();
+        CpuProfiler::SetThreadName("Main");
+
+        {
+            ITUGL_PROFILE_SCOPE("Application::Initialize");
+            Initialize();
+        }
 
         // current time when the application started
         auto startTime = std::chrono::steady_clock::now();
@@ -50,17 +56,43 @@ int Application::Run()
         // Main loop
         while (IsRunning())
         {
-            // set current time relative to start time
-            std::chrono::duration<float> duration = std::chrono::steady_clock::now() - startTime;
-            UpdateTime(duration.count());
-
-            Update();
-
-            Render();
-
-            // Swap buffers and poll events at the end of the frame
-            m_mainWindow.SwapBuffers();
-            m_device.PollEvents();
+            CpuProfiler::BeginFrame();
+            {
+                ITUGL_PROFILE_SCOPE("Application::Frame");
+
+                if (m_fixedDeltaTime > 0)
+                {
+                    UpdateTime(m_currentTime + m_fixedDeltaTime);
+                }
+                else
+                {
+                    // set current time relative to start time
+                    std::chrono::duration<float> duration = std::chrono::steady_clock::now() - startTime;
+                    UpdateTime(duration.count());
+                }
+
+                BeginFrame();
+
+                {
+                    ITUGL_PROFILE_SCOPE("Application::Update");
+                    Update();
+                }
+
+                {
+                    ITUGL_PROFILE_SCOPE("Application::Render");
+                    Render();
+                }
+
+                // Swap buffers and poll events at the end of the frame
+                {
+                    ITUGL_PROFILE_SCOPE("Application::SwapBuffers");
+                    m_mainWindow.SwapBuffers();
+                }
+                m_device.PollEvents();
+            }
+            CpuProfiler::EndFrame();
+
+            EndFrame();
         }
 
         Cleanup();
@@ -86,6 +118,14 @@ void Application::Render()
 {
 }
 
+void Application::BeginFrame()
+{
+}
+
+void Application::EndFrame()
+{
+}
+
 void Application::Cleanup()
 {
 }
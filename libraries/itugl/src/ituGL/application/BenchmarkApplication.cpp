@@ -0,0 +1,302 @@
+#include <ituGL/application/BenchmarkApplication.h>
+
+#include <ituGL/utils/CpuProfiler.h>
+#include <ituGL/utils/Json.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+
+bool BenchmarkApplication::ParseArguments(int argc, char* argv[], Settings& settings)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool hasValue = true;
+
+        if (std::strcmp(argument, "--windowed") == 0)
+        {
+            settings.headless = false;
+            hasValue = false;
+        }
+        else if (!value)
+        {
+            std::cout << "Missing value for " << argument << std::endl;
+            return false;
+        }
+        else if (std::strcmp(argument, "--warmup") == 0)
+        {
+            settings.warmupFrames = std::atoi(value);
+        }
+        else if (std::strcmp(argument, "--frames") == 0)
+        {
+            settings.measuredFrames = std::atoi(value);
+        }
+        else if (std::strcmp(argument, "--scale") == 0)
+        {
+            settings.sceneScale = std::atoi(value);
+        }
+        else if (std::strcmp(argument, "--variant") == 0)
+        {
+            settings.variant = value;
+        }
+        else if (std::strcmp(argument, "--delta") == 0)
+        {
+            settings.fixedDeltaTime = static_cast<float>(std::atof(value));
+        }
+        else if (std::strcmp(argument, "--output") == 0)
+        {
+            settings.outputPath = value;
+        }
+        else
+        {
+            std::cout << "Unknown argument: " << argument << std::endl;
+            std::cout << "Usage: " << argv[0] << " [--warmup N] [--frames N] [--scale N] [--variant NAME] [--delta SECONDS] [--output PATH] [--windowed]" << std::endl;
+            return false;
+        }
+
+        if (hasValue)
+        {
+            ++i;
+        }
+    }
+
+    // A typo in the variant would measure the default configuration, and write the typo in the results
+    if (settings.variant.empty() && !settings.variants.empty())
+    {
+        settings.variant = settings.variants.front();
+    }
+    else if (!settings.variant.empty() && std::find(settings.variants.begin(), settings.variants.end(), settings.variant) == settings.variants.end())
+    {
+        std::cout << "Unknown variant: " << settings.variant << std::endl;
+        std::cout << "Variants:";
+        for (const std::string& variant : settings.variants)
+        {
+            std::cout << " " << variant;
+        }
+        std::cout << (settings.variants.empty() ? " none" : "") << std::endl;
+        return false;
+    }
+
+    return settings.measuredFrames > 0 && settings.fixedDeltaTime > 0;
+}
+
+BenchmarkApplication::Statistics BenchmarkApplication::ComputeStatistics(std::vector<double> times)
+{
+    Statistics statistics = {};
+    if (times.empty())
+    {
+        return statistics;
+    }
+
+    std::sort(times.begin(), times.end());
+
+    // Nearest rank: the smallest time that is greater or equal than the percentage of the times
+    auto percentile = [&times](double percentage)
+        {
+            std::size_t rank = static_cast<std::size_t>(std::ceil(percentage * times.size()));
+            return times[std::clamp<std::size_t>(rank, 1, times.size()) - 1];
+        };
+
+    statistics.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    statistics.min = times.front();
+    statistics.p50 = percentile(0.50);
+    statistics.p95 = percentile(0.95);
+    statistics.p99 = percentile(0.99);
+    statistics.max = times.back();
+    return statistics;
+}
+
+void BenchmarkApplication::WriteStatistics(std::ostream& stream, const char* name, const Statistics& statistics)
+{
+    stream << "  \"" << name << "\": {\"mean\": " << statistics.mean << ", \"min\": " << statistics.min;
+    stream << ", \"p50\": " << statistics.p50 << ", \"p95\": " << statistics.p95 << ", \"p99\": " << statistics.p99;
+    stream << ", \"max\": " << statistics.max << "},\n";
+}
+
+void BenchmarkApplication::PrintStatistics(const char* label, const Statistics& statistics)
+{
+    std::cout << "  " << label << " ms: p50 " << statistics.p50 << ", p95 " << statistics.p95 << ", p99 " << statistics.p99 << std::endl;
+}
+
+void BenchmarkApplication::ResolvePaths(Settings& settings)
+{
+    // Keep the results next to where the benchmark was launched, not in the asset directory
+    if (settings.outputPath.empty())
+    {
+        settings.outputPath = settings.name + ".json";
+    }
+    settings.outputPath = std::filesystem::absolute(settings.outputPath).string();
+
+    if (!settings.assetDirectory.empty())
+    {
+        std::filesystem::current_path(settings.assetDirectory);
+    }
+}
+
+BenchmarkApplication::BenchmarkApplication(int width, int height, const Settings& settings)
+    : Application(width, height, settings.name.c_str(), settings.headless)
+    , m_settings(settings)
+    , m_frameIndex(0)
+{
+    if (!GetDevice().IsReady())
+    {
+        return;
+    }
+
+    ResolvePaths(m_settings);
+
+    // Don't wait for the display, render as fast as possible
+    GetDevice().SetVSyncEnabled(false);
+    SetFixedDeltaTime(m_settings.fixedDeltaTime);
+
+    m_cpuTimes.reserve(m_settings.measuredFrames);
+    m_gpuTimes.resize(m_settings.measuredFrames, -1.0);
+
+    if (QueryObject::IsTimerSupported())
+    {
+        m_gpuFrames.resize(FrameLatency);
+    }
+}
+
+void BenchmarkApplication::WriteJson(std::ostream& stream) const
+{
+    // Frames without GPU time are left out of the statistics
+    std::vector<double> gpuTimes = GetValidGpuTimes();
+
+    int width, height;
+    GetMainWindow().GetDimensions(width, height);
+
+    stream.setf(std::ios::fixed);
+    stream.precision(4);
+
+    stream << "{\n";
+    stream << "  \"name\": ";
+    Json::WriteString(stream, m_settings.name);
+    stream << ",\n";
+    stream << "  \"width\": " << width << ",\n";
+    stream << "  \"height\": " << height << ",\n";
+    stream << "  \"sceneScale\": " << m_settings.sceneScale << ",\n";
+    stream << "  \"variant\": ";
+    Json::WriteString(stream, m_settings.variant);
+    stream << ",\n";
+    stream << "  \"warmupFrames\": " << m_settings.warmupFrames << ",\n";
+    stream << "  \"measuredFrames\": " << m_cpuTimes.size() << ",\n";
+    stream << "  \"fixedDeltaTime\": " << m_settings.fixedDeltaTime << ",\n";
+    WriteStatistics(stream, "cpu", ComputeStatistics(m_cpuTimes));
+    if (!gpuTimes.empty())
+    {
+        WriteStatistics(stream, "gpu", ComputeStatistics(gpuTimes));
+    }
+
+    // Times of each frame in milliseconds, as [cpu, gpu]. gpu is null if it was not measured
+    stream << "  \"frames\": [";
+    for (std::size_t i = 0; i < m_cpuTimes.size(); ++i)
+    {
+        stream << (i ? ", [" : "\n    [") << m_cpuTimes[i] << ", ";
+        if (m_gpuTimes[i] >= 0.0)
+        {
+            stream << m_gpuTimes[i] << "]";
+        }
+        else
+        {
+            stream << "null]";
+        }
+    }
+    stream << "\n  ]\n}\n";
+}
+
+void BenchmarkApplication::BeginFrame()
+{
+    Application::BeginFrame();
+
+    if (!m_gpuFrames.empty())
+    {
+        unsigned int slotIndex = m_frameIndex % FrameLatency;
+        ReadGpuTime(slotIndex);
+
+        GpuFrame& gpuFrame = m_gpuFrames[slotIndex];
+        gpuFrame.startQuery.RecordTimestamp();
+        gpuFrame.frameIndex = m_frameIndex;
+    }
+}
+
+void BenchmarkApplication::EndFrame()
+{
+    if (!m_gpuFrames.empty())
+    {
+        GpuFrame& gpuFrame = m_gpuFrames[m_frameIndex % FrameLatency];
+        gpuFrame.endQuery.RecordTimestamp();
+        gpuFrame.pending = true;
+    }
+
+    // The profiler measured the whole frame, from the update to the swap
+    if (m_frameIndex >= m_settings.warmupFrames)
+    {
+        m_cpuTimes.push_back(CpuProfiler::GetFrameTime());
+    }
+
+    ++m_frameIndex;
+
+    if (m_frameIndex == m_settings.warmupFrames + m_settings.measuredFrames)
+    {
+        // Wait for the frames still in flight
+        for (unsigned int slotIndex = 0; slotIndex < m_gpuFrames.size(); ++slotIndex)
+        {
+            ReadGpuTime(slotIndex);
+        }
+
+        SaveResults();
+        Close();
+    }
+
+    Application::EndFrame();
+}
+
+void BenchmarkApplication::ReadGpuTime(unsigned int slotIndex)
+{
+    GpuFrame& gpuFrame = m_gpuFrames[slotIndex];
+    if (!gpuFrame.pending)
+    {
+        return;
+    }
+    gpuFrame.pending = false;
+
+    if (gpuFrame.frameIndex >= m_settings.warmupFrames)
+    {
+        // Unlike the profilers, the benchmark keeps every frame, so it waits for the result if it is not ready
+        GLuint64 startTime = gpuFrame.startQuery.GetResult();
+        GLuint64 endTime = gpuFrame.endQuery.GetResult();
+        m_gpuTimes[gpuFrame.frameIndex - m_settings.warmupFrames] = (endTime - startTime) * 1e-6;
+    }
+}
+
+void BenchmarkApplication::SaveResults() const
+{
+    std::ofstream file(m_settings.outputPath);
+    WriteJson(file);
+
+    std::cout << m_settings.name << ": " << m_cpuTimes.size() << " frames" << std::endl;
+    PrintStatistics("CPU", ComputeStatistics(m_cpuTimes));
+    std::vector<double> gpuTimes = GetValidGpuTimes();
+    if (!gpuTimes.empty())
+    {
+        PrintStatistics("GPU", ComputeStatistics(gpuTimes));
+    }
+    std::cout << "  Results written to " << m_settings.outputPath << std::endl;
+}
+
+std::vector<double> BenchmarkApplication::GetValidGpuTimes() const
+{
+    // Frames that were not measured keep the -1 they were initialized with
+    std::vector<double> gpuTimes;
+    std::copy_if(m_gpuTimes.begin(), m_gpuTimes.end(), std::back_inserter(gpuTimes), [](double time) { return time >= 0.0; });
+    return gpuTimes;
+}
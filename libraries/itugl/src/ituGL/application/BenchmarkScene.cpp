@@ -0,0 +1,196 @@
+#include <ituGL/application/BenchmarkScene.h>
+
+#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/asset/ModelLoader.h>
+
+#include <ituGL/camera/Camera.h>
+#include <ituGL/scene/SceneCamera.h>
+
+#include <ituGL/lighting/DirectionalLight.h>
+#include <ituGL/lighting/PointLight.h>
+#include <ituGL/scene/SceneLight.h>
+
+#include <ituGL/shader/ShaderUniformCollection.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/geometry/Model.h>
+#include <ituGL/scene/Bounds.h>
+#include <ituGL/scene/SceneModel.h>
+#include <ituGL/scene/Transform.h>
+
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/renderer/OcclusionCuller.h>
+#include <ituGL/scene/RendererSceneVisitor.h>
+
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+#include <string>
+
+BenchmarkScene::BenchmarkScene()
+    : m_spacing(1.5f)
+    , m_gridSize(0)
+{
+}
+
+void BenchmarkScene::Initialize(Renderer& renderer, unsigned int modelCount, float aspectRatio, bool occluders)
+{
+    // Square grid with at least modelCount models
+    m_gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(modelCount))));
+
+    InitializeCamera(aspectRatio);
+    InitializeLights();
+    InitializeMaterial(renderer);
+    InitializeModels(modelCount, occluders);
+}
+
+void BenchmarkScene::Update(Renderer& renderer, float time)
+{
+    // Orbit around the grid
+    float radius = 0.75f * m_gridSize * m_spacing;
+    float angle = 0.25f * time;
+    glm::vec3 position(radius * std::cos(angle), 0.4f * radius, radius * std::sin(angle));
+    m_camera->SetViewMatrix(position, glm::vec3(0.0f), glm::vec3(0, 1, 0));
+
+    // Add the scene nodes to the renderer
+    RendererSceneVisitor rendererSceneVisitor(renderer);
+    m_scene.AcceptVisitor(rendererSceneVisitor);
+}
+
+void BenchmarkScene::InitializeCamera(float aspectRatio)
+{
+    // Create the main camera. The view matrix is set every frame
+    m_camera = std::make_shared<Camera>();
+    m_camera->SetPerspectiveProjectionMatrix(1.0f, aspectRatio, 0.1f, 100.0f);
+
+    // Create a scene node for the camera, and add it to the scene
+    m_scene.AddSceneNode(std::make_shared<SceneCamera>("camera", m_camera));
+}
+
+void BenchmarkScene::InitializeLights()
+{
+    // Create a directional light and add it to the scene
+    std::shared_ptr<DirectionalLight> directionalLight = std::make_shared<DirectionalLight>();
+    directionalLight->SetDirection(glm::vec3(-0.3f, -1.0f, -0.3f)); // It will be normalized inside the function
+    directionalLight->SetIntensity(3.0f);
+    m_scene.AddSceneNode(std::make_shared<SceneLight>("directional light", directionalLight));
+
+    // A few point lights around the grid, so the batched lighting needs more than one pass
+    const int pointLightCount = 8;
+    for (int i = 0; i < pointLightCount; ++i)
+    {
+        float angle = glm::two_pi<float>() * i / pointLightCount;
+        std::shared_ptr<PointLight> pointLight = std::make_shared<PointLight>();
+        pointLight->SetPosition(glm::vec3(std::cos(angle), 0.5f, std::sin(angle)) * (0.5f * m_gridSize * m_spacing));
+        pointLight->SetDistanceAttenuation(glm::vec2(5.0f, 10.0f));
+        m_scene.AddSceneNode(std::make_shared<SceneLight>("point light " + std::to_string(i), pointLight));
+    }
+}
+
+void BenchmarkScene::InitializeMaterial(Renderer& renderer)
+{
+    // Load and build shader. With the null backend, the uniforms are read from the source
+    std::vector<const char*> vertexShaderPaths;
+    vertexShaderPaths.push_back("shaders/version330.glsl");
+    vertexShaderPaths.push_back("shaders/default.vert");
+    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
+
+    std::vector<const char*> fragmentShaderPaths;
+    fragmentShaderPaths.push_back("shaders/version330.glsl");
+    fragmentShaderPaths.push_back("shaders/utils.glsl");
+    fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
+    fragmentShaderPaths.push_back("shaders/lighting-batched.glsl");
+    fragmentShaderPaths.push_back("shaders/default_pbr.frag");
+    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
+
+    std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
+    shaderProgramPtr->Build(vertexShader, fragmentShader);
+
+    // Get transform related uniform locations
+    ShaderProgram::Location cameraPositionLocation = shaderProgramPtr->GetUniformLocation("CameraPosition");
+    ShaderProgram::Location worldMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldMatrix");
+    ShaderProgram::Location viewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("ViewProjMatrix");
+
+    // Register shader with renderer
+    renderer.RegisterShaderProgram(shaderProgramPtr,
+        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+        {
+            if (cameraChanged)
+            {
+                shaderProgram.SetUniform(cameraPositionLocation, camera.ExtractTranslation());
+                shaderProgram.SetUniform(viewProjMatrixLocation, camera.GetViewProjectionMatrix());
+            }
+            shaderProgram.SetUniform(worldMatrixLocation, worldMatrix);
+        },
+        renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
+    );
+
+    // Filter out uniforms that are not material properties
+    ShaderUniformCollection::NameSet filteredUniforms;
+    filteredUniforms.insert("CameraPosition");
+    filteredUniforms.insert("WorldMatrix");
+    filteredUniforms.insert("ViewProjMatrix");
+    filteredUniforms.insert("LightIndirect");
+    filteredUniforms.insert("LightCount");
+    filteredUniforms.insert("LightColors[0]");
+    filteredUniforms.insert("LightPositions[0]");
+    filteredUniforms.insert("LightDirections[0]");
+    filteredUniforms.insert("LightAttenuations[0]");
+
+    // Create reference material. There is no skybox, so the environment only adds the ambient color
+    m_defaultMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+    m_defaultMaterial->SetUniformValue("AmbientColor", glm::vec3(0.25f));
+    m_defaultMaterial->SetUniformValue("Color", glm::vec3(1.0f));
+}
+
+void BenchmarkScene::InitializeModels(unsigned int modelCount, bool occluders)
+{
+    // Configure loader
+    ModelLoader loader(m_defaultMaterial);
+    loader.SetCreateMaterials(true);
+    loader.GetTexture2DLoader().SetFlipVertical(true);
+
+    // Link vertex properties to attributes
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Position, "VertexPosition");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Normal, "VertexNormal");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Tangent, "VertexTangent");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::Bitangent, "VertexBitangent");
+    loader.SetMaterialAttribute(VertexAttribute::Semantic::TexCoord0, "VertexTexCoord");
+
+    // Link material properties to uniforms
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::DiffuseColor, "Color");
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::DiffuseTexture, "ColorTexture");
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::NormalTexture, "NormalTexture");
+    loader.SetMaterialProperty(ModelLoader::MaterialProperty::SpecularTexture, "SpecularTexture");
+
+    // Load the model once, and add it to the scene in a grid centered in the origin
+    std::shared_ptr<Model> chestModel = loader.LoadShared("models/treasure_chest/treasure_chest.obj");
+
+    if (occluders)
+    {
+        // The occluder must not cover anything that the chest doesn't, so it is smaller than the bounds of the mesh
+        AabbBounds bounds = chestModel->GetMesh().GetBounds();
+        glm::vec3 boxMin = bounds.GetCenter() - 0.8f * bounds.GetSize();
+        glm::vec3 boxMax = bounds.GetCenter() + 0.8f * bounds.GetSize();
+
+        m_chestOccluder = std::make_shared<OccluderMesh>();
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            m_chestOccluder->positions.push_back(glm::vec3(i & 1 ? boxMax.x : boxMin.x, i & 2 ? boxMax.y : boxMin.y, i & 4 ? boxMax.z : boxMin.z));
+        }
+        // Two triangles for each face. The culler rasterizes both sides, so the winding doesn't matter
+        m_chestOccluder->indices = {
+            0, 1, 3, 0, 3, 2,   4, 5, 7, 4, 7, 6,   // -Z, +Z
+            0, 1, 5, 0, 5, 4,   2, 3, 7, 2, 7, 6,   // -Y, +Y
+            0, 2, 6, 0, 6, 4,   1, 3, 7, 1, 7, 5 }; // -X, +X
+    }
+
+    float offset = 0.5f * (m_gridSize - 1) * m_spacing;
+    for (unsigned int i = 0; i < modelCount; ++i)
+    {
+        std::shared_ptr<Transform> transform = std::make_shared<Transform>();
+        transform->SetTranslation(glm::vec3((i % m_gridSize) * m_spacing - offset, 0.0f, (i / m_gridSize) * m_spacing - offset));
+        transform->SetRotation(glm::vec3(0.0f, 0.5f * i, 0.0f));
+        std::shared_ptr<SceneModel> sceneModel = std::make_shared<SceneModel>("treasure chest " + std::to_string(i), chestModel, transform);
+        sceneModel->SetOccluder(m_chestOccluder);
+        m_scene.AddSceneNode(sceneModel);
+    }
+}
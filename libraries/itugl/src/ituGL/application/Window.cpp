@@ -1,7 +1,7 @@
 #include <ituGL/application/Window.h>
 
 // Create the internal GLFW window. We provide some hints about it to OpenGL
-Window::Window(int width, int height, const char* title) : m_window(nullptr)
+Window::Window(int width, int height, const char* title, bool headless) : m_window(nullptr)
 {
     // Set some hints for window creation
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -9,7 +9,27 @@ Window::Window(int width, int height, const char* title) : m_window(nullptr)
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 
+    if (headless)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
+
     m_window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+
+    if (headless)
+    {
+        // EGL is not available everywhere. Fall back to the native context API, still with a hidden window
+        if (!m_window)
+        {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+            m_window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        }
+
+        // Don't leak the hints to the windows created later
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+    }
 }
 
 // If we have an internal GLFW window, destroy it
@@ -1,8 +1,11 @@
 #include <ituGL/asset/ModelLoader.h>
 
 #include <ituGL/geometry/VertexFormat.h>
+#include <ituGL/geometry/GeometryArena.h>
 #include <ituGL/shader/Material.h>
+#include <ituGL/scene/Bounds.h>
 #include <ituGL/asset/Texture2DLoader.h>
+#include <ituGL/utils/CpuProfiler.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -12,6 +15,7 @@
 ModelLoader::ModelLoader(std::shared_ptr<Material> referenceMaterial)
     : m_referenceMaterial(referenceMaterial)
     , m_createMaterials(false)
+    , m_createPositionStreams(false)
 {
     m_textureLoader.SetGenerateMipmap(true);
 }
@@ -39,6 +43,16 @@ void ModelLoader::SetCreateMaterials(bool createMaterials)
     m_createMaterials = createMaterials;
 }
 
+bool ModelLoader::GetCreatePositionStreams() const
+{
+    return m_createPositionStreams;
+}
+
+void ModelLoader::SetCreatePositionStreams(bool createPositionStreams)
+{
+    m_createPositionStreams = createPositionStreams;
+}
+
 Texture2DLoader& ModelLoader::GetTexture2DLoader()
 {
     return m_textureLoader;
@@ -49,6 +63,16 @@ const Texture2DLoader& ModelLoader::GetTexture2DLoader() const
     return m_textureLoader;
 }
 
+std::shared_ptr<GeometryArena> ModelLoader::GetGeometryArena() const
+{
+    return m_geometryArena;
+}
+
+void ModelLoader::SetGeometryArena(std::shared_ptr<GeometryArena> geometryArena)
+{
+    m_geometryArena = geometryArena;
+}
+
 bool ModelLoader::SetMaterialAttribute(VertexAttribute::Semantic semantic, const char* attributeName)
 {
     bool found = false;
@@ -75,12 +99,14 @@ bool ModelLoader::SetMaterialProperty(MaterialProperty materialProperty, const c
 
 Model ModelLoader::Load(const char* path)
 {
+    ITUGL_PROFILE_SCOPE("ModelLoader::Load");
+
     Model model;
 
     // Read the file using Assimp importer
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(path,
-        aiProcess_CalcTangentSpace | aiProcess_GenNormals | aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+        aiProcess_CalcTangentSpace | aiProcess_GenNormals | aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType | aiProcess_GenBoundingBoxes);
 
     m_baseFolder = path;
     m_baseFolder.resize(m_baseFolder.rfind('/') + 1);
@@ -93,8 +119,18 @@ Model ModelLoader::Load(const char* path)
         for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
         {
             aiMesh& meshData = *scene->mMeshes[meshIndex];
+            unsigned int firstSubmeshIndex = mesh.GetSubmeshCount();
             GenerateSubmesh(mesh, meshData);
 
+            // Store the local bounds, computed by aiProcess_GenBoundingBoxes
+            glm::vec3 boundsMin(meshData.mAABB.mMin.x, meshData.mAABB.mMin.y, meshData.mAABB.mMin.z);
+            glm::vec3 boundsMax(meshData.mAABB.mMax.x, meshData.mAABB.mMax.y, meshData.mAABB.mMax.z);
+            AabbBounds bounds(0.5f * (boundsMin + boundsMax), 0.5f * (boundsMax - boundsMin));
+            for (unsigned int submeshIndex = firstSubmeshIndex; submeshIndex < mesh.GetSubmeshCount(); ++submeshIndex)
+            {
+                mesh.SetSubmeshBounds(submeshIndex, bounds);
+            }
+
             std::shared_ptr<Material> material = m_referenceMaterial;
             if (m_createMaterials)
             {
@@ -114,6 +150,13 @@ void ModelLoader::GenerateSubmesh(Mesh& mesh, const aiMesh& meshData)
     VertexFormat vertexFormat;
     bool interleaved = true;
     std::vector<GLubyte> vertexData = CollectVertexData(meshData, vertexFormat, interleaved);
+
+    // Try to store it in the arena first
+    if (m_geometryArena && GenerateArenaSubmesh(mesh, meshData, vertexFormat, vertexData))
+    {
+        return;
+    }
+
     int vboIndex = mesh.AddVertexData<GLubyte>(vertexData);
 
     // Collect element data
@@ -123,6 +166,13 @@ void ModelLoader::GenerateSubmesh(Mesh& mesh, const aiMesh& meshData)
     std::vector<GLubyte> elementData = CollectElementData(meshData, elementType, primitives, elementCounts);
     int eboIndex = mesh.AddElementData<GLubyte>(elementData);
 
+    // Copy the positions again, de-interleaved from the other attributes
+    int positionVboIndex = -1;
+    if (m_createPositionStreams)
+    {
+        positionVboIndex = mesh.AddVertexData(std::span<const aiVector3D>(meshData.mVertices, meshData.mNumVertices));
+    }
+
     // Add submeshes
     int start = 0;
     assert(primitives.size() == elementCounts.size());
@@ -130,11 +180,46 @@ void ModelLoader::GenerateSubmesh(Mesh& mesh, const aiMesh& meshData)
     {
         Drawcall::Primitive primitive = primitives[i];
         int end = elementCounts[i];
-        mesh.AddSubmesh(primitive, start, end - start, elementType, eboIndex, vboIndex, vertexFormat.LayoutBegin(static_cast<int>(vertexData.size()), interleaved), vertexFormat.LayoutEnd(), m_materialAttributeMap);
+        unsigned int submeshIndex = mesh.AddSubmesh(primitive, start, end - start, elementType, vboIndex, eboIndex, vertexFormat.LayoutBegin(static_cast<int>(vertexData.size()), interleaved), vertexFormat.LayoutEnd(), m_materialAttributeMap);
+        if (positionVboIndex >= 0)
+        {
+            // Same elements, so the drawcall of the submesh works with both VAOs
+            mesh.SetSubmeshPositionVertexArray(submeshIndex, mesh.AddPositionVertexArray(positionVboIndex, eboIndex));
+        }
         start = end;
     }
 }
 
+bool ModelLoader::GenerateArenaSubmesh(Mesh& mesh, const aiMesh& meshData, const VertexFormat& vertexFormat, std::span<const GLubyte> vertexData)
+{
+    // Arena elements are always GLuint, so every submesh can go in the same multi-draw
+    std::vector<GLuint> elements;
+    elements.reserve(meshData.mNumFaces * 3);
+    for (unsigned int faceIndex = 0; faceIndex < meshData.mNumFaces; ++faceIndex)
+    {
+        const aiFace& face = meshData.mFaces[faceIndex];
+        elements.insert(elements.end(), face.mIndices, face.mIndices + face.mNumIndices);
+    }
+
+    // aiProcess_SortByPType splits meshes by primitive type, so all faces have the same number of indices
+    if (elements.empty())
+    {
+        return false;
+    }
+    Drawcall::Primitive primitive = GetPrimitiveType(meshData.mFaces[0].mNumIndices);
+
+    Drawcall drawcall;
+    const VertexArrayObject* vao = m_geometryArena->Allocate(vertexFormat, m_materialAttributeMap,
+        std::as_bytes(vertexData), elements, primitive, drawcall);
+    if (!vao)
+    {
+        return false;
+    }
+
+    mesh.AddSubmesh(m_geometryArena, *vao, drawcall);
+    return true;
+}
+
 std::shared_ptr<Material> ModelLoader::GenerateMaterial(const aiMaterial& materialData)
 {
     std::shared_ptr<Material> material = std::make_shared<Material>(*m_referenceMaterial);
@@ -1,5 +1,6 @@
 #include <ituGL/asset/TextureCubemapLoader.h>
 
+#include <ituGL/utils/CpuProfiler.h>
 #include <cassert>
 #include <stb_image.h>
 
@@ -14,6 +15,8 @@ TextureCubemapLoader::TextureCubemapLoader(TextureObject::Format format, Texture
 
 TextureCubemapObject TextureCubemapLoader::Load(const char* path)
 {
+    ITUGL_PROFILE_SCOPE("TextureCubemapLoader::Load");
+
     TextureCubemapObject textureCubemap;
 
     int width, height;
@@ -40,6 +40,22 @@ void BufferObject::Unbind(Target target)
     glBindBuffer(target, handle);
 }
 
+// Bind the buffer handle to an indexed binding point of the target. It also binds it to the target
+void BufferObject::BindBase(Target target, GLuint index) const
+{
+    assert(target == Target::UniformBuffer || target == Target::ShaderStorageBuffer);
+    Handle handle = GetHandle();
+    glBindBufferBase(target, index, handle);
+}
+
+// Bind a range of the buffer to an indexed binding point of the target. It also binds it to the target
+void BufferObject::BindRange(Target target, GLuint index, GLintptr offset, GLsizeiptr size) const
+{
+    assert(target == Target::UniformBuffer || target == Target::ShaderStorageBuffer);
+    Handle handle = GetHandle();
+    glBindBufferRange(target, index, handle, offset, size);
+}
+
 // Get buffer Target and allocate buffer data
 void BufferObject::AllocateData(size_t size, Usage usage)
 {
@@ -63,3 +79,35 @@ void BufferObject::UpdateData(std::span<const std::byte> data, size_t offset)
     Target target = GetTarget();
     glBufferSubData(target, offset, data.size_bytes(), data.data());
 }
+
+// Get buffer Target and allocate immutable buffer storage
+void BufferObject::AllocateStorage(size_t size, GLbitfield flags)
+{
+    assert(IsBound());
+    assert(IsStorageSupported());
+    Target target = GetTarget();
+    glBufferStorage(target, size, nullptr, flags);
+}
+
+bool BufferObject::IsStorageSupported()
+{
+    // Core in OpenGL 4.4
+    return GLAD_GL_VERSION_4_4;
+}
+
+// Get buffer Target and map a range of the buffer
+std::span<std::byte> BufferObject::MapRange(size_t offset, size_t size, GLbitfield access)
+{
+    assert(IsBound());
+    Target target = GetTarget();
+    void* data = glMapBufferRange(target, offset, size, access);
+    return data ? std::span<std::byte>(static_cast<std::byte*>(data), size) : std::span<std::byte>();
+}
+
+// Get buffer Target and unmap the buffer
+bool BufferObject::Unmap()
+{
+    assert(IsBound());
+    Target target = GetTarget();
+    return glUnmapBuffer(target) == GL_TRUE;
+}
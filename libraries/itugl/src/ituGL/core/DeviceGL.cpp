@@ -1,15 +1,27 @@
 #include <ituGL/core/DeviceGL.h>
 
 #include <ituGL/application/Window.h>
+#include <ituGL/core/NullBackendGL.h>
 #include <GLFW/glfw3.h>
+#include <limits>
 #include <cassert>
 
 DeviceGL* DeviceGL::m_instance = nullptr;
 
-DeviceGL::DeviceGL() : m_contextLoaded(false)
+DeviceGL::DeviceGL(Backend backend) : m_backend(backend), m_contextLoaded(false), m_issuedStateCalls(0), m_elidedStateCalls(0)
 {
     m_instance = this;
 
+    InvalidateState();
+
+    if (m_backend == Backend::Null)
+    {
+        // No window needed, the null functions are the context
+        NullBackendGL::Install();
+        m_contextLoaded = true;
+        return;
+    }
+
     // Init GLFW
     glfwInit();
 }
@@ -19,12 +31,17 @@ DeviceGL::~DeviceGL()
     m_instance = nullptr;
 
     // Terminate GLFW
-    glfwTerminate();
+    if (m_backend == Backend::Device)
+    {
+        glfwTerminate();
+    }
 }
 
 // Set the window that OpenGL will use for rendering
 void DeviceGL::SetCurrentWindow(Window& window)
 {
+    assert(m_backend == Backend::Device);
+
     GLFWwindow* glfwWindow = window.GetInternalWindow();
     glfwMakeContextCurrent(glfwWindow);
 
@@ -36,6 +53,9 @@ void DeviceGL::SetCurrentWindow(Window& window)
         // Set callback to be called when the window is resized
         glfwSetFramebufferSizeCallback(glfwWindow, FrameBufferResized);
     }
+
+    // New context, the state we knew is not valid anymore
+    InvalidateState();
 }
 
 // Set the dimensions of the viewport
@@ -44,10 +64,24 @@ void DeviceGL::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
     glViewport(0, 0, width, height);
 }
 
+// Get the dimensions of the current viewport
+void DeviceGL::GetViewport(GLint& x, GLint& y, GLsizei& width, GLsizei& height) const
+{
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    x = viewport[0];
+    y = viewport[1];
+    width = viewport[2];
+    height = viewport[3];
+}
+
 // Poll the events in the window event queue
 void DeviceGL::PollEvents()
 {
-    glfwPollEvents();
+    if (m_backend == Backend::Device)
+    {
+        glfwPollEvents();
+    }
 }
 
 // Callback called when the framebuffer changes size
@@ -82,22 +116,37 @@ void DeviceGL::Clear(bool clearColor, const Color& color, bool clearDepth, GLdou
     glClear(mask);
 }
 
-// Get if a feature is enabled
+void DeviceGL::IssueMemoryBarrier(GLbitfield barriers)
+{
+    glMemoryBarrier(barriers);
+}
+
+// Get if a feature is enabled. Only queries GL the first time, or after the state is invalidated
 bool DeviceGL::IsFeatureEnabled(GLenum feature) const
 {
-    return glIsEnabled(feature);
+    auto itFind = m_features.find(feature);
+    if (itFind == m_features.end())
+    {
+        itFind = m_features.emplace(feature, glIsEnabled(feature) == GL_TRUE).first;
+    }
+    return itFind->second;
 }
 
 // enable / disable a feature
 void DeviceGL::SetFeatureEnabled(GLenum feature, bool enabled)
 {
-    if (enabled)
-    {
-        glEnable(feature);
-    }
-    else
+    auto itFind = m_features.find(feature);
+    if (CheckStateChange(itFind == m_features.end() || itFind->second != enabled))
     {
-        glDisable(feature);
+        if (enabled)
+        {
+            glEnable(feature);
+        }
+        else
+        {
+            glDisable(feature);
+        }
+        m_features[feature] = enabled;
     }
 }
 
@@ -110,5 +159,320 @@ void DeviceGL::SetWireframeEnabled(bool enabled)
 // enable / disable v-sync
 void DeviceGL::SetVSyncEnabled(bool enabled)
 {
-    glfwSwapInterval(enabled ? 1 : 0);
+    if (m_backend == Backend::Device)
+    {
+        glfwSwapInterval(enabled ? 1 : 0);
+    }
+}
+
+void DeviceGL::SetDepthFunction(GLenum function)
+{
+    if (CheckStateChange(m_depthFunction != function))
+    {
+        glDepthFunc(function);
+        m_depthFunction = function;
+    }
+}
+
+void DeviceGL::SetDepthWrite(bool enabled)
+{
+    GLuint depthWrite = enabled ? GL_TRUE : GL_FALSE;
+    if (CheckStateChange(m_depthWrite != depthWrite))
+    {
+        glDepthMask(static_cast<GLboolean>(depthWrite));
+        m_depthWrite = depthWrite;
+    }
+}
+
+void DeviceGL::SetColorWrite(bool enabled)
+{
+    GLuint colorWrite = enabled ? GL_TRUE : GL_FALSE;
+    if (CheckStateChange(m_colorWrite != colorWrite))
+    {
+        GLboolean mask = static_cast<GLboolean>(colorWrite);
+        glColorMask(mask, mask, mask, mask);
+        m_colorWrite = colorWrite;
+    }
+}
+
+void DeviceGL::SetCullFace(GLenum face)
+{
+    if (CheckStateChange(m_cullFace != face))
+    {
+        glCullFace(face);
+        m_cullFace = face;
+    }
+}
+
+void DeviceGL::SetScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    std::array<GLint, 4> scissor = { x, y, width, height };
+    if (CheckStateChange(m_scissor != scissor))
+    {
+        glScissor(x, y, width, height);
+        m_scissor = scissor;
+    }
+}
+
+void DeviceGL::SetStencilFunction(GLenum face, GLenum function, GLint refValue, GLuint mask)
+{
+    bool front = face != GL_BACK;
+    bool back = face != GL_FRONT;
+    bool changedFront = front && (m_stencilFunctions[0] != function || m_stencilRefValues[0] != refValue || m_stencilMasks[0] != mask);
+    bool changedBack = back && (m_stencilFunctions[1] != function || m_stencilRefValues[1] != refValue || m_stencilMasks[1] != mask);
+    if (CheckStateChange(changedFront || changedBack))
+    {
+        glStencilFuncSeparate(face, function, refValue, mask);
+        for (int i = 0; i < 2; ++i)
+        {
+            if (i == 0 ? front : back)
+            {
+                m_stencilFunctions[i] = function;
+                m_stencilRefValues[i] = refValue;
+                m_stencilMasks[i] = mask;
+            }
+        }
+    }
+}
+
+void DeviceGL::SetStencilOperations(GLenum face, GLenum stencilFail, GLenum depthFail, GLenum depthPass)
+{
+    std::array<GLenum, 3> operations = { stencilFail, depthFail, depthPass };
+    bool front = face != GL_BACK;
+    bool back = face != GL_FRONT;
+    bool changed = (front && m_stencilOperations[0] != operations) || (back && m_stencilOperations[1] != operations);
+    if (CheckStateChange(changed))
+    {
+        glStencilOpSeparate(face, stencilFail, depthFail, depthPass);
+        if (front)
+        {
+            m_stencilOperations[0] = operations;
+        }
+        if (back)
+        {
+            m_stencilOperations[1] = operations;
+        }
+    }
+}
+
+void DeviceGL::SetBlendEquation(GLenum equationColor, GLenum equationAlpha)
+{
+    if (CheckStateChange(m_blendEquations[0] != equationColor || m_blendEquations[1] != equationAlpha))
+    {
+        if (equationColor == equationAlpha)
+        {
+            glBlendEquation(equationColor);
+        }
+        else
+        {
+            glBlendEquationSeparate(equationColor, equationAlpha);
+        }
+        m_blendEquations = { equationColor, equationAlpha };
+    }
+}
+
+void DeviceGL::SetBlendFunction(GLenum sourceColor, GLenum destColor, GLenum sourceAlpha, GLenum destAlpha)
+{
+    std::array<GLenum, 4> blendFunctions = { sourceColor, destColor, sourceAlpha, destAlpha };
+    if (CheckStateChange(m_blendFunctions != blendFunctions))
+    {
+        if (sourceColor == sourceAlpha && destColor == destAlpha)
+        {
+            glBlendFunc(sourceColor, destColor);
+        }
+        else
+        {
+            glBlendFuncSeparate(sourceColor, destColor, sourceAlpha, destAlpha);
+        }
+        m_blendFunctions = blendFunctions;
+    }
+}
+
+void DeviceGL::SetBlendColor(const Color& color)
+{
+    std::array<float, 4> blendColor = { color.GetRed(), color.GetGreen(), color.GetBlue(), color.GetAlpha() };
+    // Compared element by element: NaN is never equal, so an unknown color is always set
+    bool changed = false;
+    for (int i = 0; i < 4; ++i)
+    {
+        changed |= !(m_blendColor[i] == blendColor[i]);
+    }
+    if (CheckStateChange(changed))
+    {
+        glBlendColor(blendColor[0], blendColor[1], blendColor[2], blendColor[3]);
+        m_blendColor = blendColor;
+    }
+}
+
+void DeviceGL::UseProgram(GLuint handle)
+{
+    if (CheckStateChange(m_program != handle))
+    {
+        glUseProgram(handle);
+        m_program = handle;
+    }
+}
+
+void DeviceGL::BindVertexArray(GLuint handle)
+{
+    if (CheckStateChange(m_vertexArray != handle))
+    {
+        glBindVertexArray(handle);
+        m_vertexArray = handle;
+    }
+}
+
+void DeviceGL::BindFramebuffer(GLenum target, GLuint handle)
+{
+    bool draw = target != GL_READ_FRAMEBUFFER;
+    bool read = target != GL_DRAW_FRAMEBUFFER;
+    if (CheckStateChange((draw && m_drawFramebuffer != handle) || (read && m_readFramebuffer != handle)))
+    {
+        glBindFramebuffer(target, handle);
+        if (draw)
+        {
+            m_drawFramebuffer = handle;
+        }
+        if (read)
+        {
+            m_readFramebuffer = handle;
+        }
+    }
+}
+
+void DeviceGL::SetActiveTexture(GLint textureUnit)
+{
+    if (CheckStateChange(m_activeTexture != textureUnit))
+    {
+        glActiveTexture(GL_TEXTURE0 + textureUnit);
+        m_activeTexture = textureUnit;
+    }
+}
+
+void DeviceGL::BindTexture(GLenum target, GLuint handle)
+{
+    int targetIndex = GetTextureTargetIndex(target);
+    bool isShadowed = targetIndex >= 0 && m_activeTexture >= 0 && m_activeTexture < static_cast<GLint>(MaxTextureUnits);
+    if (!isShadowed)
+    {
+        // Not in the shadow copy, always issue it
+        CheckStateChange(true);
+        glBindTexture(target, handle);
+    }
+    else if (CheckStateChange(m_textures[m_activeTexture][targetIndex] != handle))
+    {
+        glBindTexture(target, handle);
+        m_textures[m_activeTexture][targetIndex] = handle;
+    }
+}
+
+void DeviceGL::OnProgramDeleted(GLuint handle)
+{
+    // A program in use is only flagged for deletion, so we can't know when the name is released
+    if (m_program == handle)
+    {
+        m_program = UnknownState;
+    }
+}
+
+void DeviceGL::OnVertexArrayDeleted(GLuint handle)
+{
+    if (m_vertexArray == handle)
+    {
+        m_vertexArray = 0;
+    }
+}
+
+void DeviceGL::OnFramebufferDeleted(GLuint handle)
+{
+    if (m_drawFramebuffer == handle)
+    {
+        m_drawFramebuffer = 0;
+    }
+    if (m_readFramebuffer == handle)
+    {
+        m_readFramebuffer = 0;
+    }
+}
+
+void DeviceGL::OnTextureDeleted(GLuint handle)
+{
+    for (auto& unitTextures : m_textures)
+    {
+        for (GLuint& texture : unitTextures)
+        {
+            if (texture == handle)
+            {
+                texture = 0;
+            }
+        }
+    }
+}
+
+void DeviceGL::InvalidateState()
+{
+    m_features.clear();
+
+    m_depthFunction = UnknownState;
+    m_depthWrite = UnknownState;
+
+    m_colorWrite = UnknownState;
+
+    m_cullFace = UnknownState;
+    m_scissor.fill(-1);
+
+    m_stencilFunctions.fill(UnknownState);
+    m_stencilRefValues.fill(0);
+    m_stencilMasks.fill(0);
+    m_stencilOperations.fill({ UnknownState, UnknownState, UnknownState });
+
+    m_blendEquations.fill(UnknownState);
+    m_blendFunctions.fill(UnknownState);
+    m_blendColor.fill(std::numeric_limits<float>::quiet_NaN());
+
+    m_program = UnknownState;
+    m_vertexArray = UnknownState;
+    m_drawFramebuffer = UnknownState;
+    m_readFramebuffer = UnknownState;
+
+    m_activeTexture = -1;
+    for (auto& unitTextures : m_textures)
+    {
+        unitTextures.fill(UnknownState);
+    }
+}
+
+void DeviceGL::ResetStateCallCounters()
+{
+    m_issuedStateCalls = 0;
+    m_elidedStateCalls = 0;
+}
+
+bool DeviceGL::CheckStateChange(bool changed)
+{
+    if (changed)
+    {
+        ++m_issuedStateCalls;
+    }
+    else
+    {
+        ++m_elidedStateCalls;
+    }
+    return changed;
+}
+
+int DeviceGL::GetTextureTargetIndex(GLenum target)
+{
+    switch (target)
+    {
+    case GL_TEXTURE_1D: return 0;
+    case GL_TEXTURE_2D: return 1;
+    case GL_TEXTURE_3D: return 2;
+    case GL_TEXTURE_1D_ARRAY: return 3;
+    case GL_TEXTURE_2D_ARRAY: return 4;
+    case GL_TEXTURE_RECTANGLE: return 5;
+    case GL_TEXTURE_CUBE_MAP: return 6;
+    case GL_TEXTURE_2D_MULTISAMPLE: return 7;
+    default: return -1;
+    }
 }
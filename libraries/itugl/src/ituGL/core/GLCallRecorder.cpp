@@ -0,0 +1,181 @@
+#include <ituGL/core/GLCallRecorder.h>
+
+#include <ituGL/utils/Json.h>
+
+#include <glad/glad.h>
+#include <cstdarg>
+#include <unordered_map>
+
+struct RecorderState
+{
+    bool callbackInstalled = false;
+    bool recording = false;
+
+    // glad passes the name as a string literal, so the pointer identifies the entry point
+    std::unordered_map<const char*, unsigned int> callCounts;
+
+    unsigned int drawCallCount = 0;
+    std::uint64_t bufferBytesUploaded = 0;
+    std::uint64_t textureBytesUploaded = 0;
+};
+
+static RecorderState& GetRecorderState()
+{
+    static RecorderState state;
+    return state;
+}
+
+// Size in bytes of a pixel in client memory
+static unsigned int GetPixelSize(GLenum format, GLenum type)
+{
+    unsigned int componentCount = 1;
+    switch (format)
+    {
+    case GL_RG:
+    case GL_RG_INTEGER:
+        componentCount = 2;
+        break;
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGB_INTEGER:
+        componentCount = 3;
+        break;
+    case GL_RGBA:
+    case GL_BGRA:
+    case GL_RGBA_INTEGER:
+        componentCount = 4;
+        break;
+    }
+
+    switch (type)
+    {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE:
+        return componentCount;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT:
+        return componentCount * 2;
+    case GL_UNSIGNED_INT:
+    case GL_INT:
+    case GL_FLOAT:
+        return componentCount * 4;
+    default:
+        // Packed types store the whole pixel in one value
+        return 4;
+    }
+}
+
+// Called by glad before every GL call, with the arguments of the call
+static void RecordCall(const char* name, void* function, int argumentCount, ...)
+{
+    RecorderState& state = GetRecorderState();
+    if (!state.recording)
+    {
+        return;
+    }
+
+    state.callCounts[name]++;
+
+    if (function == (void*)glDrawArrays || function == (void*)glDrawElements
+        || function == (void*)glDrawArraysInstanced || function == (void*)glDrawElementsInstanced
+        || function == (void*)glDrawElementsBaseVertex || function == (void*)glDrawElementsInstancedBaseVertex
+        || function == (void*)glMultiDrawElementsIndirect)
+    {
+        state.drawCallCount++;
+        return;
+    }
+
+    // Read the sizes of the uploads. Arguments narrower than int are promoted in the variadic call
+    va_list arguments;
+    va_start(arguments, argumentCount);
+    if (function == (void*)glBufferData || function == (void*)glBufferStorage)
+    {
+        va_arg(arguments, unsigned int); // target
+        GLsizeiptr size = va_arg(arguments, GLsizeiptr);
+        const void* data = va_arg(arguments, const void*);
+        state.bufferBytesUploaded += data ? size : 0;
+    }
+    else if (function == (void*)glBufferSubData)
+    {
+        va_arg(arguments, unsigned int); // target
+        va_arg(arguments, GLintptr); // offset
+        GLsizeiptr size = va_arg(arguments, GLsizeiptr);
+        const void* data = va_arg(arguments, const void*);
+        state.bufferBytesUploaded += data ? size : 0;
+    }
+    else if (function == (void*)glTexImage2D)
+    {
+        va_arg(arguments, unsigned int); // target
+        va_arg(arguments, int); // level
+        va_arg(arguments, int); // internal format
+        int width = va_arg(arguments, int);
+        int height = va_arg(arguments, int);
+        va_arg(arguments, int); // border
+        GLenum format = va_arg(arguments, unsigned int);
+        GLenum type = va_arg(arguments, unsigned int);
+        const void* data = va_arg(arguments, const void*);
+        state.textureBytesUploaded += data ? static_cast<std::uint64_t>(width) * height * GetPixelSize(format, type) : 0;
+    }
+    va_end(arguments);
+}
+
+void GLCallRecorder::BeginRecording()
+{
+    RecorderState& state = GetRecorderState();
+    if (!state.callbackInstalled)
+    {
+        glad_set_pre_callback(RecordCall);
+        state.callbackInstalled = true;
+    }
+
+    state.callCounts.clear();
+    state.drawCallCount = 0;
+    state.bufferBytesUploaded = 0;
+    state.textureBytesUploaded = 0;
+    state.recording = true;
+}
+
+void GLCallRecorder::EndRecording()
+{
+    GetRecorderState().recording = false;
+}
+
+bool GLCallRecorder::IsRecording()
+{
+    return GetRecorderState().recording;
+}
+
+GLCallRecorder::Statistics GLCallRecorder::GetStatistics()
+{
+    const RecorderState& state = GetRecorderState();
+
+    Statistics statistics;
+    for (const auto& [name, count] : state.callCounts)
+    {
+        statistics.callCounts[name] += count;
+        statistics.callCount += count;
+    }
+    statistics.drawCallCount = state.drawCallCount;
+    statistics.bufferBytesUploaded = state.bufferBytesUploaded;
+    statistics.textureBytesUploaded = state.textureBytesUploaded;
+    return statistics;
+}
+
+void GLCallRecorder::WriteJson(std::ostream& stream, const Statistics& statistics)
+{
+    stream << "{\"calls\": " << statistics.callCount;
+    stream << ", \"drawCalls\": " << statistics.drawCallCount;
+    stream << ", \"bufferBytesUploaded\": " << statistics.bufferBytesUploaded;
+    stream << ", \"textureBytesUploaded\": " << statistics.textureBytesUploaded;
+    stream << ", \"callCounts\": {";
+    const char* separator = "";
+    for (const auto& [name, count] : statistics.callCounts)
+    {
+        stream << separator;
+        Json::WriteString(stream, name);
+        stream << ": " << count;
+        separator = ", ";
+    }
+    stream << "}}";
+}
@@ -0,0 +1,797 @@
+#include <ituGL/core/NullBackendGL.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Entry points used by ituGL and the exercises, without the gl prefix
+// They all get a function that does nothing and returns 0. Some of them are replaced later with a real implementation
+#define NULL_GL_FUNCTIONS(X) \
+    X(ActiveTexture) X(AttachShader) X(BeginQuery) X(BindBuffer) X(BindBufferBase) X(BindBufferRange) X(BindFramebuffer) \
+    X(BindImageTexture) X(BindTexture) X(BindVertexArray) X(BlendColor) X(BlendEquation) X(BlendEquationSeparate) X(BlendFunc) X(BlendFuncSeparate) \
+    X(BlitFramebuffer) X(BufferData) X(BufferStorage) X(BufferSubData) X(CheckFramebufferStatus) X(Clear) X(ClearColor) \
+    X(ClearDepth) X(ClearStencil) X(ClientWaitSync) X(ColorMask) X(CompileShader) X(CreateProgram) X(CreateShader) X(CullFace) \
+    X(DeleteBuffers) X(DeleteFramebuffers) X(DeleteProgram) X(DeleteQueries) X(DeleteShader) X(DeleteSync) X(DeleteTextures) \
+    X(DeleteVertexArrays) X(DepthFunc) X(DepthMask) X(Disable) X(DisableVertexAttribArray) X(DispatchCompute) X(DrawArrays) X(DrawArraysInstanced) \
+    X(DrawBuffer) X(DrawBuffers) X(DrawElements) X(DrawElementsBaseVertex) X(DrawElementsInstanced) X(DrawElementsInstancedBaseVertex) \
+    X(Enable) X(EnableVertexAttribArray) X(EndQuery) X(FenceSync) X(Finish) X(Flush) X(FramebufferTexture2D) X(GenBuffers) \
+    X(GenFramebuffers) X(GenQueries) X(GenTextures) X(GenVertexArrays) X(GenerateMipmap) X(GetActiveUniform) X(GetActiveUniformsiv) \
+    X(GetAttribLocation) X(GetError) X(GetFloatv) X(GetIntegerv) X(GetProgramInfoLog) X(GetProgramResourceIndex) X(GetProgramiv) \
+    X(GetQueryObjectui64v) X(GetQueryObjectuiv) X(GetShaderInfoLog) X(GetShaderiv) X(GetString) X(GetTexParameterIuiv) \
+    X(GetTexParameterfv) X(GetTexParameteriv) X(GetUniformBlockIndex) X(GetUniformIndices) X(GetUniformLocation) \
+    X(GetnUniformdv) X(GetnUniformfv) X(GetnUniformiv) X(GetnUniformuiv) X(IsEnabled) X(LinkProgram) X(MapBufferRange) \
+    X(MemoryBarrier) X(MultiDrawElementsIndirect) X(PixelStorei) X(PolygonMode) X(QueryCounter) X(ReadBuffer) X(ReadPixels) X(Scissor) \
+    X(ShaderSource) X(ShaderStorageBlockBinding) X(StencilFuncSeparate) X(StencilOpSeparate) X(TexBuffer) X(TexImage2D) \
+    X(TexImage2DMultisample) X(TexParameterIuiv) X(TexParameterf) X(TexParameterfv) X(TexParameteri) X(TexSubImage2D) \
+    X(Uniform1f) X(Uniform1i) X(Uniform1ui) X(Uniform2f) X(Uniform3f) X(Uniform4f) \
+    X(Uniform1dv) X(Uniform1fv) X(Uniform1iv) X(Uniform1uiv) X(Uniform2dv) X(Uniform2fv) X(Uniform2iv) X(Uniform2uiv) \
+    X(Uniform3dv) X(Uniform3fv) X(Uniform3iv) X(Uniform3uiv) X(Uniform4dv) X(Uniform4fv) X(Uniform4iv) X(Uniform4uiv) \
+    X(UniformBlockBinding) X(UniformMatrix2fv) X(UniformMatrix2x3fv) X(UniformMatrix2x4fv) X(UniformMatrix3fv) \
+    X(UniformMatrix3x2fv) X(UniformMatrix3x4fv) X(UniformMatrix4fv) X(UniformMatrix4x2fv) X(UniformMatrix4x3fv) \
+    X(UnmapBuffer) X(UseProgram) X(VertexAttribDivisor) X(VertexAttribIPointer) X(VertexAttribPointer) X(Viewport)
+
+// Function that ignores its arguments and returns a zero value, for any signature
+template<typename TFunction>
+struct NullFunction;
+
+template<typename TResult, typename... TArgs>
+struct NullFunction<TResult(APIENTRYP)(TArgs...)>
+{
+    static TResult APIENTRY Call(TArgs...)
+    {
+        return TResult();
+    }
+};
+
+struct NullShader
+{
+    GLenum type;
+    std::string source;
+    bool compiled = false;
+};
+
+struct NullUniform
+{
+    std::string name;
+    GLenum type;
+    GLint size;
+    GLint location;
+};
+
+struct NullProgram
+{
+    bool linked = false;
+    std::vector<GLuint> shaders;
+    std::vector<NullUniform> uniforms;
+    std::vector<std::string> uniformBlocks;
+    std::vector<std::string> storageBlocks;
+    std::vector<std::pair<std::string, GLint>> attributes;
+};
+
+struct NullState
+{
+    bool installed = false;
+
+    // All objects share the same names. 0 is never used, it means no object
+    GLuint nextHandle = 1;
+    unsigned int liveObjectCount = 0;
+
+    std::unordered_map<GLuint, NullShader> shaders;
+    std::unordered_map<GLuint, NullProgram> programs;
+
+    // Client memory returned when mapping a buffer, by buffer name
+    std::unordered_map<GLenum, GLuint> boundBuffers;
+    std::unordered_map<GLuint, std::vector<std::byte>> bufferMemory;
+
+    // State that can be queried back
+    std::unordered_set<GLenum> enabledFeatures;
+    std::array<GLint, 4> viewport = {};
+    GLint activeTexture = GL_TEXTURE0;
+};
+
+static NullState& GetNullState()
+{
+    static NullState state;
+    return state;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Shader reflection
+
+static GLenum GetUniformType(const std::string& typeName)
+{
+    static const std::unordered_map<std::string, GLenum> types =
+    {
+        { "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+        { "double", GL_DOUBLE }, { "dvec2", GL_DOUBLE_VEC2 }, { "dvec3", GL_DOUBLE_VEC3 }, { "dvec4", GL_DOUBLE_VEC4 },
+        { "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+        { "uint", GL_UNSIGNED_INT }, { "uvec2", GL_UNSIGNED_INT_VEC2 }, { "uvec3", GL_UNSIGNED_INT_VEC3 }, { "uvec4", GL_UNSIGNED_INT_VEC4 },
+        { "bool", GL_BOOL }, { "bvec2", GL_BOOL_VEC2 }, { "bvec3", GL_BOOL_VEC3 }, { "bvec4", GL_BOOL_VEC4 },
+        { "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+        { "mat2x3", GL_FLOAT_MAT2x3 }, { "mat2x4", GL_FLOAT_MAT2x4 }, { "mat3x2", GL_FLOAT_MAT3x2 },
+        { "mat3x4", GL_FLOAT_MAT3x4 }, { "mat4x2", GL_FLOAT_MAT4x2 }, { "mat4x3", GL_FLOAT_MAT4x3 },
+        { "sampler1D", GL_SAMPLER_1D }, { "sampler2D", GL_SAMPLER_2D }, { "sampler3D", GL_SAMPLER_3D },
+        { "samplerCube", GL_SAMPLER_CUBE }, { "sampler2DShadow", GL_SAMPLER_2D_SHADOW }, { "sampler2DArray", GL_SAMPLER_2D_ARRAY },
+        { "sampler2DMS", GL_SAMPLER_2D_MULTISAMPLE }, { "samplerBuffer", GL_SAMPLER_BUFFER },
+        { "isampler2D", GL_INT_SAMPLER_2D }, { "usampler2D", GL_UNSIGNED_INT_SAMPLER_2D },
+        { "isamplerBuffer", GL_INT_SAMPLER_BUFFER }, { "usamplerBuffer", GL_UNSIGNED_INT_SAMPLER_BUFFER },
+        { "image2D", GL_IMAGE_2D },
+    };
+    auto itFind = types.find(typeName);
+    return itFind != types.end() ? itFind->second : GL_NONE;
+}
+
+// Split the source in identifiers, numbers and symbols, without comments
+// Preprocessor lines are removed too, but the values of #define are kept to resolve array sizes
+static std::vector<std::string> TokenizeSource(const std::string& source, std::unordered_map<std::string, int>& defines)
+{
+    std::vector<std::string> tokens;
+    std::size_t i = 0;
+    bool lineStart = true;
+    while (i < source.size())
+    {
+        char c = source[i];
+        if (c == '\n')
+        {
+            lineStart = true;
+            ++i;
+        }
+        else if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            ++i;
+        }
+        else if (source.compare(i, 2, "//") == 0)
+        {
+            i = source.find('\n', i);
+            i = i == std::string::npos ? source.size() : i;
+        }
+        else if (source.compare(i, 2, "/*") == 0)
+        {
+            i = source.find("*/", i + 2);
+            i = i == std::string::npos ? source.size() : i + 2;
+        }
+        else if (c == '#' && lineStart)
+        {
+            std::size_t lineEnd = source.find('\n', i);
+            lineEnd = lineEnd == std::string::npos ? source.size() : lineEnd;
+            std::vector<std::string> directive;
+            std::size_t start = i + 1;
+            while (start < lineEnd)
+            {
+                std::size_t end = source.find_first_of(" \t\r", start);
+                end = std::min(end == std::string::npos ? lineEnd : end, lineEnd);
+                if (end > start)
+                {
+                    directive.push_back(source.substr(start, end - start));
+                }
+                start = end + 1;
+            }
+
+            // Conditions are not evaluated. Keep the first value, like #ifndef guards would
+            if (directive.size() >= 3 && directive[0] == "define" && std::isdigit(static_cast<unsigned char>(directive[2][0])))
+            {
+                defines.emplace(directive[1], std::stoi(directive[2]));
+            }
+            i = lineEnd;
+        }
+        else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+        {
+            std::size_t start = i;
+            while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_' || source[i] == '.'))
+            {
+                ++i;
+            }
+            tokens.push_back(source.substr(start, i - start));
+            lineStart = false;
+        }
+        else
+        {
+            tokens.push_back(std::string(1, c));
+            lineStart = false;
+            ++i;
+        }
+    }
+    return tokens;
+}
+
+// Add the uniforms, blocks and vertex inputs declared in the global scope of a shader
+static void ReflectShader(const NullShader& shader, NullProgram& program)
+{
+    std::unordered_map<std::string, int> defines;
+    std::vector<std::string> tokens = TokenizeSource(shader.source, defines);
+    auto getToken = [&tokens](std::size_t index) { return index < tokens.size() ? tokens[index] : std::string(); };
+    auto isQualifier = [](const std::string& token) { return token == "lowp" || token == "mediump" || token == "highp" || token == "flat"
+        || token == "readonly" || token == "writeonly" || token == "coherent" || token == "restrict"; };
+
+    int braceDepth = 0;
+    int parenDepth = 0;
+    GLint layoutLocation = -1;
+    GLint nextAttributeLocation = 0;
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        const std::string& token = tokens[i];
+        if (token == "{") { ++braceDepth; continue; }
+        if (token == "}") { --braceDepth; continue; }
+        if (token == "(") { ++parenDepth; continue; }
+        if (token == ")") { --parenDepth; continue; }
+        if (token == ";") { layoutLocation = -1; continue; }
+        if (braceDepth > 0 || parenDepth > 0)
+        {
+            continue;
+        }
+
+        if (token == "layout")
+        {
+            // layout (location = N, ...)
+            for (std::size_t j = i + 1; j < tokens.size() && tokens[j] != ")"; ++j)
+            {
+                if (tokens[j] == "location" && getToken(j + 1) == "=")
+                {
+                    layoutLocation = std::atoi(getToken(j + 2).c_str());
+                }
+            }
+        }
+        else if (token == "uniform" || token == "buffer")
+        {
+            std::size_t j = i + 1;
+            while (isQualifier(getToken(j)))
+            {
+                ++j;
+            }
+
+            // Blocks: uniform Name { ... }
+            if (getToken(j + 1) == "{")
+            {
+                std::vector<std::string>& blocks = token == "uniform" ? program.uniformBlocks : program.storageBlocks;
+                if (std::find(blocks.begin(), blocks.end(), getToken(j)) == blocks.end())
+                {
+                    blocks.push_back(getToken(j));
+                }
+                continue;
+            }
+
+            // Variables: uniform type name[size], name[size];
+            GLenum type = GetUniformType(getToken(j));
+            for (std::size_t k = j + 1; type != GL_NONE && k < tokens.size(); )
+            {
+                std::string name = tokens[k];
+                GLint size = 1;
+                if (getToken(k + 1) == "[")
+                {
+                    const std::string& sizeToken = getToken(k + 2);
+                    auto itDefine = defines.find(sizeToken);
+                    size = itDefine != defines.end() ? itDefine->second : std::max(std::atoi(sizeToken.c_str()), 1);
+                    k += 3;
+                }
+                ++k;
+
+                // The same uniform can be declared in several shaders of the program
+                auto isSameName = [&name](const NullUniform& uniform) { return uniform.name == name; };
+                if (std::none_of(program.uniforms.begin(), program.uniforms.end(), isSameName))
+                {
+                    program.uniforms.push_back({ name, type, size, 0 });
+                }
+
+                if (getToken(k) != ",")
+                {
+                    break;
+                }
+                ++k;
+            }
+        }
+        else if (token == "in" && shader.type == GL_VERTEX_SHADER)
+        {
+            std::size_t j = i + 1;
+            while (isQualifier(getToken(j)))
+            {
+                ++j;
+            }
+            GLint location = layoutLocation >= 0 ? layoutLocation : nextAttributeLocation;
+            nextAttributeLocation = location + 1;
+            program.attributes.emplace_back(getToken(j + 1), location);
+        }
+    }
+}
+
+// Split "Name[index]" in the name and the index
+static std::string ParseUniformName(const GLchar* name, GLint& index)
+{
+    std::string baseName(name);
+    index = 0;
+    std::size_t bracket = baseName.find('[');
+    if (bracket != std::string::npos)
+    {
+        index = std::atoi(baseName.c_str() + bracket + 1);
+        baseName.resize(bracket);
+    }
+    return baseName;
+}
+
+static const NullUniform* FindUniform(GLuint program, const GLchar* name, GLint& index)
+{
+    NullState& state = GetNullState();
+    auto itProgram = state.programs.find(program);
+    if (itProgram == state.programs.end())
+    {
+        return nullptr;
+    }
+    std::string baseName = ParseUniformName(name, index);
+    for (const NullUniform& uniform : itProgram->second.uniforms)
+    {
+        if (uniform.name == baseName && index < uniform.size)
+        {
+            return &uniform;
+        }
+    }
+    return nullptr;
+}
+
+static GLuint FindBlock(const std::vector<std::string>& blocks, const GLchar* name)
+{
+    auto itFind = std::find(blocks.begin(), blocks.end(), name);
+    return itFind != blocks.end() ? static_cast<GLuint>(itFind - blocks.begin()) : GL_INVALID_INDEX;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Objects
+
+static GLuint CreateHandle()
+{
+    NullState& state = GetNullState();
+    ++state.liveObjectCount;
+    return state.nextHandle++;
+}
+
+static void DeleteHandle(GLuint handle)
+{
+    NullState& state = GetNullState();
+    if (handle && state.liveObjectCount > 0)
+    {
+        --state.liveObjectCount;
+    }
+}
+
+static void APIENTRY NullGenObjects(GLsizei n, GLuint* handles)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        handles[i] = CreateHandle();
+    }
+}
+
+static void APIENTRY NullDeleteObjects(GLsizei n, const GLuint* handles)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        DeleteHandle(handles[i]);
+    }
+}
+
+static void APIENTRY NullDeleteBuffers(GLsizei n, const GLuint* handles)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        GetNullState().bufferMemory.erase(handles[i]);
+        DeleteHandle(handles[i]);
+    }
+}
+
+static GLuint APIENTRY NullCreateShader(GLenum type)
+{
+    GLuint handle = CreateHandle();
+    GetNullState().shaders[handle] = { type, std::string() };
+    return handle;
+}
+
+static void APIENTRY NullDeleteShader(GLuint shader)
+{
+    if (GetNullState().shaders.erase(shader))
+    {
+        DeleteHandle(shader);
+    }
+}
+
+static GLuint APIENTRY NullCreateProgram()
+{
+    GLuint handle = CreateHandle();
+    GetNullState().programs[handle] = NullProgram();
+    return handle;
+}
+
+static void APIENTRY NullDeleteProgram(GLuint program)
+{
+    if (GetNullState().programs.erase(program))
+    {
+        DeleteHandle(program);
+    }
+}
+
+static GLsync APIENTRY NullFenceSync(GLenum, GLbitfield)
+{
+    // Any value that is not null. Fences are never waited for
+    return reinterpret_cast<GLsync>(static_cast<std::uintptr_t>(1));
+}
+
+static GLenum APIENTRY NullClientWaitSync(GLsync, GLbitfield, GLuint64)
+{
+    return GL_ALREADY_SIGNALED;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Shaders and programs
+
+static void APIENTRY NullShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+{
+    std::string& source = GetNullState().shaders[shader].source;
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (lengths && lengths[i] >= 0)
+        {
+            source.append(strings[i], lengths[i]);
+        }
+        else
+        {
+            source.append(strings[i]);
+        }
+    }
+}
+
+static void APIENTRY NullGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    const NullShader& nullShader = GetNullState().shaders[shader];
+    switch (pname)
+    {
+    case GL_COMPILE_STATUS: *params = nullShader.compiled ? GL_TRUE : GL_FALSE; break;
+    case GL_SHADER_TYPE: *params = nullShader.type; break;
+    case GL_SHADER_SOURCE_LENGTH: *params = static_cast<GLint>(nullShader.source.size()) + 1; break;
+    default: *params = 0; break;
+    }
+}
+
+static void APIENTRY NullGetInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    if (length)
+    {
+        *length = 0;
+    }
+    if (bufSize > 0)
+    {
+        infoLog[0] = '\0';
+    }
+}
+
+static void APIENTRY NullCompileShader(GLuint shader)
+{
+    GetNullState().shaders[shader].compiled = true;
+}
+
+static void APIENTRY NullAttachShader(GLuint program, GLuint shader)
+{
+    GetNullState().programs[program].shaders.push_back(shader);
+}
+
+static void APIENTRY NullLinkProgram(GLuint program)
+{
+    NullState& state = GetNullState();
+    NullProgram& nullProgram = state.programs[program];
+    nullProgram.uniforms.clear();
+    nullProgram.uniformBlocks.clear();
+    nullProgram.storageBlocks.clear();
+    nullProgram.attributes.clear();
+    nullProgram.linked = true;
+    for (GLuint shader : nullProgram.shaders)
+    {
+        ReflectShader(state.shaders[shader], nullProgram);
+    }
+
+    // Each element of an array takes one location
+    GLint location = 0;
+    for (NullUniform& uniform : nullProgram.uniforms)
+    {
+        uniform.location = location;
+        location += uniform.size;
+    }
+}
+
+static void APIENTRY NullGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    const NullProgram& nullProgram = GetNullState().programs[program];
+    switch (pname)
+    {
+    case GL_LINK_STATUS:
+    case GL_VALIDATE_STATUS:
+        *params = nullProgram.linked ? GL_TRUE : GL_FALSE;
+        break;
+    case GL_ACTIVE_UNIFORMS:
+        *params = static_cast<GLint>(nullProgram.uniforms.size());
+        break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+        *params = 0;
+        for (const NullUniform& uniform : nullProgram.uniforms)
+        {
+            // Room for "[0]" and the null character
+            *params = std::max(*params, static_cast<GLint>(uniform.name.size()) + 4);
+        }
+        break;
+    case GL_ACTIVE_ATTRIBUTES:
+        *params = static_cast<GLint>(nullProgram.attributes.size());
+        break;
+    case GL_ACTIVE_UNIFORM_BLOCKS:
+        *params = static_cast<GLint>(nullProgram.uniformBlocks.size());
+        break;
+    case GL_ATTACHED_SHADERS:
+        *params = static_cast<GLint>(nullProgram.shaders.size());
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+static void APIENTRY NullGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    const NullUniform& uniform = GetNullState().programs[program].uniforms.at(index);
+
+    // Arrays are reported with the name of their first element
+    std::string uniformName = uniform.size > 1 ? uniform.name + "[0]" : uniform.name;
+    GLsizei nameLength = std::min(static_cast<GLsizei>(uniformName.size()), bufSize - 1);
+    if (bufSize > 0)
+    {
+        std::memcpy(name, uniformName.c_str(), nameLength);
+        name[nameLength] = '\0';
+    }
+    if (length)
+    {
+        *length = std::max(nameLength, 0);
+    }
+    *size = uniform.size;
+    *type = uniform.type;
+}
+
+static GLint APIENTRY NullGetUniformLocation(GLuint program, const GLchar* name)
+{
+    GLint index;
+    const NullUniform* uniform = FindUniform(program, name, index);
+    return uniform ? uniform->location + index : -1;
+}
+
+static void APIENTRY NullGetUniformIndices(GLuint program, GLsizei count, const GLchar* const* names, GLuint* indices)
+{
+    const std::vector<NullUniform>& uniforms = GetNullState().programs[program].uniforms;
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        GLint index;
+        const NullUniform* uniform = FindUniform(program, names[i], index);
+        indices[i] = uniform ? static_cast<GLuint>(uniform - uniforms.data()) : GL_INVALID_INDEX;
+    }
+}
+
+static void APIENTRY NullGetActiveUniformsiv(GLuint program, GLsizei count, const GLuint* indices, GLenum pname, GLint* params)
+{
+    const std::vector<NullUniform>& uniforms = GetNullState().programs[program].uniforms;
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        const NullUniform& uniform = uniforms.at(indices[i]);
+        params[i] = pname == GL_UNIFORM_SIZE ? uniform.size : pname == GL_UNIFORM_TYPE ? static_cast<GLint>(uniform.type) : 0;
+    }
+}
+
+static GLint APIENTRY NullGetAttribLocation(GLuint program, const GLchar* name)
+{
+    for (const auto& [attributeName, location] : GetNullState().programs[program].attributes)
+    {
+        if (attributeName == name)
+        {
+            return location;
+        }
+    }
+    return -1;
+}
+
+static GLuint APIENTRY NullGetUniformBlockIndex(GLuint program, const GLchar* name)
+{
+    return FindBlock(GetNullState().programs[program].uniformBlocks, name);
+}
+
+static GLuint APIENTRY NullGetProgramResourceIndex(GLuint program, GLenum programInterface, const GLchar* name)
+{
+    const NullProgram& nullProgram = GetNullState().programs[program];
+    switch (programInterface)
+    {
+    case GL_UNIFORM_BLOCK: return FindBlock(nullProgram.uniformBlocks, name);
+    case GL_SHADER_STORAGE_BLOCK: return FindBlock(nullProgram.storageBlocks, name);
+    default: return GL_INVALID_INDEX;
+    }
+}
+
+// Uniform values read back are always zero
+template<typename T>
+static void APIENTRY NullGetnUniform(GLuint, GLint, GLsizei bufSize, T* params)
+{
+    std::memset(params, 0, bufSize);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Buffers
+
+static void APIENTRY NullBindBuffer(GLenum target, GLuint buffer)
+{
+    GetNullState().boundBuffers[target] = buffer;
+}
+
+static void* APIENTRY NullMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield)
+{
+    NullState& state = GetNullState();
+    std::vector<std::byte>& memory = state.bufferMemory[state.boundBuffers[target]];
+    if (memory.size() < static_cast<std::size_t>(offset + length))
+    {
+        memory.resize(offset + length);
+    }
+    return memory.data() + offset;
+}
+
+static GLboolean APIENTRY NullUnmapBuffer(GLenum)
+{
+    return GL_TRUE;
+}
+
+// ------------------------------------------------------------------------------------------------
+// State queries
+
+static void APIENTRY NullEnable(GLenum cap)
+{
+    GetNullState().enabledFeatures.insert(cap);
+}
+
+static void APIENTRY NullDisable(GLenum cap)
+{
+    GetNullState().enabledFeatures.erase(cap);
+}
+
+static GLboolean APIENTRY NullIsEnabled(GLenum cap)
+{
+    return GetNullState().enabledFeatures.contains(cap) ? GL_TRUE : GL_FALSE;
+}
+
+static void APIENTRY NullViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    GetNullState().viewport = { x, y, width, height };
+}
+
+static void APIENTRY NullActiveTexture(GLenum texture)
+{
+    GetNullState().activeTexture = texture;
+}
+
+static void APIENTRY NullGetIntegerv(GLenum pname, GLint* data)
+{
+    const NullState& state = GetNullState();
+    switch (pname)
+    {
+    case GL_VIEWPORT: std::copy(state.viewport.begin(), state.viewport.end(), data); break;
+    case GL_ACTIVE_TEXTURE: *data = state.activeTexture; break;
+    case GL_MAJOR_VERSION: *data = 4; break;
+    case GL_MINOR_VERSION: *data = 1; break;
+    case GL_MAX_TEXTURE_IMAGE_UNITS: *data = 16; break;
+    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: *data = 80; break;
+    case GL_MAX_DRAW_BUFFERS: *data = 8; break;
+    case GL_MAX_COLOR_ATTACHMENTS: *data = 8; break;
+    case GL_MAX_SAMPLES: *data = 4; break;
+    case GL_MAX_TEXTURE_SIZE: *data = 16384; break;
+    case GL_MAX_UNIFORM_BLOCK_SIZE: *data = 65536; break;
+    case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: *data = 256; break;
+    default: *data = 0; break;
+    }
+}
+
+template<typename T>
+static void APIENTRY NullGetTexParameter(GLenum, GLenum, T* params)
+{
+    params[0] = T();
+}
+
+static void APIENTRY NullGetQueryObjectuiv(GLuint, GLenum pname, GLuint* params)
+{
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+static GLenum APIENTRY NullCheckFramebufferStatus(GLenum)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+// ------------------------------------------------------------------------------------------------
+
+void NullBackendGL::Install()
+{
+    NullState& state = GetNullState();
+    if (state.installed)
+    {
+        return;
+    }
+
+    // Everything does nothing by default
+#define NULL_GL_DEFAULT(name) glad_gl##name = NullFunction<decltype(glad_gl##name)>::Call;
+    NULL_GL_FUNCTIONS(NULL_GL_DEFAULT)
+#undef NULL_GL_DEFAULT
+
+    glad_glGenBuffers = NullGenObjects;
+    glad_glGenTextures = NullGenObjects;
+    glad_glGenVertexArrays = NullGenObjects;
+    glad_glGenFramebuffers = NullGenObjects;
+    glad_glGenQueries = NullGenObjects;
+    glad_glDeleteBuffers = NullDeleteBuffers;
+    glad_glDeleteTextures = NullDeleteObjects;
+    glad_glDeleteVertexArrays = NullDeleteObjects;
+    glad_glDeleteFramebuffers = NullDeleteObjects;
+    glad_glDeleteQueries = NullDeleteObjects;
+    glad_glCreateShader = NullCreateShader;
+    glad_glDeleteShader = NullDeleteShader;
+    glad_glCreateProgram = NullCreateProgram;
+    glad_glDeleteProgram = NullDeleteProgram;
+    glad_glFenceSync = NullFenceSync;
+    glad_glClientWaitSync = NullClientWaitSync;
+
+    glad_glShaderSource = NullShaderSource;
+    glad_glCompileShader = NullCompileShader;
+    glad_glGetShaderiv = NullGetShaderiv;
+    glad_glGetShaderInfoLog = NullGetInfoLog;
+    glad_glAttachShader = NullAttachShader;
+    glad_glLinkProgram = NullLinkProgram;
+    glad_glGetProgramiv = NullGetProgramiv;
+    glad_glGetProgramInfoLog = NullGetInfoLog;
+    glad_glGetActiveUniform = NullGetActiveUniform;
+    glad_glGetUniformLocation = NullGetUniformLocation;
+    glad_glGetUniformIndices = NullGetUniformIndices;
+    glad_glGetActiveUniformsiv = NullGetActiveUniformsiv;
+    glad_glGetAttribLocation = NullGetAttribLocation;
+    glad_glGetUniformBlockIndex = NullGetUniformBlockIndex;
+    glad_glGetProgramResourceIndex = NullGetProgramResourceIndex;
+    glad_glGetnUniformiv = NullGetnUniform<GLint>;
+    glad_glGetnUniformuiv = NullGetnUniform<GLuint>;
+    glad_glGetnUniformfv = NullGetnUniform<GLfloat>;
+    glad_glGetnUniformdv = NullGetnUniform<GLdouble>;
+
+    glad_glBindBuffer = NullBindBuffer;
+    glad_glMapBufferRange = NullMapBufferRange;
+    glad_glUnmapBuffer = NullUnmapBuffer;
+
+    glad_glEnable = NullEnable;
+    glad_glDisable = NullDisable;
+    glad_glIsEnabled = NullIsEnabled;
+    glad_glViewport = NullViewport;
+    glad_glActiveTexture = NullActiveTexture;
+    glad_glGetIntegerv = NullGetIntegerv;
+    glad_glGetTexParameterfv = NullGetTexParameter<GLfloat>;
+    glad_glGetTexParameteriv = NullGetTexParameter<GLint>;
+    glad_glGetTexParameterIuiv = NullGetTexParameter<GLuint>;
+    glad_glGetQueryObjectuiv = NullGetQueryObjectuiv;
+    glad_glCheckFramebufferStatus = NullCheckFramebufferStatus;
+
+    // Report the version requested by Window, so the same features are used
+    GLAD_GL_VERSION_1_0 = GLAD_GL_VERSION_1_1 = GLAD_GL_VERSION_1_2 = GLAD_GL_VERSION_1_3 = GLAD_GL_VERSION_1_4 = GLAD_GL_VERSION_1_5 = 1;
+    GLAD_GL_VERSION_2_0 = GLAD_GL_VERSION_2_1 = 1;
+    GLAD_GL_VERSION_3_0 = GLAD_GL_VERSION_3_1 = GLAD_GL_VERSION_3_2 = GLAD_GL_VERSION_3_3 = 1;
+    GLAD_GL_VERSION_4_0 = GLAD_GL_VERSION_4_1 = 1;
+    GLAD_GL_VERSION_4_2 = GLAD_GL_VERSION_4_3 = GLAD_GL_VERSION_4_4 = GLAD_GL_VERSION_4_5 = GLAD_GL_VERSION_4_6 = 0;
+
+    state.installed = true;
+}
+
+bool NullBackendGL::IsInstalled()
+{
+    return GetNullState().installed;
+}
+
+unsigned int NullBackendGL::GetLiveObjectCount()
+{
+    return GetNullState().liveObjectCount;
+}
@@ -0,0 +1,252 @@
+#include <ituGL/core/StreamingBuffer.h>
+
+#include <algorithm>
+#include <cassert>
+
+StreamingBuffer::StreamingBuffer()
+    : m_buffer(nullptr)
+    , m_persistent(false)
+    , m_regionSize(0)
+    , m_cursor(0)
+    , m_currentRegion(0)
+    , m_frameIndex(0)
+{
+}
+
+// Delete the pending fences. The buffer is owned by someone else
+StreamingBuffer::~StreamingBuffer()
+{
+    for (Region& region : m_regions)
+    {
+        if (region.fence)
+        {
+            glDeleteSync(region.fence);
+        }
+    }
+    for (GLsync fence : m_frameFences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+        }
+    }
+}
+
+void StreamingBuffer::Initialize(BufferObject& buffer, size_t regionSize, unsigned int regionCount)
+{
+    assert(!m_buffer);
+    assert(regionSize > 0 && regionCount > 0);
+
+    m_buffer = &buffer;
+    m_regionSize = regionSize;
+    m_regions.assign(regionCount, Region{ nullptr, false, false, 0, 0 });
+
+    // With a single region there is nothing to keep as slack, reads are protected for the last frame
+    m_frameFences.assign(std::max(regionCount - 1, 1u), nullptr);
+    m_frameIndex = 0;
+
+    size_t capacity = regionSize * regionCount;
+
+    m_persistent = IsPersistentMappingSupported();
+    if (m_persistent)
+    {
+        // Coherent, so the writes are visible to the GPU without flushing
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        buffer.AllocateStorage(capacity, flags);
+        m_data = buffer.MapRange(0, capacity, flags);
+        assert(m_data.size() == capacity);
+    }
+    else
+    {
+        buffer.AllocateData(capacity, BufferObject::StreamDraw);
+        m_clientData.resize(capacity);
+        m_data = m_clientData;
+    }
+
+    m_cursor = 0;
+    m_currentRegion = 0;
+}
+
+std::span<std::byte> StreamingBuffer::Allocate(size_t size, size_t alignment, size_t& offset)
+{
+    assert(m_buffer);
+    assert(size > 0 && size <= GetCapacity());
+
+    alignment = std::max<size_t>(alignment, 1);
+    size_t begin = (m_cursor + alignment - 1) / alignment * alignment;
+
+    // Wrap around if it doesn't fit before the end
+    bool wrapped = begin + size > GetCapacity();
+    if (wrapped)
+    {
+        begin = 0;
+    }
+    size_t end = begin + size;
+
+    // Acquire the regions that we enter, and mark them as written this frame
+    // In the current region, only the data ahead of the cursor is overwritten. The GPU could still be reading it if it was read
+    unsigned int firstRegion = static_cast<unsigned int>(begin / m_regionSize);
+    unsigned int lastRegion = static_cast<unsigned int>((end - 1) / m_regionSize);
+    for (unsigned int regionIndex = firstRegion; regionIndex <= lastRegion; ++regionIndex)
+    {
+        if (regionIndex != m_currentRegion || wrapped)
+        {
+            AcquireRegion(regionIndex);
+            wrapped = false;
+        }
+        else if (m_regions[regionIndex].read)
+        {
+            WaitForReads();
+        }
+        m_regions[regionIndex].written = true;
+    }
+
+    if (!m_persistent)
+    {
+        AddDirtyRange(begin, end);
+    }
+
+    m_cursor = end;
+    offset = begin;
+    return m_data.subspan(begin, size);
+}
+
+void StreamingBuffer::Flush()
+{
+    // Coherent mapped memory doesn't need to be flushed
+    if (m_persistent)
+    {
+        return;
+    }
+
+    // Upload the modified range of each region. Usually one or two regions per frame
+    bool bound = false;
+    for (Region& region : m_regions)
+    {
+        if (region.dirtyEnd > region.dirtyBegin)
+        {
+            if (!bound)
+            {
+                m_buffer->Bind();
+                bound = true;
+            }
+            std::span<const std::byte> data(m_clientData.data() + region.dirtyBegin, region.dirtyEnd - region.dirtyBegin);
+            m_buffer->UpdateData(data, region.dirtyBegin);
+            region.dirtyBegin = region.dirtyEnd = 0;
+        }
+    }
+}
+
+void StreamingBuffer::MarkRead(size_t offset, size_t size)
+{
+    assert(offset + size <= GetCapacity());
+
+    if (size > 0)
+    {
+        unsigned int firstRegion = static_cast<unsigned int>(offset / m_regionSize);
+        unsigned int lastRegion = static_cast<unsigned int>((offset + size - 1) / m_regionSize);
+        for (unsigned int regionIndex = firstRegion; regionIndex <= lastRegion; ++regionIndex)
+        {
+            m_regions[regionIndex].read = true;
+        }
+    }
+}
+
+void StreamingBuffer::EndFrame()
+{
+    // Uploads with glBufferSubData are already synchronized by the driver
+    if (m_persistent)
+    {
+        for (Region& region : m_regions)
+        {
+            if (region.written)
+            {
+                // The new fence is placed after the previous one, so we only need to keep the last
+                if (region.fence)
+                {
+                    glDeleteSync(region.fence);
+                }
+                region.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            }
+        }
+
+        // Replace the oldest frame fence. It is only deleted: the GPU may still be working on that frame, but nothing waits for it anymore
+        GLsync& frameFence = m_frameFences[m_frameIndex % m_frameFences.size()];
+        if (frameFence)
+        {
+            glDeleteSync(frameFence);
+        }
+        frameFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    for (Region& region : m_regions)
+    {
+        region.written = false;
+    }
+    ++m_frameIndex;
+}
+
+bool StreamingBuffer::IsPersistentMappingSupported()
+{
+    // Needs immutable storage, core in OpenGL 4.4
+    return BufferObject::IsStorageSupported();
+}
+
+void StreamingBuffer::AcquireRegion(unsigned int regionIndex)
+{
+    Region& region = m_regions[regionIndex];
+    if (region.fence)
+    {
+        WaitAndDeleteFence(region.fence);
+    }
+    if (region.read)
+    {
+        WaitForReads();
+        region.read = false;
+    }
+    m_currentRegion = regionIndex;
+}
+
+void StreamingBuffer::WaitForReads()
+{
+    // The next fence to replace is the one placed regionCount - 1 frames ago
+    // After waiting, it is deleted, so the next writes in this frame don't wait again
+    GLsync& frameFence = m_frameFences[m_frameIndex % m_frameFences.size()];
+    if (frameFence)
+    {
+        WaitAndDeleteFence(frameFence);
+    }
+}
+
+void StreamingBuffer::WaitAndDeleteFence(GLsync& fence)
+{
+    // Only the first wait flushes the commands, otherwise the fence could never be signaled
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    const GLuint64 timeout = 1000000; // 1 ms, in nanoseconds
+    while (glClientWaitSync(fence, waitFlags, timeout) == GL_TIMEOUT_EXPIRED)
+    {
+        waitFlags = 0;
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamingBuffer::AddDirtyRange(size_t begin, size_t end)
+{
+    while (begin < end)
+    {
+        Region& region = m_regions[begin / m_regionSize];
+        size_t regionEnd = std::min(end, (begin / m_regionSize + 1) * m_regionSize);
+        if (region.dirtyEnd > region.dirtyBegin)
+        {
+            region.dirtyBegin = std::min(region.dirtyBegin, begin);
+            region.dirtyEnd = std::max(region.dirtyEnd, regionEnd);
+        }
+        else
+        {
+            region.dirtyBegin = begin;
+            region.dirtyEnd = regionEnd;
+        }
+        begin = regionEnd;
+    }
+}
@@ -0,0 +1,12 @@
+#include <ituGL/geometry/DrawIndirectBufferObject.h>
+
+DrawIndirectBufferObject::DrawIndirectBufferObject()
+{
+    // Nothing to do here, it is done by the base class
+}
+
+// Call the base implementation with the span converted to bytes
+void DrawIndirectBufferObject::AllocateData(std::span<const Drawcall::IndirectCommand> commands, Usage usage)
+{
+    AllocateData(Data::GetBytes(commands), usage);
+}
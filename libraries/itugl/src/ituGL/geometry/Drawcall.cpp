@@ -5,7 +5,7 @@
 #include <cassert>
 
 Drawcall::Drawcall()
-    : m_primitive(Primitive::Invalid), m_first(0), m_count(0), m_eboType(Data::Type::None)
+    : m_primitive(Primitive::Invalid), m_first(0), m_count(0), m_eboType(Data::Type::None), m_baseVertex(0)
 {
 }
 
@@ -15,11 +15,31 @@ Drawcall::Drawcall(Primitive primitive, GLsizei count, GLint first)
 }
 
 Drawcall::Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first)
-    : m_primitive(primitive), m_first(first), m_count(count), m_eboType(eboType)
+    : Drawcall(primitive, count, eboType, first, 0)
+{
+}
+
+Drawcall::Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first, GLint baseVertex)
+    : m_primitive(primitive), m_first(first), m_count(count), m_eboType(eboType), m_baseVertex(baseVertex)
 {
     assert(primitive != Primitive::Invalid);
     assert(first >= 0);
     assert(count > 0);
+    assert(baseVertex == 0 || eboType != Data::Type::None);
+}
+
+Drawcall::IndirectCommand Drawcall::GetIndirectCommand(GLuint instanceCount, GLuint baseInstance) const
+{
+    assert(m_eboType != Data::Type::None);
+
+    // m_first is a byte offset in the EBO, commands use an index
+    IndirectCommand command;
+    command.count = static_cast<GLuint>(m_count);
+    command.instanceCount = instanceCount;
+    command.firstIndex = static_cast<GLuint>(m_first) / Data::GetTypeSize(m_eboType);
+    command.baseVertex = m_baseVertex;
+    command.baseInstance = baseInstance;
+    return command;
 }
 
 // Execute the drawcall
@@ -39,6 +59,60 @@ void Drawcall::Draw() const
         // If there is an EBO, use glDrawElements
         assert(ElementBufferObject::IsSupportedType(m_eboType));
         const char* basePointer = nullptr; // Actual element pointer is in VAO
-        glDrawElements(primitive, m_count, static_cast<GLenum>(m_eboType), basePointer + m_first);
+        if (m_baseVertex == 0)
+        {
+            glDrawElements(primitive, m_count, static_cast<GLenum>(m_eboType), basePointer + m_first);
+        }
+        else
+        {
+            glDrawElementsBaseVertex(primitive, m_count, static_cast<GLenum>(m_eboType), basePointer + m_first, m_baseVertex);
+        }
     }
 }
+
+// Execute the drawcall, rendering instanceCount instances
+void Drawcall::DrawInstanced(GLsizei instanceCount) const
+{
+    assert(IsValid());
+    assert(VertexArrayObject::IsAnyBound());
+    assert(instanceCount > 0);
+
+    GLenum primitive = static_cast<GLenum>(m_primitive);
+    if (m_eboType == Data::Type::None)
+    {
+        // If no EBO is present, use glDrawArraysInstanced
+        glDrawArraysInstanced(primitive, m_first, m_count, instanceCount);
+    }
+    else
+    {
+        // If there is an EBO, use glDrawElementsInstanced
+        assert(ElementBufferObject::IsSupportedType(m_eboType));
+        const char* basePointer = nullptr; // Actual element pointer is in VAO
+        if (m_baseVertex == 0)
+        {
+            glDrawElementsInstanced(primitive, m_count, static_cast<GLenum>(m_eboType), basePointer + m_first, instanceCount);
+        }
+        else
+        {
+            glDrawElementsInstancedBaseVertex(primitive, m_count, static_cast<GLenum>(m_eboType), basePointer + m_first, instanceCount, m_baseVertex);
+        }
+    }
+}
+
+// Execute drawCount indirect commands, starting at indirectOffset in the bound draw indirect buffer
+void Drawcall::DrawMultiIndirect(GLintptr indirectOffset, GLsizei drawCount) const
+{
+    assert(IsValid());
+    assert(VertexArrayObject::IsAnyBound());
+    assert(m_eboType != Data::Type::None);
+    assert(IsMultiDrawIndirectSupported());
+
+    const char* basePointer = nullptr; // Actual command pointer is in the draw indirect buffer
+    glMultiDrawElementsIndirect(static_cast<GLenum>(m_primitive), static_cast<GLenum>(m_eboType), basePointer + indirectOffset, drawCount, 0);
+}
+
+bool Drawcall::IsMultiDrawIndirectSupported()
+{
+    // Core in OpenGL 4.3
+    return GLAD_GL_VERSION_4_3;
+}
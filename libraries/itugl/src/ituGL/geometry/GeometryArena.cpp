@@ -0,0 +1,121 @@
+#include <ituGL/geometry/GeometryArena.h>
+
+#include <cassert>
+
+GeometryArena::GeometryArena(unsigned int vertexCapacity, unsigned int elementCapacity)
+    : m_vertexCapacity(vertexCapacity)
+    , m_elementCapacity(elementCapacity)
+{
+}
+
+const VertexArrayObject* GeometryArena::Allocate(const VertexFormat& vertexFormat, const Mesh::SemanticMap& locations,
+    std::span<const std::byte> vertexData, std::span<const GLuint> elements, Drawcall::Primitive primitive, Drawcall& drawcall)
+{
+    assert(vertexFormat.GetSize() > 0);
+    assert(vertexData.size() % vertexFormat.GetSize() == 0);
+
+    unsigned int vertexCount = static_cast<unsigned int>(vertexData.size() / vertexFormat.GetSize());
+    unsigned int elementCount = static_cast<unsigned int>(elements.size());
+
+    Pool* pool = GetPool(vertexFormat, locations, vertexCount, elementCount);
+    if (!pool)
+    {
+        return nullptr;
+    }
+
+    // Append the data at the end of the used ranges. Unbind the VAO first, binding the EBO would modify it
+    VertexArrayObject::Unbind();
+    pool->vbo.Bind();
+    pool->vbo.UpdateData(vertexData, pool->vertexCount * vertexFormat.GetSize());
+    VertexBufferObject::Unbind();
+
+    pool->ebo.Bind();
+    pool->ebo.UpdateData(elements, pool->elementCount * sizeof(GLuint));
+    ElementBufferObject::Unbind();
+
+    // First is a byte offset in the EBO, and the elements are relative to the first vertex
+    GLint first = static_cast<GLint>(pool->elementCount * sizeof(GLuint));
+    GLint baseVertex = static_cast<GLint>(pool->vertexCount);
+    drawcall = Drawcall(primitive, static_cast<GLsizei>(elementCount), Data::Type::UInt, first, baseVertex);
+
+    pool->vertexCount += vertexCount;
+    pool->elementCount += elementCount;
+
+    return &pool->vao;
+}
+
+GeometryArena::Pool* GeometryArena::GetPool(const VertexFormat& vertexFormat, const Mesh::SemanticMap& locations, unsigned int vertexCount, unsigned int elementCount)
+{
+    // Too big for any pool
+    if (vertexCount > m_vertexCapacity || elementCount > m_elementCapacity)
+    {
+        return nullptr;
+    }
+
+    for (std::unique_ptr<Pool>& pool : m_pools)
+    {
+        if (pool->vertexCount + vertexCount <= m_vertexCapacity && pool->elementCount + elementCount <= m_elementCapacity
+            && pool->locations == locations && IsSameFormat(pool->vertexFormat, vertexFormat))
+        {
+            return pool.get();
+        }
+    }
+
+    // Create a new pool with the full capacity allocated. Unbind the VAO first, binding the EBO would modify it
+    Pool& pool = *m_pools.emplace_back(std::make_unique<Pool>());
+    VertexArrayObject::Unbind();
+    pool.vertexFormat = vertexFormat;
+    pool.locations = locations;
+    pool.vertexCount = 0;
+    pool.elementCount = 0;
+
+    pool.vbo.Bind();
+    pool.vbo.AllocateData(m_vertexCapacity * vertexFormat.GetSize());
+
+    pool.ebo.Bind();
+    pool.ebo.AllocateData<GLuint>(m_elementCapacity);
+
+    // Set up the VAO once. Attributes are interleaved, so the layout doesn't depend on the vertex count
+    pool.vao.Bind();
+    pool.vbo.Bind();
+    GLuint location = 0;
+    auto itEnd = pool.vertexFormat.LayoutEnd();
+    for (auto it = pool.vertexFormat.LayoutBegin(m_vertexCapacity, true); it != itEnd; it++)
+    {
+        const VertexAttribute& attribute = it->GetAttribute();
+        auto itLocation = locations.find(attribute.GetSemantic());
+        if (itLocation != locations.end())
+        {
+            location = itLocation->second;
+        }
+        pool.vao.SetAttribute(location, attribute, it->GetOffset(), it->GetStride());
+        location += attribute.GetLocationSize();
+    }
+    pool.ebo.Bind();
+
+    VertexArrayObject::Unbind();
+    VertexBufferObject::Unbind();
+    ElementBufferObject::Unbind();
+
+    return &pool;
+}
+
+bool GeometryArena::IsSameFormat(const VertexFormat& a, const VertexFormat& b)
+{
+    if (a.GetAttributeCount() != b.GetAttributeCount())
+    {
+        return false;
+    }
+
+    for (int i = 0; i < a.GetAttributeCount(); ++i)
+    {
+        VertexAttribute attributeA = a.GetAttribute(i);
+        VertexAttribute attributeB = b.GetAttribute(i);
+        if (attributeA.GetType() != attributeB.GetType() || attributeA.GetComponents() != attributeB.GetComponents()
+            || attributeA.IsNormalized() != attributeB.IsNormalized() || attributeA.GetSemantic() != attributeB.GetSemantic())
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -1,5 +1,11 @@
 #include <ituGL/geometry/Mesh.h>
 
+#include <ituGL/geometry/GeometryArena.h>
+#include <ituGL/geometry/VertexFormat.h>
+#include <ituGL/scene/Bounds.h>
+#include <glm/common.hpp>
+#include <algorithm>
+
 Mesh::Mesh()
 {
 }
@@ -20,12 +26,36 @@ unsigned int Mesh::AddVertexArray()
     return vaoIndex;
 }
 
+unsigned int Mesh::AddPositionVertexArray(unsigned int vboIndex, int eboIndex)
+{
+    VertexFormat positionFormat;
+    positionFormat.AddVertexAttribute<float>(3, VertexAttribute::Semantic::Position);
+
+    // No semantic map, so the position goes to location 0
+    auto it = positionFormat.LayoutBegin(0, true);
+    unsigned int vaoIndex = AddVertexArray(vboIndex, it, positionFormat.LayoutEnd());
+
+    if (eboIndex >= 0)
+    {
+        GetVertexArray(vaoIndex).Bind();
+        GetElementBuffer(eboIndex).Bind();
+
+        VertexArrayObject::Unbind();
+        ElementBufferObject::Unbind();
+    }
+
+    return vaoIndex;
+}
+
 unsigned int Mesh::AddSubmesh(unsigned int vaoIndex, const Drawcall& drawcall)
 {
     unsigned int submeshIndex = GetSubmeshCount();
     Submesh& submesh = m_submeshes.emplace_back();
     submesh.vaoIndex = vaoIndex;
     submesh.drawcall = drawcall;
+    submesh.arenaVao = nullptr;
+    submesh.positionVaoIndex = -1;
+    submesh.hasBounds = false;
     return submeshIndex;
 }
 
@@ -35,11 +65,80 @@ unsigned int Mesh::AddSubmesh(unsigned int vaoIndex,
     return AddSubmesh(vaoIndex, Drawcall(primitive, count, eboType, first));
 }
 
+unsigned int Mesh::AddSubmesh(std::shared_ptr<const GeometryArena> arena, const VertexArrayObject& arenaVao, const Drawcall& drawcall)
+{
+    if (std::find(m_arenas.begin(), m_arenas.end(), arena) == m_arenas.end())
+    {
+        m_arenas.push_back(arena);
+    }
+
+    unsigned int submeshIndex = GetSubmeshCount();
+    Submesh& submesh = m_submeshes.emplace_back();
+    submesh.vaoIndex = 0;
+    submesh.drawcall = drawcall;
+    submesh.arenaVao = &arenaVao;
+    submesh.positionVaoIndex = -1;
+    submesh.hasBounds = false;
+    return submeshIndex;
+}
+
+const VertexArrayObject& Mesh::GetSubmeshVertexArray(unsigned int submeshIndex) const
+{
+    const Submesh& submesh = GetSubmesh(submeshIndex);
+    return submesh.arenaVao ? *submesh.arenaVao : GetVertexArray(submesh.vaoIndex);
+}
+
+void Mesh::SetSubmeshPositionVertexArray(unsigned int submeshIndex, unsigned int vaoIndex)
+{
+    assert(vaoIndex < GetVertexArrayCount());
+    GetSubmesh(submeshIndex).positionVaoIndex = static_cast<int>(vaoIndex);
+}
+
+const VertexArrayObject* Mesh::GetSubmeshPositionVertexArray(unsigned int submeshIndex) const
+{
+    const Submesh& submesh = GetSubmesh(submeshIndex);
+    return submesh.positionVaoIndex >= 0 ? &GetVertexArray(submesh.positionVaoIndex) : nullptr;
+}
+
+void Mesh::SetSubmeshBounds(unsigned int submeshIndex, const AabbBounds& bounds)
+{
+    Submesh& submesh = GetSubmesh(submeshIndex);
+    submesh.hasBounds = true;
+    submesh.boundsCenter = bounds.GetCenter();
+    submesh.boundsSize = bounds.GetSize();
+}
+
+AabbBounds Mesh::GetSubmeshBounds(unsigned int submeshIndex) const
+{
+    const Submesh& submesh = GetSubmesh(submeshIndex);
+    assert(submesh.hasBounds);
+    return AabbBounds(submesh.boundsCenter, submesh.boundsSize);
+}
+
+bool Mesh::HasBounds() const
+{
+    return !m_submeshes.empty() && std::all_of(m_submeshes.begin(), m_submeshes.end(), [](const Submesh& submesh) { return submesh.hasBounds; });
+}
+
+// Merge the bounds of all the submeshes
+AabbBounds Mesh::GetBounds() const
+{
+    assert(HasBounds());
+    glm::vec3 boundsMin = m_submeshes[0].boundsCenter - m_submeshes[0].boundsSize;
+    glm::vec3 boundsMax = m_submeshes[0].boundsCenter + m_submeshes[0].boundsSize;
+    for (const Submesh& submesh : m_submeshes)
+    {
+        boundsMin = glm::min(boundsMin, submesh.boundsCenter - submesh.boundsSize);
+        boundsMax = glm::max(boundsMax, submesh.boundsCenter + submesh.boundsSize);
+    }
+    return AabbBounds(0.5f * (boundsMin + boundsMax), 0.5f * (boundsMax - boundsMin));
+}
+
 // Bind the VAO and render the drawcall of the submesh
 void Mesh::DrawSubmesh(int submeshIndex) const
 {
     const Submesh& submesh = GetSubmesh(submeshIndex);
-    const VertexArrayObject& vao = GetVertexArray(submesh.vaoIndex);
+    const VertexArrayObject& vao = GetSubmeshVertexArray(submeshIndex);
     vao.Bind();
     submesh.drawcall.Draw();
     //VertexArrayObject::Unbind(); // No need to unbind
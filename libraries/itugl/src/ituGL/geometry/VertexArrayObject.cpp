@@ -1,6 +1,8 @@
 #include <ituGL/geometry/VertexArrayObject.h>
 
 #include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/core/DeviceGL.h>
+#include <glm/mat4x4.hpp>
 #include <cassert>
 
 #ifndef NDEBUG
@@ -21,6 +23,10 @@ VertexArrayObject::~VertexArrayObject()
 {
     Handle& handle = GetHandle();
     glDeleteVertexArrays(1, &handle);
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->OnVertexArrayDeleted(handle);
+    }
 }
 
 VertexArrayObject::VertexArrayObject(VertexArrayObject&& vao) noexcept : Object(std::move(vao))
@@ -37,7 +43,7 @@ VertexArrayObject& VertexArrayObject::operator = (VertexArrayObject&& vao) noexc
 void VertexArrayObject::Bind() const
 {
     Handle handle = GetHandle();
-    glBindVertexArray(handle);
+    DeviceGL::GetInstance().BindVertexArray(handle);
 #ifndef NDEBUG
     s_boundHandle = handle;
 #endif
@@ -47,7 +53,7 @@ void VertexArrayObject::Bind() const
 void VertexArrayObject::Unbind()
 {
     Handle handle = NullHandle;
-    glBindVertexArray(handle);
+    DeviceGL::GetInstance().BindVertexArray(handle);
 #ifndef NDEBUG
     s_boundHandle = handle;
 #endif
@@ -74,3 +80,29 @@ void VertexArrayObject::SetAttribute(GLuint location, const VertexAttribute& att
     // Finally, we enable the VertexAttribute in this location
     glEnableVertexAttribArray(location);
 }
+
+// Sets how often the attribute in location advances: 0 means every vertex, N means every N instances
+void VertexArrayObject::SetAttributeDivisor(GLuint location, GLuint divisor)
+{
+    assert(IsBound());
+
+    glVertexAttribDivisor(location, divisor);
+}
+
+void VertexArrayObject::SetInstanceMatrixAttribute(GLuint location, GLint offset) const
+{
+    assert(IsBound());
+    assert(VertexBufferObject::IsAnyBound());
+
+    // One vec4 attribute per column, advancing once per instance
+    GLsizei stride = static_cast<GLsizei>(sizeof(glm::mat4));
+    for (GLuint i = 0; i < 4; ++i)
+    {
+        const unsigned char* pointer = nullptr; // Actual base pointer is in VBO
+        pointer += offset + i * sizeof(glm::vec4);
+
+        glVertexAttribPointer(location + i, 4, GL_FLOAT, GL_FALSE, stride, pointer);
+        glEnableVertexAttribArray(location + i);
+        glVertexAttribDivisor(location + i, 1);
+    }
+}
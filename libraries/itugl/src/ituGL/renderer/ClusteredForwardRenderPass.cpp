@@ -0,0 +1,111 @@
+#include <ituGL/renderer/ClusteredForwardRenderPass.h>
+
+#include <ituGL/camera/Camera.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/renderer/Renderer.h>
+
+ClusteredForwardRenderPass::ClusteredForwardRenderPass(int drawcallCollectionIndex, const glm::uvec3& gridSize)
+    : m_drawcallCollectionIndex(drawcallCollectionIndex)
+    , m_lightGrid(gridSize)
+{
+    SetName("ClusteredForward");
+    InitTextures();
+}
+
+void ClusteredForwardRenderPass::InitTextures()
+{
+    // The buffers are attached once. Allocating them again later keeps the attachment
+    std::array<TextureBufferObject*, 3> buffers = { &m_lightDataBuffer, &m_clusterRangesBuffer, &m_lightIndicesBuffer };
+    std::array<BufferTextureObject*, 3> textures = { &m_lightDataTexture, &m_clusterRangesTexture, &m_lightIndicesTexture };
+    std::array<TextureObject::InternalFormat, 3> formats = { TextureObject::InternalFormatRGBA32F, TextureObject::InternalFormatRG32UI, TextureObject::InternalFormatR32UI };
+    for (int i = 0; i < 3; ++i)
+    {
+        buffers[i]->Bind();
+        buffers[i]->AllocateData(16, BufferObject::Usage::StreamDraw);
+        textures[i]->Bind();
+        textures[i]->SetBuffer(formats[i], *buffers[i]);
+    }
+    TextureBufferObject::Unbind();
+    BufferTextureObject::Unbind();
+}
+
+void ClusteredForwardRenderPass::Render()
+{
+    Renderer& renderer = GetRenderer();
+
+    const Camera& camera = renderer.GetCurrentCamera();
+    const auto& lights = renderer.GetLights();
+    const auto& drawcallBatches = renderer.GetDrawcallBatches(m_drawcallCollectionIndex);
+
+    // Assign the lights to the clusters on the worker threads, and upload the result once for all the drawcalls
+    m_lightGrid.Build(camera.GetViewMatrix(), camera.GetProjectionMatrix(), lights, &renderer.GetThreadPool());
+    UploadLightGrid();
+
+    const ShaderProgram* lastShaderProgram = nullptr;
+    for (const Renderer::DrawcallBatch& drawcallBatch : drawcallBatches)
+    {
+        // Prepare drawcall states
+        renderer.PrepareDrawcall(drawcallBatch);
+
+        const ShaderProgram& shaderProgram = drawcallBatch.drawcallInfo->shaderProgram;
+        if (&shaderProgram != lastShaderProgram)
+        {
+            SetLightGridUniforms(shaderProgram);
+            lastShaderProgram = &shaderProgram;
+        }
+
+        // Set the uniforms that don't depend on the lights, like the ambient color. The lights come from the grid
+        unsigned int lightIndex = 0;
+        renderer.UpdateLights(shaderProgram, std::span<const Light* const>(), lightIndex);
+
+        // Each drawcall is rendered once, as the first light pass
+        renderer.SetLightingRenderStates(true);
+
+        renderer.Draw(drawcallBatch);
+    }
+}
+
+void ClusteredForwardRenderPass::UploadLightGrid()
+{
+    m_lightDataBuffer.Bind();
+    m_lightDataBuffer.AllocateData(m_lightGrid.GetLightData());
+
+    m_clusterRangesBuffer.Bind();
+    m_clusterRangesBuffer.AllocateData(m_lightGrid.GetClusterRanges());
+
+    m_lightIndicesBuffer.Bind();
+    m_lightIndicesBuffer.AllocateData(m_lightGrid.GetLightIndices());
+
+    TextureBufferObject::Unbind();
+
+    TextureObject::SetActiveTexture(LightDataTextureUnit);
+    m_lightDataTexture.Bind();
+    TextureObject::SetActiveTexture(ClusterRangesTextureUnit);
+    m_clusterRangesTexture.Bind();
+    TextureObject::SetActiveTexture(LightIndicesTextureUnit);
+    m_lightIndicesTexture.Bind();
+}
+
+void ClusteredForwardRenderPass::SetLightGridUniforms(const ShaderProgram& shaderProgram)
+{
+    auto it = m_lightGridLocations.find(&shaderProgram);
+    if (it == m_lightGridLocations.end())
+    {
+        LightGridLocations locations;
+        locations.lightData = shaderProgram.GetUniformLocation("ClusterLightData");
+        locations.clusterRanges = shaderProgram.GetUniformLocation("ClusterRanges");
+        locations.lightIndices = shaderProgram.GetUniformLocation("ClusterLightIndices");
+        locations.gridSize = shaderProgram.GetUniformLocation("ClusterGridSize");
+        locations.depthParams = shaderProgram.GetUniformLocation("ClusterDepthParams");
+        locations.globalLightCount = shaderProgram.GetUniformLocation("GlobalLightCount");
+        it = m_lightGridLocations.emplace(&shaderProgram, locations).first;
+    }
+
+    const LightGridLocations& locations = it->second;
+    shaderProgram.SetUniform(locations.lightData, LightDataTextureUnit);
+    shaderProgram.SetUniform(locations.clusterRanges, ClusterRangesTextureUnit);
+    shaderProgram.SetUniform(locations.lightIndices, LightIndicesTextureUnit);
+    shaderProgram.SetUniform(locations.gridSize, m_lightGrid.GetGridSize());
+    shaderProgram.SetUniform(locations.depthParams, m_lightGrid.GetDepthSliceParams());
+    shaderProgram.SetUniform(locations.globalLightCount, m_lightGrid.GetGlobalLightCount());
+}
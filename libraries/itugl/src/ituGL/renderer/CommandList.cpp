@@ -0,0 +1,223 @@
+#include <ituGL/renderer/CommandList.h>
+
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/shader/UniformBufferObject.h>
+#include <ituGL/geometry/VertexArrayObject.h>
+#include <ituGL/geometry/VertexBufferObject.h>
+#include <ituGL/geometry/DrawIndirectBufferObject.h>
+#include <ituGL/geometry/Drawcall.h>
+#include <ituGL/texture/TextureObject.h>
+#include <cassert>
+#include <type_traits>
+
+CommandList::CommandList()
+{
+}
+
+void CommandList::Clear()
+{
+    m_commands.clear();
+    m_uniformData.clear();
+}
+
+void CommandList::UseMaterial(const Material& material)
+{
+    const ShaderProgram* shaderProgram = material.GetShaderProgramPointer();
+    assert(shaderProgram);
+    UseShaderProgram(*shaderProgram);
+    material.RecordUniforms(*this);
+
+    // The render states go through the state cache of the device, and the setup function calls it directly
+    m_commands.push_back(UseMaterialStatesCommand{ &material });
+}
+
+void CommandList::UseShaderProgram(const ShaderProgram& shaderProgram)
+{
+    m_commands.push_back(UseShaderProgramCommand{ &shaderProgram });
+}
+
+void CommandList::BindVertexArray(const VertexArrayObject& vao)
+{
+    m_commands.push_back(BindVertexArrayCommand{ &vao });
+}
+
+void CommandList::BindUniformBuffer(const UniformBufferObject& uniformBuffer, GLuint binding)
+{
+    m_commands.push_back(BindUniformBufferCommand{ &uniformBuffer, binding });
+}
+
+void CommandList::BindTexture(const ShaderProgram& shaderProgram, ShaderProgram::Location location, GLint textureUnit, const TextureObject& texture)
+{
+    m_commands.push_back(BindTextureCommand{ &shaderProgram, location, textureUnit, &texture });
+}
+
+void CommandList::UpdateTransforms(const Renderer& renderer, const ShaderProgram& shaderProgram, unsigned int worldMatrixIndex, bool cameraChanged)
+{
+    m_commands.push_back(UpdateTransformsCommand{ &renderer, &shaderProgram, worldMatrixIndex, cameraChanged });
+}
+
+void CommandList::SetInstanceAttributes(const VertexArrayObject& vao, const VertexBufferObject& instanceBuffer, GLuint location, unsigned int firstInstance)
+{
+    m_commands.push_back(SetInstanceAttributesCommand{ &vao, &instanceBuffer, location, firstInstance });
+}
+
+void CommandList::Draw(const Drawcall& drawcall)
+{
+    m_commands.push_back(DrawCommand{ &drawcall });
+}
+
+void CommandList::DrawInstanced(const Drawcall& drawcall, GLsizei instanceCount)
+{
+    m_commands.push_back(DrawInstancedCommand{ &drawcall, instanceCount });
+}
+
+void CommandList::DrawMultiIndirect(const Drawcall& drawcall, const DrawIndirectBufferObject& indirectBuffer, GLintptr indirectOffset, GLsizei drawCount)
+{
+    m_commands.push_back(DrawMultiIndirectCommand{ &drawcall, &indirectBuffer, indirectOffset, drawCount });
+}
+
+void CommandList::Execute() const
+{
+    for (const Command& command : m_commands)
+    {
+        std::visit([this](const auto& command)
+            {
+                using T = std::decay_t<decltype(command)>;
+                if constexpr (std::is_same_v<T, UseMaterialStatesCommand>)
+                {
+                    command.material->UseStates();
+                }
+                else if constexpr (std::is_same_v<T, UseShaderProgramCommand>)
+                {
+                    command.shaderProgram->Use();
+                }
+                else if constexpr (std::is_same_v<T, BindVertexArrayCommand>)
+                {
+                    command.vao->Bind();
+                }
+                else if constexpr (std::is_same_v<T, BindUniformBufferCommand>)
+                {
+                    command.uniformBuffer->BindBase(command.binding);
+                }
+                else if constexpr (std::is_same_v<T, BindTextureCommand>)
+                {
+                    command.shaderProgram->SetTexture(command.location, command.textureUnit, *command.texture);
+                }
+                else if constexpr (std::is_same_v<T, DrawCommand>)
+                {
+                    command.drawcall->Draw();
+                }
+                else if constexpr (std::is_same_v<T, DrawInstancedCommand>)
+                {
+                    command.drawcall->DrawInstanced(command.instanceCount);
+                }
+                else if constexpr (std::is_same_v<T, DrawMultiIndirectCommand>)
+                {
+                    command.indirectBuffer->Bind();
+                    command.drawcall->DrawMultiIndirect(command.indirectOffset, command.drawCount);
+                }
+                else
+                {
+                    Execute(command);
+                }
+            }, command);
+    }
+}
+
+void CommandList::Execute(const SetUniformCommand& command) const
+{
+    switch (command.type)
+    {
+    case Data::Type::Int:
+        ExecuteSetUniform<GLint>(command);
+        break;
+    case Data::Type::UInt:
+        ExecuteSetUniform<GLuint>(command);
+        break;
+    case Data::Type::Float:
+        ExecuteSetUniform<GLfloat>(command);
+        break;
+    case Data::Type::Double:
+        ExecuteSetUniform<GLdouble>(command);
+        break;
+    default:
+        assert(false);
+    }
+}
+
+template<typename T>
+void CommandList::ExecuteSetUniform(const SetUniformCommand& command) const
+{
+    // The values are only read by the device, as the bytes they were copied from
+    const T* values = reinterpret_cast<const T*>(&m_uniformData[command.dataOffset]);
+    const ShaderProgram& shaderProgram = *command.shaderProgram;
+    ShaderProgram::Location location = command.location;
+    std::size_t count = command.count;
+
+    if (command.columns == 1)
+    {
+        switch (command.rows)
+        {
+        case 1:
+            shaderProgram.SetUniforms(location, std::span(values, count));
+            return;
+        case 2:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::vec<2, T>*>(values), count));
+            return;
+        case 3:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::vec<3, T>*>(values), count));
+            return;
+        case 4:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::vec<4, T>*>(values), count));
+            return;
+        }
+    }
+    else if constexpr (std::is_same_v<T, GLfloat>)
+    {
+        // Only float matrices are supported
+        switch (command.columns * 4 + command.rows)
+        {
+        case 2 * 4 + 2:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat2x2*>(values), count));
+            return;
+        case 2 * 4 + 3:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat2x3*>(values), count));
+            return;
+        case 2 * 4 + 4:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat2x4*>(values), count));
+            return;
+        case 3 * 4 + 2:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat3x2*>(values), count));
+            return;
+        case 3 * 4 + 3:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat3x3*>(values), count));
+            return;
+        case 3 * 4 + 4:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat3x4*>(values), count));
+            return;
+        case 4 * 4 + 2:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat4x2*>(values), count));
+            return;
+        case 4 * 4 + 3:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat4x3*>(values), count));
+            return;
+        case 4 * 4 + 4:
+            shaderProgram.SetUniforms(location, std::span(reinterpret_cast<const glm::mat4x4*>(values), count));
+            return;
+        }
+    }
+    assert(false);
+}
+
+void CommandList::Execute(const UpdateTransformsCommand& command) const
+{
+    command.renderer->UpdateTransforms(*command.shaderProgram, command.worldMatrixIndex, command.cameraChanged);
+}
+
+void CommandList::Execute(const SetInstanceAttributesCommand& command) const
+{
+    // Point the instance attribute to the first instance
+    command.instanceBuffer->Bind();
+    command.vao->SetInstanceMatrixAttribute(command.location, static_cast<GLint>(command.firstInstance * sizeof(glm::mat4)));
+}
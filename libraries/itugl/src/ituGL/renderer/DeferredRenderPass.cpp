@@ -7,56 +7,272 @@
 #include <ituGL/shader/Material.h>
 #include <ituGL/texture/Texture2DObject.h>
 #include <glm/gtx/transform.hpp>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 DeferredRenderPass::DeferredRenderPass(std::shared_ptr<Material> material, std::shared_ptr<const FramebufferObject> framebuffer)
-    : RenderPass(framebuffer), m_material(material)
+    : RenderPass(framebuffer), m_material(material), m_lightVolumesEnabled(true), m_depthBoundsEnabled(false)
 {
+    SetName("Deferred");
     InitializeMeshes();
 }
 
 void DeferredRenderPass::Render()
 {
     Renderer& renderer = GetRenderer();
-
-    //TODO: temp hack
-    renderer.GetDevice().DisableFeature(GL_DEPTH_TEST);
+    DeviceGL& device = renderer.GetDevice();
 
     const Camera& camera = renderer.GetCurrentCamera();
+    glm::mat4 viewProjMatrix = camera.GetViewProjectionMatrix();
 
     assert(m_material);
     m_material->Use();
-    std::shared_ptr<const ShaderProgram> shaderProgram = m_material->GetShaderProgram();
+    const ShaderProgram& shaderProgram = *m_material->GetShaderProgramPointer();
+
+    // The G-buffer depth can be attached to the target, it must not be modified
+    device.SetDepthWrite(false);
 
     // Our fullscreen triangle is directly in clip coordinates.
     // Use the inverse view proj matrix to cancel view projection from the camera
-    glm::mat4 fullscreenMatrix = glm::inverse(camera.GetViewProjectionMatrix());
+    glm::mat4 fullscreenMatrix = glm::inverse(viewProjMatrix);
+
+    glm::ivec4 viewport;
+    device.GetViewport(viewport.x, viewport.y, viewport.z, viewport.w);
 
     bool first = true;
     unsigned int lightIndex = 0;
     const auto& lights = renderer.GetLights();
-    while (renderer.UpdateLights(shaderProgram, lights, lightIndex))
+    while (true)
     {
-        const Light* light = lightIndex <= lights.size() ? lights[lightIndex - 1] : nullptr;
-        assert(first || light);
+        // The update function can set several lights in each pass
+        unsigned int batchBegin = std::min(lightIndex, static_cast<unsigned int>(lights.size()));
+        if (!renderer.UpdateLights(shaderProgram, lights, lightIndex))
+        {
+            break;
+        }
+        unsigned int batchEnd = std::min(lightIndex, static_cast<unsigned int>(lights.size()));
+        assert(first || batchEnd > batchBegin);
 
         const Mesh* mesh = &renderer.GetFullscreenMesh();
         glm::mat4 worldMatrix = fullscreenMatrix;
 
-        // TODO: select different meshes depending on the type
+        // The first pass also adds the indirect light, so it always covers the whole screen.
+        // Volumes are only used for passes with a single light
+        bool volume = !first && m_lightVolumesEnabled && batchEnd - batchBegin == 1 && GetLightVolume(*lights[batchBegin], mesh, worldMatrix);
+
+        glm::ivec4 scissor = viewport;
+        bool fullscreen = true;
+        if (volume)
+        {
+            // Local bounds of the volume mesh. The cone only goes in the negative Z direction
+            glm::vec3 boundsMin(-1.0f);
+            glm::vec3 boundsMax(1.0f, 1.0f, mesh == &m_coneMesh ? 0.0f : 1.0f);
+            if (!GetScissorRectangle(viewProjMatrix * worldMatrix, boundsMin, boundsMax, viewport, scissor, fullscreen))
+            {
+                // The light is not visible, skip it
+                first = false;
+                continue;
+            }
+        }
 
         // Set the render states for the first and additional lights
         renderer.SetLightingRenderStates(first);
 
-        renderer.UpdateTransforms(shaderProgram, fullscreenMatrix, first);
+        // Only the pixels inside the projected bounds of the volume can be affected
+        device.SetFeatureEnabled(GL_SCISSOR_TEST, !fullscreen);
+        if (!fullscreen)
+        {
+            device.SetScissor(scissor.x, scissor.y, scissor.z, scissor.w);
+        }
+
+        // Volumes draw their back faces, so they still cover the pixels when the camera is inside of them.
+        // With depth clamp, the back faces beyond the far plane are not clipped either
+        device.SetCullFace(volume ? GL_FRONT : GL_BACK);
+        device.SetFeatureEnabled(GL_DEPTH_CLAMP, volume);
+
+        // A back face in front of the scene means that the surface is behind the light volume
+        bool depthBounds = volume && m_depthBoundsEnabled;
+        device.SetFeatureEnabled(GL_DEPTH_TEST, depthBounds);
+        if (depthBounds)
+        {
+            device.SetDepthFunction(GL_GEQUAL);
+        }
+
+        renderer.UpdateTransforms(shaderProgram, worldMatrix, first);
         mesh->DrawSubmesh(0);
         first = false;
     }
 
-    //TODO: temp hack
-    renderer.GetDevice().EnableFeature(GL_DEPTH_TEST);
+    // Restore the states that other passes expect
+    device.SetFeatureEnabled(GL_SCISSOR_TEST, false);
+    device.SetFeatureEnabled(GL_DEPTH_CLAMP, false);
+    device.SetCullFace(GL_BACK);
+    device.EnableFeature(GL_DEPTH_TEST);
+}
+
+bool DeferredRenderPass::GetLightVolume(const Light& light, const Mesh*& mesh, glm::mat4& worldMatrix) const
+{
+    // Distance where the light fades completely. Negative or zero if it doesn't fade
+    glm::vec4 attenuation = light.GetAttenuation();
+    float range = attenuation.y;
+    if (range <= 0.0f)
+    {
+        return false;
+    }
+
+    glm::vec3 position = light.GetPosition();
+
+    // Outer angle of spot lights. Wide cones are bounded better by the sphere
+    float angle = attenuation.w;
+    if (light.GetType() == Light::Type::Spot && angle > 0.0f && angle < glm::radians(60.0f))
+    {
+        // The spot light shines in the opposite direction to LightDirection, that is the -Z axis of the cone
+        glm::vec3 axisZ = glm::normalize(light.GetDirection());
+        glm::vec3 up = std::abs(axisZ.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 axisX = glm::normalize(glm::cross(up, axisZ));
+        glm::vec3 axisY = glm::cross(axisZ, axisX);
+
+        float radius = range * std::tan(angle);
+        worldMatrix = glm::mat4(glm::vec4(axisX * radius, 0.0f), glm::vec4(axisY * radius, 0.0f), glm::vec4(axisZ * range, 0.0f), glm::vec4(position, 1.0f));
+        mesh = &m_coneMesh;
+    }
+    else
+    {
+        worldMatrix = glm::translate(position) * glm::scale(glm::vec3(range));
+        mesh = &m_sphereMesh;
+    }
+    return true;
+}
+
+bool DeferredRenderPass::GetScissorRectangle(const glm::mat4& worldViewProjMatrix, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+    const glm::ivec4& viewport, glm::ivec4& rectangle, bool& fullscreen)
+{
+    // Transform the corners of the bounds to clip space
+    glm::vec4 corners[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        glm::vec3 corner((i & 1) ? boundsMax.x : boundsMin.x, (i & 2) ? boundsMax.y : boundsMin.y, (i & 4) ? boundsMax.z : boundsMin.z);
+        corners[i] = worldViewProjMatrix * glm::vec4(corner, 1.0f);
+    }
+
+    // If all the corners are outside of the same clipping plane, the volume is not visible
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        bool allBelow = true, allAbove = true;
+        for (const glm::vec4& corner : corners)
+        {
+            allBelow &= corner[axis] < -corner.w;
+            allAbove &= corner[axis] > corner.w;
+        }
+        if (allBelow || allAbove)
+        {
+            return false;
+        }
+    }
+
+    // The rectangle can't be computed if a corner is behind the near plane
+    fullscreen = false;
+    glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+    for (const glm::vec4& corner : corners)
+    {
+        if (corner.z < -corner.w || corner.w <= 0.0f)
+        {
+            fullscreen = true;
+            rectangle = viewport;
+            return true;
+        }
+        glm::vec2 ndc = glm::vec2(corner) / corner.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+
+    // Convert to pixels, rounding outwards
+    ndcMin = glm::clamp(ndcMin, -1.0f, 1.0f);
+    ndcMax = glm::clamp(ndcMax, -1.0f, 1.0f);
+    glm::vec2 size(viewport.z, viewport.w);
+    glm::ivec2 pixelMin = glm::ivec2(glm::floor((ndcMin * 0.5f + 0.5f) * size));
+    glm::ivec2 pixelMax = glm::ivec2(glm::ceil((ndcMax * 0.5f + 0.5f) * size));
+    rectangle = glm::ivec4(viewport.x + pixelMin.x, viewport.y + pixelMin.y, pixelMax.x - pixelMin.x, pixelMax.y - pixelMin.y);
+
+    return rectangle.z > 0 && rectangle.w > 0;
 }
 
 void DeferredRenderPass::InitializeMeshes()
 {
-    //TODO: Create meshes for spot and point lights
+    VertexFormat vertexFormat;
+    vertexFormat.AddVertexAttribute<float>(3, VertexAttribute::Semantic::Position);
+
+    // Low poly meshes are enough, but they must contain the real shape.
+    // The vertices are pushed out so the faces between them are outside of the unit sphere and cone
+    const unsigned int slices = 12;
+    const unsigned int stacks = 6;
+    const float sliceAngle = glm::two_pi<float>() / slices;
+    const float stackAngle = glm::pi<float>() / stacks;
+
+    // Sphere: one vertex in each pole and (stacks - 1) rings of vertices
+    {
+        float radius = 1.0f / (std::cos(sliceAngle * 0.5f) * std::cos(stackAngle * 0.5f));
+
+        std::vector<glm::vec3> vertices;
+        vertices.emplace_back(0.0f, radius, 0.0f);
+        for (unsigned int i = 1; i < stacks; ++i)
+        {
+            float ringY = std::cos(i * stackAngle) * radius;
+            float ringRadius = std::sin(i * stackAngle) * radius;
+            for (unsigned int j = 0; j < slices; ++j)
+            {
+                vertices.emplace_back(std::cos(j * sliceAngle) * ringRadius, ringY, -std::sin(j * sliceAngle) * ringRadius);
+            }
+        }
+        vertices.emplace_back(0.0f, -radius, 0.0f);
+
+        const unsigned short bottom = static_cast<unsigned short>(vertices.size() - 1);
+        auto ringVertex = [&](unsigned int ring, unsigned int slice) { return static_cast<unsigned short>(1 + ring * slices + slice % slices); };
+
+        std::vector<unsigned short> indices;
+        for (unsigned int j = 0; j < slices; ++j)
+        {
+            // Top and bottom caps
+            indices.insert(indices.end(), { 0, ringVertex(0, j), ringVertex(0, j + 1) });
+            indices.insert(indices.end(), { bottom, ringVertex(stacks - 2, j + 1), ringVertex(stacks - 2, j) });
+
+            // Quads between rings
+            for (unsigned int i = 0; i < stacks - 2; ++i)
+            {
+                indices.insert(indices.end(), { ringVertex(i, j), ringVertex(i + 1, j), ringVertex(i + 1, j + 1) });
+                indices.insert(indices.end(), { ringVertex(i, j), ringVertex(i + 1, j + 1), ringVertex(i, j + 1) });
+            }
+        }
+
+        m_sphereMesh.AddSubmesh<glm::vec3, unsigned short, VertexFormat::LayoutIterator>(Drawcall::Primitive::Triangles, vertices, indices,
+            vertexFormat.LayoutBegin(static_cast<int>(vertices.size()), false), vertexFormat.LayoutEnd());
+    }
+
+    // Cone: the apex, a ring of vertices in the base and the center of the base
+    {
+        float radius = 1.0f / std::cos(sliceAngle * 0.5f);
+
+        std::vector<glm::vec3> vertices;
+        vertices.emplace_back(0.0f, 0.0f, 0.0f);
+        for (unsigned int j = 0; j < slices; ++j)
+        {
+            vertices.emplace_back(std::cos(j * sliceAngle) * radius, std::sin(j * sliceAngle) * radius, -1.0f);
+        }
+        vertices.emplace_back(0.0f, 0.0f, -1.0f);
+
+        const unsigned short center = static_cast<unsigned short>(vertices.size() - 1);
+        auto ringVertex = [&](unsigned int slice) { return static_cast<unsigned short>(1 + slice % slices); };
+
+        std::vector<unsigned short> indices;
+        for (unsigned int j = 0; j < slices; ++j)
+        {
+            indices.insert(indices.end(), { 0, ringVertex(j), ringVertex(j + 1) });
+            indices.insert(indices.end(), { center, ringVertex(j + 1), ringVertex(j) });
+        }
+
+        m_coneMesh.AddSubmesh<glm::vec3, unsigned short, VertexFormat::LayoutIterator>(Drawcall::Primitive::Triangles, vertices, indices,
+            vertexFormat.LayoutBegin(static_cast<int>(vertices.size()), false), vertexFormat.LayoutEnd());
+    }
 }
@@ -0,0 +1,82 @@
+#include <ituGL/renderer/DepthPrePassRenderPass.h>
+
+#include <ituGL/camera/Camera.h>
+#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/geometry/VertexArrayObject.h>
+#include <ituGL/geometry/Drawcall.h>
+#include <ituGL/shader/Material.h>
+
+DepthPrePassRenderPass::DepthPrePassRenderPass(int drawcallCollectionIndex)
+    : m_drawcallCollectionIndex(drawcallCollectionIndex)
+    , m_worldMatrixLocation(-1)
+    , m_viewProjMatrixLocation(-1)
+{
+    SetName("DepthPrePass");
+
+    // Load shaders and build shader program
+    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load("shaders/renderer/depth.vert");
+    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load("shaders/renderer/depth.frag");
+    m_shaderProgram.Build(vertexShader, fragmentShader);
+
+    // Get uniform locations
+    m_worldMatrixLocation = m_shaderProgram.GetUniformLocation("WorldMatrix");
+    m_viewProjMatrixLocation = m_shaderProgram.GetUniformLocation("ViewProjMatrix");
+}
+
+bool DepthPrePassRenderPass::IsDepthPrepared(const Renderer::DrawcallInfo& drawcallInfo)
+{
+    // Blended drawcalls don't hide what is behind them
+    if (!drawcallInfo.positionVao || !Renderer::IsOpaqueDrawcall(drawcallInfo))
+    {
+        return false;
+    }
+
+    // The material must write depth, with a test that keeps the closest fragment like the pre-pass does
+    const Material& material = drawcallInfo.material;
+    Material::TestFunction depthTestFunction = material.GetDepthTestFunction();
+    return material.GetDepthWrite()
+        && (depthTestFunction == Material::TestFunction::Less || depthTestFunction == Material::TestFunction::LessEqual);
+}
+
+void DepthPrePassRenderPass::Render()
+{
+    Renderer& renderer = GetRenderer();
+    DeviceGL& device = renderer.GetDevice();
+
+    m_shaderProgram.Use();
+
+    const Camera& camera = renderer.GetCurrentCamera();
+    m_shaderProgram.SetUniform(m_viewProjMatrixLocation, camera.GetViewProjectionMatrix());
+
+    // Only depth, with the states that the first light pass would use
+    device.SetColorWrite(false);
+    device.SetDepthWrite(true);
+    device.SetDepthFunction(GL_LESS);
+    device.SetFeatureEnabled(GL_BLEND, false);
+
+    // The drawcalls are sorted front to back, so most of the hidden fragments already fail the depth test here
+    // The instance attributes of the batches live in the main VAOs, so the position-only VAOs are drawn one by one
+    std::span<const Renderer::DrawcallInfo> drawcalls = renderer.GetDrawcalls();
+    const VertexArrayObject* lastVao = nullptr;
+    for (unsigned int drawcallIndex : renderer.GetDrawcallIndices(m_drawcallCollectionIndex))
+    {
+        const Renderer::DrawcallInfo& drawcallInfo = drawcalls[drawcallIndex];
+        if (!IsDepthPrepared(drawcallInfo))
+        {
+            continue;
+        }
+
+        m_shaderProgram.SetUniform(m_worldMatrixLocation, renderer.GetWorldMatrix(drawcallInfo.worldMatrixIndex));
+
+        if (drawcallInfo.positionVao != lastVao)
+        {
+            drawcallInfo.positionVao->Bind();
+            lastVao = drawcallInfo.positionVao;
+        }
+
+        drawcallInfo.drawcall.Draw();
+    }
+
+    // Restore default value
+    device.SetColorWrite(true);
+}
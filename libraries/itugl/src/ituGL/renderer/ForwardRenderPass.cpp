@@ -4,6 +4,7 @@
 #include <ituGL/shader/Material.h>
 #include <ituGL/geometry/VertexArrayObject.h>
 #include <ituGL/renderer/Renderer.h>
+#include <ituGL/renderer/DepthPrePassRenderPass.h>
 
 ForwardRenderPass::ForwardRenderPass()
     : ForwardRenderPass(0)
@@ -12,7 +13,9 @@ ForwardRenderPass::ForwardRenderPass()
 
 ForwardRenderPass::ForwardRenderPass(int drawcallCollectionIndex)
     : m_drawcallCollectionIndex(drawcallCollectionIndex)
+    , m_depthPrePass(false)
 {
+    SetName("Forward");
 }
 
 void ForwardRenderPass::Render()
@@ -21,15 +24,27 @@ void ForwardRenderPass::Render()
 
     const Camera& camera = renderer.GetCurrentCamera();
     const auto& lights = renderer.GetLights();
-    const auto& drawcallCollection = renderer.GetDrawcalls(m_drawcallCollectionIndex);
+    const auto& drawcallBatches = renderer.GetDrawcallBatches(m_drawcallCollectionIndex);
 
-    // for all drawcalls
-    for (const Renderer::DrawcallInfo& drawcallInfo : drawcallCollection)
+    // Depth write is turned off for the drawcalls with depth, but materials only set it when they change
+    const Material* depthWriteMaterial = nullptr;
+
+    // for all drawcall batches
+    for (const Renderer::DrawcallBatch& drawcallBatch : drawcallBatches)
     {
         // Prepare drawcall states
-        renderer.PrepareDrawcall(drawcallInfo);
+        renderer.PrepareDrawcall(drawcallBatch);
+
+        const Renderer::DrawcallInfo& drawcallInfo = *drawcallBatch.drawcallInfo;
+        const ShaderProgram& shaderProgram = drawcallInfo.shaderProgram;
 
-        std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetShaderProgram();
+        // All the drawcalls in a batch share the VAO, so they all have depth or none of them
+        bool depthPrepared = m_depthPrePass && DepthPrePassRenderPass::IsDepthPrepared(drawcallInfo);
+        if (depthWriteMaterial && !depthPrepared)
+        {
+            renderer.GetDevice().SetDepthWrite(drawcallInfo.material.GetDepthWrite());
+        }
+        depthWriteMaterial = depthPrepared ? &drawcallInfo.material : nullptr;
 
         //for all lights
         bool first = true;
@@ -37,12 +52,18 @@ void ForwardRenderPass::Render()
         while (renderer.UpdateLights(shaderProgram, lights, lightIndex))
         {
             // Set the renderstates
-            renderer.SetLightingRenderStates(first);
+            renderer.SetLightingRenderStates(first, depthPrepared);
 
             // Draw
-            drawcallInfo.drawcall.Draw();
+            renderer.Draw(drawcallBatch);
 
             first = false;
         }
     }
+
+    // Leave the depth write of the last material, clearing the depth buffer needs it
+    if (depthWriteMaterial)
+    {
+        renderer.GetDevice().SetDepthWrite(depthWriteMaterial->GetDepthWrite());
+    }
 }
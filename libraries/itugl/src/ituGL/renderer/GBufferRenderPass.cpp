@@ -6,10 +6,27 @@
 #include <ituGL/renderer/Renderer.h>
 #include <ituGL/texture/Texture2DObject.h>
 #include <ituGL/texture/FramebufferObject.h>
+#include <vector>
 
-GBufferRenderPass::GBufferRenderPass(int width, int height, int drawcallCollectionIndex)
+GBufferRenderPass::Layout GBufferRenderPass::Layout::GetDefault()
+{
+    return { Encoding::Default, TextureObject::InternalFormatSRGBA8, TextureObject::InternalFormatRG16F, TextureObject::InternalFormatSRGBA8 };
+}
+
+GBufferRenderPass::Layout GBufferRenderPass::Layout::GetPacked(TextureObject::InternalFormat normalFormat)
+{
+    // The octahedral normal is stored as unorm, a float format would waste the bits
+    assert(normalFormat == TextureObject::InternalFormatRGB10A2 || normalFormat == TextureObject::InternalFormatRGBA8);
+    return { Encoding::Packed, TextureObject::InternalFormatSRGBA8, normalFormat, TextureObject::InternalFormatInvalid };
+}
+
+GBufferRenderPass::GBufferRenderPass(int width, int height, int drawcallCollectionIndex, const Layout& layout)
     : m_drawcallCollectionIndex(drawcallCollectionIndex)
+    , m_layout(layout)
 {
+    assert((layout.othersFormat != TextureObject::InternalFormatInvalid) == (layout.encoding == Layout::Encoding::Default));
+
+    SetName("GBuffer");
     InitTextures(width, height);
     InitFramebuffer();
 }
@@ -28,16 +45,19 @@ void GBufferRenderPass::InitFramebuffer()
     // Set the normal texture as color attachment 1
     targetFramebuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Color1, *m_normalTexture);
 
-    // Set the others texture as color attachment 2
-    targetFramebuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Color2, *m_othersTexture);
+    std::vector<FramebufferObject::Attachment> drawBuffers;
+    drawBuffers.push_back(FramebufferObject::Attachment::Color0);
+    drawBuffers.push_back(FramebufferObject::Attachment::Color1);
+
+    // Set the others texture as color attachment 2, if the layout has it
+    if (m_othersTexture)
+    {
+        targetFramebuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Color2, *m_othersTexture);
+        drawBuffers.push_back(FramebufferObject::Attachment::Color2);
+    }
 
     // Set the draw buffers used by the framebuffer (all attachments except depth)
-    targetFramebuffer->SetDrawBuffers(std::array<FramebufferObject::Attachment, 3>(
-        {
-            FramebufferObject::Attachment::Color0,
-            FramebufferObject::Attachment::Color1,
-            FramebufferObject::Attachment::Color2
-        }));
+    targetFramebuffer->SetDrawBuffers(drawBuffers);
 
     m_targetFramebuffer = targetFramebuffer;
 
@@ -53,56 +73,86 @@ void GBufferRenderPass::InitTextures(int width, int height)
     m_depthTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
     m_depthTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
 
-    // Albedo: Bind the newly created texture, set the image, and the min and magfilter as nearest
-    m_albedoTexture = std::make_shared<Texture2DObject>();
-    m_albedoTexture->Bind();
-    m_albedoTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatSRGBA8);
-    m_albedoTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_albedoTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
-
-    // Normal: Bind the newly created texture, set the image and the min and magfilter as nearest
-    m_normalTexture = std::make_shared<Texture2DObject>();
-    m_normalTexture->Bind();
-    m_normalTexture->SetImage(0, width, height, TextureObject::FormatRG, TextureObject::InternalFormatRG16F);
-    m_normalTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_normalTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
-
-    // Others: Bind the newly created texture, set the image and the min and magfilter as nearest
-    m_othersTexture = std::make_shared<Texture2DObject>();
-    m_othersTexture->Bind();
-    m_othersTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatSRGBA8);
-    m_othersTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_othersTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    // Color targets, with the formats of the layout
+    m_albedoTexture = CreateTexture(width, height, m_layout.albedoFormat);
+    m_normalTexture = CreateTexture(width, height, m_layout.normalFormat);
+    if (m_layout.othersFormat != TextureObject::InternalFormatInvalid)
+    {
+        m_othersTexture = CreateTexture(width, height, m_layout.othersFormat);
+    }
 
     Texture2DObject::Unbind();
 }
 
+std::shared_ptr<Texture2DObject> GBufferRenderPass::CreateTexture(int width, int height, TextureObject::InternalFormat internalFormat)
+{
+    // There is no data to upload, but the format must still match the components of the internal format
+    TextureObject::Format format = TextureObject::FormatRGBA;
+    switch (internalFormat)
+    {
+    case TextureObject::InternalFormatR8:
+    case TextureObject::InternalFormatR16F:
+        format = TextureObject::FormatR;
+        break;
+    case TextureObject::InternalFormatRG8:
+    case TextureObject::InternalFormatRG16:
+    case TextureObject::InternalFormatRG16F:
+        format = TextureObject::FormatRG;
+        break;
+    case TextureObject::InternalFormatRGB8:
+    case TextureObject::InternalFormatSRGB8:
+    case TextureObject::InternalFormatR11G11B10:
+        format = TextureObject::FormatRGB;
+        break;
+    default:
+        break;
+    }
+
+    // Bind the newly created texture, set the image and the min and magfilter as nearest
+    std::shared_ptr<Texture2DObject> texture = std::make_shared<Texture2DObject>();
+    texture->Bind();
+    texture->SetImage(0, width, height, format, internalFormat);
+    texture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
+    texture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    return texture;
+}
+
+int GBufferRenderPass::GetBytesPerPixel() const
+{
+    int bytesPerPixel = TextureObject::GetPixelSize(m_layout.albedoFormat) + TextureObject::GetPixelSize(m_layout.normalFormat);
+    if (m_layout.othersFormat != TextureObject::InternalFormatInvalid)
+    {
+        bytesPerPixel += TextureObject::GetPixelSize(m_layout.othersFormat);
+    }
+    return bytesPerPixel;
+}
+
 void GBufferRenderPass::Render()
 {
     Renderer& renderer = GetRenderer();
 
     const Camera& camera = renderer.GetCurrentCamera();
     const auto& lights = renderer.GetLights();
-    const auto& drawcallCollection = renderer.GetDrawcalls(m_drawcallCollectionIndex);
+    const auto& drawcallBatches = renderer.GetDrawcallBatches(m_drawcallCollectionIndex);
 
     renderer.GetDevice().Clear(true, Color(0.0f, 0.0f, 0.0f, 1.0f), true, 1.0f);
 
     bool wasSRGB = renderer.GetDevice().IsFeatureEnabled(GL_FRAMEBUFFER_SRGB);
     renderer.GetDevice().EnableFeature(GL_FRAMEBUFFER_SRGB);
 
-    // for all drawcalls
-    for (const Renderer::DrawcallInfo& drawcallInfo : drawcallCollection)
+#ifndef NDEBUG
+    // The g-buffer can only store opaque drawcalls
+    for (const Renderer::DrawcallBatch& drawcallBatch : drawcallBatches)
     {
+        const Renderer::DrawcallInfo& drawcallInfo = *drawcallBatch.drawcallInfo;
         assert(drawcallInfo.material.GetBlendEquationColor() == Material::BlendEquation::None);
         assert(drawcallInfo.material.GetBlendEquationAlpha() == Material::BlendEquation::None);
         assert(drawcallInfo.material.GetDepthWrite());
-
-        // Prepare drawcall (similar to forward)
-        renderer.PrepareDrawcall(drawcallInfo);
-
-        // Render drawcall
-        drawcallInfo.drawcall.Draw();
     }
+#endif
+
+    // Prepare and render all the drawcall batches. Without lights, they can be recorded in parallel
+    renderer.DrawDrawcallBatches(m_drawcallCollectionIndex);
 
     renderer.GetDevice().SetFeatureEnabled(GL_FRAMEBUFFER_SRGB, wasSRGB);
 }
@@ -0,0 +1,180 @@
+#include <ituGL/renderer/GpuProfiler.h>
+
+#include <ituGL/utils/DearImGui.h>
+#include <ituGL/utils/Json.h>
+#include <imgui.h>
+#include <algorithm>
+#include <ostream>
+#include <cassert>
+
+GpuProfiler::GpuProfiler(unsigned int historySize) : m_historySize(historySize), m_frameCount(0), m_activeTimer(-1)
+{
+    assert(historySize > 0);
+}
+
+void GpuProfiler::BeginFrame()
+{
+    assert(m_activeTimer < 0);
+
+    m_frameCount++;
+    unsigned int slot = m_frameCount % FrameLatency;
+
+    // The queries of this slot were issued FrameLatency frames ago, so they should be ready by now
+    for (unsigned int timerIndex = 0; timerIndex < m_timers.size(); ++timerIndex)
+    {
+        Timer& timer = m_timers[timerIndex];
+        if (timer.pending[slot])
+        {
+            const QueryObject& query = timer.queries[slot];
+            if (query.IsResultAvailable())
+            {
+                // Nanoseconds to milliseconds
+                AddSample(timerIndex, static_cast<float>(query.GetResult()) * 1e-6f);
+            }
+            timer.pending[slot] = false;
+        }
+    }
+}
+
+void GpuProfiler::BeginTimer(unsigned int timerIndex, const std::string& name)
+{
+    assert(m_activeTimer < 0);
+
+    if (timerIndex >= m_timers.size())
+    {
+        m_timers.resize(timerIndex + 1);
+        m_timings.resize(timerIndex + 1);
+    }
+
+    // The timer could be used by something else now, so its samples are not valid anymore
+    if (m_timings[timerIndex].name != name)
+    {
+        m_timings[timerIndex] = Timing();
+        m_timings[timerIndex].name = name;
+        m_timers[timerIndex].history.clear();
+        m_timers[timerIndex].historyIndex = 0;
+    }
+
+    unsigned int slot = m_frameCount % FrameLatency;
+    Timer& timer = m_timers[timerIndex];
+    timer.queries[slot].Begin(QueryObject::Target::TimeElapsed);
+    timer.pending[slot] = true;
+
+    m_activeTimer = timerIndex;
+}
+
+void GpuProfiler::EndTimer()
+{
+    assert(m_activeTimer >= 0);
+    QueryObject::End(QueryObject::Target::TimeElapsed);
+    m_activeTimer = -1;
+}
+
+float GpuProfiler::GetTotalTime() const
+{
+    float totalTime = 0.0f;
+    for (const Timing& timing : m_timings)
+    {
+        totalTime += timing.averageTime;
+    }
+    return totalTime;
+}
+
+void GpuProfiler::ResetTimings()
+{
+    for (unsigned int timerIndex = 0; timerIndex < m_timers.size(); ++timerIndex)
+    {
+        std::string name = std::move(m_timings[timerIndex].name);
+        m_timings[timerIndex] = Timing();
+        m_timings[timerIndex].name = std::move(name);
+        m_timers[timerIndex].history.clear();
+        m_timers[timerIndex].historyIndex = 0;
+    }
+}
+
+void GpuProfiler::AddSample(unsigned int timerIndex, float time)
+{
+    Timer& timer = m_timers[timerIndex];
+    if (timer.history.size() < m_historySize)
+    {
+        timer.history.push_back(time);
+    }
+    else
+    {
+        timer.history[timer.historyIndex] = time;
+    }
+    timer.historyIndex = (timer.historyIndex + 1) % m_historySize;
+
+    Timing& timing = m_timings[timerIndex];
+    timing.lastTime = time;
+    timing.sampleCount = static_cast<unsigned int>(timer.history.size());
+
+    auto minmax = std::minmax_element(timer.history.begin(), timer.history.end());
+    timing.minTime = *minmax.first;
+    timing.maxTime = *minmax.second;
+
+    float sum = 0.0f;
+    for (float sample : timer.history)
+    {
+        sum += sample;
+    }
+    timing.averageTime = sum / timing.sampleCount;
+}
+
+void GpuProfiler::DrawGUI(DearImGui& imGui, const char* windowName) const
+{
+    if (auto window = imGui.UseWindow(windowName))
+    {
+        ImGui::Text("Total: %.3f ms", GetTotalTime());
+        ImGui::Separator();
+
+        if (ImGui::BeginTable("Timings", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+        {
+            ImGui::TableSetupColumn("Pass", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Last");
+            ImGui::TableSetupColumn("Min");
+            ImGui::TableSetupColumn("Avg");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableHeadersRow();
+
+            for (unsigned int timerIndex = 0; timerIndex < m_timings.size(); ++timerIndex)
+            {
+                const Timing& timing = m_timings[timerIndex];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%u: %s", timerIndex, timing.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.lastTime);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.minTime);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.averageTime);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.maxTime);
+            }
+            ImGui::EndTable();
+        }
+    }
+}
+
+void GpuProfiler::WriteJson(std::ostream& stream) const
+{
+    stream << "{\n";
+    stream << "  \"frames\": " << m_frameCount << ",\n";
+    stream << "  \"totalTime\": " << GetTotalTime() << ",\n";
+    stream << "  \"timers\": [";
+    for (unsigned int timerIndex = 0; timerIndex < m_timings.size(); ++timerIndex)
+    {
+        const Timing& timing = m_timings[timerIndex];
+        stream << (timerIndex > 0 ? ",\n" : "\n");
+        stream << "    { \"name\": ";
+        Json::WriteString(stream, timing.name);
+        stream << ", \"last\": " << timing.lastTime;
+        stream << ", \"min\": " << timing.minTime;
+        stream << ", \"avg\": " << timing.averageTime;
+        stream << ", \"max\": " << timing.maxTime;
+        stream << ", \"samples\": " << timing.sampleCount << " }";
+    }
+    stream << "\n  ]\n";
+    stream << "}\n";
+}
@@ -0,0 +1,197 @@
+#include <ituGL/renderer/LightGrid.h>
+
+#include <ituGL/lighting/Light.h>
+#include <ituGL/utils/ThreadPool.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+LightGrid::LightGrid(const glm::uvec3& gridSize)
+    : m_gridSize(gridSize)
+    , m_nearDistance(0.0f)
+    , m_farDistance(0.0f)
+    , m_depthSliceParams(0.0f)
+    , m_globalLightCount(0)
+{
+    assert(gridSize.x > 0 && gridSize.y > 0 && gridSize.z > 0);
+    m_tileCorners.resize((gridSize.x + 1) * (gridSize.y + 1));
+    m_slices.resize(gridSize.z);
+    m_clusterRanges.resize(GetClusterCount());
+}
+
+void LightGrid::Build(const glm::mat4& viewMatrix, const glm::mat4& projMatrix, std::span<const Light* const> lights, ThreadPool* threadPool)
+{
+    // Only perspective projections (w = -z)
+    assert(projMatrix[2][3] == -1.0f);
+
+    // Extract the near and far planes from the projection matrix
+    m_nearDistance = projMatrix[3][2] / (projMatrix[2][2] - 1.0f);
+    m_farDistance = projMatrix[3][2] / (projMatrix[2][2] + 1.0f);
+
+    // Slice z starts at depth near * (far / near) ^ (z / sizeZ)
+    float depthSliceScale = m_gridSize.z / std::log(m_farDistance / m_nearDistance);
+    m_depthSliceParams = glm::vec2(depthSliceScale, -std::log(m_nearDistance) * depthSliceScale);
+
+    // Directions through the corners of the tiles, at depth 1
+    glm::mat4 invProjMatrix = glm::inverse(projMatrix);
+    for (unsigned int y = 0; y <= m_gridSize.y; ++y)
+    {
+        for (unsigned int x = 0; x <= m_gridSize.x; ++x)
+        {
+            glm::vec2 ndc = glm::vec2(x, y) / glm::vec2(m_gridSize) * 2.0f - 1.0f;
+            glm::vec4 viewPosition = invProjMatrix * glm::vec4(ndc, -1.0f, 1.0f);
+            glm::vec3 corner = glm::vec3(viewPosition) / viewPosition.w;
+            m_tileCorners[y * (m_gridSize.x + 1) + x] = corner / -corner.z;
+        }
+    }
+
+    // Global lights go first in the light data
+    m_lightData.clear();
+    m_localLights.clear();
+    for (const Light* light : lights)
+    {
+        glm::vec4 attenuation = light->GetAttenuation();
+        if (attenuation.y <= 0.0f)
+        {
+            m_lightData.push_back({ glm::vec4(light->GetPosition(), 0.0f), glm::vec4(light->GetColor() * light->GetIntensity(), 0.0f),
+                glm::vec4(light->GetDirection(), 0.0f), attenuation });
+        }
+    }
+    m_globalLightCount = static_cast<unsigned int>(m_lightData.size());
+
+    for (const Light* light : lights)
+    {
+        glm::vec4 attenuation = light->GetAttenuation();
+        if (attenuation.y <= 0.0f)
+        {
+            continue;
+        }
+
+        // Skip the lights completely outside of the depth range
+        LocalLight localLight;
+        localLight.viewPosition = glm::vec3(viewMatrix * glm::vec4(light->GetPosition(), 1.0f));
+        localLight.range = attenuation.y;
+        float depth = -localLight.viewPosition.z;
+        if (depth + localLight.range < m_nearDistance || depth - localLight.range > m_farDistance)
+        {
+            continue;
+        }
+
+        // Tiles covered by the projection of the bounding box of the sphere. All of them if it crosses the near plane
+        localLight.minTile = glm::uvec2(0);
+        localLight.maxTile = glm::uvec2(m_gridSize) - 1u;
+        if (depth - localLight.range > m_nearDistance)
+        {
+            glm::vec2 ndcMin(1.0f);
+            glm::vec2 ndcMax(-1.0f);
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                glm::vec3 sign((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+                glm::vec4 clip = projMatrix * glm::vec4(localLight.viewPosition + sign * localLight.range, 1.0f);
+                glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                ndcMin = glm::min(ndcMin, ndc);
+                ndcMax = glm::max(ndcMax, ndc);
+            }
+
+            // Outside of the screen
+            if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f)
+            {
+                continue;
+            }
+
+            glm::vec2 gridSize(m_gridSize);
+            localLight.minTile = glm::uvec2(glm::clamp((ndcMin * 0.5f + 0.5f) * gridSize, glm::vec2(0.0f), gridSize - 1.0f));
+            localLight.maxTile = glm::uvec2(glm::clamp((ndcMax * 0.5f + 0.5f) * gridSize, glm::vec2(0.0f), gridSize - 1.0f));
+        }
+
+        m_localLights.push_back(localLight);
+        m_lightData.push_back({ glm::vec4(light->GetPosition(), 0.0f), glm::vec4(light->GetColor() * light->GetIntensity(), 0.0f),
+            glm::vec4(light->GetDirection(), 0.0f), attenuation });
+    }
+
+    // Slices write different clusters, so they can be built at the same time
+    if (threadPool)
+    {
+        threadPool->ParallelFor(m_gridSize.z, [this](unsigned int slice) { BuildSlice(slice); });
+    }
+    else
+    {
+        for (unsigned int slice = 0; slice < m_gridSize.z; ++slice)
+        {
+            BuildSlice(slice);
+        }
+    }
+
+    // Merge the lists of the slices, moving their offsets
+    m_lightIndices.clear();
+    unsigned int clustersPerSlice = m_gridSize.x * m_gridSize.y;
+    for (unsigned int slice = 0; slice < m_gridSize.z; ++slice)
+    {
+        unsigned int offset = static_cast<unsigned int>(m_lightIndices.size());
+        for (unsigned int index = slice * clustersPerSlice; index < (slice + 1) * clustersPerSlice; ++index)
+        {
+            m_clusterRanges[index].x += offset;
+        }
+
+        const std::vector<unsigned int>& sliceLightIndices = m_slices[slice].lightIndices;
+        m_lightIndices.insert(m_lightIndices.end(), sliceLightIndices.begin(), sliceLightIndices.end());
+    }
+}
+
+void LightGrid::BuildSlice(unsigned int slice)
+{
+    float nearDepth = m_nearDistance * std::pow(m_farDistance / m_nearDistance, static_cast<float>(slice) / m_gridSize.z);
+    float farDepth = m_nearDistance * std::pow(m_farDistance / m_nearDistance, static_cast<float>(slice + 1) / m_gridSize.z);
+
+    // Keep only the lights that overlap the depth range of the slice
+    Slice& sliceData = m_slices[slice];
+    sliceData.candidateLights.clear();
+    for (unsigned int localIndex = 0; localIndex < m_localLights.size(); ++localIndex)
+    {
+        const LocalLight& light = m_localLights[localIndex];
+        float depth = -light.viewPosition.z;
+        if (depth + light.range >= nearDepth && depth - light.range <= farDepth)
+        {
+            sliceData.candidateLights.push_back(localIndex);
+        }
+    }
+
+    sliceData.lightIndices.clear();
+    for (unsigned int y = 0; y < m_gridSize.y; ++y)
+    {
+        for (unsigned int x = 0; x < m_gridSize.x; ++x)
+        {
+            // Bounding box of the cluster in view space, from the 4 corners of the tile at the near and far depth of the slice
+            glm::vec3 clusterMin(std::numeric_limits<float>::max());
+            glm::vec3 clusterMax(std::numeric_limits<float>::lowest());
+            for (unsigned int corner = 0; corner < 4; ++corner)
+            {
+                const glm::vec3& tileCorner = m_tileCorners[(y + (corner >> 1)) * (m_gridSize.x + 1) + x + (corner & 1)];
+                clusterMin = glm::min(clusterMin, glm::min(tileCorner * nearDepth, tileCorner * farDepth));
+                clusterMax = glm::max(clusterMax, glm::max(tileCorner * nearDepth, tileCorner * farDepth));
+            }
+
+            unsigned int offset = static_cast<unsigned int>(sliceData.lightIndices.size());
+            for (unsigned int localIndex : sliceData.candidateLights)
+            {
+                const LocalLight& light = m_localLights[localIndex];
+                if (x < light.minTile.x || x > light.maxTile.x || y < light.minTile.y || y > light.maxTile.y)
+                {
+                    continue;
+                }
+
+                // Sphere - AABB test, with the closest point of the box to the center
+                glm::vec3 offsetToBox = glm::clamp(light.viewPosition, clusterMin, clusterMax) - light.viewPosition;
+                if (glm::dot(offsetToBox, offsetToBox) <= light.range * light.range)
+                {
+                    sliceData.lightIndices.push_back(m_globalLightCount + localIndex);
+                }
+            }
+
+            unsigned int clusterIndex = x + (y + slice * m_gridSize.y) * m_gridSize.x;
+            m_clusterRanges[clusterIndex] = glm::uvec2(offset, static_cast<unsigned int>(sliceData.lightIndices.size()) - offset);
+        }
+    }
+}
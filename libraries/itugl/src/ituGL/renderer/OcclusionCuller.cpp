@@ -0,0 +1,455 @@
+#include <ituGL/renderer/OcclusionCuller.h>
+
+#include <ituGL/utils/ThreadPool.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+// SSE is always available on x86-64. Other platforms use the scalar loop, that the compiler can vectorize
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ITUGL_OCCLUSION_SSE
+#endif
+
+// Size of the tiles in pixels. Each tile is rasterized by one thread
+static const int TileWidth = 32;
+static const int TileHeight = 32;
+
+// Boxes tested in each job of TestAabbs
+static const unsigned int TestBatchSize = 256;
+
+// Distance to the near plane in clip space (OpenGL convention, -w <= z). Positive in front of it
+static float GetNearPlaneDistance(const glm::vec4& clip)
+{
+    return clip.z + clip.w;
+}
+
+// Convert a screen coordinate to a pixel index, clamped so that huge values don't overflow the int
+static int GetPixel(float coordinate, int maxPixel)
+{
+    return static_cast<int>(std::clamp(coordinate, -1.0f, static_cast<float>(maxPixel + 1)));
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int width, unsigned int height)
+    : m_width(width), m_height(height), m_viewProjMatrix(1.0f)
+{
+    // Rows are processed in groups of 4 pixels
+    assert(width > 0 && width % 4 == 0 && height > 0);
+
+    m_tileCountX = (width + TileWidth - 1) / TileWidth;
+    m_tileCountY = (height + TileHeight - 1) / TileHeight;
+    m_tileBins.resize(m_tileCountX * m_tileCountY);
+
+    // Level 0 only uses maxDepth, min and max are the same for a single pixel
+    unsigned int levelWidth = width;
+    unsigned int levelHeight = height;
+    while (true)
+    {
+        PyramidLevel& level = m_pyramid.emplace_back();
+        level.width = levelWidth;
+        level.height = levelHeight;
+        level.maxDepth.resize(levelWidth * levelHeight, 1.0f);
+        if (m_pyramid.size() > 1)
+        {
+            level.minDepth.resize(levelWidth * levelHeight, 1.0f);
+        }
+
+        if (levelWidth == 1 && levelHeight == 1)
+        {
+            break;
+        }
+        levelWidth = std::max((levelWidth + 1) / 2, 1u);
+        levelHeight = std::max((levelHeight + 1) / 2, 1u);
+    }
+}
+
+void OcclusionCuller::Reset()
+{
+    m_occluders.clear();
+}
+
+void OcclusionCuller::AddOccluder(const OccluderMesh& occluder, const glm::mat4& worldMatrix)
+{
+    assert(occluder.indices.size() % 3 == 0);
+    m_occluders.push_back({ &occluder, worldMatrix });
+}
+
+void OcclusionCuller::Rasterize(const glm::mat4& viewProjMatrix, ThreadPool* threadPool)
+{
+    m_viewProjMatrix = viewProjMatrix;
+
+    // Project all the triangles
+    m_triangles.clear();
+    for (const Occluder& occluder : m_occluders)
+    {
+        AddScreenTriangles(*occluder.mesh, viewProjMatrix * occluder.worldMatrix);
+    }
+
+    // Bin the triangles in the tiles overlapped by their bounding rectangle
+    for (std::vector<unsigned int>& bin : m_tileBins)
+    {
+        bin.clear();
+    }
+    for (unsigned int triangleIndex = 0; triangleIndex < m_triangles.size(); ++triangleIndex)
+    {
+        const ScreenTriangle& triangle = m_triangles[triangleIndex];
+        glm::vec3 boundsMin = glm::min(glm::min(triangle.vertices[0], triangle.vertices[1]), triangle.vertices[2]);
+        glm::vec3 boundsMax = glm::max(glm::max(triangle.vertices[0], triangle.vertices[1]), triangle.vertices[2]);
+
+        int minX = std::max(GetPixel(boundsMin.x, m_width), 0) / TileWidth;
+        int minY = std::max(GetPixel(boundsMin.y, m_height), 0) / TileHeight;
+        int maxX = std::min(GetPixel(boundsMax.x, m_width), static_cast<int>(m_width) - 1) / TileWidth;
+        int maxY = std::min(GetPixel(boundsMax.y, m_height), static_cast<int>(m_height) - 1) / TileHeight;
+        for (int tileY = minY; tileY <= maxY; ++tileY)
+        {
+            for (int tileX = minX; tileX <= maxX; ++tileX)
+            {
+                m_tileBins[tileY * m_tileCountX + tileX].push_back(triangleIndex);
+            }
+        }
+    }
+
+    // Tiles don't share pixels, so they can be rasterized at the same time
+    unsigned int tileCount = m_tileCountX * m_tileCountY;
+    if (threadPool)
+    {
+        threadPool->ParallelFor(tileCount, [this](unsigned int tileIndex) { RasterizeTile(tileIndex); });
+    }
+    else
+    {
+        for (unsigned int tileIndex = 0; tileIndex < tileCount; ++tileIndex)
+        {
+            RasterizeTile(tileIndex);
+        }
+    }
+
+    BuildPyramid();
+}
+
+void OcclusionCuller::AddScreenTriangles(const OccluderMesh& occluder, const glm::mat4& worldViewProjMatrix)
+{
+    const std::vector<unsigned int>& indices = occluder.indices;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        glm::vec4 clip[3];
+        for (int v = 0; v < 3; ++v)
+        {
+            clip[v] = worldViewProjMatrix * glm::vec4(occluder.positions[indices[i + v]], 1.0f);
+        }
+
+        // Clip against the near plane. The polygon can get 4 vertices, that are split in 2 triangles
+        glm::vec4 polygon[4];
+        int polygonSize = 0;
+        for (int v = 0; v < 3; ++v)
+        {
+            const glm::vec4& current = clip[v];
+            const glm::vec4& next = clip[(v + 1) % 3];
+            float currentDistance = GetNearPlaneDistance(current);
+            float nextDistance = GetNearPlaneDistance(next);
+            bool currentInside = currentDistance > 0.0f;
+            bool nextInside = nextDistance > 0.0f;
+            if (currentInside)
+            {
+                polygon[polygonSize++] = current;
+            }
+            if (currentInside != nextInside)
+            {
+                float t = currentDistance / (currentDistance - nextDistance);
+                polygon[polygonSize++] = glm::mix(current, next, t);
+            }
+        }
+
+        if (polygonSize >= 3)
+        {
+            AddScreenTriangle(polygon[0], polygon[1], polygon[2]);
+        }
+        if (polygonSize == 4)
+        {
+            AddScreenTriangle(polygon[0], polygon[2], polygon[3]);
+        }
+    }
+}
+
+void OcclusionCuller::AddScreenTriangle(const glm::vec4& clip0, const glm::vec4& clip1, const glm::vec4& clip2)
+{
+    ScreenTriangle triangle;
+    const glm::vec4* clip[3] = { &clip0, &clip1, &clip2 };
+    for (int v = 0; v < 3; ++v)
+    {
+        glm::vec3 ndc = glm::vec3(*clip[v]) / clip[v]->w;
+        triangle.vertices[v] = glm::vec3((ndc.x * 0.5f + 0.5f) * m_width, (ndc.y * 0.5f + 0.5f) * m_height, ndc.z * 0.5f + 0.5f);
+    }
+
+    // Skip triangles completely outside of the screen or behind the far plane
+    glm::vec3 boundsMin = glm::min(glm::min(triangle.vertices[0], triangle.vertices[1]), triangle.vertices[2]);
+    glm::vec3 boundsMax = glm::max(glm::max(triangle.vertices[0], triangle.vertices[1]), triangle.vertices[2]);
+    if (boundsMax.x < 0.0f || boundsMax.y < 0.0f || boundsMin.x >= m_width || boundsMin.y >= m_height || boundsMin.z > 1.0f)
+    {
+        return;
+    }
+
+    m_triangles.push_back(triangle);
+}
+
+void OcclusionCuller::RasterizeTile(unsigned int tileIndex)
+{
+    int tileMinX = (tileIndex % m_tileCountX) * TileWidth;
+    int tileMinY = (tileIndex / m_tileCountX) * TileHeight;
+    int tileMaxX = std::min(tileMinX + TileWidth, static_cast<int>(m_width)) - 1;
+    int tileMaxY = std::min(tileMinY + TileHeight, static_cast<int>(m_height)) - 1;
+
+    // Clear the tile
+    std::vector<float>& depthBuffer = m_pyramid[0].maxDepth;
+    for (int y = tileMinY; y <= tileMaxY; ++y)
+    {
+        std::fill_n(&depthBuffer[y * m_width + tileMinX], tileMaxX - tileMinX + 1, 1.0f);
+    }
+
+    for (unsigned int triangleIndex : m_tileBins[tileIndex])
+    {
+        RasterizeTriangle(m_triangles[triangleIndex], tileMinX, tileMinY, tileMaxX, tileMaxY);
+    }
+}
+
+// Evaluate the edge functions at the pixel centers. A pixel is covered if it is on the inner side of the 3 edges,
+// and its depth is interpolated with the plane equation of the triangle, since depth is linear in screen space
+void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& triangle, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY)
+{
+    glm::vec3 v0 = triangle.vertices[0];
+    glm::vec3 v1 = triangle.vertices[1];
+    glm::vec3 v2 = triangle.vertices[2];
+
+    // Occluders are double-sided: flip the clockwise triangles
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+    if (area == 0.0f)
+    {
+        return;
+    }
+    if (area < 0.0f)
+    {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    // Edge function of the edge from a to b: e(x, y) = A * x + B * y + C
+    glm::vec3 edgeA(v1.y - v2.y, v2.y - v0.y, v0.y - v1.y);
+    glm::vec3 edgeB(v2.x - v1.x, v0.x - v2.x, v1.x - v0.x);
+    glm::vec3 edgeC(v1.x * v2.y - v1.y * v2.x, v2.x * v0.y - v2.y * v0.x, v0.x * v1.y - v0.y * v1.x);
+
+    // Depth plane: the edge functions divided by the area are the barycentric coordinates
+    glm::vec3 depths(v0.z, v1.z, v2.z);
+    float depthA = glm::dot(edgeA, depths) / area;
+    float depthB = glm::dot(edgeB, depths) / area;
+    float depthC = glm::dot(edgeC, depths) / area;
+
+    // Bounding rectangle inside the tile. Start X aligned to groups of 4 pixels
+    int minX = std::max(GetPixel(std::min(std::min(v0.x, v1.x), v2.x), m_width), tileMinX) & ~3;
+    int minY = std::max(GetPixel(std::min(std::min(v0.y, v1.y), v2.y), m_height), tileMinY);
+    int maxX = std::min(GetPixel(std::max(std::max(v0.x, v1.x), v2.x), m_width), tileMaxX);
+    int maxY = std::min(GetPixel(std::max(std::max(v0.y, v1.y), v2.y), m_height), tileMaxY);
+
+    float* depthBuffer = m_pyramid[0].maxDepth.data();
+    for (int y = minY; y <= maxY; ++y)
+    {
+        float py = y + 0.5f;
+        float* row = depthBuffer + y * m_width;
+        int x = minX;
+
+#ifdef ITUGL_OCCLUSION_SSE
+        __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        __m128 rowEdge0 = _mm_set1_ps(edgeB.x * py + edgeC.x);
+        __m128 rowEdge1 = _mm_set1_ps(edgeB.y * py + edgeC.y);
+        __m128 rowEdge2 = _mm_set1_ps(edgeB.z * py + edgeC.z);
+        __m128 rowDepth = _mm_set1_ps(depthB * py + depthC);
+        __m128 stepEdge0 = _mm_set1_ps(edgeA.x);
+        __m128 stepEdge1 = _mm_set1_ps(edgeA.y);
+        __m128 stepEdge2 = _mm_set1_ps(edgeA.z);
+        __m128 stepDepth = _mm_set1_ps(depthA);
+        __m128 zero = _mm_setzero_ps();
+
+        // Groups of 4 pixels that are fully inside the tile (tiles are multiple of 4 wide)
+        for (; x + 3 <= maxX; x += 4)
+        {
+            __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(stepEdge0, px), rowEdge0);
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(stepEdge1, px), rowEdge1);
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(stepEdge2, px), rowEdge2);
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+            if (_mm_movemask_ps(inside) == 0)
+            {
+                continue;
+            }
+
+            // Keep the closest depth where the triangle covers the pixel
+            __m128 depth = _mm_add_ps(_mm_mul_ps(stepDepth, px), rowDepth);
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 closest = _mm_min_ps(current, depth);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest), _mm_andnot_ps(inside, current)));
+        }
+#endif
+
+        // Remaining pixels, or all of them without SSE
+        for (; x <= maxX; ++x)
+        {
+            float px = x + 0.5f;
+            glm::vec3 edges = edgeA * px + edgeB * py + edgeC;
+            if (edges.x >= 0.0f && edges.y >= 0.0f && edges.z >= 0.0f)
+            {
+                float depth = depthA * px + depthB * py + depthC;
+                row[x] = std::min(row[x], depth);
+            }
+        }
+    }
+}
+
+void OcclusionCuller::BuildPyramid()
+{
+    for (unsigned int levelIndex = 1; levelIndex < m_pyramid.size(); ++levelIndex)
+    {
+        const PyramidLevel& source = m_pyramid[levelIndex - 1];
+        PyramidLevel& level = m_pyramid[levelIndex];
+
+        // Level 0 has the same min and max
+        const std::vector<float>& sourceMin = levelIndex == 1 ? source.maxDepth : source.minDepth;
+        const std::vector<float>& sourceMax = source.maxDepth;
+
+        for (unsigned int y = 0; y < level.height; ++y)
+        {
+            unsigned int y0 = 2 * y;
+            unsigned int y1 = std::min(y0 + 1, source.height - 1);
+            for (unsigned int x = 0; x < level.width; ++x)
+            {
+                unsigned int x0 = 2 * x;
+                unsigned int x1 = std::min(x0 + 1, source.width - 1);
+
+                unsigned int i00 = y0 * source.width + x0;
+                unsigned int i01 = y0 * source.width + x1;
+                unsigned int i10 = y1 * source.width + x0;
+                unsigned int i11 = y1 * source.width + x1;
+
+                unsigned int index = y * level.width + x;
+                level.minDepth[index] = std::min(std::min(sourceMin[i00], sourceMin[i01]), std::min(sourceMin[i10], sourceMin[i11]));
+                level.maxDepth[index] = std::max(std::max(sourceMax[i00], sourceMax[i01]), std::max(sourceMax[i10], sourceMax[i11]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::IsVisible(const glm::vec3& center, const glm::vec3& size) const
+{
+    // Boxes without bounds are never culled
+    if (size.x >= std::numeric_limits<float>::max() || size.y >= std::numeric_limits<float>::max() || size.z >= std::numeric_limits<float>::max())
+    {
+        return true;
+    }
+
+    // Project the 8 corners, and get the screen rectangle and the closest depth
+    glm::vec2 screenMin(std::numeric_limits<float>::max());
+    glm::vec2 screenMax(std::numeric_limits<float>::lowest());
+    float closestDepth = 1.0f;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec3 sign((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+        glm::vec4 clip = m_viewProjMatrix * glm::vec4(center + sign * size, 1.0f);
+        if (GetNearPlaneDistance(clip) <= 0.0f)
+        {
+            return true;
+        }
+
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec2 screen((ndc.x * 0.5f + 0.5f) * m_width, (ndc.y * 0.5f + 0.5f) * m_height);
+        screenMin = glm::min(screenMin, screen);
+        screenMax = glm::max(screenMax, screen);
+        closestDepth = std::min(closestDepth, ndc.z * 0.5f + 0.5f);
+    }
+
+    // Outside of the screen, leave it to frustum culling
+    if (screenMax.x < 0.0f || screenMax.y < 0.0f || screenMin.x >= m_width || screenMin.y >= m_height)
+    {
+        return true;
+    }
+
+    // All the pixels touched by the rectangle
+    int minX = std::max(GetPixel(screenMin.x, m_width), 0);
+    int minY = std::max(GetPixel(screenMin.y, m_height), 0);
+    int maxX = std::min(GetPixel(screenMax.x, m_width), static_cast<int>(m_width) - 1);
+    int maxY = std::min(GetPixel(screenMax.y, m_height), static_cast<int>(m_height) - 1);
+
+    // Start from the level where the rectangle covers about 2x2 texels
+    int extent = std::max(maxX - minX, maxY - minY);
+    unsigned int level = 0;
+    while ((extent >> level) > 1 && level + 1 < m_pyramid.size())
+    {
+        ++level;
+    }
+
+    return IsRegionVisible(level, minX, minY, maxX, maxY, closestDepth);
+}
+
+bool OcclusionCuller::IsRegionVisible(unsigned int levelIndex, int minX, int minY, int maxX, int maxY, float depth) const
+{
+    const PyramidLevel& level = m_pyramid[levelIndex];
+    for (int texelY = minY >> levelIndex; texelY <= (maxY >> levelIndex); ++texelY)
+    {
+        for (int texelX = minX >> levelIndex; texelX <= (maxX >> levelIndex); ++texelX)
+        {
+            unsigned int index = texelY * level.width + texelX;
+
+            // Behind everything in this texel
+            if (depth > level.maxDepth[index])
+            {
+                continue;
+            }
+
+            // In front of everything in this texel, or nothing finer to check
+            if (levelIndex == 0 || depth <= level.minDepth[index])
+            {
+                return true;
+            }
+
+            // Refine with the pixels of the texel that the rectangle covers
+            int texelMinX = std::max(texelX << levelIndex, minX);
+            int texelMinY = std::max(texelY << levelIndex, minY);
+            int texelMaxX = std::min(((texelX + 1) << levelIndex) - 1, maxX);
+            int texelMaxY = std::min(((texelY + 1) << levelIndex) - 1, maxY);
+            if (IsRegionVisible(levelIndex - 1, texelMinX, texelMinY, texelMaxX, texelMaxY, depth))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void OcclusionCuller::TestAabbs(const std::array<std::span<const float>, 3>& centers, const std::array<std::span<const float>, 3>& sizes,
+    std::span<std::uint8_t> visible, ThreadPool* threadPool) const
+{
+    unsigned int count = static_cast<unsigned int>(visible.size());
+    auto testBatch = [&](unsigned int batchIndex)
+    {
+        unsigned int end = std::min((batchIndex + 1) * TestBatchSize, count);
+        for (unsigned int i = batchIndex * TestBatchSize; i < end; ++i)
+        {
+            if (visible[i])
+            {
+                glm::vec3 center(centers[0][i], centers[1][i], centers[2][i]);
+                glm::vec3 size(sizes[0][i], sizes[1][i], sizes[2][i]);
+                visible[i] = IsVisible(center, size) ? 1 : 0;
+            }
+        }
+    };
+
+    unsigned int batchCount = (count + TestBatchSize - 1) / TestBatchSize;
+    if (threadPool)
+    {
+        threadPool->ParallelFor(batchCount, testBatch);
+    }
+    else
+    {
+        for (unsigned int batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+        {
+            testBatch(batchIndex);
+        }
+    }
+}
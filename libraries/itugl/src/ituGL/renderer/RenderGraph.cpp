@@ -0,0 +1,386 @@
+#include <ituGL/renderer/RenderGraph.h>
+
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/renderer/RenderPass.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/texture/FramebufferObject.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+// Pass added to the renderer. It sets the textures read by the pass in the materials, and then renders the pass
+class RenderGraph::CompiledPass : public RenderPass
+{
+public:
+    struct Binding
+    {
+        std::shared_ptr<Material> material;
+        ShaderProgram::Location location;
+        std::shared_ptr<TextureObject> texture;
+    };
+
+public:
+    CompiledPass(std::unique_ptr<RenderPass> renderPass, std::shared_ptr<const FramebufferObject> targetFramebuffer,
+        std::vector<Binding>&& bindings, std::vector<std::shared_ptr<const RenderTargetPool::RenderTarget>>&& renderTargets)
+        : RenderPass(targetFramebuffer), m_renderPass(std::move(renderPass)), m_bindings(std::move(bindings)), m_renderTargets(std::move(renderTargets))
+    {
+        SetName(m_renderPass->GetName());
+    }
+
+    void Render() override
+    {
+        // Several passes can share a material with different textures, so they are set every time
+        for (const Binding& binding : m_bindings)
+        {
+            binding.material->SetUniformValue(binding.location, binding.texture);
+        }
+        m_renderPass->Render();
+    }
+
+private:
+    std::unique_ptr<RenderPass> m_renderPass;
+    std::vector<Binding> m_bindings;
+
+    // Keep the render targets used by the pass, so the pool doesn't give them to anyone else
+    std::vector<std::shared_ptr<const RenderTargetPool::RenderTarget>> m_renderTargets;
+};
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, int passIndex) : m_graph(graph), m_passIndex(passIndex)
+{
+}
+
+void RenderGraph::PassBuilder::Read(ResourceId resource)
+{
+    assert(resource >= 0 && resource < static_cast<int>(m_graph.m_versions.size()));
+    m_graph.m_passes[m_passIndex].reads.push_back(resource);
+}
+
+void RenderGraph::PassBuilder::Read(ResourceId resource, std::shared_ptr<Material> material, const char* uniformName)
+{
+    Read(resource);
+
+    assert(material);
+    ShaderProgram::Location location = material->GetUniformLocation(uniformName);
+    assert(location >= 0);
+    m_graph.m_passes[m_passIndex].bindings.push_back({ resource, material, location });
+}
+
+RenderGraph::ResourceId RenderGraph::PassBuilder::Write(ResourceId resource)
+{
+    assert(resource >= 0 && resource < static_cast<int>(m_graph.m_versions.size()));
+
+    // Only the last version can be written, older versions could still be read by other passes
+    int textureIndex = m_graph.m_versions[resource];
+    assert(m_graph.m_textures[textureIndex].lastVersion == resource);
+
+    ResourceId version = m_graph.AddVersion(textureIndex);
+    m_graph.m_passes[m_passIndex].writes.push_back(version);
+    return version;
+}
+
+void RenderGraph::PassBuilder::SetName(const std::string& name)
+{
+    m_graph.m_passes[m_passIndex].renderPass->SetName(name);
+}
+
+void RenderGraph::PassBuilder::SetDepth(ResourceId resource)
+{
+    assert(resource >= 0 && resource < static_cast<int>(m_graph.m_versions.size()));
+    assert(!m_graph.GetTexture(resource).backbuffer);
+    m_graph.m_passes[m_passIndex].depth = resource;
+}
+
+void RenderGraph::PassBuilder::SetSideEffects()
+{
+    m_graph.m_passes[m_passIndex].sideEffects = true;
+}
+
+RenderGraph::RenderGraph() : m_compiled(false), m_culledPassCount(0), m_transientTextureCount(0), m_allocatedTextureCount(0)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+}
+
+RenderGraph::ResourceId RenderGraph::ImportTexture(std::shared_ptr<Texture2DObject> texture)
+{
+    assert(texture);
+    Texture& graphTexture = m_textures.emplace_back();
+    graphTexture.desc = {};
+    graphTexture.texture = texture;
+    graphTexture.imported = true;
+    graphTexture.backbuffer = false;
+    return AddVersion(static_cast<int>(m_textures.size()) - 1);
+}
+
+RenderGraph::ResourceId RenderGraph::ImportBackbuffer()
+{
+    Texture& graphTexture = m_textures.emplace_back();
+    graphTexture.desc = {};
+    graphTexture.imported = true;
+    graphTexture.backbuffer = true;
+    return AddVersion(static_cast<int>(m_textures.size()) - 1);
+}
+
+RenderGraph::ResourceId RenderGraph::CreateTexture(const TextureDesc& desc)
+{
+    Texture& graphTexture = m_textures.emplace_back();
+    graphTexture.desc = desc;
+    graphTexture.imported = false;
+    graphTexture.backbuffer = false;
+    return AddVersion(static_cast<int>(m_textures.size()) - 1);
+}
+
+RenderGraph::PassBuilder RenderGraph::AddPass(std::unique_ptr<RenderPass> renderPass)
+{
+    assert(!m_compiled);
+    assert(renderPass && !renderPass->GetTargetFramebuffer());
+
+    Pass& pass = m_passes.emplace_back();
+    pass.renderPass = std::move(renderPass);
+    pass.depth = InvalidResource;
+    pass.sideEffects = false;
+    pass.culled = false;
+    return PassBuilder(*this, static_cast<int>(m_passes.size()) - 1);
+}
+
+RenderGraph::ResourceId RenderGraph::AddVersion(int textureIndex)
+{
+    ResourceId version = static_cast<ResourceId>(m_versions.size());
+    m_versions.push_back(textureIndex);
+    m_textures[textureIndex].lastVersion = version;
+    return version;
+}
+
+void RenderGraph::Compile(Renderer& renderer)
+{
+    assert(!m_compiled);
+
+    CullPasses();
+    ComputeLifetimes();
+    AllocateTextures(renderer.GetRenderTargetPool());
+
+    for (Pass& pass : m_passes)
+    {
+        if (pass.culled)
+        {
+            continue;
+        }
+
+        std::shared_ptr<const FramebufferObject> framebuffer = GetFramebuffer(pass, renderer);
+
+        // Resolve the textures that the pass reads
+        std::vector<CompiledPass::Binding> bindings;
+        for (const Binding& binding : pass.bindings)
+        {
+            const Texture& texture = GetTexture(binding.resource);
+            assert(texture.texture);
+            bindings.push_back({ binding.material, binding.location, texture.texture });
+        }
+
+        // Render targets of the transient textures used by the pass
+        std::vector<std::shared_ptr<const RenderTargetPool::RenderTarget>> renderTargets;
+        auto addRenderTarget = [&](ResourceId resource)
+        {
+            const Texture& texture = GetTexture(resource);
+            if (texture.renderTarget && std::find(renderTargets.begin(), renderTargets.end(), texture.renderTarget) == renderTargets.end())
+            {
+                renderTargets.push_back(texture.renderTarget);
+            }
+        };
+        std::for_each(pass.reads.begin(), pass.reads.end(), addRenderTarget);
+        std::for_each(pass.writes.begin(), pass.writes.end(), addRenderTarget);
+        if (pass.depth != InvalidResource)
+        {
+            addRenderTarget(pass.depth);
+        }
+
+        // The inner pass is not added to the renderer, but it still needs it to render
+        pass.renderPass->SetRenderer(&renderer);
+        renderer.AddRenderPass(std::make_unique<CompiledPass>(std::move(pass.renderPass), framebuffer, std::move(bindings), std::move(renderTargets)));
+    }
+
+    m_compiled = true;
+}
+
+void RenderGraph::CullPasses()
+{
+    // Go backwards, keeping the passes that write versions needed by the passes kept after them
+    std::vector<bool> neededVersions(m_versions.size(), false);
+    m_culledPassCount = 0;
+    for (auto itPass = m_passes.rbegin(); itPass != m_passes.rend(); ++itPass)
+    {
+        Pass& pass = *itPass;
+
+        bool keep = pass.sideEffects;
+        for (ResourceId resource : pass.writes)
+        {
+            keep |= neededVersions[resource] || GetTexture(resource).imported;
+        }
+
+        pass.culled = !keep;
+        if (pass.culled)
+        {
+            m_culledPassCount++;
+            continue;
+        }
+
+        for (ResourceId resource : pass.reads)
+        {
+            neededVersions[resource] = true;
+        }
+        if (pass.depth != InvalidResource)
+        {
+            neededVersions[pass.depth] = true;
+        }
+    }
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+    for (Texture& texture : m_textures)
+    {
+        texture.firstPass = -1;
+        texture.lastPass = -1;
+    }
+
+    auto useTexture = [&](ResourceId resource, int passIndex)
+    {
+        Texture& texture = GetTexture(resource);
+        if (texture.firstPass < 0)
+        {
+            texture.firstPass = passIndex;
+        }
+        texture.lastPass = passIndex;
+    };
+
+    for (int passIndex = 0; passIndex < static_cast<int>(m_passes.size()); ++passIndex)
+    {
+        const Pass& pass = m_passes[passIndex];
+        if (pass.culled)
+        {
+            continue;
+        }
+
+        for (ResourceId resource : pass.reads)
+        {
+            useTexture(resource, passIndex);
+        }
+        for (ResourceId resource : pass.writes)
+        {
+            useTexture(resource, passIndex);
+        }
+        if (pass.depth != InvalidResource)
+        {
+            useTexture(pass.depth, passIndex);
+        }
+    }
+}
+
+void RenderGraph::AllocateTextures(RenderTargetPool& renderTargetPool)
+{
+    // Transient textures that are used, in the order they start living
+    std::vector<Texture*> transientTextures;
+    for (Texture& texture : m_textures)
+    {
+        if (!texture.imported && texture.firstPass >= 0)
+        {
+            transientTextures.push_back(&texture);
+        }
+    }
+    std::stable_sort(transientTextures.begin(), transientTextures.end(),
+        [](const Texture* a, const Texture* b) { return a->firstPass < b->firstPass; });
+
+    // Acquired render targets, and the last pass that uses each of them
+    struct Allocation
+    {
+        std::shared_ptr<const RenderTargetPool::RenderTarget> renderTarget;
+        TextureDesc desc;
+        int lastPass;
+    };
+    std::vector<Allocation> allocations;
+
+    for (Texture* texture : transientTextures)
+    {
+        // Reuse a texture with the same description that is not used anymore
+        auto itAllocation = std::find_if(allocations.begin(), allocations.end(),
+            [&](const Allocation& allocation) { return allocation.desc == texture->desc && allocation.lastPass < texture->firstPass; });
+
+        if (itAllocation == allocations.end())
+        {
+            const TextureDesc& desc = texture->desc;
+            RenderTargetPool::Descriptor descriptor = RenderTargetPool::Descriptor::Create(desc.width, desc.height, desc.internalFormat);
+            allocations.push_back({ renderTargetPool.Acquire(descriptor), desc, -1 });
+            itAllocation = allocations.end() - 1;
+        }
+
+        texture->renderTarget = itAllocation->renderTarget;
+        texture->texture = itAllocation->renderTarget->GetColorTexture<Texture2DObject>(0);
+        itAllocation->lastPass = texture->lastPass;
+    }
+
+    m_transientTextureCount = static_cast<unsigned int>(transientTextures.size());
+    m_allocatedTextureCount = static_cast<unsigned int>(allocations.size());
+}
+
+std::shared_ptr<const FramebufferObject> RenderGraph::GetFramebuffer(const Pass& pass, const Renderer& renderer)
+{
+    // Passes without attachments keep the current framebuffer. Only passes with side effects get here
+    if (pass.writes.empty() && pass.depth == InvalidResource)
+    {
+        return nullptr;
+    }
+
+    // The backbuffer can't be combined with other attachments
+    if (!pass.writes.empty() && GetTexture(pass.writes[0]).backbuffer)
+    {
+        assert(pass.writes.size() == 1);
+        return renderer.GetDefaultFramebuffer();
+    }
+
+    std::vector<const Texture2DObject*> colors;
+    for (ResourceId resource : pass.writes)
+    {
+        const Texture& texture = GetTexture(resource);
+        assert(!texture.backbuffer);
+        colors.push_back(texture.texture.get());
+    }
+    const Texture2DObject* depth = pass.depth != InvalidResource ? GetTexture(pass.depth).texture.get() : nullptr;
+
+    // A single texture from the pool already has its framebuffer
+    if (colors.size() == 1 && !depth && GetTexture(pass.writes[0]).renderTarget)
+    {
+        return GetTexture(pass.writes[0]).renderTarget->framebuffer;
+    }
+
+    // Passes with the same attachments share the framebuffer, so it is not bound again between them
+    for (const Framebuffer& framebuffer : m_framebuffers)
+    {
+        if (framebuffer.colors == colors && framebuffer.depth == depth)
+        {
+            return framebuffer.framebuffer;
+        }
+    }
+
+    std::shared_ptr<FramebufferObject> framebuffer = std::make_shared<FramebufferObject>();
+    framebuffer->Bind();
+    if (depth)
+    {
+        framebuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Depth, *depth);
+    }
+
+    std::vector<FramebufferObject::Attachment> drawBuffers;
+    for (unsigned int i = 0; i < colors.size(); ++i)
+    {
+        FramebufferObject::Attachment attachment = static_cast<FramebufferObject::Attachment>(GL_COLOR_ATTACHMENT0 + i);
+        framebuffer->SetTexture(FramebufferObject::Target::Draw, attachment, *colors[i]);
+        drawBuffers.push_back(attachment);
+    }
+    framebuffer->SetDrawBuffers(drawBuffers);
+    FramebufferObject::Unbind();
+
+    m_framebuffers.push_back({ colors, depth, framebuffer });
+    return framebuffer;
+}
@@ -6,6 +6,7 @@
 RenderPass::RenderPass(std::shared_ptr<const FramebufferObject> targetFramebuffer)
     : m_renderer(nullptr)
     , m_targetFramebuffer(targetFramebuffer)
+    , m_name("RenderPass")
 {
 }
 
@@ -18,6 +19,16 @@ std::shared_ptr<const FramebufferObject> RenderPass::GetTargetFramebuffer() cons
     return m_targetFramebuffer;
 }
 
+const std::string& RenderPass::GetName() const
+{
+    return m_name;
+}
+
+void RenderPass::SetName(const std::string& name)
+{
+    m_name = name;
+}
+
 void RenderPass::SetRenderer(Renderer* renderer)
 {
     m_renderer = renderer;
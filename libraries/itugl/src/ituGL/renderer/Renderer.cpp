@@ -2,6 +2,7 @@
 
 #include <ituGL/shader/Material.h>
 #include <ituGL/geometry/VertexFormat.h>
+#include <ituGL/geometry/VertexAttribute.h>
 #include <ituGL/geometry/VertexArrayObject.h>
 #include <ituGL/geometry/Drawcall.h>
 #include <ituGL/geometry/Mesh.h>
@@ -9,8 +10,15 @@
 #include <ituGL/lighting/Light.h>
 #include <ituGL/texture/FramebufferObject.h>
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/camera/Camera.h>
+#include <ituGL/scene/Bounds.h>
+#include <ituGL/utils/CpuProfiler.h>
+#include <glm/common.hpp>
+#include <limits>
 #include <span>
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cassert>
 
 Renderer::Renderer(DeviceGL& device)
@@ -18,15 +26,42 @@ Renderer::Renderer(DeviceGL& device)
     , m_currentCamera(nullptr)
     , m_defaultFramebuffer(FramebufferObject::GetDefault())
     , m_currentFramebuffer(m_defaultFramebuffer)
-    , m_drawcallCollections(1)
+    , m_frameArena(64 * 1024)
+    , m_lights(&m_frameArena)
+    , m_worldMatrices(&m_frameArena)
+    , m_drawcalls(&m_frameArena)
+    , m_drawcallBounds{ std::pmr::vector<float>(&m_frameArena), std::pmr::vector<float>(&m_frameArena), std::pmr::vector<float>(&m_frameArena),
+        std::pmr::vector<float>(&m_frameArena), std::pmr::vector<float>(&m_frameArena), std::pmr::vector<float>(&m_frameArena) }
+    , m_drawcallVisibility(&m_frameArena)
+    , m_cullingEnabled(true)
+    , m_culledDrawcallCount(0)
+    , m_occlusionCullingEnabled(true)
+    , m_occludedDrawcallCount(0)
+    , m_parallelRecordingEnabled(true)
+    , m_gpuProfilingEnabled(QueryObject::IsTimerSupported())
+    , m_sortDrawcalls(true)
+    , m_sortEntries(&m_frameArena)
+    , m_sortEntriesScratch(&m_frameArena)
+    , m_sortedDrawcalls(&m_frameArena)
+    , m_instancingEnabled(true)
+    , m_instanceWorldMatrices(&m_frameArena)
+    , m_multiDrawEnabled(true)
+    , m_indirectCommands(&m_frameArena)
+    , m_worldMatrixBlockUsed(false)
+    , m_lastMaterial(nullptr)
+    , m_lastShaderProgram(nullptr)
+    , m_lastVao(nullptr)
+    , m_lastWorldMatrixIndex(0)
 {
+    // Default collection, with all the drawcalls
+    AddDrawcallCollection(nullptr);
+
     InitializeFullscreenMesh();
 
     device.EnableFeature(GL_FRAMEBUFFER_SRGB);
     device.EnableFeature(GL_DEPTH_TEST);
     device.EnableFeature(GL_CULL_FACE);
     device.EnableFeature(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-    device.SetVSyncEnabled(true);
 }
 
 bool Renderer::HasCamera() const
@@ -71,29 +106,305 @@ const Mesh& Renderer::GetFullscreenMesh() const
 
 void Renderer::Render()
 {
+    ITUGL_PROFILE_SCOPE("Renderer::Render");
+
     assert(m_currentCamera);
 
-    for (auto& pass : m_passes)
+    if (m_cullingEnabled)
+    {
+        CullDrawcalls();
+    }
+
+    if (m_sortDrawcalls)
+    {
+        SortDrawcalls();
+    }
+
+    FilterDrawcalls();
+
+    BuildDrawcallBatches();
+
+    UploadFrameData();
+
+    if (m_gpuProfilingEnabled)
     {
-        SetCurrentFramebuffer(pass->GetTargetFramebuffer());
-        pass->Render();
+        m_gpuProfiler.BeginFrame();
     }
 
+    for (unsigned int passIndex = 0; passIndex < m_passes.size(); ++passIndex)
+    {
+        RenderPass& pass = *m_passes[passIndex];
+        ITUGL_PROFILE_SCOPE(pass.GetName().c_str());
+        SetCurrentFramebuffer(pass.GetTargetFramebuffer());
+
+        // Passes are free to change any state, so each one starts from scratch
+        InvalidateDrawcallStates();
+
+        if (m_gpuProfilingEnabled)
+        {
+            m_gpuProfiler.BeginTimer(passIndex, pass.GetName());
+        }
+
+        pass.Render();
+
+        if (m_gpuProfilingEnabled)
+        {
+            m_gpuProfiler.EndTimer();
+        }
+    }
+
+    InvalidateDrawcallStates();
+
+    // Age the render targets that were not used this frame
+    m_renderTargetPool.EndFrame();
+
     Reset();
 }
 
+// Make a container give back its memory, so it doesn't point to the arena after resetting it
+template<typename Container>
+static void ReleaseFrameMemory(Container& container)
+{
+    Container(container.get_allocator()).swap(container);
+}
+
 void Renderer::Reset()
 {
-    m_lights.clear();
+    ReleaseFrameMemory(m_lights);
+    ReleaseFrameMemory(m_worldMatrices);
+    ReleaseFrameMemory(m_drawcalls);
+    for (auto& bounds : m_drawcallBounds)
+    {
+        ReleaseFrameMemory(bounds);
+    }
+    ReleaseFrameMemory(m_drawcallVisibility);
+    m_occlusionCuller.Reset();
 
     for (auto& collection : m_drawcallCollections)
     {
-        collection.clear();
+        ReleaseFrameMemory(collection);
     }
 
+    ReleaseFrameMemory(m_sortEntries);
+    ReleaseFrameMemory(m_sortEntriesScratch);
+    ReleaseFrameMemory(m_sortedDrawcalls);
+
+    for (auto& batches : m_drawcallBatches)
+    {
+        ReleaseFrameMemory(batches);
+    }
+    ReleaseFrameMemory(m_instanceWorldMatrices);
+    ReleaseFrameMemory(m_indirectCommands);
+
+    // All the per-frame memory is released at once. The arena keeps its capacity for the next frame
+    m_frameArena.Reset();
+
     m_currentCamera = nullptr;
 }
 
+void Renderer::UploadFrameData()
+{
+    ITUGL_PROFILE_SCOPE("Renderer::UploadFrameData");
+
+    const Camera& camera = *m_currentCamera;
+
+    CameraBlock cameraBlock;
+    cameraBlock.viewMatrix = camera.GetViewMatrix();
+    cameraBlock.projMatrix = camera.GetProjectionMatrix();
+    cameraBlock.viewProjMatrix = camera.GetViewProjectionMatrix();
+    cameraBlock.invViewMatrix = glm::inverse(cameraBlock.viewMatrix);
+    cameraBlock.invProjMatrix = glm::inverse(cameraBlock.projMatrix);
+    cameraBlock.invViewProjMatrix = glm::inverse(cameraBlock.viewProjMatrix);
+    cameraBlock.cameraPosition = glm::vec4(camera.ExtractTranslation(), 1.0f);
+
+    // Reallocating every frame lets the driver keep using the old storage if the previous frame is still in flight
+    m_cameraBuffer.Bind();
+    m_cameraBuffer.AllocateData(cameraBlock, BufferObject::StreamDraw);
+    m_cameraBuffer.BindBase(CameraBlockBinding);
+
+    // The default shaders set the world matrix as a uniform, so usually nothing reads the block
+    if (m_worldMatrixBlockUsed && !m_worldMatrices.empty())
+    {
+        UploadWorldMatrices();
+    }
+}
+
+void Renderer::UploadWorldMatrices()
+{
+    m_worldMatrixBuffer.Bind();
+    m_worldMatrixBuffer.AllocateData(std::span<const glm::mat4>(m_worldMatrices), BufferObject::StreamDraw);
+    m_worldMatrixBuffer.BindBase(WorldMatrixBlockBinding);
+}
+
+// Reduce a pointer to a small id, only used to group equal materials together. Collisions are harmless
+static uint64_t GetPointerSortId(const void* pointer)
+{
+    uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    return value;
+}
+
+uint64_t Renderer::ComputeSortKey(const DrawcallInfo& drawcallInfo) const
+{
+    const Material& material = drawcallInfo.material;
+
+    // Opaque drawcalls go first, then the blended ones
+    bool isBlended = IsBlendedDrawcall(drawcallInfo);
+    uint64_t queue = isBlended ? 1 : 0;
+
+    uint64_t shaderProgram = drawcallInfo.shaderProgram.GetId() & 0xFFFF;
+    uint64_t materialId = GetPointerSortId(&material) & 0xFFFF;
+    uint64_t vao = drawcallInfo.vao.GetHandle() & 0xFFFF;
+
+    // View depth of the object origin, in a log scale so close objects get more precision: 14 bits cover up to 2^16 units
+    const glm::mat4& worldMatrix = m_worldMatrices[drawcallInfo.worldMatrixIndex];
+    float viewDepth = -(m_currentCamera->GetViewMatrix() * worldMatrix[3]).z;
+    float depthLog = std::log2(1.0f + std::max(viewDepth, 0.0f)) * 1024.0f;
+    uint64_t depth = static_cast<uint64_t>(std::min(depthLog, 16383.0f));
+
+    uint64_t key = queue << 62;
+    if (isBlended)
+    {
+        // Blended drawcalls need to be drawn back to front, state changes are less important
+        key |= (0x3FFF - depth) << 48;
+        key |= shaderProgram << 32;
+        key |= materialId << 16;
+        key |= vao;
+    }
+    else
+    {
+        // Opaque drawcalls are grouped by state, and then front to back to help the early depth test
+        key |= shaderProgram << 46;
+        key |= materialId << 30;
+        key |= vao << 14;
+        key |= depth;
+    }
+    return key;
+}
+
+void Renderer::CullDrawcalls()
+{
+    ITUGL_PROFILE_SCOPE("Renderer::CullDrawcalls");
+
+    unsigned int count = static_cast<unsigned int>(m_drawcalls.size());
+
+    // Test all the bounds in a single call
+    FrustumBounds frustum(m_currentCamera->GetViewProjectionMatrix());
+    m_drawcallVisibility.resize(count);
+    frustum.IntersectsAabbs({ m_drawcallBounds[0], m_drawcallBounds[1], m_drawcallBounds[2] },
+        { m_drawcallBounds[3], m_drawcallBounds[4], m_drawcallBounds[5] }, m_drawcallVisibility);
+
+    // Test the boxes inside the frustum against the occluders
+    m_occludedDrawcallCount = 0;
+    if (m_occlusionCullingEnabled && m_occlusionCuller.GetOccluderCount() > 0)
+    {
+        unsigned int frustumVisibleCount = static_cast<unsigned int>(std::count(m_drawcallVisibility.begin(), m_drawcallVisibility.end(), 1));
+
+        m_occlusionCuller.Rasterize(m_currentCamera->GetViewProjectionMatrix(), &m_threadPool);
+        m_occlusionCuller.TestAabbs({ m_drawcallBounds[0], m_drawcallBounds[1], m_drawcallBounds[2] },
+            { m_drawcallBounds[3], m_drawcallBounds[4], m_drawcallBounds[5] }, m_drawcallVisibility, &m_threadPool);
+
+        unsigned int visibleCount = static_cast<unsigned int>(std::count(m_drawcallVisibility.begin(), m_drawcallVisibility.end(), 1));
+        m_occludedDrawcallCount = frustumVisibleCount - visibleCount;
+    }
+
+    // Keep the visible ones. The bounds are not needed anymore, so they are not compacted
+    m_sortedDrawcalls.clear();
+    for (unsigned int index = 0; index < count; ++index)
+    {
+        if (m_drawcallVisibility[index])
+        {
+            m_sortedDrawcalls.push_back(m_drawcalls[index]);
+        }
+    }
+    m_drawcalls.swap(m_sortedDrawcalls);
+
+    m_culledDrawcallCount = count - static_cast<unsigned int>(m_drawcalls.size());
+}
+
+void Renderer::SortDrawcalls()
+{
+    ITUGL_PROFILE_SCOPE("Renderer::SortDrawcalls");
+
+    unsigned int count = static_cast<unsigned int>(m_drawcalls.size());
+    if (count < 2)
+    {
+        return;
+    }
+
+    m_sortEntries.resize(count);
+    m_sortEntriesScratch.resize(count);
+    for (unsigned int index = 0; index < count; ++index)
+    {
+        DrawcallInfo& drawcallInfo = m_drawcalls[index];
+        drawcallInfo.sortKey = ComputeSortKey(drawcallInfo);
+        m_sortEntries[index] = { drawcallInfo.sortKey, index };
+    }
+
+    // LSD radix sort, 8 bits per pass. It is stable, so equal keys keep their submission order
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        std::array<unsigned int, 256> offsets = {};
+        for (const SortEntry& entry : m_sortEntries)
+        {
+            offsets[(entry.key >> shift) & 0xFF]++;
+        }
+
+        // Skip the pass if all the keys have the same digit
+        if (offsets[(m_sortEntries[0].key >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        // Turn the histogram into the starting offset of each digit
+        unsigned int offset = 0;
+        for (unsigned int& digitOffset : offsets)
+        {
+            unsigned int digitCount = digitOffset;
+            digitOffset = offset;
+            offset += digitCount;
+        }
+
+        for (const SortEntry& entry : m_sortEntries)
+        {
+            m_sortEntriesScratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        m_sortEntries.swap(m_sortEntriesScratch);
+    }
+
+    // DrawcallInfo holds references, so the sorted array is rebuilt instead of swapping elements
+    m_sortedDrawcalls.clear();
+    for (const SortEntry& entry : m_sortEntries)
+    {
+        m_sortedDrawcalls.push_back(m_drawcalls[entry.index]);
+    }
+    m_drawcalls.swap(m_sortedDrawcalls);
+}
+
+void Renderer::FilterDrawcalls()
+{
+    ITUGL_PROFILE_SCOPE("Renderer::FilterDrawcalls");
+
+    unsigned int count = static_cast<unsigned int>(m_drawcalls.size());
+    for (unsigned int collectionIndex = 0; collectionIndex < m_drawcallCollections.size(); ++collectionIndex)
+    {
+        DrawcallCollection& collection = m_drawcallCollections[collectionIndex];
+        const DrawcallPredicate& predicate = m_drawcallPredicates[collectionIndex];
+
+        collection.clear();
+        collection.reserve(count);
+        for (unsigned int index = 0; index < count; ++index)
+        {
+            if (!predicate || predicate(m_drawcalls[index]))
+            {
+                collection.push_back(index);
+            }
+        }
+    }
+}
+
 int Renderer::AddRenderPass(std::unique_ptr<RenderPass> renderPass)
 {
     int passIndex = static_cast<int>(m_passes.size());
@@ -109,34 +420,98 @@ void Renderer::RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shader
 {
     assert(shaderProgramPtr);
 
+    // Bind the shared blocks now, the program could be used outside of the drawcall collections
+    GetShaderProgramInfo(*shaderProgramPtr);
+
+    // The functions are resolved here once, drawing only indexes the table with the program id
+    ShaderProgramEntry& entry = m_shaderProgramEntries[shaderProgramPtr->GetId()];
+    entry.shaderProgram = shaderProgramPtr;
+
     if (updateTransformFunction)
     {
-        m_updateTransformsFunctions[shaderProgramPtr] = updateTransformFunction;
+        entry.updateTransformsFunction = updateTransformFunction;
     }
 
     if (updateLightsFunction)
     {
-        m_updateLightsFunctions[shaderProgramPtr] = updateLightsFunction;
+        entry.updateLightsFunction = updateLightsFunction;
+    }
+}
+
+void Renderer::RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
+    const UpdateLightsFunction& updateLightsFunction)
+{
+    RegisterShaderProgram(shaderProgramPtr, nullptr, updateLightsFunction);
+
+    const ShaderProgram& shaderProgram = *shaderProgramPtr;
+    ShaderProgramEntry& entry = m_shaderProgramEntries[shaderProgram.GetId()];
+    entry.standardTransforms = true;
+    entry.transformLocations.worldMatrix = shaderProgram.GetUniformLocation("WorldMatrix");
+    entry.transformLocations.worldViewMatrix = shaderProgram.GetUniformLocation("WorldViewMatrix");
+    entry.transformLocations.worldViewProjMatrix = shaderProgram.GetUniformLocation("WorldViewProjMatrix");
+    entry.transformLocations.viewProjMatrix = shaderProgram.GetUniformLocation("ViewProjMatrix");
+    entry.transformLocations.cameraPosition = shaderProgram.GetUniformLocation("CameraPosition");
+}
+
+template<typename SetUniformFunction>
+void Renderer::SetStandardTransforms(const TransformLocations& locations, const glm::mat4& worldMatrix, bool cameraChanged, SetUniformFunction setUniform) const
+{
+    const Camera& camera = *m_currentCamera;
+
+    // Camera uniforms, only needed the first time the shader program is used
+    if (cameraChanged)
+    {
+        if (locations.viewProjMatrix >= 0)
+        {
+            setUniform(locations.viewProjMatrix, camera.GetViewProjectionMatrix());
+        }
+        if (locations.cameraPosition >= 0)
+        {
+            setUniform(locations.cameraPosition, camera.ExtractTranslation());
+        }
+    }
+
+    if (locations.worldMatrix >= 0)
+    {
+        setUniform(locations.worldMatrix, worldMatrix);
+    }
+    if (locations.worldViewMatrix >= 0)
+    {
+        setUniform(locations.worldViewMatrix, camera.GetViewMatrix() * worldMatrix);
+    }
+    if (locations.worldViewProjMatrix >= 0)
+    {
+        setUniform(locations.worldViewProjMatrix, camera.GetViewProjectionMatrix() * worldMatrix);
     }
 }
 
-void Renderer::UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, unsigned int worldMatrixIndex, bool cameraChanged) const
+void Renderer::UpdateTransforms(const ShaderProgram& shaderProgram, unsigned int worldMatrixIndex, bool cameraChanged) const
 {
     const glm::mat4& worldMatrix = m_worldMatrices[worldMatrixIndex];
-    UpdateTransforms(shaderProgramPtr, worldMatrix);
+    UpdateTransforms(shaderProgram, worldMatrix, cameraChanged);
 }
 
-void Renderer::UpdateTransforms(std::shared_ptr<const ShaderProgram> shaderProgramPtr, const glm::mat4& worldMatrix, bool cameraChanged) const
+void Renderer::UpdateTransforms(const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, bool cameraChanged) const
 {
-    const auto& itFind = m_updateTransformsFunctions.find(shaderProgramPtr);
-    if (itFind != m_updateTransformsFunctions.end())
+    const ShaderProgramEntry* entry = FindShaderProgramEntry(shaderProgram);
+    if (entry && entry->updateTransformsFunction)
+    {
+        entry->updateTransformsFunction(shaderProgram, worldMatrix, *m_currentCamera, cameraChanged);
+    }
+    else if (entry && entry->standardTransforms)
     {
-        itFind->second(*shaderProgramPtr, worldMatrix, *m_currentCamera, cameraChanged);
+        SetStandardTransforms(entry->transformLocations, worldMatrix, cameraChanged,
+            [&](ShaderProgram::Location location, const auto& value) { shaderProgram.SetUniform(location, value); });
     }
 }
 
 Renderer::UpdateLightsFunction Renderer::GetDefaultUpdateLightsFunction(const ShaderProgram& shaderProgram)
 {
+    if (shaderProgram.GetUniformArraySize("LightColors") > 0)
+    {
+        return GetBatchedUpdateLightsFunction(shaderProgram);
+    }
+
     // Get lighting related uniform locations
     ShaderProgram::Location lightIndirectLocation = shaderProgram.GetUniformLocation("LightIndirect");
     ShaderProgram::Location lightColorLocation = shaderProgram.GetUniformLocation("LightColor");
@@ -171,12 +546,72 @@ Renderer::UpdateLightsFunction Renderer::GetDefaultUpdateLightsFunction(const Sh
     };
 }
 
-bool Renderer::UpdateLights(std::shared_ptr<const ShaderProgram> shaderProgramPtr, std::span<const Light* const> lights, unsigned int& lightIndex) const
+Renderer::UpdateLightsFunction Renderer::GetBatchedUpdateLightsFunction(const ShaderProgram& shaderProgram)
 {
-    const auto& itFind = m_updateLightsFunctions.find(shaderProgramPtr);
-    if (itFind != m_updateLightsFunctions.end())
+    // Get lighting related uniform locations
+    ShaderProgram::Location lightIndirectLocation = shaderProgram.GetUniformLocation("LightIndirect");
+    ShaderProgram::Location lightCountLocation = shaderProgram.GetUniformLocation("LightCount");
+    ShaderProgram::Location lightColorsLocation = shaderProgram.GetUniformLocation("LightColors");
+    ShaderProgram::Location lightPositionsLocation = shaderProgram.GetUniformLocation("LightPositions");
+    ShaderProgram::Location lightDirectionsLocation = shaderProgram.GetUniformLocation("LightDirections");
+    ShaderProgram::Location lightAttenuationsLocation = shaderProgram.GetUniformLocation("LightAttenuations");
+
+    // Lights per pass, from the size of the arrays in the shader
+    unsigned int batchSize = static_cast<unsigned int>(shaderProgram.GetUniformArraySize("LightColors"));
+    assert(batchSize > 0);
+
+    // Values of the current batch. They are kept in the function, so they are allocated only once
+    std::vector<glm::vec3> colors(batchSize);
+    std::vector<glm::vec3> positions(batchSize);
+    std::vector<glm::vec3> directions(batchSize);
+    std::vector<glm::vec4> attenuations(batchSize);
+
+    return [=](const ShaderProgram& shaderProgram, std::span<const Light* const> lights, unsigned int& lightIndex) mutable -> bool
     {
-        return itFind->second(*shaderProgramPtr, lights, lightIndex);
+        bool needsRender = lightIndex == 0;
+
+        shaderProgram.SetUniform(lightIndirectLocation, lightIndex == 0 ? 1 : 0);
+
+        unsigned int lightCount = 0;
+        if (lightIndex < lights.size())
+        {
+            lightCount = std::min(batchSize, static_cast<unsigned int>(lights.size()) - lightIndex);
+            for (unsigned int i = 0; i < lightCount; ++i)
+            {
+                const Light& light = *lights[lightIndex + i];
+                colors[i] = light.GetColor() * light.GetIntensity();
+                positions[i] = light.GetPosition();
+                directions[i] = light.GetDirection();
+                attenuations[i] = light.GetAttenuation();
+            }
+
+            std::span<const glm::vec3> colorSpan(colors.data(), lightCount);
+            std::span<const glm::vec3> positionSpan(positions.data(), lightCount);
+            std::span<const glm::vec3> directionSpan(directions.data(), lightCount);
+            std::span<const glm::vec4> attenuationSpan(attenuations.data(), lightCount);
+            shaderProgram.SetUniforms(lightColorsLocation, colorSpan);
+            shaderProgram.SetUniforms(lightPositionsLocation, positionSpan);
+            shaderProgram.SetUniforms(lightDirectionsLocation, directionSpan);
+            shaderProgram.SetUniforms(lightAttenuationsLocation, attenuationSpan);
+            needsRender = true;
+        }
+
+        // The lights after LightCount are ignored
+        shaderProgram.SetUniform(lightCountLocation, static_cast<int>(lightCount));
+
+        // Advance at least one, to finish after the first pass if there are no lights
+        lightIndex += std::max(lightCount, 1u);
+
+        return needsRender;
+    };
+}
+
+bool Renderer::UpdateLights(const ShaderProgram& shaderProgram, std::span<const Light* const> lights, unsigned int& lightIndex) const
+{
+    const ShaderProgramEntry* entry = FindShaderProgramEntry(shaderProgram);
+    if (entry && entry->updateLightsFunction)
+    {
+        return entry->updateLightsFunction(shaderProgram, lights, lightIndex);
     }
     return false;
 }
@@ -191,11 +626,41 @@ void Renderer::AddLight(const Light& light)
     m_lights.push_back(&light);
 }
 
-std::span<const Renderer::DrawcallInfo> Renderer::GetDrawcalls(unsigned int collectionIndex) const
+unsigned int Renderer::AddDrawcallCollection(const DrawcallPredicate& predicate)
+{
+    unsigned int collectionIndex = static_cast<unsigned int>(m_drawcallCollections.size());
+    m_drawcallCollections.emplace_back(&m_frameArena);
+    m_drawcallPredicates.push_back(predicate);
+    return collectionIndex;
+}
+
+bool Renderer::IsOpaqueDrawcall(const DrawcallInfo& drawcallInfo)
+{
+    return !IsBlendedDrawcall(drawcallInfo);
+}
+
+bool Renderer::IsBlendedDrawcall(const DrawcallInfo& drawcallInfo)
+{
+    const Material& material = drawcallInfo.material;
+    return material.GetBlendEquationColor() != Material::BlendEquation::None
+        || material.GetBlendEquationAlpha() != Material::BlendEquation::None;
+}
+
+std::span<const Renderer::DrawcallInfo> Renderer::GetDrawcalls() const
+{
+    return m_drawcalls;
+}
+
+std::span<const unsigned int> Renderer::GetDrawcallIndices(unsigned int collectionIndex) const
 {
     return m_drawcallCollections[collectionIndex];
 }
 
+std::span<const Renderer::DrawcallBatch> Renderer::GetDrawcallBatches(unsigned int collectionIndex) const
+{
+    return m_drawcallBatches[collectionIndex];
+}
+
 void Renderer::AddModel(const Model& model, const glm::mat4& worldMatrix)
 {
     unsigned int worldMatrixIndex = static_cast<unsigned int>(m_worldMatrices.size());
@@ -204,40 +669,389 @@ void Renderer::AddModel(const Model& model, const glm::mat4& worldMatrix)
     const Mesh& mesh = model.GetMesh();
     for (unsigned int submeshIndex = 0; submeshIndex < mesh.GetSubmeshCount(); ++submeshIndex)
     {
-        DrawcallInfo drawcallInfo(model.GetMaterial(submeshIndex), worldMatrixIndex,
-            mesh.GetSubmeshVertexArray(submeshIndex), mesh.GetSubmeshDrawcall(submeshIndex));
+        // The drawcall is added only once, collections are filled with its index before rendering
+        const Material& material = model.GetMaterial(submeshIndex);
+        m_drawcalls.emplace_back(material, *material.GetShaderProgramPointer(), worldMatrixIndex,
+            mesh.GetSubmeshVertexArray(submeshIndex), mesh.GetSubmeshPositionVertexArray(submeshIndex), mesh.GetSubmeshDrawcall(submeshIndex));
 
-        for (DrawcallCollection& collection : m_drawcallCollections)
+        // Transform the local AABB to world space. Without bounds, make it big enough to never be culled
+        glm::vec3 center(0.0f);
+        glm::vec3 size(std::numeric_limits<float>::max());
+        if (mesh.HasSubmeshBounds(submeshIndex))
         {
-            collection.push_back(drawcallInfo);
+            AabbBounds localBounds = mesh.GetSubmeshBounds(submeshIndex);
+            center = glm::vec3(worldMatrix * glm::vec4(localBounds.GetCenter(), 1.0f));
+            glm::mat3 absMatrix(glm::abs(glm::vec3(worldMatrix[0])), glm::abs(glm::vec3(worldMatrix[1])), glm::abs(glm::vec3(worldMatrix[2])));
+            size = absMatrix * localBounds.GetSize();
+        }
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            m_drawcallBounds[axis].push_back(center[axis]);
+            m_drawcallBounds[3 + axis].push_back(size[axis]);
         }
     }
 }
 
-void Renderer::PrepareDrawcall(const DrawcallInfo& drawcallInfo)
+void Renderer::AddOccluder(const OccluderMesh& occluder, const glm::mat4& worldMatrix)
 {
-    std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetShaderProgram();
+    m_occlusionCuller.AddOccluder(occluder, worldMatrix);
+}
 
-    // TODO: Room for optimization here, caching current material, current worldMatrixIndex and current VAO
+void Renderer::PrepareDrawcall(const DrawcallInfo& drawcallInfo)
+{
+    const ShaderProgram& shaderProgram = drawcallInfo.shaderProgram;
 
     // Setup material
-    drawcallInfo.material.Use();
+    if (&drawcallInfo.material != m_lastMaterial)
+    {
+        drawcallInfo.material.Use();
+        m_lastMaterial = &drawcallInfo.material;
+    }
 
     // Setup world matrix
-    // Setup camera
-    UpdateTransforms(shaderProgram, drawcallInfo.worldMatrixIndex);
+    // Setup camera, only needed the first time the shader program is used
+    bool shaderProgramChanged = &shaderProgram != m_lastShaderProgram;
+    if (shaderProgramChanged || drawcallInfo.worldMatrixIndex != m_lastWorldMatrixIndex)
+    {
+        // Shaders reading the WorldMatrixBlock only need the index, other transforms are set by the registered function
+        GLint worldMatrixIndexLocation = GetShaderProgramInfo(shaderProgram).worldMatrixIndexLocation;
+        if (worldMatrixIndexLocation >= 0)
+        {
+            shaderProgram.SetUniform(worldMatrixIndexLocation, drawcallInfo.worldMatrixIndex);
+        }
+        UpdateTransforms(shaderProgram, drawcallInfo.worldMatrixIndex, shaderProgramChanged);
+        m_lastShaderProgram = &shaderProgram;
+        m_lastWorldMatrixIndex = drawcallInfo.worldMatrixIndex;
+    }
 
     // Setup VAO
-    drawcallInfo.vao.Bind();
+    if (&drawcallInfo.vao != m_lastVao)
+    {
+        drawcallInfo.vao.Bind();
+        m_lastVao = &drawcallInfo.vao;
+    }
 }
 
-void Renderer::SetLightingRenderStates(bool firstPass)
+void Renderer::PrepareDrawcall(const DrawcallBatch& drawcallBatch)
+{
+    const DrawcallInfo& drawcallInfo = *drawcallBatch.drawcallInfo;
+
+    PrepareDrawcall(drawcallInfo);
+
+    if (drawcallBatch.instanceCount > 0)
+    {
+        GLint location = GetShaderProgramInfo(drawcallInfo.shaderProgram).instanceAttributeLocation;
+        assert(location >= 0);
+
+        // Point the instance attribute to the first instance of the batch
+        // Multi-draw commands have their own base instance, so they start at the beginning of the buffer
+        unsigned int firstInstance = drawcallBatch.commandCount > 0 ? 0 : drawcallBatch.firstInstance;
+        m_instanceBuffer.Bind();
+        drawcallInfo.vao.SetInstanceMatrixAttribute(location, static_cast<GLint>(firstInstance * sizeof(glm::mat4)));
+    }
+}
+
+void Renderer::Draw(const DrawcallBatch& drawcallBatch) const
+{
+    if (drawcallBatch.commandCount > 0)
+    {
+        m_indirectBuffer.Bind();
+        GLintptr indirectOffset = drawcallBatch.firstCommand * sizeof(Drawcall::IndirectCommand);
+        drawcallBatch.drawcallInfo->drawcall.DrawMultiIndirect(indirectOffset, drawcallBatch.commandCount);
+    }
+    else if (drawcallBatch.instanceCount > 0)
+    {
+        drawcallBatch.drawcallInfo->drawcall.DrawInstanced(drawcallBatch.instanceCount);
+    }
+    else
+    {
+        drawcallBatch.drawcallInfo->drawcall.Draw();
+    }
+}
+
+void Renderer::RecordDrawcallBatches(unsigned int collectionIndex, unsigned int firstBatch, unsigned int batchCount, CommandList& commandList) const
+{
+    ITUGL_PROFILE_SCOPE("Renderer::RecordDrawcallBatches");
+
+    std::span<const DrawcallBatch> drawcallBatches = GetDrawcallBatches(collectionIndex).subspan(firstBatch, batchCount);
+
+    // Same state tracking as PrepareDrawcall, local to the list
+    const Material* lastMaterial = nullptr;
+    const ShaderProgram* lastShaderProgram = nullptr;
+    const VertexArrayObject* lastVao = nullptr;
+    unsigned int lastWorldMatrixIndex = 0;
+
+    for (const DrawcallBatch& drawcallBatch : drawcallBatches)
+    {
+        const DrawcallInfo& drawcallInfo = *drawcallBatch.drawcallInfo;
+        const ShaderProgram& shaderProgram = drawcallInfo.shaderProgram;
+        const ShaderProgramInfo& shaderProgramInfo = FindShaderProgramInfo(shaderProgram);
+
+        if (&drawcallInfo.material != lastMaterial)
+        {
+            commandList.UseMaterial(drawcallInfo.material);
+            lastMaterial = &drawcallInfo.material;
+        }
+
+        bool shaderProgramChanged = &shaderProgram != lastShaderProgram;
+        if (shaderProgramChanged || drawcallInfo.worldMatrixIndex != lastWorldMatrixIndex)
+        {
+            if (shaderProgramInfo.worldMatrixIndexLocation >= 0)
+            {
+                commandList.SetUniform(shaderProgram, shaderProgramInfo.worldMatrixIndexLocation, drawcallInfo.worldMatrixIndex);
+            }
+            lastShaderProgram = &shaderProgram;
+            lastWorldMatrixIndex = drawcallInfo.worldMatrixIndex;
+
+            // The standard transforms are computed here, on the thread recording the list
+            // Registered functions call the device directly, so they can only run when the list is executed
+            const ShaderProgramEntry* entry = FindShaderProgramEntry(shaderProgram);
+            if (entry && entry->updateTransformsFunction)
+            {
+                commandList.UpdateTransforms(*this, shaderProgram, drawcallInfo.worldMatrixIndex, shaderProgramChanged);
+            }
+            else if (entry && entry->standardTransforms)
+            {
+                SetStandardTransforms(entry->transformLocations, m_worldMatrices[drawcallInfo.worldMatrixIndex], shaderProgramChanged,
+                    [&](ShaderProgram::Location location, const auto& value) { commandList.SetUniform(shaderProgram, location, value); });
+            }
+        }
+
+        if (&drawcallInfo.vao != lastVao)
+        {
+            commandList.BindVertexArray(drawcallInfo.vao);
+            lastVao = &drawcallInfo.vao;
+        }
+
+        if (drawcallBatch.instanceCount > 0)
+        {
+            assert(shaderProgramInfo.instanceAttributeLocation >= 0);
+            unsigned int firstInstance = drawcallBatch.commandCount > 0 ? 0 : drawcallBatch.firstInstance;
+            commandList.SetInstanceAttributes(drawcallInfo.vao, m_instanceBuffer, shaderProgramInfo.instanceAttributeLocation, firstInstance);
+        }
+
+        if (drawcallBatch.commandCount > 0)
+        {
+            GLintptr indirectOffset = drawcallBatch.firstCommand * sizeof(Drawcall::IndirectCommand);
+            commandList.DrawMultiIndirect(drawcallInfo.drawcall, m_indirectBuffer, indirectOffset, drawcallBatch.commandCount);
+        }
+        else if (drawcallBatch.instanceCount > 0)
+        {
+            commandList.DrawInstanced(drawcallInfo.drawcall, drawcallBatch.instanceCount);
+        }
+        else
+        {
+            commandList.Draw(drawcallInfo.drawcall);
+        }
+    }
+}
+
+void Renderer::DrawDrawcallBatches(unsigned int collectionIndex)
+{
+    unsigned int batchCount = static_cast<unsigned int>(GetDrawcallBatches(collectionIndex).size());
+
+    // One slice per thread, unless the slices would be too small
+    unsigned int sliceCount = 1;
+    if (m_parallelRecordingEnabled)
+    {
+        sliceCount = std::min(m_threadPool.GetThreadCount(), (batchCount + MinBatchesPerCommandList - 1) / MinBatchesPerCommandList);
+        sliceCount = std::max(sliceCount, 1u);
+    }
+    unsigned int sliceSize = (batchCount + sliceCount - 1) / sliceCount;
+
+    if (m_commandLists.size() < sliceCount)
+    {
+        m_commandLists.resize(sliceCount);
+    }
+
+    m_threadPool.ParallelFor(sliceCount, [&](unsigned int sliceIndex)
+        {
+            unsigned int firstBatch = std::min(sliceIndex * sliceSize, batchCount);
+            unsigned int sliceBatchCount = std::min(sliceSize, batchCount - firstBatch);
+            CommandList& commandList = m_commandLists[sliceIndex];
+            commandList.Clear();
+            RecordDrawcallBatches(collectionIndex, firstBatch, sliceBatchCount, commandList);
+        });
+
+    {
+        ITUGL_PROFILE_SCOPE("CommandList::Execute");
+        for (unsigned int sliceIndex = 0; sliceIndex < sliceCount; ++sliceIndex)
+        {
+            m_commandLists[sliceIndex].Execute();
+        }
+    }
+
+    // The lists changed the states behind PrepareDrawcall
+    InvalidateDrawcallStates();
+}
+
+void Renderer::InvalidateDrawcallStates()
+{
+    m_lastMaterial = nullptr;
+    m_lastShaderProgram = nullptr;
+    m_lastVao = nullptr;
+    m_lastWorldMatrixIndex = 0;
+}
+
+void Renderer::BuildDrawcallBatches()
+{
+    ITUGL_PROFILE_SCOPE("Renderer::BuildDrawcallBatches");
+
+    m_instanceWorldMatrices.clear();
+    m_indirectCommands.clear();
+    while (m_drawcallBatches.size() < m_drawcallCollections.size())
+    {
+        m_drawcallBatches.emplace_back(&m_frameArena);
+    }
+
+    bool useMultiDraw = m_instancingEnabled && m_multiDrawEnabled && Drawcall::IsMultiDrawIndirectSupported();
+
+    for (unsigned int collectionIndex = 0; collectionIndex < m_drawcallCollections.size(); ++collectionIndex)
+    {
+        const DrawcallCollection& collection = m_drawcallCollections[collectionIndex];
+        std::pmr::vector<DrawcallBatch>& batches = m_drawcallBatches[collectionIndex];
+        batches.clear();
+
+        unsigned int count = static_cast<unsigned int>(collection.size());
+        unsigned int index = 0;
+        while (index < count)
+        {
+            const DrawcallInfo& drawcallInfo = m_drawcalls[collection[index]];
+
+            // Shaders that don't opt in get one batch per drawcall
+            if (GetShaderProgramInfo(drawcallInfo.shaderProgram).instanceAttributeLocation < 0)
+            {
+                batches.push_back({ &drawcallInfo, 0, 0, 0, 0 });
+                ++index;
+                continue;
+            }
+
+            // Add consecutive drawcalls that can be rendered together. Shaders that opt in are always instanced
+            unsigned int firstInstance = static_cast<unsigned int>(m_instanceWorldMatrices.size());
+            unsigned int firstCommand = static_cast<unsigned int>(m_indirectCommands.size());
+            unsigned int runFirstInstance = firstInstance;
+            while (true)
+            {
+                const DrawcallInfo& current = m_drawcalls[collection[index]];
+                m_instanceWorldMatrices.push_back(m_worldMatrices[current.worldMatrixIndex]);
+                ++index;
+
+                const DrawcallInfo* next = index < count ? &m_drawcalls[collection[index]] : nullptr;
+                bool sameState = m_instancingEnabled && next
+                    && &next->material == &drawcallInfo.material && &next->vao == &drawcallInfo.vao;
+
+                // Same drawcall, it is one more instance
+                if (sameState && &next->drawcall == &current.drawcall)
+                {
+                    continue;
+                }
+
+                // A different drawcall with the same state can be another command of a multi-draw
+                bool continueMultiDraw = sameState && useMultiDraw && current.drawcall.IsMultiDrawCompatible(next->drawcall);
+                if (continueMultiDraw || m_indirectCommands.size() > firstCommand)
+                {
+                    unsigned int instanceEnd = static_cast<unsigned int>(m_instanceWorldMatrices.size());
+                    m_indirectCommands.push_back(current.drawcall.GetIndirectCommand(instanceEnd - runFirstInstance, runFirstInstance));
+                    runFirstInstance = instanceEnd;
+                }
+
+                if (!continueMultiDraw)
+                {
+                    break;
+                }
+            }
+
+            unsigned int instanceCount = static_cast<unsigned int>(m_instanceWorldMatrices.size()) - firstInstance;
+            unsigned int commandCount = static_cast<unsigned int>(m_indirectCommands.size()) - firstCommand;
+            batches.push_back({ &drawcallInfo, firstInstance, instanceCount, firstCommand, commandCount });
+        }
+    }
+
+    if (!m_instanceWorldMatrices.empty())
+    {
+        m_instanceBuffer.Bind();
+        m_instanceBuffer.AllocateData(std::span<const glm::mat4>(m_instanceWorldMatrices), BufferObject::StreamDraw);
+        VertexBufferObject::Unbind();
+    }
+
+    if (!m_indirectCommands.empty())
+    {
+        m_indirectBuffer.Bind();
+        m_indirectBuffer.AllocateData(m_indirectCommands);
+        DrawIndirectBufferObject::Unbind();
+    }
+}
+
+const Renderer::ShaderProgramEntry* Renderer::FindShaderProgramEntry(const ShaderProgram& shaderProgram) const
+{
+    unsigned int id = shaderProgram.GetId();
+    return id < m_shaderProgramEntries.size() ? &m_shaderProgramEntries[id] : nullptr;
+}
+
+const Renderer::ShaderProgramInfo& Renderer::FindShaderProgramInfo(const ShaderProgram& shaderProgram) const
+{
+    // All the programs in the drawcalls were found when building the batches
+    const ShaderProgramEntry* entry = FindShaderProgramEntry(shaderProgram);
+    assert(entry && entry->hasInfo);
+    return entry->info;
+}
+
+const Renderer::ShaderProgramInfo& Renderer::GetShaderProgramInfo(const ShaderProgram& shaderProgram)
+{
+    // Ids are handed out in order, so the table only grows when a new program shows up
+    unsigned int id = shaderProgram.GetId();
+    if (id >= m_shaderProgramEntries.size())
+    {
+        m_shaderProgramEntries.resize(id + 1);
+    }
+
+    ShaderProgramEntry& entry = m_shaderProgramEntries[id];
+    if (!entry.hasInfo)
+    {
+        ShaderProgramInfo& info = entry.info;
+        info.instanceAttributeLocation = shaderProgram.GetAttributeLocation("InstanceWorldMatrix");
+        info.worldMatrixIndexLocation = -1;
+
+        // Connect the shared blocks to the buffers of the renderer
+        GLuint cameraBlockIndex = shaderProgram.GetUniformBlockIndex("CameraBlock");
+        if (cameraBlockIndex != GL_INVALID_INDEX)
+        {
+            shaderProgram.SetUniformBlockBinding(cameraBlockIndex, CameraBlockBinding);
+        }
+
+        if (ShaderStorageBufferObject::IsSupported())
+        {
+            GLuint worldMatrixBlockIndex = shaderProgram.GetShaderStorageBlockIndex("WorldMatrixBlock");
+            if (worldMatrixBlockIndex != GL_INVALID_INDEX)
+            {
+                shaderProgram.SetShaderStorageBlockBinding(worldMatrixBlockIndex, WorldMatrixBlockBinding);
+                info.worldMatrixIndexLocation = shaderProgram.GetUniformLocation("WorldMatrixIndex");
+
+                // A program that was not registered can show up in the middle of a frame, after the frame data was uploaded
+                if (!m_worldMatrixBlockUsed && !m_worldMatrices.empty())
+                {
+                    UploadWorldMatrices();
+                }
+                m_worldMatrixBlockUsed = true;
+            }
+        }
+
+        entry.hasInfo = true;
+    }
+    return entry.info;
+}
+
+void Renderer::SetLightingRenderStates(bool firstPass, bool depthPrepared)
 {
     // Set the render states for the first and additional lights
     m_device.SetFeatureEnabled(GL_BLEND, !firstPass);
     // TODO: This should not be hardcoded here
-    glDepthFunc(firstPass ? GL_LESS : GL_EQUAL);
-    glBlendFunc(GL_ONE, GL_ONE);
+    m_device.SetDepthFunction(firstPass && !depthPrepared ? GL_LESS : GL_EQUAL);
+    m_device.SetBlendFunction(GL_ONE, GL_ONE);
+    if (depthPrepared)
+    {
+        m_device.SetDepthWrite(false);
+    }
 }
 
 void Renderer::InitializeFullscreenMesh()
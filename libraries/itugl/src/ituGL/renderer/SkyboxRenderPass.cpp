@@ -12,6 +12,8 @@ SkyboxRenderPass::SkyboxRenderPass(std::shared_ptr<TextureCubemapObject> texture
     , m_invViewProjMatrixLocation(-1)
     , m_skyboxTextureLocation(-1)
 {
+    SetName("Skybox");
+
     // Load shaders and build shader program
     Shader vertexShader = ShaderLoader(Shader::VertexShader).Load("shaders/renderer/skybox.vert");
     Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load("shaders/renderer/skybox.frag");
@@ -45,11 +47,11 @@ void SkyboxRenderPass::Render()
     m_shaderProgram.SetTexture(m_skyboxTextureLocation, 0, *m_texture);
 
     // Only write to depth == 1
-    glDepthFunc(GL_EQUAL);
+    renderer.GetDevice().SetDepthFunction(GL_EQUAL);
 
     const Mesh& fullscreenMesh = renderer.GetFullscreenMesh();
     fullscreenMesh.DrawSubmesh(0);
     
     // Restore default value
-    glDepthFunc(GL_LESS);
+    renderer.GetDevice().SetDepthFunction(GL_LESS);
 }
@@ -0,0 +1,104 @@
+#include <ituGL/renderer/TiledDeferredRenderPass.h>
+
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/lighting/Light.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/texture/Texture2DObject.h>
+
+TiledDeferredRenderPass::TiledDeferredRenderPass(std::shared_ptr<Material> material, std::shared_ptr<Texture2DObject> targetTexture)
+    : m_material(material)
+    , m_targetTexture(targetTexture)
+{
+    SetName("TiledDeferred");
+
+    assert(m_material);
+    assert(m_targetTexture);
+
+    const ShaderProgram& shaderProgram = *m_material->GetShaderProgramPointer();
+    m_lightCountLocation = shaderProgram.GetUniformLocation("LightCount");
+    m_targetImageLocation = shaderProgram.GetUniformLocation("TargetImage");
+
+    GLuint lightBlockIndex = shaderProgram.GetShaderStorageBlockIndex("LightBlock");
+    assert(lightBlockIndex != GL_INVALID_INDEX);
+    shaderProgram.SetShaderStorageBlockBinding(lightBlockIndex, LightBlockBinding);
+}
+
+bool TiledDeferredRenderPass::IsSupported()
+{
+    return GLAD_GL_VERSION_4_3;
+}
+
+std::shared_ptr<Material> TiledDeferredRenderPass::CreateMaterial(Renderer& renderer, const GBufferRenderPass::Layout& gbufferLayout)
+{
+    std::vector<const char*> computeShaderPaths;
+    computeShaderPaths.push_back("shaders/version430.glsl");
+    if (gbufferLayout.encoding == GBufferRenderPass::Layout::Encoding::Packed)
+    {
+        computeShaderPaths.push_back("shaders/gbuffer-packed.glsl");
+    }
+    computeShaderPaths.push_back("shaders/utils.glsl");
+    computeShaderPaths.push_back("shaders/lambert-ggx.glsl");
+    computeShaderPaths.push_back("shaders/lighting-tiled.glsl");
+    computeShaderPaths.push_back("shaders/renderer/deferred-tiled.comp");
+    Shader computeShader = ShaderLoader(Shader::ComputeShader).Load(computeShaderPaths);
+
+    std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
+    shaderProgramPtr->Build(computeShader);
+
+    // Filter out uniforms that are set by the pass
+    ShaderUniformCollection::NameSet filteredUniforms;
+    filteredUniforms.insert("LightCount");
+    filteredUniforms.insert("TargetImage");
+
+    // The camera comes from the camera block, and the lights are uploaded by the pass
+    renderer.RegisterShaderProgram(shaderProgramPtr, nullptr, nullptr);
+
+    return std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+}
+
+void TiledDeferredRenderPass::Render()
+{
+    Renderer& renderer = GetRenderer();
+    DeviceGL& device = renderer.GetDevice();
+
+    UploadLights();
+    m_lightBuffer.BindBase(LightBlockBinding);
+
+    // The material sets the G-buffer textures. The camera matrices come from the camera block of the renderer
+    m_material->Use();
+    const ShaderProgram& shaderProgram = *m_material->GetShaderProgramPointer();
+    shaderProgram.SetUniform(m_lightCountLocation, static_cast<unsigned int>(m_lightData.size()));
+    shaderProgram.SetUniform(m_targetImageLocation, static_cast<GLint>(TargetImageUnit));
+    m_targetTexture->BindImage(TargetImageUnit, 0, GL_WRITE_ONLY, TextureObject::InternalFormatRGBA16F);
+
+    // One work group for each tile, rounding up. The shader skips the pixels outside of the viewport
+    GLint x, y;
+    GLsizei width, height;
+    device.GetViewport(x, y, width, height);
+    shaderProgram.Dispatch((width + TileSize - 1) / TileSize, (height + TileSize - 1) / TileSize);
+
+    // The next passes read the target as a texture or draw on top of it
+    device.IssueMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+}
+
+void TiledDeferredRenderPass::UploadLights()
+{
+    m_lightData.clear();
+    for (const Light* light : GetRenderer().GetLights())
+    {
+        m_lightData.push_back({ glm::vec4(light->GetPosition(), 0.0f), glm::vec4(light->GetColor() * light->GetIntensity(), 0.0f),
+            glm::vec4(light->GetDirection(), 0.0f), light->GetAttenuation() });
+    }
+
+    // Empty buffers can't be bound, keep room for one light. LightCount is still 0
+    m_lightBuffer.Bind();
+    if (m_lightData.empty())
+    {
+        m_lightBuffer.AllocateData(sizeof(LightGrid::LightData), BufferObject::StreamDraw);
+    }
+    else
+    {
+        m_lightBuffer.AllocateData(std::span<const LightGrid::LightData>(m_lightData), BufferObject::StreamDraw);
+    }
+}
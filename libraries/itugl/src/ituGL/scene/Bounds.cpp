@@ -1,5 +1,13 @@
 #include <ituGL/scene/Bounds.h>
 
+#include <glm/glm.hpp>
+
+// SSE is always available on x86-64. Other platforms use the scalar loop, that the compiler can vectorize
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ITUGL_BOUNDS_SSE
+#endif
+
 SphereBounds::SphereBounds(const Bounds& bounds) : Bounds(bounds.GetCenter()), m_radius(0.0f)
 {
     switch (bounds.GetType())
@@ -135,22 +143,50 @@ bool Bounds::Intersects(const BoxBounds& boundsA, const BoxBounds& boundsB)
         && TestSeparationAxis(glm::cross(boundsA.GetZVector(), boundsB.GetZVector()), distance, mA, mB);
 }
 
+// The bounds are outside if they are completely behind any of the planes
+// radius is the distance from the center to the farthest point of the bounds, in the direction of the plane normal
+static bool IsInsidePlanes(const FrustumBounds& frustum, const glm::vec3& center, auto getRadius)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        const glm::vec4& plane = frustum.GetPlane(i);
+        glm::vec3 normal(plane);
+        if (glm::dot(normal, center) + plane.w < -getRadius(normal))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 template<>
 bool Bounds::Intersects(const FrustumBounds& boundsA, const SphereBounds& boundsB)
 {
-    return true;
+    return IsInsidePlanes(boundsA, boundsB.GetCenter(), [&](const glm::vec3&) { return boundsB.GetRadius(); });
 }
 
 template<>
 bool Bounds::Intersects(const FrustumBounds& boundsA, const AabbBounds& boundsB)
 {
-    return true;
+    return IsInsidePlanes(boundsA, boundsB.GetCenter(), [&](const glm::vec3& normal) { return glm::dot(glm::abs(normal), boundsB.GetSize()); });
 }
 
 template<>
 bool Bounds::Intersects(const FrustumBounds& boundsA, const BoxBounds& boundsB)
 {
-    return true;
+    glm::mat3 scaledMatrix = boundsB.GetScaledMatrix();
+    return IsInsidePlanes(boundsA, boundsB.GetCenter(), [&](const glm::vec3& normal)
+        {
+            return std::abs(glm::dot(normal, scaledMatrix[0])) + std::abs(glm::dot(normal, scaledMatrix[1])) + std::abs(glm::dot(normal, scaledMatrix[2]));
+        });
+}
+
+template<>
+bool Bounds::Intersects(const FrustumBounds&, const FrustumBounds&)
+{
+    // Not supported: frustums are only tested against the bounds of the objects
+    assert(false);
+    return false;
 }
 
 bool Bounds::Intersects(const Bounds& boundsA, const Bounds& boundsB)
@@ -163,6 +199,8 @@ bool Bounds::Intersects(const Bounds& boundsA, const Bounds& boundsB)
         return Bounds::Intersects(static_cast<const AabbBounds&>(boundsA), boundsB);
     case Type::Box:
         return Bounds::Intersects(static_cast<const BoxBounds&>(boundsA), boundsB);
+    case Type::Frustum:
+        return Bounds::Intersects(static_cast<const FrustumBounds&>(boundsA), boundsB);
     default:
         assert(false);
         return false;
@@ -178,3 +216,97 @@ glm::mat3 BoxBounds::GetScaledMatrix() const
         m_rotationMatrix[2] * m_size[2]
     );
 }
+
+FrustumBounds::FrustumBounds(const glm::mat4& viewProjMatrix) : Bounds(glm::vec3(0.0f))
+{
+    // Each plane is a combination of the rows of the matrix (Gribb-Hartmann), for clip space depth in [-1, 1]
+    glm::mat4 rows = glm::transpose(viewProjMatrix);
+    m_planes[0] = rows[3] + rows[0];
+    m_planes[1] = rows[3] - rows[0];
+    m_planes[2] = rows[3] + rows[1];
+    m_planes[3] = rows[3] - rows[1];
+    m_planes[4] = rows[3] + rows[2];
+    m_planes[5] = rows[3] - rows[2];
+    for (glm::vec4& plane : m_planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    // Center of the 8 corners, transformed back from clip space
+    glm::mat4 invViewProjMatrix = glm::inverse(viewProjMatrix);
+    glm::vec3 center(0.0f);
+    for (int i = 0; i < 8; ++i)
+    {
+        glm::vec4 corner = invViewProjMatrix * glm::vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f, 1.0f);
+        center += glm::vec3(corner) / corner.w;
+    }
+    m_center = center / 8.0f;
+}
+
+void FrustumBounds::IntersectsAabbs(const std::array<std::span<const float>, 3>& centers, const std::array<std::span<const float>, 3>& sizes,
+    std::span<std::uint8_t> visible) const
+{
+    size_t count = visible.size();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        assert(centers[axis].size() >= count && sizes[axis].size() >= count);
+    }
+
+    size_t i = 0;
+
+#ifdef ITUGL_BOUNDS_SSE
+    // Test 4 boxes against each plane at the same time
+    __m128 planeValues[6][7];
+    for (int p = 0; p < 6; ++p)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            planeValues[p][c] = _mm_set1_ps(m_planes[p][c]);
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            planeValues[p][4 + c] = _mm_set1_ps(std::abs(m_planes[p][c]));
+        }
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 centerX = _mm_loadu_ps(&centers[0][i]);
+        __m128 centerY = _mm_loadu_ps(&centers[1][i]);
+        __m128 centerZ = _mm_loadu_ps(&centers[2][i]);
+        __m128 sizeX = _mm_loadu_ps(&sizes[0][i]);
+        __m128 sizeY = _mm_loadu_ps(&sizes[1][i]);
+        __m128 sizeZ = _mm_loadu_ps(&sizes[2][i]);
+
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for (int p = 0; p < 6; ++p)
+        {
+            const __m128* plane = planeValues[p];
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], centerX), _mm_mul_ps(plane[1], centerY)),
+                _mm_add_ps(_mm_mul_ps(plane[2], centerZ), plane[3]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[4], sizeX), _mm_mul_ps(plane[5], sizeY)), _mm_mul_ps(plane[6], sizeZ));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        visible[i + 0] = (mask >> 0) & 1;
+        visible[i + 1] = (mask >> 1) & 1;
+        visible[i + 2] = (mask >> 2) & 1;
+        visible[i + 3] = (mask >> 3) & 1;
+    }
+#endif
+
+    // Remaining boxes, or all of them without SSE
+    for (; i < count; ++i)
+    {
+        bool inside = true;
+        for (const glm::vec4& plane : m_planes)
+        {
+            float distance = plane.x * centers[0][i] + plane.y * centers[1][i] + plane.z * centers[2][i] + plane.w;
+            float radius = std::abs(plane.x) * sizes[0][i] + std::abs(plane.y) * sizes[1][i] + std::abs(plane.z) * sizes[2][i];
+            inside &= distance + radius >= 0.0f;
+        }
+        visible[i] = inside ? 1 : 0;
+    }
+}
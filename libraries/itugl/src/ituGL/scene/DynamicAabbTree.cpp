@@ -0,0 +1,323 @@
+#include <ituGL/scene/DynamicAabbTree.h>
+
+#include <glm/common.hpp>
+#include <algorithm>
+#include <cassert>
+
+DynamicAabbTree::DynamicAabbTree(float margin) : m_root(NullProxy), m_freeList(NullProxy), m_margin(margin)
+{
+}
+
+// Allocate a leaf with the enlarged bounds and insert it in the tree
+DynamicAabbTree::ProxyId DynamicAabbTree::CreateProxy(const AabbBounds& bounds, void* userData)
+{
+    int leafId = AllocateNode();
+    Node& leaf = m_nodes[leafId];
+    leaf.boundsMin = bounds.GetMin() - m_margin;
+    leaf.boundsMax = bounds.GetMax() + m_margin;
+    leaf.userData = userData;
+    leaf.height = 0;
+
+    InsertLeaf(leafId);
+    return leafId;
+}
+
+// Remove the leaf from the tree and free it
+void DynamicAabbTree::DestroyProxy(ProxyId proxyId)
+{
+    assert(proxyId >= 0 && proxyId < static_cast<int>(m_nodes.size()));
+    assert(m_nodes[proxyId].IsLeaf());
+
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+}
+
+// If the bounds still fit in the enlarged bounds, nothing changes. Otherwise remove and insert the leaf again
+bool DynamicAabbTree::MoveProxy(ProxyId proxyId, const AabbBounds& bounds)
+{
+    assert(proxyId >= 0 && proxyId < static_cast<int>(m_nodes.size()));
+    assert(m_nodes[proxyId].IsLeaf());
+
+    Node& leaf = m_nodes[proxyId];
+    glm::vec3 boundsMin = bounds.GetMin();
+    glm::vec3 boundsMax = bounds.GetMax();
+    if (glm::all(glm::lessThanEqual(leaf.boundsMin, boundsMin)) && glm::all(glm::lessThanEqual(boundsMax, leaf.boundsMax)))
+    {
+        return false;
+    }
+
+    RemoveLeaf(proxyId);
+
+    // Reference may be invalid after removing, get it again
+    Node& movedLeaf = m_nodes[proxyId];
+    movedLeaf.boundsMin = boundsMin - m_margin;
+    movedLeaf.boundsMax = boundsMax + m_margin;
+
+    InsertLeaf(proxyId);
+    return true;
+}
+
+AabbBounds DynamicAabbTree::GetFatBounds(ProxyId proxyId) const
+{
+    const Node& node = m_nodes[proxyId];
+    return AabbBounds(0.5f * (node.boundsMin + node.boundsMax), 0.5f * (node.boundsMax - node.boundsMin));
+}
+
+int DynamicAabbTree::GetHeight() const
+{
+    return m_root != NullProxy ? m_nodes[m_root].height : 0;
+}
+
+// Slab test: intersect the ray with the 3 pairs of planes and keep the overlapping interval
+bool DynamicAabbTree::RayIntersects(const glm::vec3& origin, const glm::vec3& invDirection, const glm::vec3& boxMin, const glm::vec3& boxMax,
+    float maxDistance, float& distance)
+{
+    glm::vec3 t1 = (boxMin - origin) * invDirection;
+    glm::vec3 t2 = (boxMax - origin) * invDirection;
+    glm::vec3 tMin = glm::min(t1, t2);
+    glm::vec3 tMax = glm::max(t1, t2);
+
+    float tEnter = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+    float tExit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+
+    distance = tEnter;
+    return tEnter <= tExit;
+}
+
+// Take a node from the free list, growing the node array if it is empty
+int DynamicAabbTree::AllocateNode()
+{
+    if (m_freeList == NullProxy)
+    {
+        Node node = {};
+        node.height = -1;
+        node.parent = NullProxy;
+        m_nodes.push_back(node);
+        m_freeList = static_cast<int>(m_nodes.size()) - 1;
+    }
+
+    int nodeId = m_freeList;
+    Node& node = m_nodes[nodeId];
+    m_freeList = node.parent;
+    node.parent = NullProxy;
+    node.child1 = NullProxy;
+    node.child2 = NullProxy;
+    node.userData = nullptr;
+    node.height = 0;
+    return nodeId;
+}
+
+// Add the node to the free list
+void DynamicAabbTree::FreeNode(int nodeId)
+{
+    Node& node = m_nodes[nodeId];
+    node.parent = m_freeList;
+    node.height = -1;
+    m_freeList = nodeId;
+}
+
+// Find the best sibling for the leaf, going down the tree choosing the child with the lowest cost,
+// then create a new parent for both and fix the ancestors
+void DynamicAabbTree::InsertLeaf(int leafId)
+{
+    if (m_root == NullProxy)
+    {
+        m_root = leafId;
+        m_nodes[leafId].parent = NullProxy;
+        return;
+    }
+
+    glm::vec3 leafMin = m_nodes[leafId].boundsMin;
+    glm::vec3 leafMax = m_nodes[leafId].boundsMax;
+
+    int siblingId = m_root;
+    while (!m_nodes[siblingId].IsLeaf())
+    {
+        const Node& node = m_nodes[siblingId];
+
+        float area = GetSurfaceArea(node.boundsMin, node.boundsMax);
+        float combinedArea = GetSurfaceArea(glm::min(node.boundsMin, leafMin), glm::max(node.boundsMax, leafMax));
+
+        // Cost of creating a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree: all the ancestors grow
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        // Cost of descending into each child
+        float childCosts[2];
+        int children[2] = { node.child1, node.child2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            const Node& child = m_nodes[children[i]];
+            float childCombinedArea = GetSurfaceArea(glm::min(child.boundsMin, leafMin), glm::max(child.boundsMax, leafMax));
+            if (child.IsLeaf())
+            {
+                childCosts[i] = childCombinedArea + inheritanceCost;
+            }
+            else
+            {
+                childCosts[i] = childCombinedArea - GetSurfaceArea(child.boundsMin, child.boundsMax) + inheritanceCost;
+            }
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1])
+        {
+            break;
+        }
+
+        siblingId = childCosts[0] < childCosts[1] ? children[0] : children[1];
+    }
+
+    // Create the new parent. Allocating can move the nodes, so don't keep references before this
+    int oldParentId = m_nodes[siblingId].parent;
+    int newParentId = AllocateNode();
+
+    Node& newParent = m_nodes[newParentId];
+    newParent.parent = oldParentId;
+    newParent.boundsMin = glm::min(m_nodes[siblingId].boundsMin, leafMin);
+    newParent.boundsMax = glm::max(m_nodes[siblingId].boundsMax, leafMax);
+    newParent.height = m_nodes[siblingId].height + 1;
+    newParent.child1 = siblingId;
+    newParent.child2 = leafId;
+
+    if (oldParentId != NullProxy)
+    {
+        Node& oldParent = m_nodes[oldParentId];
+        (oldParent.child1 == siblingId ? oldParent.child1 : oldParent.child2) = newParentId;
+    }
+    else
+    {
+        m_root = newParentId;
+    }
+    m_nodes[siblingId].parent = newParentId;
+    m_nodes[leafId].parent = newParentId;
+
+    RefitAncestors(m_nodes[leafId].parent);
+}
+
+// Replace the parent of the leaf with its sibling, and fix the ancestors
+void DynamicAabbTree::RemoveLeaf(int leafId)
+{
+    if (leafId == m_root)
+    {
+        m_root = NullProxy;
+        return;
+    }
+
+    int parentId = m_nodes[leafId].parent;
+    const Node& parent = m_nodes[parentId];
+    int grandParentId = parent.parent;
+    int siblingId = parent.child1 == leafId ? parent.child2 : parent.child1;
+
+    if (grandParentId != NullProxy)
+    {
+        Node& grandParent = m_nodes[grandParentId];
+        (grandParent.child1 == parentId ? grandParent.child1 : grandParent.child2) = siblingId;
+        m_nodes[siblingId].parent = grandParentId;
+        FreeNode(parentId);
+
+        RefitAncestors(grandParentId);
+    }
+    else
+    {
+        m_root = siblingId;
+        m_nodes[siblingId].parent = NullProxy;
+        FreeNode(parentId);
+    }
+
+    m_nodes[leafId].parent = NullProxy;
+}
+
+// Walk up to the root, balancing the nodes and recomputing bounds and heights
+void DynamicAabbTree::RefitAncestors(int nodeId)
+{
+    while (nodeId != NullProxy)
+    {
+        nodeId = Balance(nodeId);
+
+        Node& node = m_nodes[nodeId];
+        const Node& child1 = m_nodes[node.child1];
+        const Node& child2 = m_nodes[node.child2];
+        node.boundsMin = glm::min(child1.boundsMin, child2.boundsMin);
+        node.boundsMax = glm::max(child1.boundsMax, child2.boundsMax);
+        node.height = 1 + std::max(child1.height, child2.height);
+
+        nodeId = node.parent;
+    }
+}
+
+// If one child is more than one level higher than the other, rotate the higher child up (AVL rotation)
+// A(B, C(F, G)) becomes C(A(B, G), F), where F is the higher child of C
+int DynamicAabbTree::Balance(int nodeIdA)
+{
+    Node& nodeA = m_nodes[nodeIdA];
+    if (nodeA.IsLeaf() || nodeA.height < 2)
+    {
+        return nodeIdA;
+    }
+
+    int nodeIdB = nodeA.child1;
+    int nodeIdC = nodeA.child2;
+    int balance = m_nodes[nodeIdC].height - m_nodes[nodeIdB].height;
+    if (balance >= -1 && balance <= 1)
+    {
+        return nodeIdA;
+    }
+
+    // Rotate the higher child (C) up. The other case is symmetric, swap the names
+    bool rotateChild2 = balance > 0;
+    if (!rotateChild2)
+    {
+        std::swap(nodeIdB, nodeIdC);
+    }
+
+    Node& nodeB = m_nodes[nodeIdB];
+    Node& nodeC = m_nodes[nodeIdC];
+    int nodeIdF = nodeC.child1;
+    int nodeIdG = nodeC.child2;
+    Node& nodeF = m_nodes[nodeIdF];
+    Node& nodeG = m_nodes[nodeIdG];
+
+    // C takes the place of A
+    nodeC.child1 = nodeIdA;
+    nodeC.parent = nodeA.parent;
+    nodeA.parent = nodeIdC;
+    if (nodeC.parent != NullProxy)
+    {
+        Node& parent = m_nodes[nodeC.parent];
+        (parent.child1 == nodeIdA ? parent.child1 : parent.child2) = nodeIdC;
+    }
+    else
+    {
+        m_root = nodeIdC;
+    }
+
+    // The higher child of C stays with C, the lower one goes to A
+    if (nodeF.height < nodeG.height)
+    {
+        std::swap(nodeIdF, nodeIdG);
+    }
+    Node& nodeHigh = m_nodes[nodeIdF];
+    Node& nodeLow = m_nodes[nodeIdG];
+
+    nodeC.child2 = nodeIdF;
+    (rotateChild2 ? nodeA.child2 : nodeA.child1) = nodeIdG;
+    nodeLow.parent = nodeIdA;
+
+    nodeA.boundsMin = glm::min(nodeB.boundsMin, nodeLow.boundsMin);
+    nodeA.boundsMax = glm::max(nodeB.boundsMax, nodeLow.boundsMax);
+    nodeA.height = 1 + std::max(nodeB.height, nodeLow.height);
+
+    nodeC.boundsMin = glm::min(nodeA.boundsMin, nodeHigh.boundsMin);
+    nodeC.boundsMax = glm::max(nodeA.boundsMax, nodeHigh.boundsMax);
+    nodeC.height = 1 + std::max(nodeA.height, nodeHigh.height);
+
+    return nodeIdC;
+}
+
+float DynamicAabbTree::GetSurfaceArea(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    glm::vec3 size = boundsMax - boundsMin;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
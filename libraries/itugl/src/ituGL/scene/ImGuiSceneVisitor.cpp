@@ -6,6 +6,7 @@
 #include <ituGL/scene/SceneModel.h>
 #include <ituGL/scene/Transform.h>
 #include <ituGL/lighting/Light.h>
+#include <ituGL/utils/CpuProfiler.h>
 #include <imgui.h>
 
 ImGuiSceneVisitor::ImGuiSceneVisitor(DearImGui& imGui, const char* windowName) : m_imGui(imGui), m_windowName(windowName)
@@ -14,6 +15,8 @@ ImGuiSceneVisitor::ImGuiSceneVisitor(DearImGui& imGui, const char* windowName) :
 
 void ImGuiSceneVisitor::VisitCamera(SceneCamera& sceneCamera)
 {
+    ITUGL_PROFILE_SCOPE("ImGuiSceneVisitor::VisitCamera");
+
     if (auto window = m_imGui.UseWindow(m_windowName.c_str()))
     {
         ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.3f, 0.3f, 0.3f, 1.0f));
@@ -41,6 +44,8 @@ void ImGuiSceneVisitor::VisitCamera(SceneCamera& sceneCamera)
 
 void ImGuiSceneVisitor::VisitLight(SceneLight& sceneLight)
 {
+    ITUGL_PROFILE_SCOPE("ImGuiSceneVisitor::VisitLight");
+
     if (auto window = m_imGui.UseWindow(m_windowName.c_str()))
     {
         ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.4f, 0.4f, 0.1f, 1.0f));
@@ -76,6 +81,8 @@ void ImGuiSceneVisitor::VisitLight(SceneLight& sceneLight)
 
 void ImGuiSceneVisitor::VisitModel(SceneModel& sceneModel)
 {
+    ITUGL_PROFILE_SCOPE("ImGuiSceneVisitor::VisitModel");
+
     if (auto window = m_imGui.UseWindow(m_windowName.c_str()))
     {
         ImGui::PushStyleColor(ImGuiCol_Header, ImVec4(0.2f, 0.2f, 0.5f, 1.0f));
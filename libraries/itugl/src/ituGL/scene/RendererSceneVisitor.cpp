@@ -5,6 +5,7 @@
 #include <ituGL/scene/SceneLight.h>
 #include <ituGL/scene/SceneModel.h>
 #include <ituGL/scene/Transform.h>
+#include <ituGL/utils/CpuProfiler.h>
 
 RendererSceneVisitor::RendererSceneVisitor(Renderer& renderer) : m_renderer(renderer)
 {
@@ -12,17 +13,27 @@ RendererSceneVisitor::RendererSceneVisitor(Renderer& renderer) : m_renderer(rend
 
 void RendererSceneVisitor::VisitCamera(SceneCamera& sceneCamera)
 {
+    ITUGL_PROFILE_SCOPE("RendererSceneVisitor::VisitCamera");
+
     assert(!m_renderer.HasCamera()); // Currently, only one camera per scene supported
     m_renderer.SetCurrentCamera(*sceneCamera.GetCamera());
 }
 
 void RendererSceneVisitor::VisitLight(SceneLight& sceneLight)
 {
+    ITUGL_PROFILE_SCOPE("RendererSceneVisitor::VisitLight");
+
     m_renderer.AddLight(*sceneLight.GetLight());
 }
 
 void RendererSceneVisitor::VisitModel(SceneModel& sceneModel)
 {
+    ITUGL_PROFILE_SCOPE("RendererSceneVisitor::VisitModel");
+
     assert(sceneModel.GetTransform());
     m_renderer.AddModel(*sceneModel.GetModel(), sceneModel.GetTransform()->GetTransformMatrix());
+    if (sceneModel.GetOccluder())
+    {
+        m_renderer.AddOccluder(*sceneModel.GetOccluder(), sceneModel.GetTransform()->GetTransformMatrix());
+    }
 }
@@ -2,6 +2,7 @@
 
 #include <ituGL/scene/SceneNode.h>
 #include <ituGL/scene/SceneVisitor.h>
+#include <ituGL/utils/CpuProfiler.h>
 #include <cassert>
 
 Scene::Scene()
@@ -29,7 +30,17 @@ std::shared_ptr<SceneNode> Scene::GetSceneNode(const std::string& name) const
 bool Scene::AddSceneNode(std::shared_ptr<SceneNode> node)
 {
     assert(node);
-    m_nodes[node->GetName()] = node;
+    std::shared_ptr<SceneNode>& sceneNode = m_nodes[node->GetName()];
+    if (sceneNode != node)
+    {
+        // Replacing a node with the same name
+        if (sceneNode)
+        {
+            RemoveSceneNodeProxy(*sceneNode);
+        }
+        sceneNode = node;
+        AddSceneNodeProxy(*node);
+    }
     node->SetOwnerScene(this);
     return true;
 }
@@ -47,6 +58,7 @@ bool Scene::RemoveSceneNode(const std::string& name)
     {
         assert(it->second);
         assert(it->second->GetOwnerScene() == this);
+        RemoveSceneNodeProxy(*it->second);
         it->second->SetOwnerScene(nullptr);
         m_nodes.erase(it);
         return true;
@@ -56,6 +68,8 @@ bool Scene::RemoveSceneNode(const std::string& name)
 
 void Scene::AcceptVisitor(SceneVisitor& visitor)
 {
+    ITUGL_PROFILE_SCOPE("Scene::AcceptVisitor");
+
     for (auto& pair : m_nodes)
     {
         pair.second->AcceptVisitor(visitor);
@@ -64,8 +78,127 @@ void Scene::AcceptVisitor(SceneVisitor& visitor)
 
 void Scene::AcceptVisitor(SceneVisitor& visitor) const
 {
+    ITUGL_PROFILE_SCOPE("Scene::AcceptVisitor");
+
     for (auto& pair : m_nodes)
     {
         pair.second->AcceptVisitor(visitor);
     }
 }
+
+// The tree returns the nodes with enlarged bounds intersecting, test them again with their real bounds
+void Scene::AcceptVisitor(SceneVisitor& visitor, const Bounds& bounds)
+{
+    ITUGL_PROFILE_SCOPE("Scene::AcceptVisitor");
+
+    UpdateBounds();
+
+    m_boundsTree.Query(bounds, [&](DynamicAabbTree::ProxyId proxyId)
+        {
+            SceneNode* node = static_cast<SceneNode*>(m_boundsTree.GetUserData(proxyId));
+            if (Bounds::Intersects(bounds, node->GetAabbBounds()))
+            {
+                node->AcceptVisitor(visitor);
+            }
+            return true;
+        });
+}
+
+void Scene::GetSceneNodes(const Bounds& bounds, std::vector<std::shared_ptr<SceneNode>>& nodes)
+{
+    UpdateBounds();
+
+    m_boundsTree.Query(bounds, [&](DynamicAabbTree::ProxyId proxyId)
+        {
+            SceneNode* node = static_cast<SceneNode*>(m_boundsTree.GetUserData(proxyId));
+            if (Bounds::Intersects(bounds, node->GetAabbBounds()))
+            {
+                nodes.push_back(m_nodes.at(node->GetName()));
+            }
+            return true;
+        });
+}
+
+// Each hit clips the ray, so the tree skips the nodes behind the closest one found so far
+std::shared_ptr<SceneNode> Scene::RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& distance)
+{
+    UpdateBounds();
+
+    glm::vec3 invDirection = 1.0f / direction;
+    SceneNode* closestNode = nullptr;
+    float closestDistance = maxDistance;
+    m_boundsTree.RayCast(origin, direction, maxDistance, [&](DynamicAabbTree::ProxyId proxyId, float rayMaxDistance)
+        {
+            SceneNode* node = static_cast<SceneNode*>(m_boundsTree.GetUserData(proxyId));
+            AabbBounds nodeBounds = node->GetAabbBounds();
+            float nodeDistance;
+            if (DynamicAabbTree::RayIntersects(origin, invDirection, nodeBounds.GetMin(), nodeBounds.GetMax(), rayMaxDistance, nodeDistance))
+            {
+                closestNode = node;
+                closestDistance = nodeDistance;
+                return nodeDistance;
+            }
+            return rayMaxDistance;
+        });
+
+    if (closestNode)
+    {
+        distance = closestDistance;
+        return m_nodes.at(closestNode->GetName());
+    }
+    return nullptr;
+}
+
+// Only the nodes whose transform changed are in the list, and most of them stay inside their enlarged bounds
+void Scene::UpdateBounds()
+{
+    for (const SceneNode* node : m_movedNodes)
+    {
+        auto it = m_nodeProxies.find(node);
+        if (it != m_nodeProxies.end() && it->second.moved)
+        {
+            m_boundsTree.MoveProxy(it->second.proxyId, node->GetAabbBounds());
+            it->second.moved = false;
+        }
+    }
+    m_movedNodes.clear();
+}
+
+void Scene::UpdateBounds(const SceneNode& node)
+{
+    auto it = m_nodeProxies.find(&node);
+    if (it != m_nodeProxies.end())
+    {
+        m_boundsTree.MoveProxy(it->second.proxyId, node.GetAabbBounds());
+    }
+}
+
+void Scene::AddSceneNodeProxy(const SceneNode& node)
+{
+    assert(m_nodeProxies.find(&node) == m_nodeProxies.end());
+
+    SceneNodeProxy proxy;
+    proxy.proxyId = m_boundsTree.CreateProxy(node.GetAabbBounds(), const_cast<SceneNode*>(&node));
+    proxy.moved = false;
+    m_nodeProxies[&node] = proxy;
+}
+
+void Scene::RemoveSceneNodeProxy(const SceneNode& node)
+{
+    auto it = m_nodeProxies.find(&node);
+    if (it != m_nodeProxies.end())
+    {
+        m_boundsTree.DestroyProxy(it->second.proxyId);
+        m_nodeProxies.erase(it);
+    }
+}
+
+void Scene::MarkMoved(const SceneNode& node)
+{
+    auto it = m_nodeProxies.find(&node);
+    if (it != m_nodeProxies.end() && !it->second.moved)
+    {
+        it->second.moved = true;
+        m_movedNodes.push_back(&node);
+    }
+}
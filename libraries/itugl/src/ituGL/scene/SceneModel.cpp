@@ -22,6 +22,17 @@ std::shared_ptr<Model> SceneModel::GetModel() const
 void SceneModel::SetModel(std::shared_ptr<Model> model)
 {
     m_model = model;
+    NotifyBoundsChanged();
+}
+
+std::shared_ptr<const OccluderMesh> SceneModel::GetOccluder() const
+{
+    return m_occluder;
+}
+
+void SceneModel::SetOccluder(std::shared_ptr<const OccluderMesh> occluder)
+{
+    m_occluder = occluder;
 }
 
 /*glm::mat4 SceneModel::GetWorldMatrix() const
@@ -57,7 +68,20 @@ BoxBounds SceneModel::GetBoxBounds() const
 {
     assert(m_transform);
     assert(m_model);
-    return BoxBounds(m_transform->GetTranslation(), m_transform->GetRotationMatrix(), m_transform->GetScale() /* * m_model->GetSize()*/);
+    glm::mat3 rotationMatrix(m_transform->GetRotationMatrix());
+    glm::vec3 scale = m_transform->GetScale();
+
+    // Without mesh bounds, assume a unit box around the origin
+    const Mesh& mesh = m_model->GetMesh();
+    if (!mesh.HasBounds())
+    {
+        return BoxBounds(m_transform->GetTranslation(), rotationMatrix, scale);
+    }
+
+    // Local bounds can be off-center, so the center also needs to be transformed
+    AabbBounds localBounds = mesh.GetBounds();
+    glm::vec3 center = m_transform->GetTranslation() + rotationMatrix * (scale * localBounds.GetCenter());
+    return BoxBounds(center, rotationMatrix, scale * localBounds.GetSize());
 }
 
 void SceneModel::AcceptVisitor(SceneVisitor& visitor)
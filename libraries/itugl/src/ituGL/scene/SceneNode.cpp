@@ -9,10 +9,18 @@ SceneNode::SceneNode(const std::string& name) : SceneNode(name, std::make_shared
 
 SceneNode::SceneNode(const std::string& name, std::shared_ptr<Transform> transform) : m_scene(nullptr), m_name(name), m_transform(transform)
 {
+    if (m_transform)
+    {
+        m_transform->AddSceneNode(this);
+    }
 }
 
 SceneNode::~SceneNode()
 {
+    if (m_transform)
+    {
+        m_transform->RemoveSceneNode(this);
+    }
 }
 
 const std::string& SceneNode::GetName() const
@@ -48,7 +56,16 @@ std::shared_ptr<const Transform> SceneNode::GetTransform() const
 
 void SceneNode::SetTransform(std::shared_ptr<Transform> transform)
 {
+    if (m_transform)
+    {
+        m_transform->RemoveSceneNode(this);
+    }
     m_transform = transform;
+    if (m_transform)
+    {
+        m_transform->AddSceneNode(this);
+    }
+    OnTransformModified();
 }
 
 Scene* SceneNode::GetOwnerScene() const
@@ -61,6 +78,22 @@ void SceneNode::SetOwnerScene(Scene* scene)
     m_scene = scene;
 }
 
+void SceneNode::OnTransformModified()
+{
+    if (m_scene)
+    {
+        m_scene->MarkMoved(*this);
+    }
+}
+
+void SceneNode::NotifyBoundsChanged() const
+{
+    if (m_scene)
+    {
+        m_scene->UpdateBounds(*this);
+    }
+}
+
 SphereBounds SceneNode::GetSphereBounds() const
 {
     return SphereBounds(glm::vec3(m_transform->GetTranslation()), 0.0f); // use world translation?
@@ -1,11 +1,40 @@
 #include <ituGL/scene/Transform.h>
 
+#include <ituGL/scene/SceneNode.h>
 #include <glm/ext/matrix_transform.hpp>
+#include <algorithm>
+#include <cassert>
 
 Transform::Transform() : m_translation(0, 0, 0), m_rotation(0, 0, 0), m_scale(1, 1, 1), m_matrix(1.0f), m_dirty(false)
 {
 }
 
+Transform::~Transform()
+{
+    // The scene nodes hold the transform, so they are gone. Only the parent can still have a link to it
+    assert(m_sceneNodes.empty());
+    if (m_parent)
+    {
+        std::vector<Transform*>& siblings = m_parent->m_children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+    }
+}
+
+void Transform::SetParent(std::shared_ptr<Transform> parent)
+{
+    if (m_parent)
+    {
+        std::vector<Transform*>& siblings = m_parent->m_children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+    }
+    m_parent = parent;
+    if (m_parent)
+    {
+        m_parent->m_children.push_back(this);
+    }
+    SetDirty();
+}
+
 glm::mat4 Transform::GetTranslationMatrix() const
 {
     return glm::translate(glm::identity<glm::mat4>(), m_translation);
@@ -43,3 +72,28 @@ bool Transform::IsDirty() const
 {
     return m_dirty || (m_parent && m_parent->IsDirty());
 }
+
+void Transform::AddSceneNode(SceneNode* node)
+{
+    m_sceneNodes.push_back(node);
+}
+
+void Transform::RemoveSceneNode(SceneNode* node)
+{
+    auto it = std::find(m_sceneNodes.begin(), m_sceneNodes.end(), node);
+    assert(it != m_sceneNodes.end());
+    m_sceneNodes.erase(it);
+}
+
+// Usually a transform has one node and no children, so this is cheap to do on every modification
+void Transform::NotifyModified() const
+{
+    for (SceneNode* node : m_sceneNodes)
+    {
+        node->OnTransformModified();
+    }
+    for (const Transform* child : m_children)
+    {
+        child->NotifyModified();
+    }
+}
@@ -2,13 +2,16 @@
 
 #include <ituGL/shader/Shader.h>
 #include <ituGL/texture/TextureObject.h>
+#include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
+unsigned int ShaderProgram::s_nextId = 0;
+
 #ifndef NDEBUG
 ShaderProgram::Handle ShaderProgram::s_usedHandle = ShaderProgram::NullHandle;
 #endif
 
-ShaderProgram::ShaderProgram() : Object(NullHandle)
+ShaderProgram::ShaderProgram() : Object(NullHandle), m_id(s_nextId++)
 {
     Handle& handle = GetHandle();
     handle = glCreateProgram();
@@ -20,17 +23,25 @@ ShaderProgram::~ShaderProgram()
     {
         Handle& handle = GetHandle();
         glDeleteProgram(handle);
+        if (DeviceGL* device = DeviceGL::GetInstancePointer())
+        {
+            device->OnProgramDeleted(handle);
+        }
         handle = NullHandle;
     }
 }
 
-ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) noexcept : Object(std::move(shaderProgram))
+// The id moves with the handle. The moved-from program gets a new one, so ids stay unique
+ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) noexcept : Object(std::move(shaderProgram)), m_id(shaderProgram.m_id)
 {
+    shaderProgram.m_id = s_nextId++;
 }
 
 ShaderProgram& ShaderProgram::operator = (ShaderProgram&& shaderProgram) noexcept
 {
     Object::operator=(std::move(shaderProgram));
+    m_id = shaderProgram.m_id;
+    shaderProgram.m_id = s_nextId++;
     return *this;
 }
 
@@ -124,12 +135,19 @@ void ShaderProgram::Use() const
     assert(IsValid());
     assert(IsLinked());
     Handle handle = GetHandle();
-    glUseProgram(handle);
+    DeviceGL::GetInstance().UseProgram(handle);
 #ifndef NDEBUG
     s_usedHandle = handle;
 #endif
 }
 
+// Run the compute shader of the program
+void ShaderProgram::Dispatch(GLuint groupCountX, GLuint groupCountY, GLuint groupCountZ) const
+{
+    assert(IsUsed());
+    glDispatchCompute(groupCountX, groupCountY, groupCountZ);
+}
+
 // Find an attribute location by name
 ShaderProgram::Location ShaderProgram::GetAttributeLocation(const char* name) const
 {
@@ -160,6 +178,54 @@ void ShaderProgram::GetUniformInfo(unsigned int index, int& size, GLenum& glType
     glGetActiveUniform(GetHandle(), index, uniformName.size(), nullptr, &size, &glType, uniformName.data());
 }
 
+// Get the number of elements of an active uniform array
+int ShaderProgram::GetUniformArraySize(const char* name) const
+{
+    assert(IsLinked());
+    GLuint index;
+    glGetUniformIndices(GetHandle(), 1, &name, &index);
+    if (index == GL_INVALID_INDEX)
+    {
+        return 0;
+    }
+
+    GLint size;
+    glGetActiveUniformsiv(GetHandle(), 1, &index, GL_UNIFORM_SIZE, &size);
+    return size;
+}
+
+// Find a uniform block index by name
+GLuint ShaderProgram::GetUniformBlockIndex(const char* name) const
+{
+    assert(IsValid());
+    assert(IsLinked());
+    return glGetUniformBlockIndex(GetHandle(), name);
+}
+
+// Set the binding point where the uniform block reads its buffer
+void ShaderProgram::SetUniformBlockBinding(GLuint blockIndex, GLuint binding) const
+{
+    assert(IsValid());
+    assert(blockIndex != GL_INVALID_INDEX);
+    glUniformBlockBinding(GetHandle(), blockIndex, binding);
+}
+
+// Find a shader storage block index by name
+GLuint ShaderProgram::GetShaderStorageBlockIndex(const char* name) const
+{
+    assert(IsValid());
+    assert(IsLinked());
+    return glGetProgramResourceIndex(GetHandle(), GL_SHADER_STORAGE_BLOCK, name);
+}
+
+// Set the binding point where the shader storage block reads its buffer
+void ShaderProgram::SetShaderStorageBlockBinding(GLuint blockIndex, GLuint binding) const
+{
+    assert(IsValid());
+    assert(blockIndex != GL_INVALID_INDEX);
+    glShaderStorageBlockBinding(GetHandle(), blockIndex, binding);
+}
+
 // All the different combinations of Get/SetUniform
 template<>
 void ShaderProgram::GetUniform<GLint>(Location location, std::span<GLint> value) const
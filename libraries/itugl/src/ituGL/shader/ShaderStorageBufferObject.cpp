@@ -0,0 +1,12 @@
+#include <ituGL/shader/ShaderStorageBufferObject.h>
+
+ShaderStorageBufferObject::ShaderStorageBufferObject()
+{
+    // Nothing to do here, it is done by the base class
+}
+
+bool ShaderStorageBufferObject::IsSupported()
+{
+    // Core in OpenGL 4.3
+    return GLAD_GL_VERSION_4_3;
+}
@@ -1,4 +1,5 @@
 #include <ituGL/shader/ShaderUniformCollection.h>
+#include <ituGL/renderer/CommandList.h>
 #include <cassert>
 #include <array>
 
@@ -85,9 +86,10 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
         if (filteredUniforms.contains(uniformName))
             continue;
 
-        // Get the uniform location
+        // Get the uniform location. Uniforms inside blocks don't have one, they are set through buffers
         ShaderProgram::Location location = GetUniformLocation(uniformName);
-        assert(location >= 0);
+        if (location < 0)
+            continue;
 
         Data::Type type;
         UniformDimension dimension;
@@ -379,6 +381,122 @@ void ShaderUniformCollection::UseUniform<float>(const DataUniform& uniform) cons
     }
 }
 
+template<typename T>
+void ShaderUniformCollection::RecordUniform(const DataUniform& uniform, CommandList& commandList) const
+{
+    ShaderProgram::Location location = uniform.location;
+    switch (uniform.dimension)
+    {
+    case UniformDimension::Scalar:
+        commandList.SetUniforms<T>(*m_shaderProgram, location, GetDataValues<T>(location));
+        break;
+    case UniformDimension::Vector2:
+        commandList.SetUniforms<T, 2>(*m_shaderProgram, location, GetDataValues<glm::vec<2, T>>(location));
+        break;
+    case UniformDimension::Vector3:
+        commandList.SetUniforms<T, 3>(*m_shaderProgram, location, GetDataValues<glm::vec<3, T>>(location));
+        break;
+    case UniformDimension::Vector4:
+        commandList.SetUniforms<T, 4>(*m_shaderProgram, location, GetDataValues<glm::vec<4, T>>(location));
+        break;
+    default:
+        assert(false);
+    }
+}
+
+template<>
+void ShaderUniformCollection::RecordUniform<float>(const DataUniform& uniform, CommandList& commandList) const
+{
+    ShaderProgram::Location location = uniform.location;
+    switch (uniform.dimension)
+    {
+    case UniformDimension::Scalar:
+        commandList.SetUniforms<float>(*m_shaderProgram, location, GetDataValues<float>(location));
+        break;
+    case UniformDimension::Vector2:
+        commandList.SetUniforms<float, 2>(*m_shaderProgram, location, GetDataValues<glm::vec<2, float>>(location));
+        break;
+    case UniformDimension::Vector3:
+        commandList.SetUniforms<float, 3>(*m_shaderProgram, location, GetDataValues<glm::vec<3, float>>(location));
+        break;
+    case UniformDimension::Vector4:
+        commandList.SetUniforms<float, 4>(*m_shaderProgram, location, GetDataValues<glm::vec<4, float>>(location));
+        break;
+    case UniformDimension::Matrix2x2:
+        commandList.SetUniforms<float, 2, 2>(*m_shaderProgram, location, GetDataValues<glm::mat<2, 2, float>>(location));
+        break;
+    case UniformDimension::Matrix2x3:
+        commandList.SetUniforms<float, 2, 3>(*m_shaderProgram, location, GetDataValues<glm::mat<2, 3, float>>(location));
+        break;
+    case UniformDimension::Matrix2x4:
+        commandList.SetUniforms<float, 2, 4>(*m_shaderProgram, location, GetDataValues<glm::mat<2, 4, float>>(location));
+        break;
+    case UniformDimension::Matrix3x2:
+        commandList.SetUniforms<float, 3, 2>(*m_shaderProgram, location, GetDataValues<glm::mat<3, 2, float>>(location));
+        break;
+    case UniformDimension::Matrix3x3:
+        commandList.SetUniforms<float, 3, 3>(*m_shaderProgram, location, GetDataValues<glm::mat<3, 3, float>>(location));
+        break;
+    case UniformDimension::Matrix3x4:
+        commandList.SetUniforms<float, 3, 4>(*m_shaderProgram, location, GetDataValues<glm::mat<3, 4, float>>(location));
+        break;
+    case UniformDimension::Matrix4x2:
+        commandList.SetUniforms<float, 4, 2>(*m_shaderProgram, location, GetDataValues<glm::mat<4, 2, float>>(location));
+        break;
+    case UniformDimension::Matrix4x3:
+        commandList.SetUniforms<float, 4, 3>(*m_shaderProgram, location, GetDataValues<glm::mat<4, 3, float>>(location));
+        break;
+    case UniformDimension::Matrix4x4:
+        commandList.SetUniforms<float, 4, 4>(*m_shaderProgram, location, GetDataValues<glm::mat<4, 4, float>>(location));
+        break;
+    default:
+        assert(false);
+    }
+}
+
+void ShaderUniformCollection::RecordUniforms(CommandList& commandList) const
+{
+    for (const DataUniform& uniform : m_dataUniforms)
+    {
+        RecordUniform(uniform, commandList);
+    }
+    for (const TextureUniform& uniform : m_textureUniforms)
+    {
+        RecordUniform(uniform, commandList);
+    }
+}
+
+void ShaderUniformCollection::RecordUniform(const DataUniform& uniform, CommandList& commandList) const
+{
+    switch (uniform.type)
+    {
+    case Data::Type::Int:
+        RecordUniform<int>(uniform, commandList);
+        break;
+    case Data::Type::UInt:
+        RecordUniform<unsigned int>(uniform, commandList);
+        break;
+    case Data::Type::Float:
+        RecordUniform<float>(uniform, commandList);
+        break;
+    case Data::Type::Double:
+        RecordUniform<double>(uniform, commandList);
+        break;
+    default:
+        assert(false);
+    }
+}
+
+void ShaderUniformCollection::RecordUniform(const TextureUniform& uniform, CommandList& commandList) const
+{
+    // Same texture unit as UseUniform
+    if (uniform.texture)
+    {
+        size_t textureIndex = &uniform - m_textureUniforms.data();
+        commandList.BindTexture(*m_shaderProgram, uniform.location, static_cast<int>(textureIndex), *uniform.texture);
+    }
+}
+
 template<>
 void ShaderUniformCollection::GetUniformValue(ShaderProgram::Location location, std::shared_ptr<TextureObject>& value) const
 {
@@ -0,0 +1,6 @@
+#include <ituGL/shader/UniformBufferObject.h>
+
+UniformBufferObject::UniformBufferObject()
+{
+    // Nothing to do here, it is done by the base class
+}
@@ -0,0 +1,14 @@
+#include <ituGL/texture/BufferTextureObject.h>
+
+#include <ituGL/texture/TextureBufferObject.h>
+#include <cassert>
+
+BufferTextureObject::BufferTextureObject()
+{
+}
+
+void BufferTextureObject::SetBuffer(InternalFormat internalFormat, const TextureBufferObject& buffer)
+{
+    assert(IsBound());
+    glTexBuffer(GetTarget(), internalFormat, buffer.GetHandle());
+}
@@ -1,6 +1,8 @@
 #include <ituGL/texture/FramebufferObject.h>
 
 #include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/texture/Texture2DMultisampleObject.h>
+#include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
 std::shared_ptr<const FramebufferObject> FramebufferObject::s_defaultFramebuffer(std::make_shared<FramebufferObject>(FramebufferObject(Object::NullHandle)));
@@ -23,6 +25,10 @@ FramebufferObject::~FramebufferObject()
     if (handle != NullHandle)
     {
         glDeleteFramebuffers(1, &handle);
+        if (DeviceGL* device = DeviceGL::GetInstancePointer())
+        {
+            device->OnFramebufferDeleted(handle);
+        }
     }
 }
 
@@ -34,7 +40,7 @@ void FramebufferObject::Bind() const
 void FramebufferObject::Bind(Target target) const
 {
     Handle handle = GetHandle();
-    glBindFramebuffer(static_cast<GLenum>(target), handle);
+    DeviceGL::GetInstance().BindFramebuffer(static_cast<GLenum>(target), handle);
 }
 
 void FramebufferObject::Unbind()
@@ -45,7 +51,7 @@ void FramebufferObject::Unbind()
 void FramebufferObject::Unbind(Target target)
 {
     Handle handle = NullHandle;
-    glBindFramebuffer(static_cast<GLenum>(target), handle);
+    DeviceGL::GetInstance().BindFramebuffer(static_cast<GLenum>(target), handle);
 }
 
 std::shared_ptr<const FramebufferObject> FramebufferObject::GetDefault()
@@ -58,6 +64,11 @@ void FramebufferObject::SetTexture(Target target, Attachment attachment, const T
     glFramebufferTexture2D(static_cast<GLenum>(target), static_cast<GLenum>(attachment), texture.GetTarget(), texture.GetHandle(), level);
 }
 
+void FramebufferObject::SetTexture(Target target, Attachment attachment, const Texture2DMultisampleObject& texture)
+{
+    glFramebufferTexture2D(static_cast<GLenum>(target), static_cast<GLenum>(attachment), texture.GetTarget(), texture.GetHandle(), 0);
+}
+
 void FramebufferObject::SetDrawBuffers(std::span<const Attachment> attachments)
 {
     glDrawBuffers(static_cast<GLint>(attachments.size()), reinterpret_cast<const GLenum*>(attachments.data()));
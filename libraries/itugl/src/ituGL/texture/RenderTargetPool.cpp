@@ -0,0 +1,206 @@
+#include <ituGL/texture/RenderTargetPool.h>
+
+#include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/texture/Texture2DMultisampleObject.h>
+#include <ituGL/texture/FramebufferObject.h>
+#include <algorithm>
+#include <cassert>
+
+RenderTargetPool::Descriptor RenderTargetPool::Descriptor::Create(int width, int height, TextureObject::InternalFormat colorFormat,
+    TextureObject::InternalFormat depthFormat, int samples)
+{
+    Descriptor descriptor;
+    descriptor.width = width;
+    descriptor.height = height;
+    descriptor.colorFormats.fill(TextureObject::InternalFormatInvalid);
+    descriptor.colorFormats[0] = colorFormat;
+    descriptor.depthFormat = depthFormat;
+    descriptor.samples = samples;
+    return descriptor;
+}
+
+RenderTargetPool::RenderTargetPool(unsigned int maxUnusedFrames) : m_maxUnusedFrames(maxUnusedFrames), m_memorySize(0)
+{
+}
+
+std::shared_ptr<const RenderTargetPool::RenderTarget> RenderTargetPool::Acquire(const Descriptor& descriptor)
+{
+    // Reuse a free render target with the same descriptor
+    for (Entry& entry : m_entries)
+    {
+        if (!IsInUse(entry) && entry.renderTarget->descriptor == descriptor)
+        {
+            entry.unusedFrames = 0;
+            return entry.renderTarget;
+        }
+    }
+
+    Entry entry;
+    entry.renderTarget = CreateRenderTarget(descriptor);
+    entry.memorySize = GetMemorySize(descriptor);
+    entry.unusedFrames = 0;
+    m_entries.push_back(entry);
+    m_memorySize += entry.memorySize;
+    return entry.renderTarget;
+}
+
+void RenderTargetPool::EndFrame()
+{
+    for (Entry& entry : m_entries)
+    {
+        entry.unusedFrames = IsInUse(entry) ? 0 : entry.unusedFrames + 1;
+    }
+
+    // Delete the render targets that have been free for too long
+    auto itRemove = std::remove_if(m_entries.begin(), m_entries.end(),
+        [&](const Entry& entry) { return entry.unusedFrames > m_maxUnusedFrames; });
+    for (auto it = itRemove; it != m_entries.end(); ++it)
+    {
+        m_memorySize -= it->memorySize;
+    }
+    m_entries.erase(itRemove, m_entries.end());
+}
+
+void RenderTargetPool::ReleaseUnused()
+{
+    auto itRemove = std::remove_if(m_entries.begin(), m_entries.end(),
+        [](const Entry& entry) { return !IsInUse(entry); });
+    for (auto it = itRemove; it != m_entries.end(); ++it)
+    {
+        m_memorySize -= it->memorySize;
+    }
+    m_entries.erase(itRemove, m_entries.end());
+}
+
+std::shared_ptr<RenderTargetPool::RenderTarget> RenderTargetPool::CreateRenderTarget(const Descriptor& descriptor)
+{
+    assert(descriptor.width > 0 && descriptor.height > 0 && descriptor.samples > 0);
+
+    std::shared_ptr<RenderTarget> renderTarget = std::make_shared<RenderTarget>();
+    renderTarget->descriptor = descriptor;
+
+    // Create the textures first, binding them would change the framebuffer state otherwise
+    for (unsigned int i = 0; i < MaxColorAttachments; ++i)
+    {
+        if (descriptor.colorFormats[i] != TextureObject::InternalFormatInvalid)
+        {
+            renderTarget->colorTextures[i] = CreateTexture(descriptor, descriptor.colorFormats[i]);
+        }
+    }
+    if (descriptor.depthFormat != TextureObject::InternalFormatInvalid)
+    {
+        renderTarget->depthTexture = CreateTexture(descriptor, descriptor.depthFormat);
+    }
+
+    // Attach them to the framebuffer
+    renderTarget->framebuffer = std::make_shared<FramebufferObject>();
+    FramebufferObject& framebuffer = *renderTarget->framebuffer;
+    framebuffer.Bind();
+
+    auto attachTexture = [&](FramebufferObject::Attachment attachment, const TextureObject& texture)
+    {
+        if (descriptor.samples > 1)
+        {
+            framebuffer.SetTexture(FramebufferObject::Target::Draw, attachment, static_cast<const Texture2DMultisampleObject&>(texture));
+        }
+        else
+        {
+            framebuffer.SetTexture(FramebufferObject::Target::Draw, attachment, static_cast<const Texture2DObject&>(texture));
+        }
+    };
+
+    std::vector<FramebufferObject::Attachment> drawBuffers;
+    for (unsigned int i = 0; i < MaxColorAttachments; ++i)
+    {
+        if (renderTarget->colorTextures[i])
+        {
+            FramebufferObject::Attachment attachment = static_cast<FramebufferObject::Attachment>(GL_COLOR_ATTACHMENT0 + i);
+            attachTexture(attachment, *renderTarget->colorTextures[i]);
+            drawBuffers.push_back(attachment);
+        }
+    }
+    if (renderTarget->depthTexture)
+    {
+        attachTexture(FramebufferObject::Attachment::Depth, *renderTarget->depthTexture);
+    }
+    framebuffer.SetDrawBuffers(drawBuffers);
+
+    FramebufferObject::Unbind();
+
+    return renderTarget;
+}
+
+std::shared_ptr<TextureObject> RenderTargetPool::CreateTexture(const Descriptor& descriptor, TextureObject::InternalFormat internalFormat)
+{
+    if (descriptor.samples > 1)
+    {
+        std::shared_ptr<Texture2DMultisampleObject> texture = std::make_shared<Texture2DMultisampleObject>();
+        texture->Bind();
+        texture->SetStorage(descriptor.samples, descriptor.width, descriptor.height, internalFormat);
+        Texture2DMultisampleObject::Unbind();
+        return texture;
+    }
+
+    // The format only matters when uploading data, but it must be compatible with the internal format
+    TextureObject::Format format;
+    bool depth = false;
+    switch (internalFormat)
+    {
+    case TextureObject::InternalFormatDepth:
+    case TextureObject::InternalFormatDepth16:
+    case TextureObject::InternalFormatDepth24:
+    case TextureObject::InternalFormatDepth32:
+    case TextureObject::InternalFormatDepth32F:
+        format = TextureObject::FormatDepth;
+        depth = true;
+        break;
+    case TextureObject::InternalFormatDepthStencil:
+    case TextureObject::InternalFormatDepth24Stencil8:
+    case TextureObject::InternalFormatDepth32FStencil8:
+        format = TextureObject::FormatDepthStencil;
+        depth = true;
+        break;
+    case TextureObject::InternalFormatR11G11B10:
+        format = TextureObject::FormatRGB;
+        break;
+    case TextureObject::InternalFormatRGB10A2:
+        format = TextureObject::FormatRGBA;
+        break;
+    default:
+    {
+        const std::array<TextureObject::Format, 4> formats = { TextureObject::FormatR, TextureObject::FormatRG, TextureObject::FormatRGB, TextureObject::FormatRGBA };
+        int componentCount = TextureObject::GetDataComponentCount(internalFormat);
+        assert(componentCount > 0);
+        format = formats[componentCount - 1];
+        break;
+    }
+    }
+
+    // Depth is read with nearest filtering, color with linear
+    std::shared_ptr<Texture2DObject> texture = std::make_shared<Texture2DObject>();
+    texture->Bind();
+    texture->SetImage(0, descriptor.width, descriptor.height, format, internalFormat);
+    texture->SetParameter(TextureObject::ParameterEnum::WrapS, GL_CLAMP_TO_EDGE);
+    texture->SetParameter(TextureObject::ParameterEnum::WrapT, GL_CLAMP_TO_EDGE);
+    texture->SetParameter(TextureObject::ParameterEnum::MinFilter, depth ? GL_NEAREST : GL_LINEAR);
+    texture->SetParameter(TextureObject::ParameterEnum::MagFilter, depth ? GL_NEAREST : GL_LINEAR);
+    Texture2DObject::Unbind();
+    return texture;
+}
+
+size_t RenderTargetPool::GetMemorySize(const Descriptor& descriptor)
+{
+    size_t pixelSize = 0;
+    for (TextureObject::InternalFormat colorFormat : descriptor.colorFormats)
+    {
+        if (colorFormat != TextureObject::InternalFormatInvalid)
+        {
+            pixelSize += TextureObject::GetPixelSize(colorFormat);
+        }
+    }
+    if (descriptor.depthFormat != TextureObject::InternalFormatInvalid)
+    {
+        pixelSize += TextureObject::GetPixelSize(descriptor.depthFormat);
+    }
+    return pixelSize * descriptor.width * descriptor.height * descriptor.samples;
+}
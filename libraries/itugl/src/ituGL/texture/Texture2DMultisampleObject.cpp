@@ -0,0 +1,14 @@
+#include <ituGL/texture/Texture2DMultisampleObject.h>
+
+#include <cassert>
+
+Texture2DMultisampleObject::Texture2DMultisampleObject()
+{
+}
+
+void Texture2DMultisampleObject::SetStorage(GLsizei samples, GLsizei width, GLsizei height, InternalFormat internalFormat, bool fixedSampleLocations)
+{
+    assert(IsBound());
+    assert(samples > 0);
+    glTexImage2DMultisample(GetTarget(), samples, internalFormat, width, height, fixedSampleLocations ? GL_TRUE : GL_FALSE);
+}
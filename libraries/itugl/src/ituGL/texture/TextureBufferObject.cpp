@@ -0,0 +1,5 @@
+#include <ituGL/texture/TextureBufferObject.h>
+
+TextureBufferObject::TextureBufferObject()
+{
+}
@@ -1,5 +1,6 @@
 #include <ituGL/texture/TextureObject.h>
 
+#include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
 TextureObject::TextureObject() : Object(NullHandle)
@@ -12,6 +13,10 @@ TextureObject::~TextureObject()
 {
     Handle& handle = GetHandle();
     glDeleteTextures(1, &handle);
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->OnTextureDeleted(handle);
+    }
 }
 
 #ifndef NDEBUG
@@ -25,19 +30,19 @@ GLint TextureObject::GetActiveTexture()
 
 void TextureObject::SetActiveTexture(GLint textureUnit)
 {
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    DeviceGL::GetInstance().SetActiveTexture(textureUnit);
 }
 
 void TextureObject::Bind(Target target) const
 {
     Handle handle = GetHandle();
-    glBindTexture(target, handle);
+    DeviceGL::GetInstance().BindTexture(target, handle);
 }
 
 void TextureObject::Unbind(Target target)
 {
     Handle handle = NullHandle;
-    glBindTexture(target, handle);
+    DeviceGL::GetInstance().BindTexture(target, handle);
 }
 
 void TextureObject::GenerateMipmap()
@@ -46,6 +51,12 @@ void TextureObject::GenerateMipmap()
     glGenerateMipmap(GetTarget());
 }
 
+void TextureObject::BindImage(GLuint imageUnit, GLint level, GLenum access, InternalFormat format) const
+{
+    // The whole texture is bound, not a single layer
+    glBindImageTexture(imageUnit, GetHandle(), level, GL_TRUE, 0, access, format);
+}
+
 void TextureObject::GetParameter(ParameterFloat pname, GLfloat& param) const
 {
     assert(IsBound());
@@ -213,6 +224,7 @@ int TextureObject::GetDataComponentCount(InternalFormat internalFormat)
     case InternalFormatDepth32F:
     case InternalFormatDepthStencil:
     case InternalFormatDepth24Stencil8:
+    case InternalFormatR32UI:
         return 1;
     case InternalFormatRG:
     case InternalFormatRG8:
@@ -222,6 +234,7 @@ int TextureObject::GetDataComponentCount(InternalFormat internalFormat)
     case InternalFormatRG16F:
     case InternalFormatRG32F:
     case InternalFormatRGCompressed:
+    case InternalFormatRG32UI:
         return 2;
     case InternalFormatRGB:
     case InternalFormatRGB8:
@@ -244,9 +257,67 @@ int TextureObject::GetDataComponentCount(InternalFormat internalFormat)
     case InternalFormatSRGBA8:
     case InternalFormatRGBACompressed:
     case InternalFormatSRGBACompressed:
+    case InternalFormatRGBA32UI:
         return 4;
     default:
         //Unknown format
         return 0;
     }
 }
+
+int TextureObject::GetPixelSize(InternalFormat internalFormat)
+{
+    switch (internalFormat)
+    {
+    case InternalFormatR8:
+    case InternalFormatR8SNorm:
+        return 1;
+    case InternalFormatRG8:
+    case InternalFormatRG8SNorm:
+    case InternalFormatR16:
+    case InternalFormatR16SNorm:
+    case InternalFormatR16F:
+    case InternalFormatDepth16:
+        return 2;
+    case InternalFormatRGB8:
+    case InternalFormatRGB8SNorm:
+    case InternalFormatSRGB8:
+    case InternalFormatDepth24:
+        return 3;
+    case InternalFormatRGBA8:
+    case InternalFormatRGBA8SNorm:
+    case InternalFormatSRGBA8:
+    case InternalFormatRG16:
+    case InternalFormatRG16SNorm:
+    case InternalFormatRG16F:
+    case InternalFormatR32F:
+    case InternalFormatR32UI:
+    case InternalFormatR11G11B10:
+    case InternalFormatRGB10A2:
+    case InternalFormatDepth32:
+    case InternalFormatDepth32F:
+    case InternalFormatDepth24Stencil8:
+        return 4;
+    case InternalFormatRGB16:
+    case InternalFormatRGB16SNorm:
+    case InternalFormatRGB16F:
+        return 6;
+    case InternalFormatRGBA16:
+    case InternalFormatRGBA16SNorm:
+    case InternalFormatRGBA16F:
+    case InternalFormatRG32F:
+    case InternalFormatRG32UI:
+    case InternalFormatDepth32FStencil8:
+        return 8;
+    case InternalFormatRGB32F:
+        return 12;
+    case InternalFormatRGBA32F:
+    case InternalFormatRGBA32UI:
+        return 16;
+    case InternalFormatDepthStencil:
+        return 4;
+    default:
+        // Unsized or compressed formats, the size depends on the driver
+        return GetDataComponentCount(internalFormat);
+    }
+}
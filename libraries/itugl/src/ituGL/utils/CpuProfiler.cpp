@@ -0,0 +1,281 @@
+#include <ituGL/utils/CpuProfiler.h>
+
+#include <ituGL/utils/DearImGui.h>
+#include <ituGL/utils/Json.h>
+#include <imgui.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Zone written by a thread in its ring buffer. Times are in nanoseconds since the profiler started
+struct ProfilerEvent
+{
+    const char* name;
+    std::uint64_t startTime;
+    std::uint64_t endTime;
+    unsigned int depth;
+};
+
+// Ring buffer with a single writer, the thread that owns it, and a single reader, EndFrame
+struct ProfilerThreadBuffer
+{
+    static const unsigned int Capacity = 4096;
+
+    std::array<ProfilerEvent, Capacity> events;
+
+    // Indices grow forever, and wrap around when accessing the array
+    std::atomic<unsigned int> writeIndex = 0;
+    std::atomic<unsigned int> readIndex = 0;
+    std::atomic<unsigned int> droppedCount = 0;
+
+    // Zones open in the thread. Only used by the owner
+    unsigned int depth = 0;
+
+    unsigned int threadIndex = 0;
+    std::string name;
+};
+
+// Zone kept while capturing. The name is copied, because it could be gone when the trace is written
+struct ProfilerCapturedZone
+{
+    std::string name;
+    unsigned int threadIndex;
+    std::uint64_t startTime;
+    std::uint64_t endTime;
+};
+
+struct ProfilerState
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    // Buffers of all the threads that recorded a zone. The mutex is only locked when a thread is added, and in EndFrame
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProfilerThreadBuffer>> threadBuffers;
+
+    std::uint64_t frameStartTime = 0;
+    double frameTime = 0.0;
+    std::vector<CpuProfiler::Zone> frameZones;
+
+    bool capturing = false;
+    std::vector<ProfilerCapturedZone> capturedZones;
+};
+
+static ProfilerState& GetProfilerState()
+{
+    static ProfilerState state;
+    return state;
+}
+
+static std::uint64_t GetProfilerTime()
+{
+    std::chrono::nanoseconds time = std::chrono::steady_clock::now() - GetProfilerState().startTime;
+    return static_cast<std::uint64_t>(time.count());
+}
+
+// Buffer of the calling thread, created the first time it is needed
+static ProfilerThreadBuffer& GetThreadBuffer()
+{
+    thread_local ProfilerThreadBuffer* threadBuffer = nullptr;
+    if (!threadBuffer)
+    {
+        ProfilerState& state = GetProfilerState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        std::unique_ptr<ProfilerThreadBuffer>& newBuffer = state.threadBuffers.emplace_back(std::make_unique<ProfilerThreadBuffer>());
+        newBuffer->threadIndex = static_cast<unsigned int>(state.threadBuffers.size()) - 1;
+        newBuffer->name = "Thread " + std::to_string(newBuffer->threadIndex);
+        threadBuffer = newBuffer.get();
+    }
+    return *threadBuffer;
+}
+
+CpuProfiler::ScopedZone::ScopedZone(const char* name) : m_name(name), m_startTime(GetProfilerTime())
+{
+    m_depth = GetThreadBuffer().depth++;
+}
+
+CpuProfiler::ScopedZone::~ScopedZone()
+{
+    std::uint64_t endTime = GetProfilerTime();
+
+    ProfilerThreadBuffer& threadBuffer = GetThreadBuffer();
+    threadBuffer.depth--;
+
+    unsigned int writeIndex = threadBuffer.writeIndex.load(std::memory_order_relaxed);
+    if (writeIndex - threadBuffer.readIndex.load(std::memory_order_acquire) >= ProfilerThreadBuffer::Capacity)
+    {
+        threadBuffer.droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    threadBuffer.events[writeIndex % ProfilerThreadBuffer::Capacity] = { m_name, m_startTime, endTime, m_depth };
+
+    // Publish the event after writing it
+    threadBuffer.writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+void CpuProfiler::BeginFrame()
+{
+    GetProfilerState().frameStartTime = GetProfilerTime();
+}
+
+void CpuProfiler::EndFrame()
+{
+    ProfilerState& state = GetProfilerState();
+    std::uint64_t frameEndTime = GetProfilerTime();
+    state.frameTime = (frameEndTime - state.frameStartTime) * 1e-6;
+    state.frameZones.clear();
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    for (const std::unique_ptr<ProfilerThreadBuffer>& threadBuffer : state.threadBuffers)
+    {
+        unsigned int readIndex = threadBuffer->readIndex.load(std::memory_order_relaxed);
+        unsigned int writeIndex = threadBuffer->writeIndex.load(std::memory_order_acquire);
+        for (; readIndex != writeIndex; ++readIndex)
+        {
+            const ProfilerEvent& event = threadBuffer->events[readIndex % ProfilerThreadBuffer::Capacity];
+
+            // Zones that started before the frame, like loading in Initialize, get negative start times
+            double startTime = (static_cast<double>(event.startTime) - static_cast<double>(state.frameStartTime)) * 1e-6;
+            double duration = (event.endTime - event.startTime) * 1e-6;
+            state.frameZones.push_back({ event.name, threadBuffer->threadIndex, event.depth, startTime, duration });
+
+            if (state.capturing)
+            {
+                state.capturedZones.push_back({ event.name, threadBuffer->threadIndex, event.startTime, event.endTime });
+            }
+        }
+
+        // Give the space back to the writer after reading the events
+        threadBuffer->readIndex.store(readIndex, std::memory_order_release);
+    }
+
+    // Zones are written when they end, so the outer zones come after the inner ones. Sort them by start time instead
+    std::sort(state.frameZones.begin(), state.frameZones.end(), [](const Zone& a, const Zone& b)
+        {
+            if (a.threadIndex != b.threadIndex)
+            {
+                return a.threadIndex < b.threadIndex;
+            }
+            return a.startTime != b.startTime ? a.startTime < b.startTime : a.depth < b.depth;
+        });
+}
+
+std::span<const CpuProfiler::Zone> CpuProfiler::GetFrameZones()
+{
+    return GetProfilerState().frameZones;
+}
+
+double CpuProfiler::GetFrameTime()
+{
+    return GetProfilerState().frameTime;
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+    ProfilerThreadBuffer& threadBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(GetProfilerState().mutex);
+    threadBuffer.name = name;
+}
+
+unsigned int CpuProfiler::GetDroppedZoneCount()
+{
+    ProfilerState& state = GetProfilerState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    unsigned int droppedCount = 0;
+    for (const std::unique_ptr<ProfilerThreadBuffer>& threadBuffer : state.threadBuffers)
+    {
+        droppedCount += threadBuffer->droppedCount.load(std::memory_order_relaxed);
+    }
+    return droppedCount;
+}
+
+void CpuProfiler::BeginCapture()
+{
+    ProfilerState& state = GetProfilerState();
+    state.capturedZones.clear();
+    state.capturing = true;
+}
+
+void CpuProfiler::EndCapture()
+{
+    GetProfilerState().capturing = false;
+}
+
+bool CpuProfiler::IsCapturing()
+{
+    return GetProfilerState().capturing;
+}
+
+void CpuProfiler::WriteChromeTrace(std::ostream& stream)
+{
+    ProfilerState& state = GetProfilerState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    stream << "{\"traceEvents\":[";
+
+    // Metadata events with the thread names
+    const char* separator = "\n";
+    for (const std::unique_ptr<ProfilerThreadBuffer>& threadBuffer : state.threadBuffers)
+    {
+        stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadBuffer->threadIndex << ",\"args\":{\"name\":";
+        Json::WriteString(stream, threadBuffer->name);
+        stream << "}}";
+        separator = ",\n";
+    }
+
+    // Complete events, with timestamps and durations in microseconds
+    stream.setf(std::ios::fixed);
+    stream.precision(3);
+    for (const ProfilerCapturedZone& zone : state.capturedZones)
+    {
+        stream << separator << "{\"name\":";
+        Json::WriteString(stream, zone.name);
+        stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << zone.threadIndex;
+        stream << ",\"ts\":" << zone.startTime * 1e-3 << ",\"dur\":" << (zone.endTime - zone.startTime) * 1e-3 << "}";
+        separator = ",\n";
+    }
+    stream << "\n]}\n";
+}
+
+void CpuProfiler::DrawGUI(DearImGui& imGui, const char* windowName)
+{
+    if (auto window = imGui.UseWindow(windowName))
+    {
+        ImGui::Text("Frame: %.3f ms", GetFrameTime());
+
+        if (!IsCapturing())
+        {
+            if (ImGui::Button("Start capture"))
+            {
+                BeginCapture();
+            }
+        }
+        else if (ImGui::Button("Save capture to cpu_trace.json"))
+        {
+            EndCapture();
+            std::ofstream file("cpu_trace.json");
+            WriteChromeTrace(file);
+        }
+
+        ImGui::Separator();
+
+        // Zones indented by depth, with a header for each thread
+        unsigned int threadIndex = ~0u;
+        for (const Zone& zone : GetFrameZones())
+        {
+            if (zone.threadIndex != threadIndex)
+            {
+                threadIndex = zone.threadIndex;
+                ImGui::Text("Thread %u", threadIndex);
+            }
+            ImGui::Text("%*s%s: %.3f ms", 2 * (zone.depth + 1), "", zone.name, zone.duration);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#include <ituGL/utils/FrameArena.h>
+
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t capacity)
+    : m_block(capacity > 0 ? std::make_unique<std::byte[]>(capacity) : nullptr)
+    , m_capacity(capacity)
+    , m_usedSize(0)
+    , m_overflowSize(0)
+    , m_highWaterMark(0)
+{
+}
+
+void FrameArena::Reset()
+{
+    size_t usedSize = GetUsedSize();
+    m_highWaterMark = std::max(m_highWaterMark, usedSize);
+
+    // The block was too small this frame. Replace it with one that fits everything, with some margin to avoid growing again
+    if (!m_overflowBlocks.empty())
+    {
+        m_overflowBlocks.clear();
+        m_capacity = m_highWaterMark + m_highWaterMark / 2;
+        m_block = std::make_unique<std::byte[]>(m_capacity);
+    }
+
+    m_usedSize = 0;
+    m_overflowSize = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // Align the address, not only the offset, the block could have less alignment than requested
+    uintptr_t blockAddress = reinterpret_cast<uintptr_t>(m_block.get());
+    uintptr_t address = (blockAddress + m_usedSize + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    size_t end = static_cast<size_t>(address - blockAddress) + bytes;
+
+    if (m_block && end <= m_capacity)
+    {
+        m_usedSize = end;
+        return reinterpret_cast<void*>(address);
+    }
+
+    // Doesn't fit, take it from the heap until the next Reset()
+    m_overflowBlocks.push_back(std::make_unique<std::byte[]>(bytes + alignment));
+    m_overflowSize += bytes + alignment;
+    uintptr_t overflowAddress = reinterpret_cast<uintptr_t>(m_overflowBlocks.back().get());
+    return reinterpret_cast<void*>((overflowAddress + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t)
+{
+    // Memory is only released on Reset()
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,22 @@
+#include <ituGL/utils/Json.h>
+
+void Json::WriteString(std::ostream& stream, std::string_view string)
+{
+    stream << '"';
+    for (char c : string)
+    {
+        if (c == '"' || c == '\\')
+        {
+            stream << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            stream << ' ';
+        }
+        else
+        {
+            stream << c;
+        }
+    }
+    stream << '"';
+}
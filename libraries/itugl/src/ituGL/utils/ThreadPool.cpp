@@ -0,0 +1,108 @@
+#include <ituGL/utils/ThreadPool.h>
+
+#include <ituGL/utils/CpuProfiler.h>
+#include <algorithm>
+#include <cassert>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : m_job(nullptr), m_count(0), m_generation(0), m_stop(false), m_nextIndex(0), m_activeWorkers(0)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // The calling thread is one of them
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCondition.notify_all();
+
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::ParallelFor(unsigned int count, const Job& job)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Not worth waking up the workers
+    if (count == 1 || m_threads.empty())
+    {
+        for (unsigned int index = 0; index < count; ++index)
+        {
+            job(index);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        assert(!m_job); // ParallelFor can't be called from a job
+        m_job = &job;
+        m_count = count;
+        m_nextIndex = 0;
+        m_activeWorkers = static_cast<unsigned int>(m_threads.size());
+        ++m_generation;
+    }
+    m_startCondition.notify_all();
+
+    RunJobs();
+
+    // Wait for the workers to finish the indices they took, and to leave the job, so it can be destroyed
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_activeWorkers == 0; });
+    m_job = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    CpuProfiler::SetThreadName("ThreadPool worker");
+
+    unsigned int generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [&] { return m_stop || m_generation != generation; });
+            if (m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        RunJobs();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeWorkers;
+        }
+        m_doneCondition.notify_one();
+    }
+}
+
+void ThreadPool::RunJobs()
+{
+    ITUGL_PROFILE_SCOPE("ThreadPool::RunJobs");
+
+    unsigned int index;
+    while ((index = m_nextIndex.fetch_add(1)) < m_count)
+    {
+        (*m_job)(index);
+    }
+}
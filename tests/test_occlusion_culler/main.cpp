@@ -0,0 +1,121 @@
+#include <ituGL/renderer/OcclusionCuller.h>
+#include <ituGL/camera/Camera.h>
+#include <ituGL/utils/ThreadPool.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+// Rasterizes a wall in front of the camera and checks which boxes behind it are culled
+
+static int s_failedCount = 0;
+
+static void Check(bool condition, const char* description)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED: " << description << std::endl;
+        ++s_failedCount;
+    }
+}
+
+struct TestBox
+{
+    const char* description;
+    glm::vec3 center;
+    glm::vec3 size;
+    bool visible;
+};
+
+int main()
+{
+    // Camera at the origin looking down -Z, with the aspect ratio of the culler
+    OcclusionCuller culler(256, 128);
+    Camera camera;
+    camera.SetViewMatrix(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    camera.SetPerspectiveProjectionMatrix(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+
+    // Wall of 10 x 10 units, 10 units away. It hides |x|, |y| < 10 at a distance of 20
+    OccluderMesh wall;
+    wall.positions = { glm::vec3(-1.0f, -1.0f, 0.0f), glm::vec3(1.0f, -1.0f, 0.0f), glm::vec3(1.0f, 1.0f, 0.0f), glm::vec3(-1.0f, 1.0f, 0.0f) };
+    wall.indices = { 0, 1, 2, 0, 2, 3 };
+    glm::mat4 wallMatrix = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -10.0f)), glm::vec3(5.0f));
+
+    // Sizes are half extents, like AabbBounds
+    const TestBox boxes[] =
+    {
+        { "box behind the center of the wall", glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(1.0f), false },
+        { "large box fully behind the wall", glm::vec3(2.0f, -2.0f, -30.0f), glm::vec3(4.0f), false },
+        { "box in front of the wall", glm::vec3(0.0f, 0.0f, -5.0f), glm::vec3(1.0f), true },
+        { "box intersecting the wall", glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(1.0f), true },
+        { "box behind the wall, beside it on screen", glm::vec3(15.0f, 0.0f, -20.0f), glm::vec3(1.0f), true },
+        { "box behind the edge of the wall, partially uncovered", glm::vec3(10.0f, 0.0f, -20.0f), glm::vec3(1.0f), true },
+        { "box crossing the near plane", glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.5f), true },
+        { "box without bounds", glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(std::numeric_limits<float>::max()), true },
+    };
+
+    // Without occluders nothing is culled
+    culler.Rasterize(camera.GetViewProjectionMatrix());
+    for (const TestBox& box : boxes)
+    {
+        Check(culler.IsVisible(box.center, box.size), box.description);
+    }
+
+    culler.AddOccluder(wall, wallMatrix);
+    Check(culler.GetOccluderCount() == 1, "occluder count");
+
+    // The same result with and without the thread pool
+    ThreadPool threadPool(4);
+    for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+    {
+        culler.Rasterize(camera.GetViewProjectionMatrix(), pool);
+
+        // The wall covers the center of the depth buffer, at the depth of a point 10 units away
+        std::span<const float> depthBuffer = culler.GetDepthBuffer();
+        glm::vec4 wallClip = camera.GetViewProjectionMatrix() * glm::vec4(0.0f, 0.0f, -10.0f, 1.0f);
+        float wallDepth = wallClip.z / wallClip.w * 0.5f + 0.5f;
+        float centerDepth = depthBuffer[(culler.GetHeight() / 2) * culler.GetWidth() + culler.GetWidth() / 2];
+        Check(std::abs(centerDepth - wallDepth) < 1e-4f, "depth of the wall at the center of the depth buffer");
+        Check(depthBuffer[0] == 1.0f, "empty corner of the depth buffer");
+
+        for (const TestBox& box : boxes)
+        {
+            Check(culler.IsVisible(box.center, box.size) == box.visible, box.description);
+        }
+
+        // Test all the boxes at once, in structure of arrays
+        const size_t boxCount = std::size(boxes);
+        std::vector<float> centers[3], sizes[3];
+        std::vector<std::uint8_t> visible(boxCount, 1);
+        for (const TestBox& box : boxes)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                centers[axis].push_back(box.center[axis]);
+                sizes[axis].push_back(box.size[axis]);
+            }
+        }
+        culler.TestAabbs({ centers[0], centers[1], centers[2] }, { sizes[0], sizes[1], sizes[2] }, visible, pool);
+        for (size_t i = 0; i < boxCount; ++i)
+        {
+            Check((visible[i] != 0) == boxes[i].visible, boxes[i].description);
+        }
+    }
+
+    // After a reset, the next rasterization is empty again
+    culler.Reset();
+    culler.Rasterize(camera.GetViewProjectionMatrix());
+    Check(culler.IsVisible(boxes[0].center, boxes[0].size), "box behind the removed wall");
+
+    if (s_failedCount > 0)
+    {
+        std::cerr << s_failedCount << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}